@@ -1,11 +1,104 @@
 #include "Mesh.hpp"
 
+#include "Data/Quantise.hpp"
+#include "Geometry/Intersect.hpp"
+#include "Geometry/Line.hpp"
+#include "Utility/Config.hpp"
 #include "Utility/Utility.hpp"
 
+#include "glm/gtc/matrix_transform.hpp"
 #include "imgui.h"
 
 namespace Data
 {
+	Mesh::Mesh(const std::filesystem::path& p_filepath)
+		: Mesh(MeshFile::get_or_build(p_filepath, Config::Cache_Directory / "Models"), p_filepath)
+	{}
+	Mesh::Mesh(const MeshFile& p_mesh_file, const std::filesystem::path& p_filepath)
+		: VAO{}
+		, vert_buffer{{OpenGL::BufferStorageFlag::DynamicStorageBit}, p_mesh_file.vertex_data(), p_mesh_file.vertex_data_size()}
+		, index_buffer{OpenGL::Buffer{{OpenGL::BufferStorageFlag::DynamicStorageBit}, p_mesh_file.index_data(), p_mesh_file.index_data_size()}}
+		, collision_hull{p_mesh_file.hull_vertices}
+		, AABB{p_mesh_file.min, p_mesh_file.max}
+		, has_alpha{false}
+		, filepath{p_filepath}
+		, LODs{p_mesh_file.LODs}
+		, quantised{true}
+		, triangles{}
+		, triangle_BVH{}
+	{
+		ASSERT_THROW(p_mesh_file.vertex_count > 0, "Vertex data is empty");
+		ASSERT_THROW(p_mesh_file.index_count > 0, "Index data is empty");
+
+		constexpr GLint vertex_buffer_binding_point = 0;
+		// Positions and colours are fetched as unsigned normalised [0, 1], normals as signed normalised octahedral coordinates
+		// decoded in the vertex shader. UVs are half floats, keeping tiling UVs outside [0, 1] intact.
+		VAO.set_vertex_attrib_pointers(OpenGL::PrimitiveMode::Triangles, {
+			{0, 3, OpenGL::BufferDataType::UnsignedShort, offsetof(QuantisedVertex, position), vertex_buffer_binding_point, true},
+			{1, 2, OpenGL::BufferDataType::Short,         offsetof(QuantisedVertex, normal),   vertex_buffer_binding_point, true},
+			{2, 4, OpenGL::BufferDataType::UnsignedByte,  offsetof(QuantisedVertex, colour),   vertex_buffer_binding_point, true},
+			{3, 2, OpenGL::BufferDataType::HalfFloat,     offsetof(QuantisedVertex, uv),       vertex_buffer_binding_point, false}
+		});
+		VAO.attach_buffer(vert_buffer, 0, 0, sizeof(QuantisedVertex), (GLsizei)p_mesh_file.vertex_count);
+		VAO.attach_element_buffer(index_buffer.value(), (GLsizei)LODs.front().index_count);
+
+		{ // Dequantise LOD 0 for ray casts.
+			const auto* vertices  = reinterpret_cast<const QuantisedVertex*>(p_mesh_file.vertex_data());
+			const auto* indices   = reinterpret_cast<const unsigned int*>(p_mesh_file.index_data());
+			const glm::vec3 scale = Quantise::position_scale(AABB.m_min, AABB.m_max) / 65535.f;
+			const auto position   = [&](unsigned int p_index)
+			{
+				const auto& quantised_position = vertices[p_index].position;
+				return AABB.m_min + glm::vec3(quantised_position[0], quantised_position[1], quantised_position[2]) * scale;
+			};
+
+			const MeshLOD& LOD = LODs.front();
+			triangles.reserve(LOD.index_count / 3);
+			for (size_t i = LOD.first_index; i + 2 < LOD.first_index + LOD.index_count; i += 3)
+				triangles.emplace_back(position(indices[i]), position(indices[i + 1]), position(indices[i + 2]));
+			build_triangle_BVH();
+		}
+	}
+
+	size_t Mesh::select_LOD(float p_screen_size, float p_max_pixel_error) const
+	{
+		size_t LOD = 0;
+		while (LOD + 1 < LODs.size() && LODs[LOD + 1].error * p_screen_size <= p_max_pixel_error)
+			LOD++;
+		return LOD;
+	}
+	glm::mat4 Mesh::dequantise_matrix() const
+	{
+		if (!quantised)
+			return glm::identity<glm::mat4>();
+
+		return glm::scale(glm::translate(glm::identity<glm::mat4>(), AABB.m_min), Quantise::position_scale(AABB.m_min, AABB.m_max));
+	}
+
+	std::optional<float> Mesh::cast_ray(const Geometry::Ray& p_ray, float p_max_distance) const
+	{
+		const auto hit = triangle_BVH.cast_ray(p_ray, [&](uint32_t p_triangle, float p_closest) -> std::optional<float>
+		{
+			const auto intersection = Geometry::get_intersection(Geometry::Line(p_ray.m_start, p_ray.m_start + p_ray.m_direction), triangles[p_triangle]);
+			if (!intersection)
+				return std::nullopt;
+
+			// The intersection is with a line, discard hits behind the start of the ray.
+			const float distance = glm::dot(*intersection - p_ray.m_start, p_ray.m_direction) / glm::dot(p_ray.m_direction, p_ray.m_direction);
+			return distance >= 0.f && distance <= p_closest ? std::optional<float>(distance) : std::nullopt;
+		}, p_max_distance);
+
+		return hit ? std::optional<float>(hit->distance) : std::nullopt;
+	}
+	void Mesh::build_triangle_BVH()
+	{
+		std::vector<Geometry::AABB> bounds;
+		bounds.reserve(triangles.size());
+		for (const auto& triangle : triangles)
+			bounds.push_back(Geometry::AABB(glm::min(glm::min(triangle.m_point_1, triangle.m_point_2), triangle.m_point_3), glm::max(glm::max(triangle.m_point_1, triangle.m_point_2), triangle.m_point_3)));
+		triangle_BVH = Geometry::BVH(bounds);
+	}
+
 	void Mesh::draw_UI()
 	{
 		auto formated_verts = Utility::number_with_seperator(VAO.draw_count());
@@ -31,12 +124,34 @@ namespace Data
 
 		ImGui::SameLine();
 		ImGui::Text(VAO.is_indexed() ? " (Indexed)" : " (Not Indexed)");
+		if (quantised)
+		{
+			ImGui::SameLine();
+			ImGui::Text(" (Quantised)");
+		}
 
 		auto formatted_capacity      = Utility::format_number(vert_buffer.capacity());
 		auto formatted_used_capacity = Utility::format_number(vert_buffer.used_capacity());
 		ImGui::Text_Manual("Buffer size %sB", formatted_capacity.c_str());
 		ImGui::Text_Manual("Buffer used %sB (%.2f%%)", formatted_used_capacity.c_str(), vert_buffer.used_capacity_ratio() * 100.f);
 
+		if (!filepath.empty())
+			ImGui::Text_Manual("File:       %s", filepath.filename().string().c_str());
+		if (!collision_hull.empty())
+			ImGui::Text_Manual("Collision hull: %zu vertices, %zu faces", collision_hull.m_vertices.size(), collision_hull.m_faces.size());
+		if (!triangle_BVH.empty())
+			ImGui::Text_Manual("Triangle BVH: %zu nodes", triangle_BVH.m_nodes.size());
+
+		if (LODs.size() > 1 && ImGui::TreeNode("LODs"))
+		{
+			for (size_t i = 0; i < LODs.size(); i++)
+			{
+				auto formated_count = Utility::number_with_seperator(LODs[i].index_count);
+				ImGui::Text_Manual("LOD %zu: %s indices, error %.4f", i, formated_count.c_str(), LODs[i].error);
+			}
+			ImGui::TreePop();
+		}
+
 		AABB.draw_UI("Bounds");
 	}
 }
@@ -52,7 +167,10 @@ namespace Component
 		if (ImGui::TreeNode("Mesh"))
 		{
 			if (m_mesh)
+			{
+				ImGui::Text_Manual("LOD:        %zu / %zu", m_LOD, m_mesh->LODs.size() - 1);
 				m_mesh->draw_UI();
+			}
 			else
 				ImGui::Text("Mesh is null");
 
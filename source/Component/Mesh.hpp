@@ -1,16 +1,36 @@
 #pragma once
 
+#include "Data/MeshFile.hpp"
 #include "Data/Vertex.hpp"
 #include "Geometry/AABB.hpp"
+#include "Geometry/BVH.hpp"
+#include "Geometry/ConvexHull.hpp"
+#include "Geometry/Ray.hpp"
+#include "Geometry/Triangle.hpp"
 #include "OpenGL/Types.hpp"
 #include "Utility/ResourceManager.hpp"
 
+#include "glm/mat4x4.hpp"
+
 #include <algorithm>
+#include <filesystem>
+#include <limits>
 #include <optional>
 #include <vector>
 
 namespace Data
 {
+	// CPU side properties of a mesh gathered while its vertices are generated, see Utility::MeshBuilder::get_descriptor.
+	// Handed to Data::Mesh with the vertex data so constructing a mesh never reads the vertices back.
+	struct MeshDescriptor
+	{
+		Geometry::AABB AABB;                  // Object-space bounds of the vertex positions.
+		Geometry::ConvexHull collision_hull;  // Convex hull of the vertex positions for collision detection. Empty if the mesh isn't built for collision.
+		bool has_alpha = false;               // If any vertex colour is transparent.
+		bool ray_cast  = false;               // Keep the triangles of LOD 0 and build a BVH over them for Mesh::cast_ray. Transient and debug meshes skip the cost.
+		std::vector<MeshLOD> LODs;            // Empty for a single LOD drawing the whole mesh.
+	};
+
 	class Mesh
 	{
 		OpenGL::VAO VAO;
@@ -18,19 +38,30 @@ namespace Data
 		std::optional<OpenGL::Buffer> index_buffer; // EBO for indexed rendering.
 
 	public:
-		std::vector<glm::vec3> vertex_positions; // Unique vertex positions for collision detection.
-		Geometry::AABB AABB;                     // Object-space AABB for broad-phase collision detection.
-		bool has_alpha;                          // If the mesh has any alpha values in its colour data.
-
+		Geometry::ConvexHull collision_hull; // Convex hull of the vertex positions for collision detection. Shared by every entity using the mesh.
+		Geometry::AABB AABB;                 // Object-space AABB for broad-phase collision detection.
+		bool has_alpha;                      // If the mesh has any alpha values in its colour data.
+		std::filesystem::path filepath;      // Model file the mesh was imported from. Empty for meshes built at runtime.
+		std::vector<MeshLOD> LODs;           // Ranges of the index buffer (vertex buffer if not indexed) drawing the mesh at decreasing detail. LOD 0 is the full mesh.
+		bool quantised;                      // If the vertex buffer is in the Data::QuantisedVertex layout. Positions are then relative to AABB, see dequantise_matrix.
+		std::vector<Geometry::Triangle> triangles; // Object-space triangles of LOD 0. Empty if the mesh isn't drawn as triangles or wasn't built for ray casts.
+		Geometry::BVH triangle_BVH;                // Over triangles, for ray casts against the surface of the mesh.
+
+		//@param p_descriptor Properties of vertex_data, see Utility::MeshBuilder::get_descriptor. LODs are ignored for non-indexed meshes.
 		template <typename VertexType>
 		requires Data::is_valid_mesh_vert<VertexType>
-		Mesh(const std::vector<VertexType>& vertex_data, OpenGL::PrimitiveMode primitive_mode)
+		Mesh(const std::vector<VertexType>& vertex_data, OpenGL::PrimitiveMode primitive_mode, MeshDescriptor p_descriptor)
 			: VAO{}
 			, vert_buffer{{OpenGL::BufferStorageFlag::DynamicStorageBit}, vertex_data}
 			, index_buffer{}
-			, vertex_positions{}// }
-			, AABB{}            // |> TODO: these out of the MeshBuilder directly.
-			, has_alpha{false}  // }
+			, collision_hull{std::move(p_descriptor.collision_hull)}
+			, AABB{p_descriptor.AABB}
+			, has_alpha{p_descriptor.has_alpha}
+			, filepath{}
+			, LODs{{0, static_cast<uint32_t>(vertex_data.size()), 0.f}}
+			, quantised{false}
+			, triangles{}
+			, triangle_BVH{}
 		{
 			static_assert(has_position_member<VertexType>, "VertexType must have a position member");
 			ASSERT_THROW(!vertex_data.empty(), "Vertex data is empty");
@@ -45,8 +76,6 @@ namespace Data
 					{2, 4, OpenGL::BufferDataType::Float, offsetof(VertexType, colour),   vertex_buffer_binding_point, false},
 					{3, 2, OpenGL::BufferDataType::Float, offsetof(VertexType, uv),       vertex_buffer_binding_point, false}
 				});
-
-				has_alpha = std::find_if(vertex_data.begin(), vertex_data.end(), [](const auto& vertex) { return vertex.colour.a < 1.0f; }) != vertex_data.end();
 			}
 			else if constexpr (std::is_same_v<VertexType, Data::ColourVertex>)
 			{
@@ -54,8 +83,6 @@ namespace Data
 					{0, 3, OpenGL::BufferDataType::Float, offsetof(VertexType, position), vertex_buffer_binding_point, false},
 					{2, 4, OpenGL::BufferDataType::Float, offsetof(VertexType, colour),   vertex_buffer_binding_point, false}
 				});
-
-				has_alpha = std::find_if(vertex_data.begin(), vertex_data.end(), [](const auto& vertex) { return vertex.colour.a < 1.0f; }) != vertex_data.end();
 			}
 			else if constexpr (std::is_same_v<VertexType, Data::TextureVertex>)
 			{
@@ -75,18 +102,30 @@ namespace Data
 
 			VAO.attach_buffer(vert_buffer, 0, 0, sizeof(VertexType), (GLsizei)vertex_data.size());
 
-			for (const auto& vertex : vertex_data)
-				AABB.unite(vertex.position);
+			if (p_descriptor.ray_cast && primitive_mode == OpenGL::PrimitiveMode::Triangles)
+			{
+				triangles.reserve(vertex_data.size() / 3);
+				for (size_t i = 0; i + 2 < vertex_data.size(); i += 3)
+					triangles.emplace_back(vertex_data[i].position, vertex_data[i + 1].position, vertex_data[i + 2].position);
+				build_triangle_BVH();
+			}
 		}
 
+		//@param p_descriptor Properties of vertex_data, see Utility::MeshBuilder::get_descriptor. If it has no LODs, all the indices form LOD 0.
 		template <typename VertexType>
 		requires Data::is_valid_mesh_vert<VertexType>
-		Mesh(std::vector<VertexType>&& vertex_data, std::vector<unsigned int> indices, OpenGL::PrimitiveMode primitive_mode)
+		Mesh(std::vector<VertexType>&& vertex_data, std::vector<unsigned int> indices, OpenGL::PrimitiveMode primitive_mode, MeshDescriptor p_descriptor)
 			: VAO{}
 			, vert_buffer{{OpenGL::BufferStorageFlag::DynamicStorageBit}, vertex_data}
 			, index_buffer{OpenGL::Buffer{{OpenGL::BufferStorageFlag::DynamicStorageBit}, indices}}
-			, vertex_positions{}// TODO: Feed vertex_positions out of the MeshBuilder directly.
-			, AABB{} // TODO: Feed AABB out of the MeshBuilder directly.
+			, collision_hull{std::move(p_descriptor.collision_hull)}
+			, AABB{p_descriptor.AABB}
+			, has_alpha{p_descriptor.has_alpha}
+			, filepath{}
+			, LODs{p_descriptor.LODs.empty() ? std::vector<MeshLOD>{{0, static_cast<uint32_t>(indices.size()), 0.f}} : std::move(p_descriptor.LODs)}
+			, quantised{false}
+			, triangles{}
+			, triangle_BVH{}
 		{
 			ASSERT_THROW(!vertex_data.empty(), "Vertex data is empty");
 			ASSERT_THROW(!indices.empty(), "Index data is empty");
@@ -126,12 +165,25 @@ namespace Data
 				[]<bool flag = false>() { static_assert(flag, "Unsupported Vertex type"); }(); // #CPP23 P2593R0 swap for static_assert(false)
 
 			VAO.attach_buffer(vert_buffer, 0, 0, sizeof(VertexType), (GLsizei)vertex_data.size());
-			VAO.attach_element_buffer(index_buffer.value(), (GLsizei)indices.size());
+			VAO.attach_element_buffer(index_buffer.value(), (GLsizei)LODs.front().index_count);
 
-			for (const auto& vertex : vertex_data)
-				AABB.unite(vertex.position);
+			if (p_descriptor.ray_cast && primitive_mode == OpenGL::PrimitiveMode::Triangles)
+			{
+				const MeshLOD& LOD = LODs.front();
+				triangles.reserve(LOD.index_count / 3);
+				for (size_t i = LOD.first_index; i + 2 < LOD.first_index + LOD.index_count; i += 3)
+					triangles.emplace_back(vertex_data[indices[i]].position, vertex_data[indices[i + 1]].position, vertex_data[indices[i + 2]].position);
+				build_triangle_BVH();
+			}
 		}
 
+		// Import the model file at p_filepath. The processed version is loaded from the model cache, parsing the model only if it changed.
+		Mesh(const std::filesystem::path& p_filepath);
+		// Construct an indexed triangle mesh from a processed model file. The vertex and index blobs are uploaded to the GPU as-is.
+		//@param p_mesh_file The processed model, see Data::MeshFile::get_or_build.
+		//@param p_filepath The source model file p_mesh_file was built from.
+		Mesh(const MeshFile& p_mesh_file, const std::filesystem::path& p_filepath);
+
 		Mesh(const Mesh&)            = delete;
 		Mesh& operator=(const Mesh&) = delete;
 		Mesh(Mesh&&)                 = default;
@@ -139,7 +191,20 @@ namespace Data
 
 		const OpenGL::VAO& get_VAO() const { return VAO; }
 		bool empty()                 const { return VAO.draw_count() > 0; }
+		// Pick the coarsest LOD whose simplification error stays below p_max_pixel_error when the mesh covers p_screen_size pixels.
+		//@param p_screen_size Projected size on screen in pixels of the longest side of the mesh AABB.
+		//@param p_max_pixel_error How far in pixels the simplified surface may deviate from the full detail mesh.
+		size_t select_LOD(float p_screen_size, float p_max_pixel_error = 1.f) const;
+		// Transform from the positions stored in the vertex buffer to object space. Identity unless the mesh is quantised.
+		// Shaders reading the position attribute directly apply this before the model matrix.
+		glm::mat4 dequantise_matrix() const;
+		// Distance along p_ray to the first triangle it hits, nullopt if it misses or the mesh has no triangles, see MeshDescriptor::ray_cast.
+		//@param p_ray Ray in the object space of the mesh.
+		std::optional<float> cast_ray(const Geometry::Ray& p_ray, float p_max_distance = std::numeric_limits<float>::infinity()) const;
 		void draw_UI();
+
+	private:
+		void build_triangle_BVH();
 	};
 }
 
@@ -158,6 +223,7 @@ namespace Component
 		constexpr static size_t Persistent_ID = 1;
 
 		MeshRef m_mesh;
+		size_t m_LOD = 0; // Index into m_mesh LODs to draw. Picked every frame by the renderer from the size of the mesh on screen.
 
 		Mesh(MeshRef& p_mesh);
 		Mesh()                       = default;
@@ -1,7 +1,9 @@
 #include "Terrain.hpp"
 
+#include "Data/Quantise.hpp"
 #include "System/AssetManager.hpp"
 #include "Utility/MeshBuilder.hpp"
+#include "Utility/MeshOptimiser.hpp"
 #include "Utility/Performance.hpp"
 #include "Utility/Stopwatch.hpp"
 #include "Utility/Utility.hpp"
@@ -14,11 +16,12 @@
 
 namespace Component
 {
-	using VertexType = Data::Vertex;
+	using VertexType       = Data::Vertex;        // Full precision layout the chunks are generated and smoothed in.
+	using BufferVertexType = Data::TerrainVertex; // Compact layout the chunks are uploaded in, see Data::Quantise::to_terrain_vertex.
 
 	size_t Terrain::chunk_vert_buff_stride() const
 	{
-		return (chunk_detail + 1) * (chunk_detail + 1) * sizeof(VertexType); // Verts per chunk * size of each vert
+		return (chunk_detail + 1) * (chunk_detail + 1) * sizeof(BufferVertexType); // Verts per chunk * size of each vert
 	}
 	size_t Terrain::chunk_index_buff_stride() const
 	{
@@ -188,9 +191,26 @@ namespace Component
 			}
 		}
 
-		// Normalize the vertex normals
+		{
+			PERF(OptimiseIndices);
+			// Every chunk shares the same grid topology so the vertex cache optimised order only has to be found once per chunk_detail.
+			if (optimised_chunk_detail != chunk_detail || optimised_chunk_indices.empty())
+			{
+				optimised_chunk_indices = Utility::MeshOptimiser::optimise_vertex_cache(new_indices, new_verts.size());
+				optimised_chunk_detail  = chunk_detail;
+			}
+
+			new_indices = optimised_chunk_indices;
+		}
+
+		// Normalize the vertex normals and pack them into the buffer layout.
+		std::vector<BufferVertexType> buffer_verts;
+		buffer_verts.reserve(new_verts.size());
 		for (auto& vert : new_verts)
+		{
 			vert.normal = glm::normalize(vert.normal);
+			buffer_verts.push_back(Data::Quantise::to_terrain_vertex(vert));
+		}
 
 		{ // Push the new verts to their offset in the buffer
 			PERF(SetVertBuffer);
@@ -206,7 +226,7 @@ namespace Component
  				LOG("[TERRAIN] Resizing terrain buffer from {}B to {}B", current_cap, new_cap_formatted);
 				vert_buffer.reserve(new_capacity);
 			}
-			vert_buffer.set_data(new_verts, chunk_offset);
+			vert_buffer.set_data(buffer_verts, chunk_offset);
 		}
 
 		{ // Push the new indices to the offset in the buffer
@@ -231,7 +251,7 @@ namespace Component
 			index_buffer.set_data(new_indices, chunk_offset);
 		}
 
-		VAO.attach_buffer(vert_buffer, 0, 0, sizeof(VertexType), (GLsizei)(vert_buffer.used_capacity() / sizeof(VertexType)));
+		VAO.attach_buffer(vert_buffer, 0, 0, sizeof(BufferVertexType), (GLsizei)(vert_buffer.used_capacity() / sizeof(BufferVertexType)));
 		VAO.attach_element_buffer(index_buffer, (GLsizei)(index_buffer.used_capacity() / sizeof(unsigned int)));
 
 		// const size_t chunk_stride = chunk_vert_buff_stride();
@@ -243,6 +263,8 @@ namespace Component
 		: VAO{}
 		, vert_buffer{{OpenGL::BufferStorageFlag::DynamicStorageBit}}
 		, index_buffer{{OpenGL::BufferStorageFlag::DynamicStorageBit}}
+		, optimised_chunk_indices{}
+		, optimised_chunk_detail{0}
 		, node_mesh_info{}
 		, root_bounds{}
 		, max_depth{6}
@@ -259,10 +281,9 @@ namespace Component
 	{
 		constexpr GLint vertex_buffer_binding_point = 0;
 		VAO.set_vertex_attrib_pointers(OpenGL::PrimitiveMode::Triangles, {
-			{0, 3, OpenGL::BufferDataType::Float, offsetof(VertexType, position), vertex_buffer_binding_point, false},
-			{1, 3, OpenGL::BufferDataType::Float, offsetof(VertexType, normal),   vertex_buffer_binding_point, false},
-			{3, 2, OpenGL::BufferDataType::Float, offsetof(VertexType, uv),       vertex_buffer_binding_point, false},
-			{2, 4, OpenGL::BufferDataType::Float, offsetof(VertexType, colour),   vertex_buffer_binding_point, false}
+			{0, 3, OpenGL::BufferDataType::Float,     offsetof(BufferVertexType, position), vertex_buffer_binding_point, false},
+			{1, 2, OpenGL::BufferDataType::Short,     offsetof(BufferVertexType, normal),   vertex_buffer_binding_point, true},
+			{3, 2, OpenGL::BufferDataType::HalfFloat, offsetof(BufferVertexType, uv),       vertex_buffer_binding_point, false}
 		});
 
 		noise_params.height = height;
@@ -271,6 +292,8 @@ namespace Component
 		: VAO{}
 		, vert_buffer{p_other.vert_buffer}
 		, index_buffer{p_other.index_buffer}
+		, optimised_chunk_indices{p_other.optimised_chunk_indices}
+		, optimised_chunk_detail{p_other.optimised_chunk_detail}
 		, node_mesh_info{p_other.node_mesh_info}
 		, root_bounds{p_other.root_bounds}
 		, max_depth{p_other.max_depth}
@@ -287,12 +310,11 @@ namespace Component
 	{
 		constexpr GLint vertex_buffer_binding_point = 0;
 		VAO.set_vertex_attrib_pointers(OpenGL::PrimitiveMode::Triangles, {
-			{0, 3, OpenGL::BufferDataType::Float, offsetof(VertexType, position), vertex_buffer_binding_point, false},
-			{1, 3, OpenGL::BufferDataType::Float, offsetof(VertexType, normal),   vertex_buffer_binding_point, false},
-			{3, 2, OpenGL::BufferDataType::Float, offsetof(VertexType, uv),       vertex_buffer_binding_point, false},
-			{2, 4, OpenGL::BufferDataType::Float, offsetof(VertexType, colour),   vertex_buffer_binding_point, false}
+			{0, 3, OpenGL::BufferDataType::Float,     offsetof(BufferVertexType, position), vertex_buffer_binding_point, false},
+			{1, 2, OpenGL::BufferDataType::Short,     offsetof(BufferVertexType, normal),   vertex_buffer_binding_point, true},
+			{3, 2, OpenGL::BufferDataType::HalfFloat, offsetof(BufferVertexType, uv),       vertex_buffer_binding_point, false}
 		});
-		VAO.attach_buffer(vert_buffer, 0, 0, sizeof(VertexType), (GLsizei)(vert_buffer.used_capacity() / sizeof(VertexType)));
+		VAO.attach_buffer(vert_buffer, 0, 0, sizeof(BufferVertexType), (GLsizei)(vert_buffer.used_capacity() / sizeof(BufferVertexType)));
 		VAO.attach_element_buffer(index_buffer, (GLsizei)(index_buffer.used_capacity() / sizeof(unsigned int)));
 	}
 	Terrain& Terrain::operator=(const Terrain& p_other)
@@ -548,7 +570,7 @@ namespace Component
 
 			ImGui::Text("Max depth", max_depth);
 			ImGui::Text("Per node detail", (int)chunk_detail);
-			ImGui::Text("Vert count ", Utility::format_number(vert_buffer.used_capacity() / sizeof(VertexType), 1));
+			ImGui::Text("Vert count ", Utility::format_number(vert_buffer.used_capacity() / sizeof(BufferVertexType), 1));
 			ImGui::Text("Index count", Utility::format_number(index_buffer.used_capacity() / sizeof(unsigned int), 1));
 			ImGui::Text("Vert buffer size", Utility::format_number(vert_buffer.used_capacity(), 1) + "B");
 			ImGui::Text("Index buffer size", Utility::format_number(index_buffer.used_capacity(), 1) + "B");
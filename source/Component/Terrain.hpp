@@ -24,6 +24,9 @@ namespace Component
 		OpenGL::VAO VAO;
 		OpenGL::Buffer vert_buffer;
 		OpenGL::Buffer index_buffer;
+		// Vertex cache optimised index order of one chunk, every chunk shares the same grid topology. Only valid for optimised_chunk_detail.
+		std::vector<unsigned int> optimised_chunk_indices;
+		uint16_t optimised_chunk_detail;
 
 		size_t chunk_vert_buff_stride() const;
 		size_t chunk_index_buff_stride() const;
@@ -1,47 +1,58 @@
 #include "Texture.hpp"
 #include "System/AssetManager.hpp"
 
+#include "Data/CompressedTexture.hpp"
+
 #include "Utility/Logger.hpp"
+#include "Utility/Config.hpp"
 #include "Utility/File.hpp"
 
 #include "imgui.h"
 
 namespace Data
 {
-	OpenGL::TextureFormat format_from_channels(const uint8_t p_channels)
+	static OpenGL::TextureInternalFormat internal_format(const BlockFormat p_format)
 	{
-		switch (p_channels)
+		switch (p_format)
 		{
-			case 1: return OpenGL::TextureFormat::R;
-			case 2: return OpenGL::TextureFormat::RG;
-			case 3: return OpenGL::TextureFormat::RGB;
-			case 4: return OpenGL::TextureFormat::RGBA;
-			default: throw std::runtime_error("Invalid number of channels for texture format.");
+			case BlockFormat::BC1: return OpenGL::TextureInternalFormat::BC1_RGB;
+			case BlockFormat::BC3: return OpenGL::TextureInternalFormat::BC3_RGBA;
+			case BlockFormat::BC4: return OpenGL::TextureInternalFormat::BC4_R;
+			case BlockFormat::BC5: return OpenGL::TextureInternalFormat::BC5_RG;
+			case BlockFormat::BC7: return OpenGL::TextureInternalFormat::BC7_RGBA;
+			default: throw std::runtime_error("Invalid block format for texture internal format.");
 		}
 	}
-	OpenGL::TextureInternalFormat internal_format_from_channels(const uint8_t p_channels)
+
+	// Create the GPU texture for p_compressed uploading every level's blocks as-is.
+	static OpenGL::Texture make_GL_texture(const CompressedTexture& p_compressed)
 	{
-		switch (p_channels)
+		const auto& base     = p_compressed.levels.front();
+		const auto gl_format  = internal_format(p_compressed.format);
+
+		OpenGL::Texture texture{glm::uvec2(base.width, base.height),
+		                        OpenGL::InterpolationFilter::Linear,
+		                        OpenGL::WrappingMode::Repeat,
+		                        gl_format,
+		                        static_cast<GLsizei>(p_compressed.levels.size())};
+
+		for (size_t level = 0; level < p_compressed.levels.size(); level++)
 		{
-			case 1: return OpenGL::TextureInternalFormat::R8;
-			case 2: return OpenGL::TextureInternalFormat::RG8;
-			case 3: return OpenGL::TextureInternalFormat::RGB8;
-			case 4: return OpenGL::TextureInternalFormat::RGBA8;
-			default: throw std::runtime_error("Invalid number of channels for texture internal format.");
+			const auto& mip = p_compressed.levels[level];
+			texture.upload_compressed_level(static_cast<GLint>(level), glm::uvec2(mip.width, mip.height), gl_format, static_cast<GLsizei>(mip.size), p_compressed.level_data(level));
 		}
+
+		return texture;
 	}
 
-	Texture::Texture(const std::filesystem::path& p_filepath) noexcept
+	Texture::Texture(const std::filesystem::path& p_filepath, TextureUsage p_usage)
+		: Texture(p_filepath, p_usage, CompressedTexture::get_or_build(p_filepath, p_usage, Config::Cache_Directory / "Textures"))
+	{}
+	Texture::Texture(const std::filesystem::path& p_filepath, TextureUsage p_usage, const CompressedTexture& p_compressed)
 		: m_filepath{p_filepath}
-		, m_image{p_filepath}
-		, m_GL_texture{ resolution(),
-		                OpenGL::InterpolationFilter::Linear,
-		                OpenGL::WrappingMode::Repeat,
-		                internal_format_from_channels(m_image.number_of_channels),
-		                format_from_channels(m_image.number_of_channels),
-		                OpenGL::TextureDataType::UNSIGNED_BYTE,
-		                true,
-		                m_image.data }
+		, m_usage{p_usage}
+		, m_resolution{p_compressed.levels.front().width, p_compressed.levels.front().height}
+		, m_GL_texture{make_GL_texture(p_compressed)}
 	{}
 } // namespace Data
 
@@ -71,7 +82,7 @@ namespace Component
 		if (ImGui::TreeNode("Texture"))
 		{
 			p_asset_manager.draw_texture_selector("Diffuse", m_diffuse);
-			p_asset_manager.draw_texture_selector("Specular", m_specular);
+			p_asset_manager.draw_texture_selector("Specular", m_specular, Data::TextureUsage::Data);
 
 			ImGui::Slider("Shininess", m_shininess, 1.f, 512.f, "%.1f");
 			ImGui::ColorEdit4("Colour", &m_colour[0]);
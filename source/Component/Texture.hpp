@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Data/Image.hpp"
+#include "Data/CompressedTexture.hpp"
 #include "OpenGL/Types.hpp"
 #include "Utility/File.hpp"
 #include "Utility/ResourceManager.hpp"
@@ -14,30 +14,36 @@
 namespace Data
 {
 	// Texture represents an image file on disk and its associated GPU handle.
-	// On construction a Texture is loaded into memory and onto the GPU ready for rendering.
+	// On construction the block compressed version of the image is loaded from the texture cache (processing the image if
+	// required) and uploaded to the GPU with its full mip chain ready for rendering. The decoded pixels are not kept in memory.
 	class Texture
 	{
 		std::filesystem::path m_filepath;
-		Data::Image m_image;
+		TextureUsage m_usage;
+		glm::uvec2 m_resolution;
+
+		Texture(const std::filesystem::path& p_filepath, TextureUsage p_usage, const CompressedTexture& p_compressed);
 
 	public:
 		OpenGL::Texture m_GL_texture;
 
-		Texture(const std::filesystem::path& p_filePath) noexcept;
+		// Throws if p_filePath doesn't exist or can't be decoded.
+		//@param p_usage What the texels represent in the slot the texture is loaded for, see TextureUsage.
+		Texture(const std::filesystem::path& p_filePath, TextureUsage p_usage);
 		~Texture()                                     = default;
 		Texture(Texture&& p_other) noexcept            = default;
 		Texture& operator=(Texture&& p_other) noexcept = default;
 		Texture(const Texture& p_other)                = delete;
 		Texture& operator=(const Texture& p_other)     = delete;
 
-		// Raw access to the image pixel data. Access for read only.
-		std::byte* data() const { return m_image.data; }
 		// Return a display-friendly name for this image.
 		std::string name() const { return m_filepath.stem().string(); };
 		// Return the resolution of the image in pixels.
-		glm::uvec2 resolution() const { return {m_image.width, m_image.height}; }
+		glm::uvec2 resolution() const { return m_resolution; }
 		// Return the filepath of the image.
 		const std::filesystem::path& filepath() const { return m_filepath; }
+		// Return the usage the image was processed for.
+		TextureUsage usage() const { return m_usage; }
 	};
 }
 
@@ -27,6 +27,8 @@ namespace Component
 		glm::vec3 m_scale;          // Scale in each axis.
 		glm::quat m_orientation;    // Unit quaternion taking the Starting_Forward_Direction to the current forward direction.
 
+		bool operator==(const Transform& p_other) const = default;
+
 		// Rotate the object to roll pitch and yaw euler angles in the order XYZ. Angles suppled are in degrees.
 		void rotate_euler_degrees(const glm::vec3& p_roll_pitch_yaw_degrees);
 		// Focus the orientation/forward to p_point.
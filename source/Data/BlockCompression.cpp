@@ -0,0 +1,350 @@
+#include "BlockCompression.hpp"
+
+#include "Utility/Logger.hpp"
+#include "Utility/Parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+// Block layouts follow the Khronos Data Format Specification (S3TC, RGTC and BPTC sections).
+// Endpoints are chosen with a principal component range fit, then every texel picks its nearest palette entry.
+// This is a fast single-pass encoder, not an exhaustive search, trading a small amount of quality for build time.
+namespace Data::BlockCompression
+{
+	using RGBA  = std::array<uint8_t, 4>;
+	using Block = std::array<RGBA, 16>; // Texels of a 4x4 block in row-major order.
+
+	// Principal axis of the block's texels over the first p_dimensions channels by power iteration of the covariance matrix.
+	// Returns the endpoints along that axis, i.e. the extreme projections of the texels, as floats.
+	template <int Dimensions>
+	static std::pair<std::array<float, 4>, std::array<float, 4>> range_fit(const Block& p_block)
+	{
+		std::array<float, 4> mean = {0.f, 0.f, 0.f, 0.f};
+		for (const auto& texel : p_block)
+			for (int c = 0; c < Dimensions; c++)
+				mean[c] += static_cast<float>(texel[c]) / 16.f;
+
+		float covariance[4][4] = {};
+		for (const auto& texel : p_block)
+			for (int i = 0; i < Dimensions; i++)
+				for (int j = 0; j < Dimensions; j++)
+					covariance[i][j] += (static_cast<float>(texel[i]) - mean[i]) * (static_cast<float>(texel[j]) - mean[j]);
+
+		std::array<float, 4> axis = {1.f, 1.f, 1.f, 1.f};
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			std::array<float, 4> next = {0.f, 0.f, 0.f, 0.f};
+			for (int i = 0; i < Dimensions; i++)
+				for (int j = 0; j < Dimensions; j++)
+					next[i] += covariance[i][j] * axis[j];
+
+			float length = 0.f;
+			for (int c = 0; c < Dimensions; c++)
+				length = std::max(length, std::abs(next[c]));
+
+			if (length < 1e-6f) // Every texel is identical (or nearly), any axis works.
+				break;
+
+			for (int c = 0; c < Dimensions; c++)
+				axis[c] = next[c] / length;
+		}
+
+		float min_projection = std::numeric_limits<float>::max();
+		float max_projection = std::numeric_limits<float>::lowest();
+		for (const auto& texel : p_block)
+		{
+			float projection = 0.f;
+			for (int c = 0; c < Dimensions; c++)
+				projection += (static_cast<float>(texel[c]) - mean[c]) * axis[c];
+
+			min_projection = std::min(min_projection, projection);
+			max_projection = std::max(max_projection, projection);
+		}
+
+		float length_squared = 0.f;
+		for (int c = 0; c < Dimensions; c++)
+			length_squared += axis[c] * axis[c];
+
+		std::array<float, 4> start = mean;
+		std::array<float, 4> end   = mean;
+		for (int c = 0; c < Dimensions; c++)
+		{
+			start[c] = std::clamp(mean[c] + axis[c] * min_projection / length_squared, 0.f, 255.f);
+			end[c]   = std::clamp(mean[c] + axis[c] * max_projection / length_squared, 0.f, 255.f);
+		}
+		return {start, end};
+	}
+
+	template <int Dimensions, size_t Palette_Size>
+	static uint8_t nearest_index(const RGBA& p_texel, const std::array<RGBA, Palette_Size>& p_palette)
+	{
+		uint8_t best_index = 0;
+		int best_error     = std::numeric_limits<int>::max();
+		for (size_t i = 0; i < Palette_Size; i++)
+		{
+			int error = 0;
+			for (int c = 0; c < Dimensions; c++)
+			{
+				const int difference = static_cast<int>(p_texel[c]) - static_cast<int>(p_palette[i][c]);
+				error += difference * difference;
+			}
+			if (error < best_error)
+			{
+				best_error = error;
+				best_index = static_cast<uint8_t>(i);
+			}
+		}
+		return best_index;
+	}
+
+//==============================================================================================================================
+// BC1 - 2 RGB565 endpoints + 16 2-bit indices
+//==============================================================================================================================
+	static uint16_t to_565(const std::array<float, 4>& p_colour)
+	{
+		const auto r = static_cast<uint16_t>(std::lround(p_colour[0] * 31.f / 255.f));
+		const auto g = static_cast<uint16_t>(std::lround(p_colour[1] * 63.f / 255.f));
+		const auto b = static_cast<uint16_t>(std::lround(p_colour[2] * 31.f / 255.f));
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+	static RGBA from_565(uint16_t p_colour)
+	{
+		const int r = (p_colour >> 11) & 31;
+		const int g = (p_colour >> 5) & 63;
+		const int b = p_colour & 31;
+		return {static_cast<uint8_t>((r << 3) | (r >> 2)), static_cast<uint8_t>((g << 2) | (g >> 4)), static_cast<uint8_t>((b << 3) | (b >> 2)), 255};
+	}
+	static void encode_BC1(const Block& p_block, std::byte* p_output)
+	{
+		auto [start, end] = range_fit<3>(p_block);
+		uint16_t colour_0 = to_565(end);
+		uint16_t colour_1 = to_565(start);
+
+		uint32_t indices = 0;
+		if (colour_0 != colour_1)
+		{
+			// colour_0 > colour_1 selects the opaque 4 colour palette.
+			if (colour_0 < colour_1)
+				std::swap(colour_0, colour_1);
+
+			const RGBA c0 = from_565(colour_0);
+			const RGBA c1 = from_565(colour_1);
+			std::array<RGBA, 4> palette = {c0, c1, RGBA{}, RGBA{}};
+			for (int c = 0; c < 3; c++)
+			{
+				palette[2][c] = static_cast<uint8_t>((2 * c0[c] + c1[c] + 1) / 3);
+				palette[3][c] = static_cast<uint8_t>((c0[c] + 2 * c1[c] + 1) / 3);
+			}
+
+			for (int i = 0; i < 16; i++)
+				indices |= static_cast<uint32_t>(nearest_index<3>(p_block[i], palette)) << (i * 2);
+		}
+
+		std::memcpy(p_output,     &colour_0, sizeof(colour_0));
+		std::memcpy(p_output + 2, &colour_1, sizeof(colour_1));
+		std::memcpy(p_output + 4, &indices,  sizeof(indices));
+	}
+
+//==============================================================================================================================
+// BC4 - 2 8-bit endpoints + 16 3-bit indices for a single channel. BC3 alpha and both halves of BC5 use this block.
+//==============================================================================================================================
+	static void encode_BC4(const Block& p_block, int p_channel, std::byte* p_output)
+	{
+		uint8_t min = 255;
+		uint8_t max = 0;
+		for (const auto& texel : p_block)
+		{
+			min = std::min(min, texel[p_channel]);
+			max = std::max(max, texel[p_channel]);
+		}
+
+		uint64_t indices = 0;
+		if (min != max)
+		{
+			// endpoint_0 > endpoint_1 selects the 8 value palette: e0, e1 then 6 values interpolated from e0 towards e1.
+			std::array<int, 8> palette = {max, min, 0, 0, 0, 0, 0, 0};
+			for (int i = 1; i < 7; i++)
+				palette[i + 1] = ((7 - i) * max + i * min + 3) / 7;
+
+			for (int i = 0; i < 16; i++)
+			{
+				const int value = p_block[i][p_channel];
+				uint64_t best   = 0;
+				for (uint64_t p = 1; p < palette.size(); p++)
+					if (std::abs(value - palette[p]) < std::abs(value - palette[best]))
+						best = p;
+
+				indices |= best << (i * 3);
+			}
+		}
+
+		p_output[0] = std::byte{max};
+		p_output[1] = std::byte{min};
+		for (int i = 0; i < 6; i++)
+			p_output[2 + i] = std::byte{static_cast<uint8_t>(indices >> (i * 8))};
+	}
+
+//==============================================================================================================================
+// BC7 - Mode 6 only: 1 subset, RGBA 7-bit endpoints with a unique p-bit each, 4-bit indices.
+//==============================================================================================================================
+	static void encode_BC7(const Block& p_block, std::byte* p_output)
+	{
+		constexpr std::array<int, 16> weights = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+		auto [start, end] = range_fit<4>(p_block);
+
+		// Quantise each endpoint to 7 bits per channel plus a shared p-bit (the LSB), picking the p-bit with the least error.
+		auto quantise = [](const std::array<float, 4>& p_endpoint, uint8_t& p_bit)
+		{
+			std::array<uint8_t, 4> best_quantised = {};
+			float best_error = std::numeric_limits<float>::max();
+			for (uint8_t p = 0; p < 2; p++)
+			{
+				std::array<uint8_t, 4> quantised;
+				float error = 0.f;
+				for (int c = 0; c < 4; c++)
+				{
+					quantised[c] = static_cast<uint8_t>(std::clamp(static_cast<int>(std::lround((p_endpoint[c] - p) / 2.f)), 0, 127));
+					const float difference = static_cast<float>(quantised[c] * 2 + p) - p_endpoint[c];
+					error += difference * difference;
+				}
+				if (error < best_error)
+				{
+					best_error     = error;
+					best_quantised = quantised;
+					p_bit          = p;
+				}
+			}
+			return best_quantised;
+		};
+
+		std::array<uint8_t, 2> p_bits = {0, 0};
+		std::array<std::array<uint8_t, 4>, 2> endpoints = {quantise(start, p_bits[0]), quantise(end, p_bits[1])};
+
+		auto build_palette = [&]()
+		{
+			std::array<RGBA, 16> palette;
+			for (int i = 0; i < 16; i++)
+				for (int c = 0; c < 4; c++)
+				{
+					const int e0 = endpoints[0][c] * 2 + p_bits[0];
+					const int e1 = endpoints[1][c] * 2 + p_bits[1];
+					palette[i][c] = static_cast<uint8_t>(((64 - weights[i]) * e0 + weights[i] * e1 + 32) >> 6);
+				}
+			return palette;
+		};
+		const auto palette = build_palette();
+
+		std::array<uint8_t, 16> indices;
+		for (int i = 0; i < 16; i++)
+			indices[i] = nearest_index<4>(p_block[i], palette);
+
+		// The anchor (texel 0) index is stored with an implicit 0 MSB. Swap the endpoints and invert the indices to satisfy it.
+		if (indices[0] & 0x8)
+		{
+			std::swap(endpoints[0], endpoints[1]);
+			std::swap(p_bits[0], p_bits[1]);
+			for (auto& index : indices)
+				index = static_cast<uint8_t>(15 - index);
+		}
+
+		// Pack LSB first: mode (7 bits), R0 R1 G0 G1 B0 B1 A0 A1 (7 bits each), P0, P1, anchor index (3 bits), 15 indices (4 bits).
+		uint64_t low     = 0;
+		uint64_t high    = 0;
+		int bit_position = 0;
+		auto write_bits  = [&](uint64_t p_value, int p_bit_count)
+		{
+			for (int i = 0; i < p_bit_count; i++, bit_position++)
+			{
+				const uint64_t bit = (p_value >> i) & 1;
+				if (bit_position < 64) low  |= bit << bit_position;
+				else                   high |= bit << (bit_position - 64);
+			}
+		};
+
+		write_bits(1 << 6, 7);
+		for (int c = 0; c < 4; c++)
+		{
+			write_bits(endpoints[0][c], 7);
+			write_bits(endpoints[1][c], 7);
+		}
+		write_bits(p_bits[0], 1);
+		write_bits(p_bits[1], 1);
+		write_bits(indices[0], 3);
+		for (int i = 1; i < 16; i++)
+			write_bits(indices[i], 4);
+
+		std::memcpy(p_output,     &low,  sizeof(low));
+		std::memcpy(p_output + 8, &high, sizeof(high));
+	}
+
+	size_t block_size(BlockFormat p_format)
+	{
+		switch (p_format)
+		{
+			case BlockFormat::BC1: return 8;
+			case BlockFormat::BC3: return 16;
+			case BlockFormat::BC4: return 8;
+			case BlockFormat::BC5: return 16;
+			case BlockFormat::BC7: return 16;
+			default: throw std::runtime_error("Unknown BlockFormat");
+		}
+	}
+	size_t compressed_size(BlockFormat p_format, int p_width, int p_height)
+	{
+		return static_cast<size_t>((p_width + 3) / 4) * static_cast<size_t>((p_height + 3) / 4) * block_size(p_format);
+	}
+
+	std::vector<std::byte> compress(const std::byte* p_pixels, int p_width, int p_height, uint8_t p_channels, BlockFormat p_format)
+	{
+		ASSERT_THROW(p_pixels != nullptr && p_width > 0 && p_height > 0, "[BLOCK COMPRESSION] Invalid source image {}x{}.", p_width, p_height);
+		ASSERT_THROW(p_channels >= 1 && p_channels <= 4, "[BLOCK COMPRESSION] Unsupported channel count {}.", p_channels);
+
+		const int blocks_x       = (p_width + 3) / 4;
+		const int blocks_y       = (p_height + 3) / 4;
+		const size_t bytes_block = block_size(p_format);
+		std::vector<std::byte> output(compressed_size(p_format, p_width, p_height));
+
+		Utility::parallel_for(static_cast<size_t>(blocks_y), 4, [&](size_t p_begin, size_t p_end)
+		{
+			for (int block_y = static_cast<int>(p_begin); block_y < static_cast<int>(p_end); block_y++)
+			{
+				for (int block_x = 0; block_x < blocks_x; block_x++)
+				{
+					// Gather the block, replicating edge texels for blocks overhanging the image.
+					Block block;
+					for (int y = 0; y < 4; y++)
+					{
+						for (int x = 0; x < 4; x++)
+						{
+							const int source_x = std::min(block_x * 4 + x, p_width - 1);
+							const int source_y = std::min(block_y * 4 + y, p_height - 1);
+							const auto* texel = reinterpret_cast<const uint8_t*>(p_pixels) + (static_cast<size_t>(source_y) * p_width + source_x) * p_channels;
+
+							RGBA& out = block[y * 4 + x];
+							out = {texel[0], 0, 0, 255};
+							for (uint8_t c = 1; c < p_channels; c++)
+								out[c] = texel[c];
+						}
+					}
+
+					std::byte* destination = output.data() + (static_cast<size_t>(block_y) * blocks_x + block_x) * bytes_block;
+					switch (p_format)
+					{
+						case BlockFormat::BC1: encode_BC1(block, destination); break;
+						case BlockFormat::BC3: encode_BC4(block, 3, destination); encode_BC1(block, destination + 8); break;
+						case BlockFormat::BC4: encode_BC4(block, 0, destination); break;
+						case BlockFormat::BC5: encode_BC4(block, 0, destination); encode_BC4(block, 1, destination + 8); break;
+						case BlockFormat::BC7: encode_BC7(block, destination); break;
+					}
+				}
+			}
+		});
+
+		return output;
+	}
+} // namespace Data::BlockCompression
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Data
+{
+	// GPU block compressed texture formats. Every format encodes 4x4 texel blocks into a fixed number of bytes.
+	enum class BlockFormat : uint8_t
+	{
+		BC1, // RGB, 8 bytes per block (4 bpp). Colour maps without alpha.
+		BC3, // RGBA, 16 bytes per block (8 bpp). BC1 colour + BC4 alpha.
+		BC4, // R, 8 bytes per block (4 bpp). Single channel data maps (height, roughness, AO).
+		BC5, // RG, 16 bytes per block (8 bpp). Two BC4 channels, used for tangent-space normal maps (z reconstructed in shader).
+		BC7  // RGBA, 16 bytes per block (8 bpp). High quality colour with or without alpha.
+	};
+
+	namespace BlockCompression
+	{
+		// Number of bytes a 4x4 block occupies in p_format.
+		size_t block_size(BlockFormat p_format);
+		// Number of bytes required to store a p_width x p_height image in p_format. Partial blocks at the edges are padded to whole blocks.
+		size_t compressed_size(BlockFormat p_format, int p_width, int p_height);
+
+		// Encode a tightly packed 8-bit image into p_format blocks. Rows of blocks are encoded in parallel on worker threads.
+		// Missing channels are read as 0 for green and blue and 255 for alpha.
+		//@param p_pixels Tightly packed 8-bit pixel data with p_channels channels per pixel.
+		//@return The blocks in row-major order, compressed_size(p_format, p_width, p_height) bytes.
+		std::vector<std::byte> compress(const std::byte* p_pixels, int p_width, int p_height, uint8_t p_channels, BlockFormat p_format);
+	}
+} // namespace Data
\ No newline at end of file
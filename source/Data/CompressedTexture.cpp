@@ -0,0 +1,182 @@
+#include "CompressedTexture.hpp"
+#include "Image.hpp"
+#include "MipChain.hpp"
+
+#include "Utility/Logger.hpp"
+#include "Utility/Serialise.hpp"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+
+namespace Data
+{
+	constexpr uint32_t Compressed_Texture_Magic   = 0x58455453; // 'STEX' little-endian.
+	constexpr uint16_t Compressed_Texture_Version = 1;          // Increment when the file layout or encoders change to rebuild old caches.
+
+	static std::string_view usage_suffix(TextureUsage p_usage)
+	{
+		switch (p_usage)
+		{
+			case TextureUsage::Colour: return "colour";
+			case TextureUsage::Data:   return "data";
+			case TextureUsage::Normal: return "normal";
+			default: throw std::runtime_error("Invalid texture usage.");
+		}
+	}
+
+	BlockFormat CompressedTexture::choose_format(TextureUsage p_usage, const std::byte* p_pixels, int p_width, int p_height, uint8_t p_channels)
+	{
+		if (p_usage == TextureUsage::Normal || p_channels == 2)
+			return BlockFormat::BC5;
+		if (p_channels == 1)
+			return BlockFormat::BC4;
+		if (p_channels == 3)
+			return BlockFormat::BC1;
+
+		// 4 channel images with no transparency don't need the alpha channel, BC1 is half the size of BC7.
+		const size_t texel_count = static_cast<size_t>(p_width) * p_height;
+		for (size_t i = 0; i < texel_count; i++)
+			if (p_pixels[i * 4 + 3] != std::byte{255})
+				return BlockFormat::BC7;
+
+		return BlockFormat::BC1;
+	}
+
+	CompressedTexture CompressedTexture::build(const std::filesystem::path& p_source_path, TextureUsage p_usage)
+	{
+		const Image image{p_source_path};
+		const auto format    = choose_format(p_usage, image.data, image.width, image.height, image.number_of_channels);
+		const auto mip_chain = MipChain::build(image, MipFilter::Kaiser, p_usage == TextureUsage::Colour);
+
+		CompressedTexture texture;
+		texture.format = format;
+		texture.levels.reserve(mip_chain.levels.size());
+
+		size_t total_size = 0;
+		for (const auto& level : mip_chain.levels)
+			total_size += BlockCompression::compressed_size(format, level.width, level.height);
+		texture.data.reserve(total_size);
+
+		for (const auto& level : mip_chain.levels)
+		{
+			const auto blocks = BlockCompression::compress(level.pixels.data(), level.width, level.height, mip_chain.number_of_channels, format);
+			texture.levels.push_back(Level{level.width, level.height, texture.data.size(), blocks.size()});
+			texture.data.insert(texture.data.end(), blocks.begin(), blocks.end());
+		}
+
+		return texture;
+	}
+
+	CompressedTexture CompressedTexture::get_or_build(const std::filesystem::path& p_source_path, TextureUsage p_usage, const std::filesystem::path& p_cache_directory)
+	{
+		ASSERT_THROW(std::filesystem::exists(p_source_path), "Texture file {} does not exist.", p_source_path.string());
+
+		const auto write_time  = static_cast<int64_t>(std::filesystem::last_write_time(p_source_path).time_since_epoch().count());
+		const auto source_size = std::filesystem::file_size(p_source_path);
+		const auto path_hash   = std::hash<std::string>{}(std::filesystem::absolute(p_source_path).lexically_normal().string());
+		const auto cache_path  = p_cache_directory / std::format("{}_{}_{:016x}.tex", p_source_path.stem().string(), usage_suffix(p_usage), path_hash);
+
+		if (auto cached = load(cache_path, write_time, source_size))
+			return std::move(*cached);
+
+		auto texture = build(p_source_path, p_usage);
+		texture.save(cache_path, write_time, source_size);
+		return texture;
+	}
+
+	std::optional<CompressedTexture> CompressedTexture::load(const std::filesystem::path& p_cache_path, int64_t p_source_write_time, uintmax_t p_source_size)
+	{
+		if (!std::filesystem::exists(p_cache_path))
+			return std::nullopt;
+
+		CompressedTexture texture;
+		{ // Read the whole file in one go, the levels are then referenced in place.
+			std::ifstream in(p_cache_path, std::ios::binary);
+			if (!in)
+				return std::nullopt;
+
+			texture.data.resize(std::filesystem::file_size(p_cache_path));
+			if (!in.read(reinterpret_cast<char*>(texture.data.data()), static_cast<std::streamsize>(texture.data.size())))
+				return std::nullopt;
+		}
+
+		size_t position = 0;
+		auto read = [&texture, &position](auto& p_value)
+		{
+			if (position + sizeof(p_value) > texture.data.size())
+				return false;
+
+			std::memcpy(&p_value, texture.data.data() + position, sizeof(p_value));
+			position += sizeof(p_value);
+			return true;
+		};
+
+		uint32_t magic          = 0;
+		uint16_t version        = 0;
+		uint8_t format          = 0;
+		uint8_t level_count     = 0;
+		int64_t source_time     = 0;
+		uint64_t source_size    = 0;
+		if (!read(magic) || !read(version) || !read(format) || !read(level_count) || !read(source_time) || !read(source_size))
+			return std::nullopt;
+		if (magic != Compressed_Texture_Magic || version != Compressed_Texture_Version || format > static_cast<uint8_t>(BlockFormat::BC7))
+			return std::nullopt;
+		if (source_time != p_source_write_time || source_size != p_source_size)
+			return std::nullopt; // Source image changed since the cache was written.
+
+		texture.format = static_cast<BlockFormat>(format);
+		texture.levels.resize(level_count);
+		for (auto& level : texture.levels)
+		{
+			int32_t width   = 0;
+			int32_t height  = 0;
+			uint64_t offset = 0;
+			uint64_t size   = 0;
+			if (!read(width) || !read(height) || !read(offset) || !read(size))
+				return std::nullopt;
+			if (offset + size > texture.data.size() || size != BlockCompression::compressed_size(texture.format, width, height))
+				return std::nullopt;
+
+			level = Level{width, height, static_cast<size_t>(offset), static_cast<size_t>(size)};
+		}
+
+		return texture;
+	}
+
+	void CompressedTexture::save(const std::filesystem::path& p_cache_path, int64_t p_source_write_time, uintmax_t p_source_size) const
+	{
+		constexpr size_t header_size = sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t) * 2 + sizeof(int64_t) + sizeof(uint64_t);
+		constexpr size_t level_size  = sizeof(int32_t) * 2 + sizeof(uint64_t) * 2;
+		const size_t blocks_offset   = header_size + level_size * levels.size();
+
+		try
+		{
+			std::filesystem::create_directories(p_cache_path.parent_path());
+			std::ofstream out(p_cache_path, std::ios::binary | std::ios::trunc);
+			out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+
+			Utility::write_binary(out, Compressed_Texture_Version, Compressed_Texture_Magic);
+			Utility::write_binary(out, Compressed_Texture_Version, Compressed_Texture_Version);
+			Utility::write_binary(out, Compressed_Texture_Version, static_cast<uint8_t>(format));
+			Utility::write_binary(out, Compressed_Texture_Version, static_cast<uint8_t>(levels.size()));
+			Utility::write_binary(out, Compressed_Texture_Version, p_source_write_time);
+			Utility::write_binary(out, Compressed_Texture_Version, static_cast<uint64_t>(p_source_size));
+			for (const auto& level : levels)
+			{
+				Utility::write_binary(out, Compressed_Texture_Version, static_cast<int32_t>(level.width));
+				Utility::write_binary(out, Compressed_Texture_Version, static_cast<int32_t>(level.height));
+				Utility::write_binary(out, Compressed_Texture_Version, static_cast<uint64_t>(blocks_offset + level.offset));
+				Utility::write_binary(out, Compressed_Texture_Version, static_cast<uint64_t>(level.size));
+			}
+			out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR(false, "[COMPRESSED TEXTURE] Failed to write cache file '{}'. {}", p_cache_path.string(), e.what());
+		}
+	}
+} // namespace Data
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "BlockCompression.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace Data
+{
+	// What the texels of a texture represent, given by the slot the texture is used in. Decides the block format and how mips are filtered.
+	enum class TextureUsage : uint8_t
+	{
+		Colour, // sRGB encoded colour (diffuse, albedo, particles). Mips are filtered in linear light.
+		Data,   // Linear values (specular, roughness, masks, height). Mips are filtered as stored.
+		Normal  // Tangent-space normal map. Compressed to BC5 (z reconstructed in shader) and filtered as stored.
+	};
+
+	// A block compressed texture with its complete mip chain, as stored in the processed texture cache.
+	// A cache file is a small header followed by the blocks of every level, the whole file is loaded with a single read
+	// and the levels are uploaded straight from the loaded buffer.
+	struct CompressedTexture
+	{
+		struct Level
+		{
+			int width     = 0;
+			int height    = 0;
+			size_t offset = 0; // Byte offset of the level's blocks into data.
+			size_t size   = 0; // Size in bytes of the level's blocks.
+		};
+
+		BlockFormat format = BlockFormat::BC1;
+		std::vector<Level> levels;
+		std::vector<std::byte> data; // Blocks of every level. When loaded from a cache file this also holds the header.
+
+		const std::byte* level_data(size_t p_level) const { return data.data() + levels[p_level].offset; }
+
+		// Load the processed version of the image file at p_source_path from p_cache_directory.
+		// If no cache file exists or the source changed since it was written (by write time or file size), the texture is built and the cache rewritten.
+		// Each p_usage of a source image is processed and cached separately.
+		// Throws if p_source_path does not exist.
+		static CompressedTexture get_or_build(const std::filesystem::path& p_source_path, TextureUsage p_usage, const std::filesystem::path& p_cache_directory);
+		// Decode, generate mips for and block compress the image file at p_source_path.
+		static CompressedTexture build(const std::filesystem::path& p_source_path, TextureUsage p_usage);
+		// The block format used for an image based on its usage and contents.
+		// Normal maps and two channel images are compressed to BC5, single channel to BC4, opaque images to BC1 and images with alpha to BC7.
+		static BlockFormat choose_format(TextureUsage p_usage, const std::byte* p_pixels, int p_width, int p_height, uint8_t p_channels);
+
+	private:
+		static std::optional<CompressedTexture> load(const std::filesystem::path& p_cache_path, int64_t p_source_write_time, uintmax_t p_source_size);
+		void save(const std::filesystem::path& p_cache_path, int64_t p_source_write_time, uintmax_t p_source_size) const;
+	};
+} // namespace Data
\ No newline at end of file
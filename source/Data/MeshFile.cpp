@@ -0,0 +1,150 @@
+#include "MeshFile.hpp"
+#include "OBJ.hpp"
+#include "Quantise.hpp"
+
+#include "Geometry/ConvexHull.hpp"
+
+#include "Utility/Logger.hpp"
+#include "Utility/MeshOptimiser.hpp"
+#include "Utility/MeshSimplifier.hpp"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <type_traits>
+
+namespace Data
+{
+	constexpr uint32_t Mesh_File_Magic   = 0x48534D53; // 'SMSH' little-endian.
+	constexpr uint16_t Mesh_File_Version = 4;          // Increment when the file layout or Data::QuantisedVertex changes to rebuild old caches.
+
+	// Fixed size header at the start of every cache file. Padded so the vertex blob that follows is suitably aligned.
+	struct MeshFileHeader
+	{
+		uint32_t magic;
+		uint16_t version;
+		uint16_t vertex_size; // sizeof(Data::QuantisedVertex) at the time of writing.
+		int64_t source_write_time;
+		uint64_t source_size;
+		uint64_t vertex_count;
+		uint64_t index_count;
+		float min[3];
+		float max[3];
+		uint32_t LOD_count;
+		uint32_t hull_vertex_count;
+		uint32_t padding[2];
+	};
+	static_assert(sizeof(MeshFileHeader) == MeshFile::Header_Size, "MeshFileHeader must match MeshFile::Header_Size.");
+	static_assert(std::is_trivially_copyable_v<QuantisedVertex>, "Vertex data is written to the cache as raw bytes.");
+	static_assert(std::is_trivially_copyable_v<MeshLOD>, "LOD table is written to the cache as raw bytes.");
+	static_assert(sizeof(glm::vec3) == sizeof(float) * 3, "Hull vertices are written to the cache as raw bytes.");
+
+	MeshFile MeshFile::from_model(const OBJ::Model& p_model, const std::vector<MeshLOD>& p_LODs, int64_t p_source_write_time, uintmax_t p_source_size)
+	{
+		MeshFile mesh_file;
+		mesh_file.vertex_count = p_model.vertices.size();
+		mesh_file.index_count  = p_model.indices.size();
+		mesh_file.min          = p_model.min;
+		mesh_file.max          = p_model.max;
+		mesh_file.LODs         = p_LODs.empty() ? std::vector<MeshLOD>{{0, static_cast<uint32_t>(p_model.indices.size()), 0.f}} : p_LODs;
+
+		{ // Hull the full precision positions, quantising first would move the hull by up to half a quantisation step.
+			std::vector<glm::vec3> positions;
+			positions.reserve(p_model.vertices.size());
+			for (const auto& vertex : p_model.vertices)
+				positions.push_back(vertex.position);
+			mesh_file.hull_vertices = Geometry::ConvexHull(positions).m_vertices;
+		}
+
+		const size_t LOD_table_size = mesh_file.LODs.size() * sizeof(MeshLOD);
+		const size_t hull_data_size = mesh_file.hull_vertices.size() * sizeof(glm::vec3);
+		mesh_file.data.resize(Header_Size + mesh_file.vertex_data_size() + mesh_file.index_data_size() + LOD_table_size + hull_data_size);
+
+		const auto quantised_vertices = Quantise::quantise(p_model.vertices, p_model.min, p_model.max);
+		const MeshFileHeader header{Mesh_File_Magic, Mesh_File_Version, static_cast<uint16_t>(sizeof(QuantisedVertex)), p_source_write_time, static_cast<uint64_t>(p_source_size),
+		                            mesh_file.vertex_count, mesh_file.index_count,
+		                            {p_model.min.x, p_model.min.y, p_model.min.z}, {p_model.max.x, p_model.max.y, p_model.max.z},
+		                            static_cast<uint32_t>(mesh_file.LODs.size()), static_cast<uint32_t>(mesh_file.hull_vertices.size()), {}};
+		std::memcpy(mesh_file.data.data(), &header, sizeof(header));
+		std::memcpy(mesh_file.data.data() + Header_Size, quantised_vertices.data(), mesh_file.vertex_data_size());
+		std::memcpy(mesh_file.data.data() + Header_Size + mesh_file.vertex_data_size(), p_model.indices.data(), mesh_file.index_data_size());
+		std::memcpy(mesh_file.data.data() + Header_Size + mesh_file.vertex_data_size() + mesh_file.index_data_size(), mesh_file.LODs.data(), LOD_table_size);
+		std::memcpy(mesh_file.data.data() + Header_Size + mesh_file.vertex_data_size() + mesh_file.index_data_size() + LOD_table_size, mesh_file.hull_vertices.data(), hull_data_size);
+		return mesh_file;
+	}
+
+	MeshFile MeshFile::get_or_build(const std::filesystem::path& p_source_path, const std::filesystem::path& p_cache_directory)
+	{
+		const auto write_time  = static_cast<int64_t>(std::filesystem::last_write_time(p_source_path).time_since_epoch().count());
+		const auto source_size = std::filesystem::file_size(p_source_path);
+		const auto path_hash   = std::hash<std::string>{}(std::filesystem::absolute(p_source_path).lexically_normal().string());
+		const auto cache_path  = p_cache_directory / std::format("{}_{:016x}.mesh", p_source_path.stem().string(), path_hash);
+
+		if (auto cached = load(cache_path, write_time, source_size))
+			return std::move(*cached);
+
+		auto model = OBJ::parse(p_source_path);
+		Utility::MeshOptimiser::optimise(model.vertices, model.indices);
+		const auto LODs = Utility::MeshSimplifier::build_LODs(model.vertices, model.indices);
+
+		auto mesh_file = from_model(model, LODs, write_time, source_size);
+		mesh_file.save(cache_path);
+		return mesh_file;
+	}
+
+	std::optional<MeshFile> MeshFile::load(const std::filesystem::path& p_cache_path, int64_t p_source_write_time, uintmax_t p_source_size)
+	{
+		if (!std::filesystem::exists(p_cache_path))
+			return std::nullopt;
+
+		MeshFile mesh_file;
+		{ // Read the whole file in one go, the vertex and index blobs are then uploaded in place.
+			std::ifstream in(p_cache_path, std::ios::binary);
+			if (!in)
+				return std::nullopt;
+
+			mesh_file.data.resize(std::filesystem::file_size(p_cache_path));
+			if (mesh_file.data.size() < Header_Size || !in.read(reinterpret_cast<char*>(mesh_file.data.data()), static_cast<std::streamsize>(mesh_file.data.size())))
+				return std::nullopt;
+		}
+
+		MeshFileHeader header;
+		std::memcpy(&header, mesh_file.data.data(), sizeof(header));
+		if (header.magic != Mesh_File_Magic || header.version != Mesh_File_Version || header.vertex_size != sizeof(QuantisedVertex))
+			return std::nullopt;
+		if (header.source_write_time != p_source_write_time || header.source_size != p_source_size)
+			return std::nullopt; // Source model changed since the cache was written.
+
+		mesh_file.vertex_count = static_cast<size_t>(header.vertex_count);
+		mesh_file.index_count  = static_cast<size_t>(header.index_count);
+		mesh_file.min          = glm::vec3{header.min[0], header.min[1], header.min[2]};
+		mesh_file.max          = glm::vec3{header.max[0], header.max[1], header.max[2]};
+		const size_t LOD_table_size = header.LOD_count * sizeof(MeshLOD);
+		const size_t hull_data_size = header.hull_vertex_count * sizeof(glm::vec3);
+		if (header.LOD_count == 0 || mesh_file.data.size() != Header_Size + mesh_file.vertex_data_size() + mesh_file.index_data_size() + LOD_table_size + hull_data_size)
+			return std::nullopt;
+
+		mesh_file.LODs.resize(header.LOD_count);
+		std::memcpy(mesh_file.LODs.data(), mesh_file.index_data() + mesh_file.index_data_size(), LOD_table_size);
+		mesh_file.hull_vertices.resize(header.hull_vertex_count);
+		std::memcpy(mesh_file.hull_vertices.data(), mesh_file.index_data() + mesh_file.index_data_size() + LOD_table_size, hull_data_size);
+
+		return mesh_file;
+	}
+
+	void MeshFile::save(const std::filesystem::path& p_cache_path) const
+	{
+		try
+		{
+			std::filesystem::create_directories(p_cache_path.parent_path());
+			std::ofstream out(p_cache_path, std::ios::binary | std::ios::trunc);
+			out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+			out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR(false, "[MESH FILE] Failed to write cache file '{}'. {}", p_cache_path.string(), e.what());
+		}
+	}
+} // namespace Data
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Vertex.hpp"
+
+#include "glm/vec3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace Data
+{
+	namespace OBJ { struct Model; }
+
+	// A range of a mesh's index buffer drawing it at one level of detail.
+	struct MeshLOD
+	{
+		uint32_t first_index = 0; // Offset into the index buffer in indices.
+		uint32_t index_count = 0;
+		float error          = 0.f; // Largest distance the simplified surface deviates from the full detail mesh, relative to the longest side of the mesh AABB.
+	};
+
+	// An indexed triangle mesh in the Data::QuantisedVertex layout as stored in the processed model cache.
+	// A cache file is a fixed size header followed by the vertex, index, LOD and collision hull blobs. The file is loaded with a single read and
+	// the blobs are uploaded to the GPU as-is, so importing a model only parses and simplifies the source file when it changes.
+	struct MeshFile
+	{
+		constexpr static size_t Header_Size = 80;
+
+		std::vector<std::byte> data; // Header followed by vertex_count QuantisedVertex, index_count unsigned int, the LOD table and the hull vertices.
+		size_t vertex_count = 0;
+		size_t index_count  = 0; // Indices of all the LODs, which are stored back to back.
+		glm::vec3 min       = glm::vec3{0.f}; // Object-space bounds of the vertex positions. Quantised positions are relative to these.
+		glm::vec3 max       = glm::vec3{0.f};
+		std::vector<MeshLOD> LODs; // Index ranges of every level of detail, LOD 0 is the full detail mesh.
+		std::vector<glm::vec3> hull_vertices; // Full precision vertices of the convex hull of the vertex positions. Saves rebuilding the hull from every vertex on load.
+
+		const std::byte* vertex_data() const { return data.data() + Header_Size; }
+		const std::byte* index_data()  const { return vertex_data() + vertex_data_size(); }
+		size_t vertex_data_size()      const { return vertex_count * sizeof(QuantisedVertex); }
+		size_t index_data_size()       const { return index_count * sizeof(unsigned int); }
+
+		// Load the processed version of the model file at p_source_path from p_cache_directory.
+		// If no cache file exists or the source changed since it was written (by write time or file size), the model is parsed and the cache rewritten.
+		static MeshFile get_or_build(const std::filesystem::path& p_source_path, const std::filesystem::path& p_cache_directory);
+		// Pack p_model into the cache file layout, quantising its vertices to the bounds of the model and wrapping them in a convex hull.
+		//@param p_LODs Index ranges of p_model.indices for each level of detail. If empty, all the indices form a single LOD.
+		static MeshFile from_model(const OBJ::Model& p_model, const std::vector<MeshLOD>& p_LODs = {}, int64_t p_source_write_time = 0, uintmax_t p_source_size = 0);
+
+	private:
+		static std::optional<MeshFile> load(const std::filesystem::path& p_cache_path, int64_t p_source_write_time, uintmax_t p_source_size);
+		void save(const std::filesystem::path& p_cache_path) const;
+	};
+} // namespace Data
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "MipChain.hpp"
+#include "Image.hpp"
+
+#include "Utility/Logger.hpp"
+#include "Utility/Parallel.hpp"
+#include "Utility/SIMD.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+namespace Data
+{
+	namespace SIMD = Utility::SIMD;
+
+	// Separable 1D downsampling kernel. Destination texel x is the weighted sum of source texels [2x + first_offset, 2x + first_offset + weights.size()).
+	struct Kernel
+	{
+		std::vector<float> weights;
+		int first_offset;
+	};
+
+	// Zeroth order modified Bessel function of the first kind, used by the Kaiser window.
+	static float bessel_I0(float p_x)
+	{
+		float sum  = 1.f;
+		float term = 1.f;
+		for (int k = 1; k < 20; k++)
+		{
+			const float factor = p_x / (2.f * static_cast<float>(k));
+			term *= factor * factor;
+			sum  += term;
+		}
+		return sum;
+	}
+	static Kernel make_kernel(MipFilter p_filter)
+	{
+		switch (p_filter)
+		{
+			case MipFilter::Box: return Kernel{{0.5f, 0.5f}, 0};
+			case MipFilter::Kaiser:
+			{
+				// Sinc low-pass at the destination Nyquist frequency, windowed by Kaiser to a support of 3 destination texels each side.
+				constexpr float alpha = 4.f;
+				constexpr float width = 3.f;
+				constexpr int radius  = 6; // Source texels each side of the destination texel centre.
+
+				Kernel kernel{{}, -radius + 1};
+				float total = 0.f;
+				for (int offset = kernel.first_offset; offset <= radius; offset++)
+				{
+					// Distance in destination texels between source texel centre (offset + 0.5) and destination texel centre (1.0) in source space.
+					const float d      = (static_cast<float>(offset) - 0.5f) / 2.f;
+					const float pi_d   = std::numbers::pi_v<float> * d;
+					const float sinc   = std::abs(pi_d) < 1e-6f ? 1.f : std::sin(pi_d) / pi_d;
+					const float t      = std::min(1.f, std::abs(d) / width);
+					const float window = bessel_I0(alpha * std::sqrt(1.f - t * t)) / bessel_I0(alpha);
+
+					kernel.weights.push_back(sinc * window);
+					total += kernel.weights.back();
+				}
+				for (auto& weight : kernel.weights)
+					weight /= total;
+
+				return kernel;
+			}
+			default: throw std::runtime_error("Unknown MipFilter");
+		}
+	}
+
+	// Lookup tables for 8-bit <-> linear float conversion.
+	struct ConversionTables
+	{
+		std::array<float, 256> sRGB_to_linear;
+		std::array<float, 256> unorm_to_float;
+		std::array<uint8_t, 4096> linear_to_sRGB; // Indexed by linear value * 4095.
+
+		ConversionTables()
+		{
+			for (size_t i = 0; i < sRGB_to_linear.size(); i++)
+			{
+				const float c     = static_cast<float>(i) / 255.f;
+				sRGB_to_linear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				unorm_to_float[i] = c;
+			}
+			for (size_t i = 0; i < linear_to_sRGB.size(); i++)
+			{
+				const float l     = static_cast<float>(i) / static_cast<float>(linear_to_sRGB.size() - 1);
+				const float c     = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.f / 2.4f) - 0.055f;
+				linear_to_sRGB[i] = static_cast<uint8_t>(std::clamp(c * 255.f + 0.5f, 0.f, 255.f));
+			}
+		}
+		static const ConversionTables& get()
+		{
+			static const ConversionTables tables;
+			return tables;
+		}
+	};
+
+	// The level being downsampled. Level 0 is read straight from the 8-bit source, later levels from the linear float level above.
+	// Float levels are always stored as 4 floats per texel so each texel fits a SIMD register.
+	struct SourceLevel
+	{
+		const std::byte* bytes = nullptr;
+		const float* linear    = nullptr;
+		int width              = 0;
+		int height             = 0;
+		uint8_t channels       = 0;
+		std::array<const float*, 4> channel_tables = {nullptr, nullptr, nullptr, nullptr}; // Per-channel byte -> linear tables for the 8-bit source.
+	};
+
+	// p_accumulator[x] += p_weight * source[x, p_row] for every texel of the row.
+	static void accumulate_row(const SourceLevel& p_source, int p_row, float p_weight, float* p_accumulator)
+	{
+		const SIMD::Float4 weight = SIMD::set(p_weight);
+
+		if (p_source.linear)
+		{
+			const float* row = p_source.linear + static_cast<size_t>(p_row) * p_source.width * 4;
+			for (int x = 0; x < p_source.width; x++)
+				SIMD::store(p_accumulator + x * 4, SIMD::mul_add(SIMD::load(row + x * 4), weight, SIMD::load(p_accumulator + x * 4)));
+		}
+		else
+		{
+			const auto& tables     = p_source.channel_tables;
+			const uint8_t channels = p_source.channels;
+			const auto* row        = reinterpret_cast<const uint8_t*>(p_source.bytes) + static_cast<size_t>(p_row) * p_source.width * channels;
+
+			for (int x = 0; x < p_source.width; x++, row += channels)
+			{
+				const SIMD::Float4 texel = SIMD::set(tables[0][row[0]],
+				                                     channels > 1 ? tables[1][row[1]] : 0.f,
+				                                     channels > 2 ? tables[2][row[2]] : 0.f,
+				                                     channels > 3 ? tables[3][row[3]] : 0.f);
+				SIMD::store(p_accumulator + x * 4, SIMD::mul_add(texel, weight, SIMD::load(p_accumulator + x * 4)));
+			}
+		}
+	}
+
+	// Downsample p_source into p_destination (4 floats per texel) with the separable p_kernel.
+	// Each destination row filters the kernel's source rows vertically at full width, then filters that row horizontally.
+	static void downsample(const SourceLevel& p_source, const Kernel& p_kernel, int p_width, int p_height, std::vector<float>& p_destination)
+	{
+		p_destination.resize(static_cast<size_t>(p_width) * p_height * 4);
+
+		Utility::parallel_for(static_cast<size_t>(p_height), 8, [&](size_t p_begin, size_t p_end)
+		{
+			const SIMD::Float4 zero = SIMD::set(0.f);
+			const SIMD::Float4 one  = SIMD::set(1.f);
+			std::vector<float> vertical(static_cast<size_t>(p_source.width) * 4);
+
+			for (int y = static_cast<int>(p_begin); y < static_cast<int>(p_end); y++)
+			{
+				std::fill(vertical.begin(), vertical.end(), 0.f);
+				for (int k = 0; k < static_cast<int>(p_kernel.weights.size()); k++)
+				{
+					const int source_y = std::clamp(y * 2 + p_kernel.first_offset + k, 0, p_source.height - 1);
+					accumulate_row(p_source, source_y, p_kernel.weights[k], vertical.data());
+				}
+
+				float* destination_row = p_destination.data() + static_cast<size_t>(y) * p_width * 4;
+				for (int x = 0; x < p_width; x++)
+				{
+					SIMD::Float4 sum = zero;
+					for (int k = 0; k < static_cast<int>(p_kernel.weights.size()); k++)
+					{
+						const int source_x = std::clamp(x * 2 + p_kernel.first_offset + k, 0, p_source.width - 1);
+						sum = SIMD::mul_add(SIMD::load(vertical.data() + source_x * 4), SIMD::set(p_kernel.weights[k]), sum);
+					}
+					// Clamp the negative lobes of Kaiser so ringing doesn't accumulate down the chain.
+					SIMD::store(destination_row + x * 4, SIMD::clamp(sum, zero, one));
+				}
+			}
+		});
+	}
+
+	// Quantise the linear p_level (4 floats per texel) back to tightly packed 8-bit texels with p_channels channels.
+	static std::vector<std::byte> encode(const std::vector<float>& p_level, int p_width, int p_height, uint8_t p_channels, bool p_sRGB)
+	{
+		const auto& tables = ConversionTables::get();
+		std::vector<std::byte> pixels(static_cast<size_t>(p_width) * p_height * p_channels);
+
+		Utility::parallel_for(static_cast<size_t>(p_height), 32, [&](size_t p_begin, size_t p_end)
+		{
+			for (size_t i = p_begin * p_width; i < p_end * p_width; i++)
+			{
+				for (uint8_t c = 0; c < p_channels; c++)
+				{
+					const float value = p_level[i * 4 + c];
+					pixels[i * p_channels + c] = p_sRGB && c < 3
+						? std::byte{tables.linear_to_sRGB[static_cast<size_t>(value * 4095.f + 0.5f)]}
+						: std::byte{static_cast<uint8_t>(value * 255.f + 0.5f)};
+				}
+			}
+		});
+
+		return pixels;
+	}
+
+	int MipChain::level_count(int p_width, int p_height)
+	{
+		return std::bit_width(static_cast<unsigned int>(std::max(p_width, p_height)));
+	}
+
+	MipChain MipChain::build(const std::byte* p_pixels, int p_width, int p_height, uint8_t p_channels, MipFilter p_filter, bool p_sRGB)
+	{
+		ASSERT_THROW(p_pixels != nullptr && p_width > 0 && p_height > 0, "[MIPCHAIN] Invalid source image {}x{}.", p_width, p_height);
+		ASSERT_THROW(p_channels >= 1 && p_channels <= 4, "[MIPCHAIN] Unsupported channel count {}.", p_channels);
+
+		const auto& tables = ConversionTables::get();
+		const int levels   = level_count(p_width, p_height);
+
+		MipChain chain;
+		chain.number_of_channels = p_channels;
+		chain.levels.reserve(levels);
+		chain.levels.push_back(Level{p_width, p_height, std::vector<std::byte>(p_pixels, p_pixels + static_cast<size_t>(p_width) * p_height * p_channels)});
+
+		SourceLevel source;
+		source.bytes    = p_pixels;
+		source.width    = p_width;
+		source.height   = p_height;
+		source.channels = p_channels;
+		for (uint8_t c = 0; c < 4; c++)
+			source.channel_tables[c] = p_sRGB && c < 3 ? tables.sRGB_to_linear.data() : tables.unorm_to_float.data();
+
+		const Kernel kernel = make_kernel(p_filter);
+		std::vector<float> previous;
+		std::vector<float> current;
+
+		for (int level = 1; level < levels; level++)
+		{
+			const int width  = std::max(1, source.width / 2);
+			const int height = std::max(1, source.height / 2);
+
+			downsample(source, kernel, width, height, current);
+			chain.levels.push_back(Level{width, height, encode(current, width, height, p_channels, p_sRGB)});
+
+			std::swap(previous, current);
+			source.bytes  = nullptr;
+			source.linear = previous.data();
+			source.width  = width;
+			source.height = height;
+		}
+
+		return chain;
+	}
+	MipChain MipChain::build(const Image& p_image, MipFilter p_filter, bool p_sRGB)
+	{
+		return build(p_image.data, p_image.width, p_image.height, p_image.number_of_channels, p_filter, p_sRGB);
+	}
+} // namespace Data
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Data
+{
+	struct Image;
+
+	// Filter used to downsample each mip level from the level above it.
+	enum class MipFilter : uint8_t
+	{
+		Box,   // 2x2 average. Fast, slightly blurry.
+		Kaiser // Kaiser-windowed sinc over a 12 texel footprint. Sharper, preserves detail in distant mips.
+	};
+
+	// A complete chain of downsampled images generated on the CPU, level 0 being the source resolution and the last level 1x1.
+	// Each level is stored tightly packed with the same number of channels as the source, ready for upload or serialising to a cache.
+	struct MipChain
+	{
+		struct Level
+		{
+			int width  = 0;
+			int height = 0;
+			std::vector<std::byte> pixels;
+		};
+
+		std::vector<Level> levels;
+		uint8_t number_of_channels = 0;
+
+		// Build the full mip chain of 8-bit p_pixels. Rows of each level are filtered in parallel on worker threads.
+		//@param p_pixels Tightly packed 8-bit pixel data with p_channels channels per pixel.
+		//@param p_filter The downsampling filter.
+		//@param p_sRGB If true, the colour channels are decoded to linear space before filtering and encoded back after. The 4th channel (alpha) is always linear.
+		static MipChain build(const std::byte* p_pixels, int p_width, int p_height, uint8_t p_channels, MipFilter p_filter = MipFilter::Box, bool p_sRGB = true);
+		static MipChain build(const Image& p_image, MipFilter p_filter = MipFilter::Box, bool p_sRGB = true);
+
+		// Number of levels in a complete chain for an image of p_width x p_height.
+		static int level_count(int p_width, int p_height);
+	};
+} // namespace Data
\ No newline at end of file
@@ -0,0 +1,373 @@
+#include "OBJ.hpp"
+
+#include "Utility/File.hpp"
+#include "Utility/Logger.hpp"
+#include "Utility/Parallel.hpp"
+
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <unordered_map>
+
+namespace Data::OBJ
+{
+	constexpr size_t Min_Chunk_Size = 256 * 1024; // Smallest number of bytes worth parsing on a separate thread.
+
+	// A face corner as read from an OBJ file, -1 for a missing uv or normal.
+	// Negative (relative) OBJ indices can't be resolved until the element counts of the preceding chunks are known.
+	// These are stored relative to the start of the chunk and flagged in relative_mask.
+	struct Corner
+	{
+		std::array<int32_t, 3> index = {-1, -1, -1}; // Position, uv and normal.
+		uint8_t relative_mask        = 0;
+
+		bool operator==(const Corner& p_other) const { return index == p_other.index; }
+	};
+	struct CornerHash
+	{
+		size_t operator()(const Corner& p_corner) const
+		{
+			size_t hash = static_cast<uint32_t>(p_corner.index[0]);
+			hash = hash * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(p_corner.index[1]);
+			hash = hash * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(p_corner.index[2]);
+			return hash;
+		}
+	};
+
+	// The contents of a range of lines of the file.
+	struct Chunk
+	{
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec2> uvs;
+		std::vector<glm::vec3> normals;
+		std::vector<Corner> corners; // 3 per triangle.
+
+		// Output of the indexing pass.
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;          // Chunk-local vertex indices.
+		std::vector<int32_t> vertex_position_index; // Position index of each vertex, used to generate missing normals.
+
+		std::exception_ptr error; // Set if parsing or indexing the chunk threw, rethrown on the calling thread by rethrow_chunk_error.
+	};
+
+	static bool is_space(char p_char) { return p_char == ' ' || p_char == '\t' || p_char == '\r'; }
+	static void skip_space(const char*& p_ptr, const char* p_end)
+	{
+		while (p_ptr < p_end && is_space(*p_ptr))
+			p_ptr++;
+	}
+	static float read_float(const char*& p_ptr, const char* p_end)
+	{
+		skip_space(p_ptr, p_end);
+		if (p_ptr < p_end && *p_ptr == '+')
+			p_ptr++;
+
+		float value = 0.f;
+		const auto result = std::from_chars(p_ptr, p_end, value);
+		if (result.ec != std::errc{})
+			throw std::runtime_error("Invalid number in OBJ file.");
+
+		p_ptr = result.ptr;
+		return value;
+	}
+	// Read a float that the OBJ spec allows to be left out at the end of a line, e.g. the v and w of a vt.
+	static float read_optional_float(const char*& p_ptr, const char* p_end, float p_default)
+	{
+		skip_space(p_ptr, p_end);
+		if (p_ptr >= p_end || *p_ptr == '#')
+			return p_default;
+
+		return read_float(p_ptr, p_end);
+	}
+	// Read a single index of a face corner, converting it from 1-based to 0-based.
+	// Negative indices are relative to p_count, the number of elements read so far in this chunk, and are flagged in p_relative_mask.
+	static int32_t read_index(const char*& p_ptr, const char* p_end, size_t p_count, uint8_t p_element, uint8_t& p_relative_mask)
+	{
+		int32_t value     = 0;
+		const auto result = std::from_chars(p_ptr, p_end, value);
+		if (result.ec != std::errc{} || value == 0)
+			throw std::runtime_error("Invalid face index in OBJ file.");
+
+		p_ptr = result.ptr;
+		if (value > 0)
+			return value - 1;
+
+		p_relative_mask |= uint8_t(1) << p_element;
+		return static_cast<int32_t>(p_count) + value;
+	}
+	static Corner read_corner(const char*& p_ptr, const char* p_end, const Chunk& p_chunk)
+	{
+		// Corners are one of v, v/vt, v//vn or v/vt/vn.
+		Corner corner;
+		corner.index[0] = read_index(p_ptr, p_end, p_chunk.positions.size(), 0, corner.relative_mask);
+		if (p_ptr < p_end && *p_ptr == '/')
+		{
+			p_ptr++;
+			if (p_ptr < p_end && *p_ptr != '/')
+				corner.index[1] = read_index(p_ptr, p_end, p_chunk.uvs.size(), 1, corner.relative_mask);
+			if (p_ptr < p_end && *p_ptr == '/')
+			{
+				p_ptr++;
+				corner.index[2] = read_index(p_ptr, p_end, p_chunk.normals.size(), 2, corner.relative_mask);
+			}
+		}
+		return corner;
+	}
+
+	static void parse_line(const char* p_ptr, const char* p_end, Chunk& p_chunk)
+	{
+		skip_space(p_ptr, p_end);
+		if (p_end - p_ptr < 2)
+			return;
+
+		if (p_ptr[0] == 'v' && is_space(p_ptr[1]))
+		{
+			// v x y z [w], the rational weight w and any trailing vertex colour are ignored.
+			p_ptr += 2;
+			const float x = read_float(p_ptr, p_end);
+			const float y = read_float(p_ptr, p_end);
+			const float z = read_float(p_ptr, p_end);
+			p_chunk.positions.emplace_back(x, y, z);
+		}
+		else if (p_ptr[0] == 'v' && p_ptr[1] == 't')
+		{
+			// vt u [v] [w], the w of 3D texture coordinates is ignored.
+			p_ptr += 2;
+			const float u = read_float(p_ptr, p_end);
+			const float v = read_optional_float(p_ptr, p_end, 0.f);
+			p_chunk.uvs.emplace_back(u, v);
+		}
+		else if (p_ptr[0] == 'v' && p_ptr[1] == 'n')
+		{
+			p_ptr += 2;
+			const float x = read_float(p_ptr, p_end);
+			const float y = read_float(p_ptr, p_end);
+			const float z = read_float(p_ptr, p_end);
+			p_chunk.normals.emplace_back(x, y, z);
+		}
+		else if (p_ptr[0] == 'f' && is_space(p_ptr[1]))
+		{
+			p_ptr += 2;
+			// Fan triangulate polygons around the first corner.
+			Corner first, previous;
+			size_t corner_count = 0;
+			while (true)
+			{
+				skip_space(p_ptr, p_end);
+				if (p_ptr >= p_end || *p_ptr == '#')
+					break;
+
+				const Corner corner = read_corner(p_ptr, p_end, p_chunk);
+				if (corner_count >= 2)
+				{
+					p_chunk.corners.push_back(first);
+					p_chunk.corners.push_back(previous);
+					p_chunk.corners.push_back(corner);
+				}
+				else if (corner_count == 0)
+					first = corner;
+
+				previous = corner;
+				corner_count++;
+			}
+		}
+	}
+
+	static void parse_chunk(const char* p_begin, const char* p_end, Chunk& p_chunk)
+	{
+		// Estimate the element counts from the chunk size to avoid most reallocations. Typical OBJ lines are ~30 bytes.
+		const size_t line_estimate = static_cast<size_t>(p_end - p_begin) / 32;
+		p_chunk.positions.reserve(line_estimate / 2);
+		p_chunk.corners.reserve(line_estimate * 3);
+
+		const char* line_begin = p_begin;
+		while (line_begin < p_end)
+		{
+			const char* line_end = std::find(line_begin, p_end, '\n');
+			parse_line(line_begin, line_end, p_chunk);
+			line_begin = line_end + 1;
+		}
+	}
+
+	// Resolve relative indices and turn the corners of p_chunk into unique vertices and indices into them.
+	static void index_chunk(Chunk& p_chunk, const std::array<size_t, 3>& p_chunk_offsets, const std::array<size_t, 3>& p_totals,
+	                        const std::vector<glm::vec3>& p_positions, const std::vector<glm::vec2>& p_uvs, const std::vector<glm::vec3>& p_normals)
+	{
+		std::unordered_map<Corner, unsigned int, CornerHash> corner_to_vertex;
+		corner_to_vertex.reserve(p_chunk.corners.size() / 2);
+		p_chunk.indices.reserve(p_chunk.corners.size());
+
+		for (auto corner : p_chunk.corners)
+		{
+			for (uint8_t element = 0; element < 3; element++)
+			{
+				if (corner.relative_mask & (uint8_t(1) << element))
+					corner.index[element] += static_cast<int32_t>(p_chunk_offsets[element]);
+				if (corner.index[element] != -1 && (corner.index[element] < 0 || static_cast<size_t>(corner.index[element]) >= p_totals[element]))
+					throw std::runtime_error("OBJ face references a vertex element that does not exist.");
+			}
+			ASSERT_THROW(corner.index[0] != -1, "OBJ face corner is missing a position.");
+
+			const auto [it, inserted] = corner_to_vertex.try_emplace(corner, static_cast<unsigned int>(p_chunk.vertices.size()));
+			if (inserted)
+			{
+				Vertex vertex;
+				vertex.position = p_positions[corner.index[0]];
+				if (corner.index[1] != -1) vertex.uv     = p_uvs[corner.index[1]];
+				if (corner.index[2] != -1) vertex.normal = p_normals[corner.index[2]];
+				p_chunk.vertices.push_back(vertex);
+				p_chunk.vertex_position_index.push_back(corner.index[2] == -1 ? corner.index[0] : -1);
+			}
+			p_chunk.indices.push_back(it->second);
+		}
+	}
+
+	// Rethrow the error of the earliest failed chunk on the calling thread, so the reported error doesn't depend on thread timing.
+	static void rethrow_chunk_error(const std::vector<Chunk>& p_chunks)
+	{
+		for (const auto& chunk : p_chunks)
+		{
+			if (chunk.error)
+				std::rethrow_exception(chunk.error);
+		}
+	}
+
+	Model parse(std::string_view p_source)
+	{
+		// Split the source into line aligned chunks, one per thread.
+		const size_t max_chunks  = std::max(1u, std::thread::hardware_concurrency());
+		const size_t chunk_count = std::clamp(p_source.size() / Min_Chunk_Size, size_t(1), max_chunks);
+
+		std::vector<const char*> boundaries{p_source.data()};
+		for (size_t i = 1; i < chunk_count; i++)
+		{
+			const char* split = std::max(p_source.data() + p_source.size() * i / chunk_count, boundaries.back());
+			split             = std::find(split, p_source.data() + p_source.size(), '\n');
+			boundaries.push_back(split == p_source.data() + p_source.size() ? split : split + 1);
+		}
+		boundaries.push_back(p_source.data() + p_source.size());
+
+		std::vector<Chunk> chunks(chunk_count);
+		Utility::parallel_for(chunk_count, 1, [&](size_t p_begin, size_t p_end)
+		{
+			for (size_t i = p_begin; i < p_end; i++)
+			{
+				try { parse_chunk(boundaries[i], boundaries[i + 1], chunks[i]); }
+				catch (...) { chunks[i].error = std::current_exception(); }
+			}
+		});
+		rethrow_chunk_error(chunks);
+
+		// Gather the vertex elements of every chunk, faces can reference elements from any earlier (or later) chunk.
+		std::vector<std::array<size_t, 3>> chunk_offsets(chunk_count);
+		std::array<size_t, 3> totals = {0, 0, 0};
+		for (size_t i = 0; i < chunk_count; i++)
+		{
+			chunk_offsets[i] = totals;
+			totals[0] += chunks[i].positions.size();
+			totals[1] += chunks[i].uvs.size();
+			totals[2] += chunks[i].normals.size();
+		}
+
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec2> uvs;
+		std::vector<glm::vec3> normals;
+		positions.reserve(totals[0]);
+		uvs.reserve(totals[1]);
+		normals.reserve(totals[2]);
+		for (auto& chunk : chunks)
+		{
+			positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+			uvs.insert(uvs.end(), chunk.uvs.begin(), chunk.uvs.end());
+			normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+			chunk.positions = {};
+			chunk.uvs       = {};
+			chunk.normals   = {};
+		}
+
+		// Each chunk indexes its own corners. A vertex shared by faces in different chunks is duplicated, which only happens along chunk seams.
+		Utility::parallel_for(chunk_count, 1, [&](size_t p_begin, size_t p_end)
+		{
+			for (size_t i = p_begin; i < p_end; i++)
+			{
+				try { index_chunk(chunks[i], chunk_offsets[i], totals, positions, uvs, normals); }
+				catch (...) { chunks[i].error = std::current_exception(); }
+			}
+		});
+		rethrow_chunk_error(chunks);
+
+		std::vector<size_t> vertex_offsets(chunk_count + 1, 0);
+		std::vector<size_t> index_offsets(chunk_count + 1, 0);
+		for (size_t i = 0; i < chunk_count; i++)
+		{
+			vertex_offsets[i + 1] = vertex_offsets[i] + chunks[i].vertices.size();
+			index_offsets[i + 1]  = index_offsets[i] + chunks[i].indices.size();
+		}
+		ASSERT_THROW(index_offsets.back() > 0, "OBJ file contains no faces.");
+
+		Model model;
+		model.vertices.resize(vertex_offsets.back());
+		model.indices.resize(index_offsets.back());
+		std::vector<int32_t> vertex_position_index(vertex_offsets.back());
+		Utility::parallel_for(chunk_count, 1, [&](size_t p_begin, size_t p_end)
+		{
+			for (size_t i = p_begin; i < p_end; i++)
+			{
+				const auto& chunk = chunks[i];
+				std::copy(chunk.vertices.begin(), chunk.vertices.end(), model.vertices.begin() + vertex_offsets[i]);
+				std::copy(chunk.vertex_position_index.begin(), chunk.vertex_position_index.end(), vertex_position_index.begin() + vertex_offsets[i]);
+				std::transform(chunk.indices.begin(), chunk.indices.end(), model.indices.begin() + index_offsets[i],
+					[offset = static_cast<unsigned int>(vertex_offsets[i])](unsigned int p_index) { return p_index + offset; });
+			}
+		});
+
+		// Vertices without a normal share the sum of the area weighted normals of all the faces touching their position.
+		if (std::any_of(vertex_position_index.begin(), vertex_position_index.end(), [](int32_t p_index) { return p_index != -1; }))
+		{
+			std::vector<glm::vec3> position_normals(positions.size(), glm::vec3{0.f});
+			for (size_t i = 0; i < model.indices.size(); i += 3)
+			{
+				const auto& a = model.vertices[model.indices[i]].position;
+				const auto& b = model.vertices[model.indices[i + 1]].position;
+				const auto& c = model.vertices[model.indices[i + 2]].position;
+				const auto face_normal = glm::cross(b - a, c - a); // Length is twice the triangle area.
+
+				for (size_t corner = 0; corner < 3; corner++)
+				{
+					const auto position_index = vertex_position_index[model.indices[i + corner]];
+					if (position_index != -1)
+						position_normals[position_index] += face_normal;
+				}
+			}
+			for (size_t i = 0; i < model.vertices.size(); i++)
+			{
+				if (vertex_position_index[i] != -1)
+				{
+					const auto& normal = position_normals[vertex_position_index[i]];
+					model.vertices[i].normal = glm::length(normal) > 0.f ? glm::normalize(normal) : glm::vec3{0.f, 1.f, 0.f};
+				}
+			}
+		}
+
+		model.min = model.vertices.front().position;
+		model.max = model.vertices.front().position;
+		for (const auto& vertex : model.vertices)
+		{
+			model.min = glm::min(model.min, vertex.position);
+			model.max = glm::max(model.max, vertex.position);
+		}
+
+		return model;
+	}
+
+	Model parse(const std::filesystem::path& p_path)
+	{
+		const Utility::MappedFile file{p_path};
+		return parse(file.view());
+	}
+} // namespace Data::OBJ
\ No newline at end of file
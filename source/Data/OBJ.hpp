@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Vertex.hpp"
+
+#include "glm/vec3.hpp"
+
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace Data::OBJ
+{
+	// Indexed triangle list parsed from a Wavefront OBJ file.
+	struct Model
+	{
+		std::vector<Vertex> vertices;     // Unique position/uv/normal combinations referenced by the faces.
+		std::vector<unsigned int> indices; // 3 per triangle, polygons are fan triangulated.
+		glm::vec3 min = glm::vec3{0.f};   // Object-space bounds of the vertex positions.
+		glm::vec3 max = glm::vec3{0.f};
+	};
+
+	// Parse the OBJ file at p_path. The file is memory mapped and parsed in parallel.
+	// Only geometry is read (v, vt, vn and f), materials, groups and smoothing groups are ignored.
+	// Vertices without a normal in the file are given area weighted smooth normals.
+	// Throws if the file cannot be read or references missing data.
+	Model parse(const std::filesystem::path& p_path);
+	// Parse the contents of an OBJ file already in memory. See parse(path).
+	Model parse(std::string_view p_source);
+} // namespace Data::OBJ
\ No newline at end of file
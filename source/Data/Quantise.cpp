@@ -0,0 +1,144 @@
+#include "Quantise.hpp"
+
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Data::Quantise
+{
+	uint16_t to_half(float p_value)
+	{
+		const uint32_t bits = std::bit_cast<uint32_t>(p_value);
+		const uint32_t sign = (bits >> 16) & 0x8000u;
+		uint32_t magnitude  = bits & 0x7FFFFFFFu;
+
+		if (magnitude >= 0x7F800000u) // Infinity or NaN, keep NaNs quiet.
+			return static_cast<uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u));
+		if (magnitude >= 0x477FF000u) // 65520 and above round past the largest half (65504).
+			return static_cast<uint16_t>(sign | 0x7C00u);
+		if (magnitude < 0x38800000u) // Below the smallest normal half (2^-14), becomes subnormal in steps of 2^-24.
+			return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::nearbyint(std::bit_cast<float>(magnitude) * 16777216.f)));
+
+		// Rebias the exponent from 127 to 15 and round the 13 dropped mantissa bits to nearest even. A mantissa carry correctly bumps the exponent.
+		magnitude += 0xC8000FFFu + ((magnitude >> 13) & 1u);
+		return static_cast<uint16_t>(sign | (magnitude >> 13));
+	}
+	float from_half(uint16_t p_half)
+	{
+		const uint32_t sign     = (static_cast<uint32_t>(p_half) & 0x8000u) << 16;
+		const uint32_t exponent = (p_half >> 10) & 0x1Fu;
+		const uint32_t mantissa = p_half & 0x3FFu;
+
+		if (exponent == 0) // Zero or subnormal.
+			return std::bit_cast<float>(sign | std::bit_cast<uint32_t>(static_cast<float>(mantissa) / 16777216.f));
+		if (exponent == 0x1Fu) // Infinity or NaN.
+			return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+
+		return std::bit_cast<float>(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+	}
+
+	uint16_t to_unorm16(float p_value)
+	{
+		return static_cast<uint16_t>(std::lround(std::clamp(p_value, 0.f, 1.f) * 65535.f));
+	}
+	uint8_t to_unorm8(float p_value)
+	{
+		return static_cast<uint8_t>(std::lround(std::clamp(p_value, 0.f, 1.f) * 255.f));
+	}
+
+	std::array<int16_t, 2> to_octahedral(const glm::vec3& p_normal)
+	{
+		const float length_1 = std::abs(p_normal.x) + std::abs(p_normal.y) + std::abs(p_normal.z);
+		if (length_1 == 0.f)
+			return {0, 0}; // Decodes to +Z, zero normals have no direction to preserve.
+
+		glm::vec2 octahedron{p_normal.x / length_1, p_normal.y / length_1};
+		if (p_normal.z < 0.f)
+		{
+			// Fold the lower hemisphere over the diagonals. Sign is never 0 so points on the axes fold to a consistent side.
+			const glm::vec2 sign{octahedron.x >= 0.f ? 1.f : -1.f, octahedron.y >= 0.f ? 1.f : -1.f};
+			octahedron = glm::vec2{(1.f - std::abs(octahedron.y)) * sign.x, (1.f - std::abs(octahedron.x)) * sign.y};
+		}
+
+		// Rounding each component to nearest isn't the closest encoding on the sphere. Try the 4 neighbouring grid points and keep the best.
+		const float x = std::clamp(octahedron.x, -1.f, 1.f) * 32767.f;
+		const float y = std::clamp(octahedron.y, -1.f, 1.f) * 32767.f;
+		const glm::vec3 normal = glm::normalize(p_normal);
+
+		std::array<int16_t, 2> best = {0, 0};
+		float best_dot              = -2.f;
+		for (const float candidate_x : {std::floor(x), std::ceil(x)})
+		{
+			for (const float candidate_y : {std::floor(y), std::ceil(y)})
+			{
+				const std::array<int16_t, 2> candidate = {static_cast<int16_t>(candidate_x), static_cast<int16_t>(candidate_y)};
+				const float dot                        = glm::dot(from_octahedral(candidate), normal);
+				if (dot > best_dot)
+				{
+					best     = candidate;
+					best_dot = dot;
+				}
+			}
+		}
+		return best;
+	}
+	glm::vec3 from_octahedral(const std::array<int16_t, 2>& p_encoded)
+	{
+		// Matches oct_decode in the vertex shaders after GL converts the signed normalised attribute.
+		const float x = std::max(static_cast<float>(p_encoded[0]) / 32767.f, -1.f);
+		const float y = std::max(static_cast<float>(p_encoded[1]) / 32767.f, -1.f);
+		glm::vec3 normal{x, y, 1.f - std::abs(x) - std::abs(y)};
+		const float fold = std::max(-normal.z, 0.f);
+		normal.x += normal.x >= 0.f ? -fold : fold;
+		normal.y += normal.y >= 0.f ? -fold : fold;
+		return glm::normalize(normal);
+	}
+
+	glm::vec3 position_scale(const glm::vec3& p_min, const glm::vec3& p_max)
+	{
+		const auto extent = p_max - p_min;
+		return glm::vec3{extent.x > 0.f ? extent.x : 1.f, extent.y > 0.f ? extent.y : 1.f, extent.z > 0.f ? extent.z : 1.f};
+	}
+
+	QuantisedVertex quantise(const Vertex& p_vertex, const glm::vec3& p_min, const glm::vec3& p_max)
+	{
+		const auto relative = (p_vertex.position - p_min) / position_scale(p_min, p_max);
+		const auto normal   = to_octahedral(p_vertex.normal);
+
+		QuantisedVertex vertex;
+		vertex.position[0] = to_unorm16(relative.x);
+		vertex.position[1] = to_unorm16(relative.y);
+		vertex.position[2] = to_unorm16(relative.z);
+		vertex.normal[0]   = normal[0];
+		vertex.normal[1]   = normal[1];
+		vertex.uv[0]       = to_half(p_vertex.uv.x);
+		vertex.uv[1]       = to_half(p_vertex.uv.y);
+		vertex.colour[0]   = to_unorm8(p_vertex.colour.r);
+		vertex.colour[1]   = to_unorm8(p_vertex.colour.g);
+		vertex.colour[2]   = to_unorm8(p_vertex.colour.b);
+		vertex.colour[3]   = to_unorm8(p_vertex.colour.a);
+		return vertex;
+	}
+	std::vector<QuantisedVertex> quantise(const std::vector<Vertex>& p_vertices, const glm::vec3& p_min, const glm::vec3& p_max)
+	{
+		std::vector<QuantisedVertex> quantised;
+		quantised.reserve(p_vertices.size());
+		for (const auto& vertex : p_vertices)
+			quantised.push_back(quantise(vertex, p_min, p_max));
+		return quantised;
+	}
+	TerrainVertex to_terrain_vertex(const Vertex& p_vertex)
+	{
+		const auto normal = to_octahedral(p_vertex.normal);
+
+		TerrainVertex vertex;
+		vertex.position  = p_vertex.position;
+		vertex.normal[0] = normal[0];
+		vertex.normal[1] = normal[1];
+		vertex.uv[0]     = to_half(p_vertex.uv.x);
+		vertex.uv[1]     = to_half(p_vertex.uv.y);
+		return vertex;
+	}
+} // namespace Data::Quantise
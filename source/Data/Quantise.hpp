@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Vertex.hpp"
+
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Conversions between full precision vertex attributes and the compact encodings read by the GPU as normalised and half float attributes.
+// Every decode matches what the GL vertex fetch (or the shader for octahedral normals) does, so a round trip shows the precision the GPU sees.
+namespace Data::Quantise
+{
+	// IEEE 754 binary16 conversion with round to nearest even. Out of range values become infinity, NaN stays NaN.
+	uint16_t to_half(float p_value);
+	float from_half(uint16_t p_half);
+
+	// Map p_value in [0, 1] to the full range of an unsigned normalised integer, rounding to nearest.
+	uint16_t to_unorm16(float p_value);
+	uint8_t to_unorm8(float p_value);
+
+	// Octahedral encoding of a unit vector (Meyer et al. 2010). Projects onto the octahedron |x| + |y| + |z| = 1 and folds the
+	// lower hemisphere over the upper, giving 2 signed normalised components with a worst case angular error below 0.01 degrees at 16 bits.
+	std::array<int16_t, 2> to_octahedral(const glm::vec3& p_normal);
+	glm::vec3 from_octahedral(const std::array<int16_t, 2>& p_encoded);
+
+	// Quantise p_vertex with its position relative to the box p_min to p_max. See Data::Mesh::dequantise_matrix for the inverse.
+	QuantisedVertex quantise(const Vertex& p_vertex, const glm::vec3& p_min, const glm::vec3& p_max);
+	std::vector<QuantisedVertex> quantise(const std::vector<Vertex>& p_vertices, const glm::vec3& p_min, const glm::vec3& p_max);
+	TerrainVertex to_terrain_vertex(const Vertex& p_vertex);
+
+	// Scale between the positions stored in a QuantisedVertex in [0, 1] and the box p_min to p_max.
+	// Flat axes use a scale of 1 to keep the dequantisation matrix invertible, their quantised coordinate is always 0.
+	glm::vec3 position_scale(const glm::vec3& p_min, const glm::vec3& p_max);
+} // namespace Data::Quantise
@@ -0,0 +1,185 @@
+#include "ThumbnailCache.hpp"
+#include "Image.hpp"
+#include "MipChain.hpp"
+
+#include "Utility/Logger.hpp"
+#include "Utility/Serialise.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+namespace Data
+{
+	constexpr uint32_t Thumbnail_Cache_Magic   = 0x43485453; // 'STHC' little-endian.
+	constexpr uint16_t Thumbnail_Cache_Version = 0;          // Increment when the file layout changes to discard old caches.
+
+	static int64_t write_time_ticks(const std::filesystem::path& p_path, std::error_code& p_error)
+	{
+		return static_cast<int64_t>(std::filesystem::last_write_time(p_path, p_error).time_since_epoch().count());
+	}
+
+	ThumbnailCache::ThumbnailCache(const std::filesystem::path& p_cache_file) noexcept
+		: m_cache_file{p_cache_file}
+		, m_entries{}
+		, m_dirty{false}
+	{
+		try
+		{
+			std::error_code error;
+			if (!std::filesystem::exists(m_cache_file, error))
+				return;
+
+			std::ifstream in(m_cache_file, std::ios::binary);
+			if (!in.is_open())
+			{
+				LOG_WARN(false, "[THUMBNAIL CACHE] Failed to open cache file '{}', rebuilding.", m_cache_file.string());
+				m_dirty = true;
+				return;
+			}
+			in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+			uint32_t magic   = 0;
+			uint16_t version = 0;
+			Utility::read_binary(in, Thumbnail_Cache_Version, magic);
+			Utility::read_binary(in, Thumbnail_Cache_Version, version);
+			if (magic != Thumbnail_Cache_Magic || version != Thumbnail_Cache_Version)
+			{
+				LOG_WARN(false, "[THUMBNAIL CACHE] Cache file '{}' is outdated, rebuilding.", m_cache_file.string());
+				m_dirty = true;
+				return;
+			}
+
+			size_t entry_count = 0;
+			Utility::read_binary(in, Thumbnail_Cache_Version, entry_count);
+			m_entries.reserve(entry_count);
+
+			for (size_t i = 0; i < entry_count; i++)
+			{
+				std::string path;
+				Entry entry;
+				Utility::read_binary(in, Thumbnail_Cache_Version, path);
+				Utility::read_binary(in, Thumbnail_Cache_Version, entry.last_write_time);
+				Utility::read_binary(in, Thumbnail_Cache_Version, entry.file_size);
+				Utility::read_binary(in, Thumbnail_Cache_Version, entry.thumbnail.width);
+				Utility::read_binary(in, Thumbnail_Cache_Version, entry.thumbnail.height);
+				Utility::read_binary(in, Thumbnail_Cache_Version, entry.thumbnail.pixels);
+				m_entries.emplace(std::move(path), std::move(entry));
+			}
+		}
+		catch (const std::exception& e) // Stream failures, or a corrupt entry count or string length exhausting memory.
+		{
+			LOG_WARN(false, "[THUMBNAIL CACHE] Failed to read cache file '{}', rebuilding. {}", m_cache_file.string(), e.what());
+			m_entries.clear();
+			m_dirty = true;
+		}
+	}
+	ThumbnailCache::~ThumbnailCache()
+	{
+		save();
+	}
+
+	const Thumbnail& ThumbnailCache::get(const std::filesystem::path& p_image_path)
+	{
+		// If the file can't be queried treat the entry as stale, loading the Image reports why the file is unreadable.
+		std::error_code error;
+		const auto write_time = write_time_ticks(p_image_path, error);
+		const auto file_size  = error ? 0 : std::filesystem::file_size(p_image_path, error);
+
+		auto& entry = m_entries[p_image_path.string()];
+		entry.used  = true;
+
+		if (error || entry.thumbnail.pixels.empty() || entry.last_write_time != write_time || entry.file_size != file_size)
+		{
+			const Image image{p_image_path};
+			entry.last_write_time = write_time;
+			entry.file_size       = file_size;
+			entry.thumbnail       = downscale(image.data, image.width, image.height, image.number_of_channels, Max_Resolution);
+			m_dirty               = true;
+		}
+
+		return entry.thumbnail;
+	}
+
+	void ThumbnailCache::save() noexcept
+	{
+		const auto entry_count = static_cast<size_t>(std::count_if(m_entries.begin(), m_entries.end(), [](const auto& p_entry) { return p_entry.second.used; }));
+		if (!m_dirty && entry_count == m_entries.size())
+			return;
+
+		// save runs from the destructor, every failure is logged and the cache is rebuilt next run instead of throwing.
+		try
+		{
+			std::error_code error;
+			std::filesystem::create_directories(m_cache_file.parent_path(), error);
+			if (error)
+			{
+				LOG_ERROR(false, "[THUMBNAIL CACHE] Failed to create cache directory '{}'. {}", m_cache_file.parent_path().string(), error.message());
+				return;
+			}
+
+			std::ofstream out(m_cache_file, std::ios::binary | std::ios::trunc);
+			if (!out.is_open())
+			{
+				LOG_ERROR(false, "[THUMBNAIL CACHE] Failed to open cache file '{}' for writing.", m_cache_file.string());
+				return;
+			}
+			out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+
+			Utility::write_binary(out, Thumbnail_Cache_Version, Thumbnail_Cache_Magic);
+			Utility::write_binary(out, Thumbnail_Cache_Version, Thumbnail_Cache_Version);
+			Utility::write_binary(out, Thumbnail_Cache_Version, entry_count);
+
+			for (const auto& [path, entry] : m_entries)
+			{
+				if (!entry.used)
+					continue;
+
+				Utility::write_binary(out, Thumbnail_Cache_Version, path);
+				Utility::write_binary(out, Thumbnail_Cache_Version, entry.last_write_time);
+				Utility::write_binary(out, Thumbnail_Cache_Version, entry.file_size);
+				Utility::write_binary(out, Thumbnail_Cache_Version, entry.thumbnail.width);
+				Utility::write_binary(out, Thumbnail_Cache_Version, entry.thumbnail.height);
+				Utility::write_binary(out, Thumbnail_Cache_Version, entry.thumbnail.pixels);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR(false, "[THUMBNAIL CACHE] Failed to write cache file '{}'. {}", m_cache_file.string(), e.what());
+		}
+
+		std::erase_if(m_entries, [](const auto& p_entry) { return !p_entry.second.used; });
+		m_dirty = false;
+	}
+
+	Thumbnail ThumbnailCache::downscale(const std::byte* p_pixels, int p_width, int p_height, uint8_t p_channels, int p_max_resolution)
+	{
+		ASSERT(p_pixels != nullptr && p_width > 0 && p_height > 0, "[THUMBNAIL CACHE] Invalid source image.");
+		ASSERT(p_channels >= 1 && p_channels <= 4, "[THUMBNAIL CACHE] Unsupported channel count {}.", p_channels);
+
+		// Reuse the mip chain builder so thumbnails are filtered in linear space on worker threads.
+		const auto mip_chain = MipChain::build(p_pixels, p_width, p_height, p_channels, MipFilter::Box, p_channels >= 3);
+		const auto& level    = *std::find_if(mip_chain.levels.begin(), mip_chain.levels.end(), [p_max_resolution](const auto& p_level)
+			{ return std::max(p_level.width, p_level.height) <= p_max_resolution; });
+
+		Thumbnail thumbnail;
+		thumbnail.width  = level.width;
+		thumbnail.height = level.height;
+		thumbnail.pixels.resize(static_cast<size_t>(thumbnail.width) * thumbnail.height * 4);
+
+		// 1 and 2 channel images are grey and grey-alpha (stb convention), expand to RGBA.
+		for (size_t i = 0; i < static_cast<size_t>(thumbnail.width) * thumbnail.height; i++)
+		{
+			const std::byte* in = &level.pixels[i * p_channels];
+			std::byte* out      = &thumbnail.pixels[i * 4];
+			switch (p_channels)
+			{
+				case 1: out[0] = out[1] = out[2] = in[0]; out[3] = std::byte{255}; break;
+				case 2: out[0] = out[1] = out[2] = in[0]; out[3] = in[1];          break;
+				case 3: out[0] = in[0]; out[1] = in[1]; out[2] = in[2]; out[3] = std::byte{255}; break;
+				case 4: out[0] = in[0]; out[1] = in[1]; out[2] = in[2]; out[3] = in[3];          break;
+			}
+		}
+
+		return thumbnail;
+	}
+} // namespace Data
\ No newline at end of file
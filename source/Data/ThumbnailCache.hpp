@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Data
+{
+	// A small downscaled RGBA8 copy of an image file used for previews.
+	struct Thumbnail
+	{
+		int width  = 0;
+		int height = 0;
+		std::vector<std::byte> pixels; // Tightly packed RGBA8 rows, width * height * 4 bytes.
+	};
+
+	// Persistent store of Thumbnails packed into a single file on disk.
+	// Each entry is keyed by the source image path, its last write time and its file size.
+	// Thumbnails are only regenerated (decode + downscale) when the source file changes or is not in the cache.
+	class ThumbnailCache
+	{
+		struct Entry
+		{
+			int64_t last_write_time = 0;
+			uintmax_t file_size     = 0;
+			bool used               = false; // Whether the entry was requested since load. Unused entries are pruned on save.
+			Thumbnail thumbnail;
+		};
+
+		std::filesystem::path m_cache_file;
+		std::unordered_map<std::string, Entry> m_entries; // Key is the source image path string.
+		bool m_dirty; // Whether an entry was added, regenerated or pruned since the cache file was read.
+
+	public:
+		constexpr static int Max_Resolution = 128; // Longest side of a thumbnail in pixels.
+
+		// Read the packed cache from p_cache_file if it exists. Corrupt or outdated files are discarded.
+		ThumbnailCache(const std::filesystem::path& p_cache_file) noexcept;
+		~ThumbnailCache();
+		ThumbnailCache(const ThumbnailCache& p_other)            = delete;
+		ThumbnailCache& operator=(const ThumbnailCache& p_other) = delete;
+
+		// Get the thumbnail of the image at p_image_path. Generates it if the cached entry is missing or out of date.
+		const Thumbnail& get(const std::filesystem::path& p_image_path);
+		// Write the cache back to disk if anything changed. Entries that were not requested via get are dropped.
+		// Failures to create or write the cache file are logged, save never throws as it runs from the destructor.
+		void save() noexcept;
+
+		// Downscale p_pixels so the longest side is at most p_max_resolution, converting to RGBA8.
+		// The result is the first level of the image's MipChain that fits, so filtering is gamma-correct.
+		//@param p_pixels Tightly packed 8-bit pixel data with p_channels channels per pixel.
+		static Thumbnail downscale(const std::byte* p_pixels, int p_width, int p_height, uint8_t p_channels, int p_max_resolution);
+	};
+} // namespace Data
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "glm/vec2.hpp"
 
 #include <concepts>
+#include <cstdint>
 #include <stdexcept>
 #include <type_traits>
 
@@ -47,4 +48,23 @@ namespace Data
 	{
 		glm::vec3 position = glm::vec3{0.f};
 	};
+	// Compact Vertex at 20 bytes instead of 48. Every attribute is read as a normalised or half float attribute, see Data::Quantise.
+	// Positions are relative to the mesh AABB so the vertex shader must scale them back into object space.
+	struct QuantisedVertex
+	{
+		uint16_t position[3] = {0, 0, 0}; // Unsigned normalised position in the mesh AABB, 0 is the min and 65535 the max.
+		uint16_t padding     = 0;         // Keeps the following attributes 4-byte aligned.
+		int16_t normal[2]    = {0, 0};    // Signed normalised octahedral encoding of the unit normal.
+		uint16_t uv[2]       = {0, 0};    // Half float texture coordinates.
+		uint8_t colour[4]    = {255, 255, 255, 255}; // Unsigned normalised RGBA.
+	};
+	static_assert(sizeof(QuantisedVertex) == 20, "QuantisedVertex is uploaded as-is and must stay tightly packed.");
+	// Terrain chunk vertex at 20 bytes instead of 48. Chunks span the whole world and share a draw call so positions stay full precision.
+	struct TerrainVertex
+	{
+		glm::vec3 position = glm::vec3{0.f};
+		int16_t normal[2]  = {0, 0}; // Signed normalised octahedral encoding of the unit normal.
+		uint16_t uv[2]     = {0, 0}; // Half float texture coordinates.
+	};
+	static_assert(sizeof(TerrainVertex) == 20, "TerrainVertex is uploaded as-is and must stay tightly packed.");
 } // namespace Data
@@ -18,6 +18,7 @@ namespace Geometry
 		AABB();
 		AABB(const float& p_low_X, const float& p_high_X, const float& p_low_Y, const float& p_high_Y, const float& p_low_Z, const float& p_high_Z);
 		AABB(const glm::vec3& p_min, const glm::vec3& p_max);
+		bool operator==(const AABB& p_other) const = default;
 
 		glm::vec3 get_size() const;
 		glm::vec3 get_center() const;
@@ -0,0 +1,208 @@
+#include "BVH.hpp"
+
+#include "Utility/Logger.hpp"
+
+#include <algorithm>
+
+namespace Geometry
+{
+	namespace
+	{
+		constexpr int Bin_Count = 16; // SAH split candidates per axis are the boundaries between bins.
+
+		struct Bounds
+		{
+			glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+			glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+			void unite(const glm::vec3& p_min, const glm::vec3& p_max)
+			{
+				min = glm::min(min, p_min);
+				max = glm::max(max, p_max);
+			}
+			// Half the surface area, the constant factor cancels out in the SAH.
+			float area() const
+			{
+				const glm::vec3 size = max - min;
+				return size.x < 0.f ? 0.f : size.x * size.y + size.y * size.z + size.z * size.x;
+			}
+		};
+
+		// Builds the nodes top-down, splitting each node at the bin boundary with the lowest surface area heuristic cost.
+		class Builder
+		{
+			// Primitive bounds are copied and partitioned along with the primitive indices so every pass over a node reads memory in order.
+			struct Item
+			{
+				glm::vec3 min;
+				uint32_t primitive;
+				glm::vec3 max;
+
+				float centroid(int p_axis) const { return (min[p_axis] + max[p_axis]) * 0.5f; }
+			};
+
+			std::vector<Item> m_items;
+			BVH& m_BVH;
+			uint32_t m_max_leaf_size;
+
+		public:
+			Builder(const std::vector<AABB>& p_bounds, BVH& p_BVH, uint32_t p_max_leaf_size)
+				: m_items{}
+				, m_BVH{p_BVH}
+				, m_max_leaf_size{std::max(p_max_leaf_size, 1u)}
+			{
+				m_items.reserve(p_bounds.size());
+				for (uint32_t i = 0; i < p_bounds.size(); i++)
+					m_items.push_back({p_bounds[i].m_min, i, p_bounds[i].m_max});
+			}
+			~Builder()
+			{
+				m_BVH.m_primitives.resize(m_items.size());
+				for (size_t i = 0; i < m_items.size(); i++)
+					m_BVH.m_primitives[i] = m_items[i].primitive;
+			}
+
+			void build(uint32_t p_node, uint32_t p_first, uint32_t p_count, uint32_t p_depth)
+			{
+				Bounds node_bounds;
+				Bounds centroid_bounds;
+				for (uint32_t i = p_first; i < p_first + p_count; i++)
+				{
+					node_bounds.unite(m_items[i].min, m_items[i].max);
+					const glm::vec3 centroid = (m_items[i].min + m_items[i].max) * 0.5f;
+					centroid_bounds.unite(centroid, centroid);
+				}
+				m_BVH.m_nodes[p_node].min = node_bounds.min;
+				m_BVH.m_nodes[p_node].max = node_bounds.max;
+
+				if (p_count <= 1 || p_depth >= BVH::Max_Depth)
+					return make_leaf(p_node, p_first, p_count);
+
+				// Find the cheapest split over all the bins on all axes.
+				int best_axis   = -1;
+				int best_split  = 0;
+				float best_cost = std::numeric_limits<float>::max();
+				for (int axis = 0; axis < 3; axis++)
+				{
+					const float extent = centroid_bounds.max[axis] - centroid_bounds.min[axis];
+					if (extent <= 0.f)
+						continue; // All the centroids lie in a plane perpendicular to the axis.
+
+					std::array<Bounds, Bin_Count> bins;
+					std::array<uint32_t, Bin_Count> bin_counts = {};
+					for (uint32_t i = p_first; i < p_first + p_count; i++)
+					{
+						const int bin = bin_index(m_items[i].centroid(axis), centroid_bounds.min[axis], extent);
+						bins[bin].unite(m_items[i].min, m_items[i].max);
+						bin_counts[bin]++;
+					}
+
+					// Sweep from the right to get the cost of everything right of each boundary, then from the left to complete the cost.
+					std::array<float, Bin_Count - 1> right_costs;
+					Bounds right_bounds;
+					uint32_t right_count = 0;
+					for (int i = Bin_Count - 1; i > 0; i--)
+					{
+						right_bounds.unite(bins[i].min, bins[i].max);
+						right_count += bin_counts[i];
+						right_costs[i - 1] = right_bounds.area() * static_cast<float>(right_count);
+					}
+					Bounds left_bounds;
+					uint32_t left_count = 0;
+					for (int i = 0; i < Bin_Count - 1; i++)
+					{
+						left_bounds.unite(bins[i].min, bins[i].max);
+						left_count += bin_counts[i];
+						const float cost = left_bounds.area() * static_cast<float>(left_count) + right_costs[i];
+						if (left_count > 0 && left_count < p_count && cost < best_cost)
+						{
+							best_axis  = axis;
+							best_split = i;
+							best_cost  = cost;
+						}
+					}
+				}
+
+				// Splitting costs a traversal step per ray on top of the intersections in the children, relative to testing every primitive here.
+				const float leaf_cost  = static_cast<float>(p_count);
+				const float split_cost = 1.f + best_cost / std::max(node_bounds.area(), std::numeric_limits<float>::min());
+
+				uint32_t left_count = 0;
+				if (best_axis >= 0)
+				{
+					if (p_count <= m_max_leaf_size && split_cost >= leaf_cost)
+						return make_leaf(p_node, p_first, p_count);
+
+					const float extent = centroid_bounds.max[best_axis] - centroid_bounds.min[best_axis];
+					const auto middle  = std::partition(m_items.begin() + p_first, m_items.begin() + p_first + p_count, [&](const Item& p_item)
+						{ return bin_index(p_item.centroid(best_axis), centroid_bounds.min[best_axis], extent) <= best_split; });
+					left_count = static_cast<uint32_t>(middle - (m_items.begin() + p_first));
+				}
+				else
+				{ // Every centroid is in the same place, no split separates them.
+					if (p_count <= m_max_leaf_size)
+						return make_leaf(p_node, p_first, p_count);
+
+					left_count = p_count / 2;
+				}
+
+				const auto left_child = static_cast<uint32_t>(m_BVH.m_nodes.size());
+				m_BVH.m_nodes.resize(m_BVH.m_nodes.size() + 2);
+				m_BVH.m_nodes[p_node].first = left_child;
+				m_BVH.m_nodes[p_node].count = 0;
+				build(left_child, p_first, left_count, p_depth + 1);
+				build(left_child + 1, p_first + left_count, p_count - left_count, p_depth + 1);
+			}
+
+		private:
+			void make_leaf(uint32_t p_node, uint32_t p_first, uint32_t p_count)
+			{
+				m_BVH.m_nodes[p_node].first = p_first;
+				m_BVH.m_nodes[p_node].count = p_count;
+			}
+			static int bin_index(float p_centroid, float p_min, float p_extent)
+			{
+				return std::min(static_cast<int>((p_centroid - p_min) * (static_cast<float>(Bin_Count) / p_extent)), Bin_Count - 1);
+			}
+		};
+	} // namespace
+
+	BVH::BVH(const std::vector<AABB>& p_bounds, uint32_t p_max_leaf_size)
+		: m_nodes{}
+		, m_primitives{}
+	{
+		if (p_bounds.empty())
+			return;
+
+		ASSERT_THROW(p_bounds.size() < std::numeric_limits<uint32_t>::max(), "[BVH] Too many primitives {}", p_bounds.size());
+
+		m_nodes.reserve(p_bounds.size() * 2 - 1); // A binary tree with one primitive per leaf, the most nodes possible.
+		m_nodes.emplace_back();
+		Builder(p_bounds, *this, p_max_leaf_size).build(0, 0, static_cast<uint32_t>(p_bounds.size()), 0); // Writes m_primitives when it goes out of scope.
+		m_nodes.shrink_to_fit();
+	}
+
+	void BVH::refit(const std::vector<AABB>& p_bounds)
+	{
+		ASSERT_THROW(p_bounds.size() == m_primitives.size(), "[BVH] Refit with {} primitives, built with {}", p_bounds.size(), m_primitives.size());
+
+		// Children always follow their parent so a reverse pass updates every child before its parent.
+		for (size_t i = m_nodes.size(); i-- > 0;)
+		{
+			Node& node = m_nodes[i];
+			Bounds bounds;
+			if (node.is_leaf())
+			{
+				for (uint32_t j = node.first; j < node.first + node.count; j++)
+					bounds.unite(p_bounds[m_primitives[j]].m_min, p_bounds[m_primitives[j]].m_max);
+			}
+			else
+			{
+				bounds.unite(m_nodes[node.first].min, m_nodes[node.first].max);
+				bounds.unite(m_nodes[node.first + 1].min, m_nodes[node.first + 1].max);
+			}
+			node.min = bounds.min;
+			node.max = bounds.max;
+		}
+	}
+} // namespace Geometry
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "AABB.hpp"
+#include "Intersect.hpp"
+#include "Ray.hpp"
+#include "TreeTraversal.hpp"
+
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace Geometry
+{
+	class Frustrum;
+
+	// Bounding volume hierarchy over a set of primitives given by their AABBs.
+	// Built top-down with binned SAH (Wald 2007) and flattened into an array of 32 byte nodes where the children of a node are adjacent.
+	// The primitives are only referred to by index, queries hand candidates to a callback doing the exact test against the primitive
+	// (triangles of a mesh, entities in a scene...), so the same structure serves any primitive type.
+	class BVH
+	{
+	public:
+		struct Node
+		{
+			glm::vec3 min;
+			uint32_t first; // Leaf: index into m_primitives of its first primitive. Interior: index of the left child, the right child follows it.
+			glm::vec3 max;
+			uint32_t count; // Number of primitives in a leaf, 0 for interior nodes.
+
+			bool is_leaf() const { return count > 0; }
+		};
+		struct Hit
+		{
+			uint32_t primitive; // Index of the primitive in the bounds the BVH was built from.
+			float distance;
+		};
+
+		std::vector<Node> m_nodes;          // m_nodes[0] is the root. Children always come after their parent.
+		std::vector<uint32_t> m_primitives; // Primitive indices in leaf order, leaves own a contiguous range.
+
+		BVH() = default;
+		//@param p_bounds AABB of each primitive. The primitives are referred to by their index in p_bounds.
+		//@param p_max_leaf_size Nodes with this many primitives or fewer become leaves unless splitting them lowers the SAH cost.
+		explicit BVH(const std::vector<AABB>& p_bounds, uint32_t p_max_leaf_size = 4);
+
+		bool empty() const { return m_nodes.empty(); }
+		AABB bounds() const { return empty() ? AABB() : AABB(m_nodes[0].min, m_nodes[0].max); }
+		// Update the node bounds after the primitives moved, keeping the tree structure. Far cheaper than a rebuild but the tree gets
+		// less efficient as primitives move away from their neighbours, rebuild when primitives are added or removed.
+		//@param p_bounds New AABB of each primitive, must be the same size as the bounds the BVH was built from.
+		void refit(const std::vector<AABB>& p_bounds);
+
+		// Calls p_callback(primitive) for each primitive in a leaf overlapping p_AABB.
+		template <typename Callback>
+		void query(const AABB& p_AABB, const Callback& p_callback) const
+		{
+			for_each_leaf([&p_AABB](const Node& p_node) { return Traversal::overlaps(p_node.min, p_node.max, p_AABB); }, p_callback);
+		}
+		// Calls p_callback(primitive) for each primitive in a leaf inside or intersecting p_frustrum.
+		template <typename Callback>
+		void query(const Frustrum& p_frustrum, const Callback& p_callback) const
+		{
+			for_each_leaf([&p_frustrum](const Node& p_node) { return intersecting(p_frustrum, AABB(p_node.min, p_node.max)); }, p_callback);
+		}
+
+		// The closest primitive hit by p_ray.
+		// Nodes are visited nearest first and skipped once they are further than the closest hit so far.
+		//@param p_intersect Called as p_intersect(primitive, max_distance), returns the distance along p_ray to the primitive or nullopt if it misses.
+		//@param p_max_distance Hits further than this along p_ray are ignored. Distances are in units of the length of the ray direction.
+		template <typename Intersect>
+		std::optional<Hit> cast_ray(const Ray& p_ray, const Intersect& p_intersect, float p_max_distance = std::numeric_limits<float>::infinity()) const
+		{
+			if (empty())
+				return std::nullopt;
+
+			const glm::vec3 inverse_direction = Traversal::inverse(p_ray.m_direction);
+			std::optional<Hit> closest;
+			float closest_distance = std::min(p_max_distance, std::numeric_limits<float>::max()); // Finite so nodes missed (at infinity) are never visited.
+
+			std::array<std::pair<uint32_t, float>, Max_Depth + 1> stack; // Node index and distance to it.
+			size_t stack_size = 0;
+			if (const float entry = Traversal::ray_entry(m_nodes[0].min, m_nodes[0].max, p_ray.m_start, inverse_direction, closest_distance); entry <= closest_distance)
+				stack[stack_size++] = {0, entry};
+
+			while (stack_size > 0)
+			{
+				const auto [node_index, node_distance] = stack[--stack_size];
+				if (node_distance > closest_distance)
+					continue; // A closer hit was found after this node was pushed.
+
+				const Node& node = m_nodes[node_index];
+				if (node.is_leaf())
+				{
+					for (uint32_t i = node.first; i < node.first + node.count; i++)
+					{
+						if (const std::optional<float> hit_distance = p_intersect(m_primitives[i], closest_distance); hit_distance && *hit_distance <= closest_distance)
+						{
+							closest_distance = *hit_distance;
+							closest          = Hit{m_primitives[i], *hit_distance};
+						}
+					}
+				}
+				else
+				{
+					float left_entry  = Traversal::ray_entry(m_nodes[node.first].min, m_nodes[node.first].max, p_ray.m_start, inverse_direction, closest_distance);
+					float right_entry = Traversal::ray_entry(m_nodes[node.first + 1].min, m_nodes[node.first + 1].max, p_ray.m_start, inverse_direction, closest_distance);
+					uint32_t near_child = node.first;
+					uint32_t far_child  = node.first + 1;
+					if (right_entry < left_entry)
+					{
+						std::swap(left_entry, right_entry);
+						std::swap(near_child, far_child);
+					}
+					// Push the far child first so the near child is popped first.
+					if (right_entry <= closest_distance)
+						stack[stack_size++] = {far_child, right_entry};
+					if (left_entry <= closest_distance)
+						stack[stack_size++] = {near_child, left_entry};
+				}
+			}
+			return closest;
+		}
+		// The closest primitive to p_point.
+		//@param p_distance_squared Called as p_distance_squared(primitive), returns the squared distance from p_point to the primitive.
+		//@param p_max_distance Primitives further than this from p_point are ignored.
+		template <typename DistanceSquared>
+		std::optional<Hit> nearest(const glm::vec3& p_point, const DistanceSquared& p_distance_squared, float p_max_distance = std::numeric_limits<float>::infinity()) const
+		{
+			if (empty())
+				return std::nullopt;
+
+			std::optional<Hit> closest;
+			float closest_distance_squared = p_max_distance * p_max_distance;
+
+			std::array<std::pair<uint32_t, float>, Max_Depth + 1> stack; // Node index and squared distance to it.
+			size_t stack_size = 0;
+			stack[stack_size++] = {0, Traversal::distance_squared(m_nodes[0].min, m_nodes[0].max, p_point)};
+
+			while (stack_size > 0)
+			{
+				const auto [node_index, node_distance_squared] = stack[--stack_size];
+				if (node_distance_squared > closest_distance_squared)
+					continue;
+
+				const Node& node = m_nodes[node_index];
+				if (node.is_leaf())
+				{
+					for (uint32_t i = node.first; i < node.first + node.count; i++)
+					{
+						if (const float primitive_distance_squared = p_distance_squared(m_primitives[i]); primitive_distance_squared <= closest_distance_squared)
+						{
+							closest_distance_squared = primitive_distance_squared;
+							closest                  = Hit{m_primitives[i], primitive_distance_squared};
+						}
+					}
+				}
+				else
+				{
+					float near_distance = Traversal::distance_squared(m_nodes[node.first].min, m_nodes[node.first].max, p_point);
+					float far_distance  = Traversal::distance_squared(m_nodes[node.first + 1].min, m_nodes[node.first + 1].max, p_point);
+					uint32_t near_child = node.first;
+					uint32_t far_child  = node.first + 1;
+					if (far_distance < near_distance)
+					{
+						std::swap(near_distance, far_distance);
+						std::swap(near_child, far_child);
+					}
+					if (far_distance <= closest_distance_squared)
+						stack[stack_size++] = {far_child, far_distance};
+					if (near_distance <= closest_distance_squared)
+						stack[stack_size++] = {near_child, near_distance};
+				}
+			}
+
+			if (closest)
+				closest->distance = std::sqrt(closest->distance);
+			return closest;
+		}
+
+		// Nodes this deep are always leaves, bounding the traversal stacks.
+		static constexpr uint32_t Max_Depth = 48;
+
+	private:
+		// Depth first traversal calling p_callback(primitive) for every primitive in leaves reached through nodes passing p_node_test.
+		template <typename NodeTest, typename Callback>
+		void for_each_leaf(const NodeTest& p_node_test, const Callback& p_callback) const
+		{
+			if (empty() || !p_node_test(m_nodes[0]))
+				return;
+
+			std::array<uint32_t, Max_Depth + 1> stack;
+			size_t stack_size = 0;
+			stack[stack_size++] = 0;
+
+			while (stack_size > 0)
+			{
+				const Node& node = m_nodes[stack[--stack_size]];
+				if (node.is_leaf())
+				{
+					for (uint32_t i = node.first; i < node.first + node.count; i++)
+						p_callback(m_primitives[i]);
+				}
+				else
+				{
+					if (p_node_test(m_nodes[node.first + 1]))
+						stack[stack_size++] = node.first + 1;
+					if (p_node_test(m_nodes[node.first]))
+						stack[stack_size++] = node.first;
+				}
+			}
+		}
+	};
+} // namespace Geometry
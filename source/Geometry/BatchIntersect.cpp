@@ -0,0 +1,325 @@
+#include "BatchIntersect.hpp"
+#include "AABB.hpp"
+#include "Frustrum.hpp"
+#include "Ray.hpp"
+#include "Triangle.hpp"
+
+#include "Utility/Logger.hpp"
+#include "Utility/SIMD.hpp"
+
+#include <bit>
+#include <cmath>
+#include <utility>
+
+namespace Geometry::Batch
+{
+	namespace
+	{
+		namespace SIMD = Utility::SIMD;
+		using Float = SIMD::FloatWide;
+		using Mask  = SIMD::MaskWide;
+		constexpr size_t Width = static_cast<size_t>(SIMD::Wide_Lanes);
+		static_assert(Padding % Width == 0 && RayPacket::Size % Width == 0, "Batches must be a whole number of registers.");
+
+		// One vector per lane.
+		struct Vec3
+		{
+			Float x, y, z;
+		};
+
+		Vec3 load(const std::array<std::vector<float>, 3>& p_components, size_t p_offset)
+		{
+			return {SIMD::load_wide(p_components[0].data() + p_offset), SIMD::load_wide(p_components[1].data() + p_offset), SIMD::load_wide(p_components[2].data() + p_offset)};
+		}
+		Vec3 load(const std::array<std::array<float, RayPacket::Size>, 3>& p_components, size_t p_offset)
+		{
+			return {SIMD::load_wide(p_components[0].data() + p_offset), SIMD::load_wide(p_components[1].data() + p_offset), SIMD::load_wide(p_components[2].data() + p_offset)};
+		}
+		Vec3 broadcast(const glm::vec3& p_vector) { return {SIMD::set_wide(p_vector.x), SIMD::set_wide(p_vector.y), SIMD::set_wide(p_vector.z)}; }
+
+		Vec3 sub(const Vec3& p_a, const Vec3& p_b) { return {SIMD::sub(p_a.x, p_b.x), SIMD::sub(p_a.y, p_b.y), SIMD::sub(p_a.z, p_b.z)}; }
+		Float dot(const Vec3& p_a, const Vec3& p_b) { return SIMD::mul_add(p_a.x, p_b.x, SIMD::mul_add(p_a.y, p_b.y, SIMD::mul(p_a.z, p_b.z))); }
+		Vec3 cross(const Vec3& p_a, const Vec3& p_b)
+		{
+			return {SIMD::sub(SIMD::mul(p_a.y, p_b.z), SIMD::mul(p_a.z, p_b.y)),
+			        SIMD::sub(SIMD::mul(p_a.z, p_b.x), SIMD::mul(p_a.x, p_b.z)),
+			        SIMD::sub(SIMD::mul(p_a.x, p_b.y), SIMD::mul(p_a.y, p_b.x))};
+		}
+
+		// Reciprocal of a ray direction component. Components parallel to a slab (within epsilon like the scalar test in Intersect.cpp) map to a large
+		// finite value instead of infinity so an origin lying on a slab plane gives 0 * 1e30 = 0 rather than 0 * inf = NaN.
+		float inverse(float p_direction)
+		{
+			return std::abs(p_direction) < std::numeric_limits<float>::epsilon() ? std::copysign(1e30f, p_direction) : 1.f / p_direction;
+		}
+		glm::vec3 inverse(const glm::vec3& p_direction) { return {inverse(p_direction.x), inverse(p_direction.y), inverse(p_direction.z)}; }
+
+		// Slab test (Kay and Kajiya) of a ray against an AABB in each lane.
+		Float ray_AABB(const Vec3& p_origin, const Vec3& p_inverse_direction, const Vec3& p_min, const Vec3& p_max, Float p_max_distance)
+		{
+			const Vec3 t_1 = {SIMD::mul(SIMD::sub(p_min.x, p_origin.x), p_inverse_direction.x), SIMD::mul(SIMD::sub(p_min.y, p_origin.y), p_inverse_direction.y), SIMD::mul(SIMD::sub(p_min.z, p_origin.z), p_inverse_direction.z)};
+			const Vec3 t_2 = {SIMD::mul(SIMD::sub(p_max.x, p_origin.x), p_inverse_direction.x), SIMD::mul(SIMD::sub(p_max.y, p_origin.y), p_inverse_direction.y), SIMD::mul(SIMD::sub(p_max.z, p_origin.z), p_inverse_direction.z)};
+
+			// Start the entry at 0 so boxes behind the ray miss and rays starting inside a box hit it at 0.
+			Float entry = SIMD::max(SIMD::set_wide(0.f), SIMD::min(t_1.x, t_2.x));
+			entry       = SIMD::max(entry, SIMD::min(t_1.y, t_2.y));
+			entry       = SIMD::max(entry, SIMD::min(t_1.z, t_2.z));
+			Float exit  = SIMD::min(p_max_distance, SIMD::max(t_1.x, t_2.x));
+			exit        = SIMD::min(exit, SIMD::max(t_1.y, t_2.y));
+			exit        = SIMD::min(exit, SIMD::max(t_1.z, t_2.z));
+			return SIMD::select(SIMD::less_equal(entry, exit), entry, SIMD::set_wide(Miss));
+		}
+		// Möller-Trumbore test of a ray against a triangle in each lane.
+		Float ray_triangle(const Vec3& p_origin, const Vec3& p_direction, const Vec3& p_point_1, const Vec3& p_edge_1, const Vec3& p_edge_2, Float p_max_distance)
+		{
+			const Vec3 p            = cross(p_direction, p_edge_2);
+			const Float determinant = dot(p_edge_1, p);
+			const Float inverse_det = SIMD::div(SIMD::set_wide(1.f), determinant);
+			const Vec3 s            = sub(p_origin, p_point_1);
+			const Float u           = SIMD::mul(dot(s, p), inverse_det);
+			const Vec3 q            = cross(s, p_edge_1);
+			const Float v           = SIMD::mul(dot(p_direction, q), inverse_det);
+			const Float t           = SIMD::mul(dot(p_edge_2, q), inverse_det);
+
+			const Float zero = SIMD::set_wide(0.f);
+			// A zero determinant means the ray is parallel to the triangle or the triangle is degenerate (including the zeroed padding lanes).
+			Mask hit = SIMD::greater(SIMD::abs(determinant), SIMD::set_wide(std::numeric_limits<float>::min()));
+			hit      = SIMD::mask_and(hit, SIMD::mask_and(SIMD::greater_equal(u, zero), SIMD::greater_equal(v, zero)));
+			hit      = SIMD::mask_and(hit, SIMD::less_equal(SIMD::add(u, v), SIMD::set_wide(1.f)));
+			hit      = SIMD::mask_and(hit, SIMD::mask_and(SIMD::greater_equal(t, zero), SIMD::less_equal(t, p_max_distance)));
+			return SIMD::select(hit, t, SIMD::set_wide(Miss));
+		}
+
+		// Runs p_kernel over p_count lanes a register at a time, writing its distances to p_distances.
+		template <typename Kernel>
+		void write_distances(size_t p_count, float* p_distances, const Kernel& p_kernel)
+		{
+			for (size_t offset = 0; offset < p_count; offset += Width)
+			{
+				if (offset + Width <= p_count)
+					SIMD::store(p_distances + offset, p_kernel(offset));
+				else
+				{ // Drop the padding lanes of the last register.
+					float lanes[Width];
+					SIMD::store(lanes, p_kernel(offset));
+					for (size_t i = 0; offset + i < p_count; i++)
+						p_distances[offset + i] = lanes[i];
+				}
+			}
+		}
+		// Runs p_kernel over p_count lanes a register at a time, returning the closest hit.
+		template <typename Kernel>
+		std::optional<Hit> find_closest(size_t p_count, const Kernel& p_kernel)
+		{
+			std::optional<Hit> closest;
+			float closest_distance = Miss;
+
+			for (size_t offset = 0; offset < p_count; offset += Width)
+			{
+				const Float distances = p_kernel(offset);
+				if (SIMD::mask_bits(SIMD::less(distances, SIMD::set_wide(closest_distance))) == 0)
+					continue; // Nothing in this register beats the current closest.
+
+				float lanes[Width];
+				SIMD::store(lanes, distances);
+				for (size_t i = 0; i < Width && offset + i < p_count; i++)
+				{
+					if (lanes[i] < closest_distance)
+					{
+						closest_distance = lanes[i];
+						closest          = Hit{offset + i, lanes[i]};
+					}
+				}
+			}
+			return closest;
+		}
+
+		// Grows the components by another Padding block of zeros.
+		void grow(std::array<std::vector<float>, 3>& p_components)
+		{
+			for (auto& component : p_components)
+				component.resize(component.size() + Padding, 0.f);
+		}
+	} // namespace
+
+	void AABBs::push_back(const AABB& p_AABB)
+	{
+		if (count == min[0].size())
+		{
+			grow(min);
+			grow(max);
+		}
+		set(count++, p_AABB);
+	}
+	void AABBs::set(size_t p_index, const AABB& p_AABB)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			min[axis][p_index] = p_AABB.m_min[axis];
+			max[axis][p_index] = p_AABB.m_max[axis];
+		}
+	}
+	void AABBs::erase(size_t p_index)
+	{
+		ASSERT(p_index < count, "[BATCH] Erasing AABB {} out of {}", p_index, count);
+		count--;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			min[axis][p_index] = min[axis][count];
+			max[axis][p_index] = max[axis][count];
+			min[axis][count]   = 0.f; // Keep the padding lanes zeroed.
+			max[axis][count]   = 0.f;
+		}
+	}
+	void AABBs::clear()
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			min[axis].clear();
+			max[axis].clear();
+		}
+		count = 0;
+	}
+
+	void Triangles::push_back(const Triangle& p_triangle)
+	{
+		if (count == point_1[0].size())
+		{
+			grow(point_1);
+			grow(edge_1);
+			grow(edge_2);
+		}
+		const glm::vec3 triangle_edge_1 = p_triangle.m_point_2 - p_triangle.m_point_1;
+		const glm::vec3 triangle_edge_2 = p_triangle.m_point_3 - p_triangle.m_point_1;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			point_1[axis][count] = p_triangle.m_point_1[axis];
+			edge_1[axis][count]  = triangle_edge_1[axis];
+			edge_2[axis][count]  = triangle_edge_2[axis];
+		}
+		count++;
+	}
+	void Triangles::clear()
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			point_1[axis].clear();
+			edge_1[axis].clear();
+			edge_2[axis].clear();
+		}
+		count = 0;
+	}
+
+	RayPacket::RayPacket()
+	{
+		max_distance.fill(-Miss);
+	}
+	void RayPacket::push_back(const Ray& p_ray, float p_max_distance)
+	{
+		ASSERT_THROW(count < Size, "[BATCH] RayPacket is full, it can hold {} rays.", Size);
+
+		const glm::vec3 inverse_ray_direction = inverse(p_ray.m_direction);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			origin[axis][count]            = p_ray.m_start[axis];
+			direction[axis][count]         = p_ray.m_direction[axis];
+			inverse_direction[axis][count] = inverse_ray_direction[axis];
+		}
+		max_distance[count++] = p_max_distance;
+	}
+
+	void intersect(const Ray& p_ray, const AABBs& p_AABBs, float* p_distances, float p_max_distance)
+	{
+		const Vec3 origin            = broadcast(p_ray.m_start);
+		const Vec3 inverse_direction = broadcast(inverse(p_ray.m_direction));
+		const Float max_distance     = SIMD::set_wide(p_max_distance);
+		write_distances(p_AABBs.count, p_distances, [&](size_t p_offset)
+			{ return ray_AABB(origin, inverse_direction, load(p_AABBs.min, p_offset), load(p_AABBs.max, p_offset), max_distance); });
+	}
+	void intersect(const Ray& p_ray, const Triangles& p_triangles, float* p_distances, float p_max_distance)
+	{
+		const Vec3 origin        = broadcast(p_ray.m_start);
+		const Vec3 direction     = broadcast(p_ray.m_direction);
+		const Float max_distance = SIMD::set_wide(p_max_distance);
+		write_distances(p_triangles.count, p_distances, [&](size_t p_offset)
+			{ return ray_triangle(origin, direction, load(p_triangles.point_1, p_offset), load(p_triangles.edge_1, p_offset), load(p_triangles.edge_2, p_offset), max_distance); });
+	}
+	void intersect(const RayPacket& p_rays, const AABB& p_AABB, float* p_distances)
+	{
+		const Vec3 min = broadcast(p_AABB.m_min);
+		const Vec3 max = broadcast(p_AABB.m_max);
+		write_distances(p_rays.count, p_distances, [&](size_t p_offset)
+			{ return ray_AABB(load(p_rays.origin, p_offset), load(p_rays.inverse_direction, p_offset), min, max, SIMD::load_wide(p_rays.max_distance.data() + p_offset)); });
+	}
+	void intersect(const RayPacket& p_rays, const Triangle& p_triangle, float* p_distances)
+	{
+		const Vec3 point_1 = broadcast(p_triangle.m_point_1);
+		const Vec3 edge_1  = broadcast(p_triangle.m_point_2 - p_triangle.m_point_1);
+		const Vec3 edge_2  = broadcast(p_triangle.m_point_3 - p_triangle.m_point_1);
+		write_distances(p_rays.count, p_distances, [&](size_t p_offset)
+			{ return ray_triangle(load(p_rays.origin, p_offset), load(p_rays.direction, p_offset), point_1, edge_1, edge_2, SIMD::load_wide(p_rays.max_distance.data() + p_offset)); });
+	}
+
+	size_t intersecting(const Frustrum& p_frustrum, const AABBs& p_AABBs, uint32_t* p_indices)
+	{
+		// Test the corner of each AABB furthest along the inside direction of each plane, an AABB is outside if that corner is outside any plane.
+		// The corner only depends on the signs of the plane normal, so per plane pick the min or max array of each axis once up front.
+		// Inside is dot(normal, p) + d >= 0, with the near and far planes of Frustrum flipped back as in Geometry::intersecting(Frustrum, AABB).
+		struct PlaneLanes
+		{
+			Vec3 normal;
+			Float distance;
+			std::array<const float*, 3> corner;
+		};
+		const std::array<std::pair<const Plane*, float>, 6> planes = {{
+			{&p_frustrum.m_left, 1.f}, {&p_frustrum.m_right, 1.f}, {&p_frustrum.m_bottom, 1.f}, {&p_frustrum.m_top, 1.f}, {&p_frustrum.m_near, -1.f}, {&p_frustrum.m_far, -1.f}}};
+		std::array<PlaneLanes, 6> plane_lanes;
+		for (size_t i = 0; i < planes.size(); i++)
+		{
+			const glm::vec3 normal = planes[i].first->m_normal * planes[i].second;
+			plane_lanes[i].normal   = broadcast(normal);
+			plane_lanes[i].distance = SIMD::set_wide(planes[i].first->m_distance * planes[i].second);
+			for (int axis = 0; axis < 3; axis++)
+				plane_lanes[i].corner[axis] = normal[axis] >= 0.f ? p_AABBs.max[axis].data() : p_AABBs.min[axis].data();
+		}
+
+		const Float zero = SIMD::set_wide(0.f);
+		size_t visible   = 0;
+		for (size_t offset = 0; offset < p_AABBs.count; offset += Width)
+		{
+			int inside_bits = (1 << Width) - 1;
+			for (const auto& plane : plane_lanes)
+			{
+				const Float signed_distance = SIMD::mul_add(plane.normal.x, SIMD::load_wide(plane.corner[0] + offset),
+				                              SIMD::mul_add(plane.normal.y, SIMD::load_wide(plane.corner[1] + offset),
+				                              SIMD::mul_add(plane.normal.z, SIMD::load_wide(plane.corner[2] + offset), plane.distance)));
+				inside_bits &= SIMD::mask_bits(SIMD::greater_equal(signed_distance, zero));
+				if (inside_bits == 0)
+					break; // Every lane is outside a plane.
+			}
+
+			if (const size_t remaining = p_AABBs.count - offset; remaining < Width)
+				inside_bits &= (1 << remaining) - 1; // Drop the padding lanes.
+			for (; inside_bits != 0; inside_bits &= inside_bits - 1)
+				p_indices[visible++] = static_cast<uint32_t>(offset + std::countr_zero(static_cast<unsigned>(inside_bits)));
+		}
+		return visible;
+	}
+
+	std::optional<Hit> closest_hit(const Ray& p_ray, const AABBs& p_AABBs, float p_max_distance)
+	{
+		const Vec3 origin            = broadcast(p_ray.m_start);
+		const Vec3 inverse_direction = broadcast(inverse(p_ray.m_direction));
+		const Float max_distance     = SIMD::set_wide(p_max_distance);
+		return find_closest(p_AABBs.count, [&](size_t p_offset)
+			{ return ray_AABB(origin, inverse_direction, load(p_AABBs.min, p_offset), load(p_AABBs.max, p_offset), max_distance); });
+	}
+	std::optional<Hit> closest_hit(const Ray& p_ray, const Triangles& p_triangles, float p_max_distance)
+	{
+		const Vec3 origin        = broadcast(p_ray.m_start);
+		const Vec3 direction     = broadcast(p_ray.m_direction);
+		const Float max_distance = SIMD::set_wide(p_max_distance);
+		return find_closest(p_triangles.count, [&](size_t p_offset)
+			{ return ray_triangle(origin, direction, load(p_triangles.point_1, p_offset), load(p_triangles.edge_1, p_offset), load(p_triangles.edge_2, p_offset), max_distance); });
+	}
+} // namespace Geometry::Batch
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace Geometry
+{
+	class AABB;
+	class Frustrum;
+	class Ray;
+	class Triangle;
+
+	// Intersection kernels testing one ray against many primitives, or a packet of rays against one primitive, a SIMD register of lanes at a time.
+	// Primitives are stored as structure of arrays so each register loads one component of several primitives.
+	// The register width is chosen at compile time (see Utility/SIMD.hpp), callers only depend on the storage layout below.
+	//
+	// Distances are in units of the ray direction, which doesn't have to be normalised. Rays starting inside an AABB hit it at distance 0.
+	// Triangles are double-sided.
+	namespace Batch
+	{
+		constexpr float Miss = std::numeric_limits<float>::infinity(); // Distance written for primitives that are not hit.
+		// The arrays are padded to a multiple of this many elements, the widest register the kernels may be built for (AVX-512).
+		// Padding lanes are tested but their results are never written out.
+		constexpr size_t Padding = 16;
+
+		struct AABBs
+		{
+			std::array<std::vector<float>, 3> min; // min[axis][i] is the minimum of AABB i along axis.
+			std::array<std::vector<float>, 3> max;
+			size_t count = 0;
+
+			void push_back(const AABB& p_AABB);
+			void set(size_t p_index, const AABB& p_AABB);
+			// Remove AABB p_index by moving the last AABB into its place.
+			void erase(size_t p_index);
+			void clear();
+		};
+		struct Triangles
+		{
+			std::array<std::vector<float>, 3> point_1; // point_1[axis][i] is the first point of triangle i.
+			std::array<std::vector<float>, 3> edge_1;  // point_2 - point_1.
+			std::array<std::vector<float>, 3> edge_2;  // point_3 - point_1.
+			size_t count = 0;
+
+			void push_back(const Triangle& p_triangle);
+			void clear();
+		};
+		// Up to Size rays stored one per lane, used to test coherent rays (e.g. a picking region) against the same primitive.
+		struct RayPacket
+		{
+			static constexpr size_t Size = 8;
+
+			std::array<std::array<float, Size>, 3> origin            = {};
+			std::array<std::array<float, Size>, 3> direction         = {};
+			std::array<std::array<float, Size>, 3> inverse_direction = {};
+			std::array<float, Size> max_distance = {}; // Unused lanes are given a negative max distance so they never hit.
+			size_t count = 0;
+
+			RayPacket();
+			//@param p_max_distance Hits further than this along the ray are treated as misses.
+			void push_back(const Ray& p_ray, float p_max_distance = Miss);
+		};
+		struct Hit
+		{
+			size_t index;   // Index of the primitive hit.
+			float distance; // Distance along the ray to the hit.
+		};
+
+		// Writes the distance along p_ray to the entry point of each AABB or Miss into p_distances.
+		//@param p_distances Output for p_AABBs.count distances.
+		//@param p_max_distance Hits further than this along the ray are treated as misses.
+		void intersect(const Ray& p_ray, const AABBs& p_AABBs, float* p_distances, float p_max_distance = Miss);
+		// Writes the distance along p_ray to each triangle or Miss into p_distances.
+		//@param p_distances Output for p_triangles.count distances.
+		//@param p_max_distance Hits further than this along the ray are treated as misses.
+		void intersect(const Ray& p_ray, const Triangles& p_triangles, float* p_distances, float p_max_distance = Miss);
+		// Writes the distance along each ray in p_rays to p_AABB or Miss into p_distances.
+		//@param p_distances Output for p_rays.count distances.
+		void intersect(const RayPacket& p_rays, const AABB& p_AABB, float* p_distances);
+		// Writes the distance along each ray in p_rays to p_triangle or Miss into p_distances.
+		//@param p_distances Output for p_rays.count distances.
+		void intersect(const RayPacket& p_rays, const Triangle& p_triangle, float* p_distances);
+
+		// Writes the index of each AABB inside or intersecting p_frustrum into p_indices, in ascending order.
+		// Conservative in the same way as Geometry::intersecting(Frustrum, AABB), which this matches for every AABB.
+		//@param p_indices Output for up to p_AABBs.count indices.
+		//@return The number of indices written.
+		size_t intersecting(const Frustrum& p_frustrum, const AABBs& p_AABBs, uint32_t* p_indices);
+
+		// The first AABB hit along p_ray, if any.
+		std::optional<Hit> closest_hit(const Ray& p_ray, const AABBs& p_AABBs, float p_max_distance = Miss);
+		// The first triangle hit along p_ray, if any.
+		std::optional<Hit> closest_hit(const Ray& p_ray, const Triangles& p_triangles, float p_max_distance = Miss);
+	} // namespace Batch
+} // namespace Geometry
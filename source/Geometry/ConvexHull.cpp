@@ -0,0 +1,501 @@
+#include "ConvexHull.hpp"
+
+#include "Utility/Logger.hpp"
+
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+
+namespace Geometry
+{
+	namespace
+	{
+		constexpr uint32_t No_Point = std::numeric_limits<uint32_t>::max();
+
+		struct HullFace
+		{
+			std::array<uint32_t, 3> vertices;   // Counter-clockwise seen from outside the hull.
+			std::array<uint32_t, 3> neighbours; // neighbours[i] is the face across the edge vertices[i] -> vertices[(i + 1) % 3].
+			glm::vec3 normal;
+			float offset;
+			std::vector<uint32_t> outside; // Points in front of the face not yet on the hull. The furthest is always added next.
+			bool visible = false;          // Marked while finding the faces the next point sees, removed once the point is added.
+			bool removed = false;
+
+			float distance(const glm::vec3& p_point) const { return glm::dot(normal, p_point) - offset; }
+		};
+
+		// Edge of the region of faces visible from the point being added. The new faces fan out from these to the point.
+		struct HorizonEdge
+		{
+			uint32_t from;
+			uint32_t to;
+			uint32_t face; // The face across the edge that stays on the hull.
+		};
+
+		// Round off when computing a plane distance grows with the magnitude of the coordinates involved.
+		// Points closer than this to a face are considered on it.
+		float hull_tolerance(const std::vector<glm::vec3>& p_points)
+		{
+			glm::vec3 max_abs{0.f};
+			for (const auto& point : p_points)
+				max_abs = glm::max(max_abs, glm::abs(point));
+
+			return 3.f * std::numeric_limits<float>::epsilon() * (max_abs.x + max_abs.y + max_abs.z);
+		}
+
+		// Indices of the most extreme points spanning the point cloud. Points are No_Point past the dimension of the cloud, e.g. d for coplanar points.
+		struct Simplex
+		{
+			uint32_t a = No_Point;
+			uint32_t b = No_Point;
+			uint32_t c = No_Point;
+			uint32_t d = No_Point;
+		};
+		Simplex find_simplex(const std::vector<glm::vec3>& p_points, float p_tolerance)
+		{
+			Simplex simplex;
+			if (p_points.empty())
+				return simplex;
+
+			// The pair of axis extremes furthest apart is a good first edge.
+			std::array<uint32_t, 6> extremes{};
+			for (uint32_t i = 0; i < p_points.size(); i++)
+			{
+				for (int axis = 0; axis < 3; axis++)
+				{
+					if (p_points[i][axis] < p_points[extremes[axis * 2]][axis])     extremes[axis * 2]     = i;
+					if (p_points[i][axis] > p_points[extremes[axis * 2 + 1]][axis]) extremes[axis * 2 + 1] = i;
+				}
+			}
+			simplex.a     = 0;
+			float longest = 0.f;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const float length = glm::length(p_points[extremes[axis * 2 + 1]] - p_points[extremes[axis * 2]]);
+				if (length > longest)
+				{
+					longest   = length;
+					simplex.a = extremes[axis * 2];
+					simplex.b = extremes[axis * 2 + 1];
+				}
+			}
+			if (longest <= p_tolerance)
+			{
+				simplex.b = No_Point;
+				return simplex;
+			}
+
+			// Furthest point from the line ab.
+			const glm::vec3 direction = glm::normalize(p_points[simplex.b] - p_points[simplex.a]);
+			float furthest = p_tolerance;
+			for (uint32_t i = 0; i < p_points.size(); i++)
+			{
+				const float distance = glm::length(glm::cross(p_points[i] - p_points[simplex.a], direction));
+				if (distance > furthest)
+				{
+					furthest  = distance;
+					simplex.c = i;
+				}
+			}
+			if (simplex.c == No_Point)
+				return simplex;
+
+			// Furthest point from the plane abc.
+			const glm::vec3 normal = glm::normalize(glm::cross(p_points[simplex.b] - p_points[simplex.a], p_points[simplex.c] - p_points[simplex.a]));
+			furthest = p_tolerance;
+			for (uint32_t i = 0; i < p_points.size(); i++)
+			{
+				const float distance = std::abs(glm::dot(p_points[i] - p_points[simplex.a], normal));
+				if (distance > furthest)
+				{
+					furthest  = distance;
+					simplex.d = i;
+				}
+			}
+			return simplex;
+		}
+
+		class QuickHull
+		{
+		public:
+			QuickHull(const std::vector<glm::vec3>& p_points)
+				: m_points{p_points}
+				, m_faces{}
+				, m_tolerance{hull_tolerance(p_points)}
+			{}
+
+			// Build the hull, returns false if the points have no volume.
+			bool build()
+			{
+				if (!build_simplex())
+					return false;
+
+				for (uint32_t face_index = 0; face_index < m_faces.size(); face_index++)
+				{
+					// New faces are appended so this single pass visits every face ever created. Faces removed since they were created have no outside points.
+					while (!m_faces[face_index].removed && !m_faces[face_index].outside.empty())
+						add_point(face_index);
+				}
+				return true;
+			}
+
+			float tolerance() const { return m_tolerance; }
+
+			// Copy the faces left on the hull into p_hull, keeping only the points they use as vertices.
+			void extract(ConvexHull& p_hull) const
+			{
+				std::vector<uint32_t> vertex_remap(m_points.size(), No_Point);
+				std::vector<uint32_t> face_remap(m_faces.size(), No_Point);
+				uint32_t face_count = 0;
+				for (uint32_t face_index = 0; face_index < m_faces.size(); face_index++)
+				{
+					if (!m_faces[face_index].removed)
+						face_remap[face_index] = face_count++;
+				}
+
+				p_hull.m_vertices.clear();
+				p_hull.m_faces.clear();
+				p_hull.m_faces.reserve(face_count);
+				for (const auto& face : m_faces)
+				{
+					if (face.removed)
+						continue;
+
+					ConvexHull::Face hull_face;
+					for (int i = 0; i < 3; i++)
+					{
+						if (vertex_remap[face.vertices[i]] == No_Point)
+						{
+							vertex_remap[face.vertices[i]] = static_cast<uint32_t>(p_hull.m_vertices.size());
+							p_hull.m_vertices.push_back(m_points[face.vertices[i]]);
+						}
+						hull_face.vertices[i]   = vertex_remap[face.vertices[i]];
+						hull_face.neighbours[i] = face_remap[face.neighbours[i]];
+					}
+					hull_face.normal = face.normal;
+					hull_face.offset = face.offset;
+					p_hull.m_faces.push_back(hull_face);
+				}
+			}
+
+		private:
+			const std::vector<glm::vec3>& m_points;
+			std::vector<HullFace> m_faces;
+			float m_tolerance; // Points closer than this to a face are considered on it.
+
+			uint32_t add_face(uint32_t p_a, uint32_t p_b, uint32_t p_c)
+			{
+				HullFace face;
+				face.vertices   = {p_a, p_b, p_c};
+				face.neighbours = {No_Point, No_Point, No_Point};
+				face.normal     = glm::normalize(glm::cross(m_points[p_b] - m_points[p_a], m_points[p_c] - m_points[p_a]));
+				face.offset     = glm::dot(face.normal, m_points[p_a]);
+				m_faces.push_back(std::move(face));
+				return static_cast<uint32_t>(m_faces.size() - 1);
+			}
+			// Give p_point to the face it is furthest in front of. Points behind or on every face are inside the hull and dropped.
+			void assign_outside(uint32_t p_point, const std::vector<uint32_t>& p_faces)
+			{
+				float furthest     = m_tolerance;
+				uint32_t best_face = No_Point;
+				for (const auto face_index : p_faces)
+				{
+					const float distance = m_faces[face_index].distance(m_points[p_point]);
+					if (distance > furthest)
+					{
+						furthest  = distance;
+						best_face = face_index;
+					}
+				}
+				if (best_face != No_Point)
+					m_faces[best_face].outside.push_back(p_point);
+			}
+
+			// Start the hull with the tetrahedron spanned by the most extreme points. Returns false if the points are flat.
+			bool build_simplex()
+			{
+				const auto simplex = find_simplex(m_points, m_tolerance);
+				if (simplex.d == No_Point)
+					return false;
+
+				uint32_t a = simplex.a, b = simplex.b, c = simplex.c;
+				const uint32_t d = simplex.d;
+				const glm::vec3 normal = glm::cross(m_points[b] - m_points[a], m_points[c] - m_points[a]);
+
+				// Wind abc so d is behind it, then every face of the tetrahedron faces away from d.
+				if (glm::dot(m_points[d] - m_points[a], normal) > 0.f)
+					std::swap(b, c);
+
+				// Faces of the tetrahedron with the edges each neighbour shares.
+				//      0: a b c   1: a d b   2: b d c   3: c d a
+				const uint32_t abc = add_face(a, b, c);
+				const uint32_t adb = add_face(a, d, b);
+				const uint32_t bdc = add_face(b, d, c);
+				const uint32_t cda = add_face(c, d, a);
+				m_faces[abc].neighbours = {adb, bdc, cda}; // ab, bc, ca
+				m_faces[adb].neighbours = {cda, bdc, abc}; // ad, db, ba
+				m_faces[bdc].neighbours = {adb, cda, abc}; // bd, dc, cb
+				m_faces[cda].neighbours = {bdc, adb, abc}; // cd, da, ac
+
+				const std::vector<uint32_t> faces = {abc, adb, bdc, cda};
+				for (uint32_t i = 0; i < m_points.size(); i++)
+				{
+					if (i != a && i != b && i != c && i != d)
+						assign_outside(i, faces);
+				}
+				return true;
+			}
+
+			// Mark p_face visible from p_eye and continue across its edges, collecting the boundary of the visible region in order.
+			//@param p_entry_edge The edge of p_face crossed to reach it. Edges are visited starting after it so the horizon stays a connected loop.
+			void find_horizon(const glm::vec3& p_eye, uint32_t p_face, int p_entry_edge, std::vector<HorizonEdge>& p_horizon, std::vector<uint32_t>& p_visible)
+			{
+				m_faces[p_face].visible = true;
+				p_visible.push_back(p_face);
+
+				for (int i = 0; i < 3; i++)
+				{
+					const int edge       = (p_entry_edge + i) % 3;
+					const uint32_t other = m_faces[p_face].neighbours[edge];
+					if (m_faces[other].visible)
+						continue;
+
+					if (m_faces[other].distance(p_eye) > m_tolerance)
+					{
+						const auto& other_neighbours = m_faces[other].neighbours;
+						const int back_edge          = static_cast<int>(std::find(other_neighbours.begin(), other_neighbours.end(), p_face) - other_neighbours.begin());
+						find_horizon(p_eye, other, (back_edge + 1) % 3, p_horizon, p_visible);
+					}
+					else
+						p_horizon.push_back({m_faces[p_face].vertices[edge], m_faces[p_face].vertices[(edge + 1) % 3], other});
+				}
+			}
+
+			// Add the furthest outside point of p_face to the hull, replacing the faces it sees with a fan of faces around it.
+			void add_point(uint32_t p_face)
+			{
+				auto& outside = m_faces[p_face].outside;
+				const auto eye_it = std::max_element(outside.begin(), outside.end(), [&](uint32_t p_lhs, uint32_t p_rhs)
+					{ return m_faces[p_face].distance(m_points[p_lhs]) < m_faces[p_face].distance(m_points[p_rhs]); });
+				const uint32_t eye = *eye_it;
+				outside.erase(eye_it);
+
+				std::vector<HorizonEdge> horizon;
+				std::vector<uint32_t> visible;
+				find_horizon(m_points[eye], p_face, 0, horizon, visible);
+
+				std::vector<uint32_t> new_faces;
+				new_faces.reserve(horizon.size());
+				for (const auto& edge : horizon)
+				{
+					const uint32_t face  = add_face(edge.from, edge.to, eye);
+					auto& neighbours     = m_faces[edge.face].neighbours;
+					const auto& vertices = m_faces[edge.face].vertices;
+					for (int i = 0; i < 3; i++)
+					{
+						if (vertices[i] == edge.to && vertices[(i + 1) % 3] == edge.from)
+							neighbours[i] = face;
+					}
+					m_faces[face].neighbours[0] = edge.face;
+					new_faces.push_back(face);
+				}
+				for (size_t i = 0; i < new_faces.size(); i++)
+				{// The horizon is a closed loop so each new face shares its side edges with the faces before and after it.
+					m_faces[new_faces[i]].neighbours[1] = new_faces[(i + 1) % new_faces.size()];
+					m_faces[new_faces[i]].neighbours[2] = new_faces[(i + new_faces.size() - 1) % new_faces.size()];
+				}
+
+				for (const auto face_index : visible)
+				{
+					std::vector<uint32_t> orphans;
+					std::swap(orphans, m_faces[face_index].outside);
+					m_faces[face_index].removed = true;
+
+					for (const auto point : orphans)
+						assign_outside(point, new_faces);
+				}
+			}
+		};
+
+		// The vertices of p_hull excluding any lying inside a flat region of it.
+		// These are points within the tolerance of coplanar that were added to the hull before the faces around them, e.g. as part of the starting simplex.
+		std::vector<glm::vec3> non_flat_vertices(const ConvexHull& p_hull, float p_tolerance)
+		{
+			std::vector<std::vector<uint32_t>> vertex_faces(p_hull.m_vertices.size());
+			for (uint32_t face_index = 0; face_index < p_hull.m_faces.size(); face_index++)
+			{
+				for (const auto vertex : p_hull.m_faces[face_index].vertices)
+					vertex_faces[vertex].push_back(face_index);
+			}
+
+			std::vector<glm::vec3> vertices;
+			for (size_t i = 0; i < p_hull.m_vertices.size(); i++)
+			{
+				const auto& plane = p_hull.m_faces[vertex_faces[i].front()];
+				const bool flat   = std::all_of(vertex_faces[i].begin(), vertex_faces[i].end(), [&](uint32_t p_face)
+				{
+					const auto& face_vertices = p_hull.m_faces[p_face].vertices;
+					return std::all_of(face_vertices.begin(), face_vertices.end(), [&](uint32_t p_vertex)
+						{ return std::abs(glm::dot(plane.normal, p_hull.m_vertices[p_vertex]) - plane.offset) <= p_tolerance; });
+				});
+				if (!flat)
+					vertices.push_back(p_hull.m_vertices[i]);
+			}
+			return vertices;
+		}
+
+		// Order the coplanar p_points counter-clockwise around the normal of abc into their 2D convex outline (Andrew's monotone chain).
+		std::vector<glm::vec3> flat_outline(const std::vector<glm::vec3>& p_points, const Simplex& p_simplex, float p_tolerance)
+		{
+			const glm::vec3 origin = p_points[p_simplex.a];
+			const glm::vec3 u      = glm::normalize(p_points[p_simplex.b] - origin);
+			const glm::vec3 normal = glm::normalize(glm::cross(p_points[p_simplex.b] - origin, p_points[p_simplex.c] - origin));
+			const glm::vec3 v      = glm::cross(normal, u);
+
+			struct Projected { float x; float y; uint32_t index; };
+			std::vector<Projected> projected;
+			projected.reserve(p_points.size());
+			for (uint32_t i = 0; i < p_points.size(); i++)
+				projected.push_back({glm::dot(p_points[i] - origin, u), glm::dot(p_points[i] - origin, v), i});
+
+			std::sort(projected.begin(), projected.end(), [](const Projected& p_lhs, const Projected& p_rhs)
+				{ return std::tie(p_lhs.x, p_lhs.y) < std::tie(p_rhs.x, p_rhs.y); });
+
+			// (p_b - p_a) x (p_c - p_a) is the distance of p_c from the line through p_a and p_b scaled by |p_b - p_a|.
+			const auto turns_left = [p_tolerance](const Projected& p_a, const Projected& p_b, const Projected& p_c)
+			{
+				const float cross  = (p_b.x - p_a.x) * (p_c.y - p_a.y) - (p_b.y - p_a.y) * (p_c.x - p_a.x);
+				const float length = std::hypot(p_b.x - p_a.x, p_b.y - p_a.y);
+				return cross > p_tolerance * length;
+			};
+
+			// Lower then upper half of the outline, each ending on the first point of the other.
+			std::vector<Projected> outline;
+			outline.reserve(projected.size() + 1);
+			for (size_t i = 0; i < projected.size(); i++)
+			{
+				while (outline.size() >= 2 && !turns_left(outline[outline.size() - 2], outline.back(), projected[i]))
+					outline.pop_back();
+				outline.push_back(projected[i]);
+			}
+			const size_t lower_size = outline.size();
+			for (size_t i = projected.size() - 1; i-- > 0;)
+			{
+				while (outline.size() > lower_size && !turns_left(outline[outline.size() - 2], outline.back(), projected[i]))
+					outline.pop_back();
+				outline.push_back(projected[i]);
+			}
+			outline.pop_back(); // The first point is repeated at the end.
+
+			std::vector<glm::vec3> vertices;
+			vertices.reserve(outline.size());
+			for (const auto& point : outline)
+				vertices.push_back(p_points[point.index]);
+			return vertices;
+		}
+
+		// Link every vertex of p_hull to the vertices it shares an edge with.
+		void build_adjacency(ConvexHull& p_hull)
+		{
+			p_hull.m_adjacency_offsets.assign(p_hull.m_vertices.size() + 1, 0);
+			p_hull.m_adjacency.clear();
+
+			if (p_hull.is_flat())
+			{// Ring around the outline, a line links its 2 end points once.
+				const auto count = static_cast<uint32_t>(p_hull.m_vertices.size());
+				const uint32_t per_vertex = count > 2 ? 2 : count - 1;
+				for (uint32_t i = 0; i < count; i++)
+				{
+					p_hull.m_adjacency_offsets[i + 1] = p_hull.m_adjacency_offsets[i] + per_vertex;
+					if (per_vertex > 0) p_hull.m_adjacency.push_back((i + 1) % count);
+					if (per_vertex > 1) p_hull.m_adjacency.push_back((i + count - 1) % count);
+				}
+				return;
+			}
+
+			// Each edge of a closed hull appears once in each direction, so every vertex gains the neighbour at the end of each edge leaving it.
+			for (const auto& face : p_hull.m_faces)
+				for (const auto vertex : face.vertices)
+					p_hull.m_adjacency_offsets[vertex + 1]++;
+			for (size_t i = 1; i < p_hull.m_adjacency_offsets.size(); i++)
+				p_hull.m_adjacency_offsets[i] += p_hull.m_adjacency_offsets[i - 1];
+
+			p_hull.m_adjacency.resize(p_hull.m_adjacency_offsets.back());
+			auto next_slot = p_hull.m_adjacency_offsets;
+			for (const auto& face : p_hull.m_faces)
+				for (int i = 0; i < 3; i++)
+					p_hull.m_adjacency[next_slot[face.vertices[i]]++] = face.vertices[(i + 1) % 3];
+		}
+	} // namespace
+
+	ConvexHull::ConvexHull(const std::vector<glm::vec3>& p_points)
+		: m_vertices{}
+		, m_faces{}
+		, m_adjacency_offsets{}
+		, m_adjacency{}
+	{
+		if (p_points.empty())
+			return;
+
+		QuickHull hull{p_points};
+		if (hull.build())
+		{
+			hull.extract(*this);
+
+			// Rebuilding from the remaining vertices removes the flat vertices and the faces fanning around them.
+			const auto vertices = non_flat_vertices(*this, hull.tolerance());
+			if (vertices.size() != m_vertices.size())
+			{
+				QuickHull pruned{vertices};
+				if (pruned.build())
+					pruned.extract(*this);
+			}
+		}
+		else
+		{
+			const auto simplex = find_simplex(p_points, hull.tolerance());
+			if (simplex.b == No_Point)
+				m_vertices = {p_points[simplex.a]};
+			else if (simplex.c == No_Point)
+				m_vertices = {p_points[simplex.a], p_points[simplex.b]};
+			else
+				m_vertices = flat_outline(p_points, simplex, hull.tolerance());
+		}
+
+		build_adjacency(*this);
+	}
+
+	std::span<const uint32_t> ConvexHull::neighbours(uint32_t p_vertex) const
+	{
+		return {m_adjacency.data() + m_adjacency_offsets[p_vertex], m_adjacency_offsets[p_vertex + 1] - m_adjacency_offsets[p_vertex]};
+	}
+
+	uint32_t ConvexHull::support_vertex(const glm::vec3& p_direction, uint32_t p_start) const
+	{
+		ASSERT(!m_vertices.empty(), "Support vertex of an empty ConvexHull.");
+		uint32_t support     = p_start < m_vertices.size() ? p_start : 0;
+		float support_height = glm::dot(p_direction, m_vertices[support]);
+
+		for (bool climbed = true; climbed;)
+		{
+			climbed = false;
+			for (const auto neighbour : neighbours(support))
+			{
+				const float height = glm::dot(p_direction, m_vertices[neighbour]);
+				if (height > support_height)
+				{
+					support        = neighbour;
+					support_height = height;
+					climbed        = true;
+				}
+			}
+		}
+		return support;
+	}
+} // namespace Geometry
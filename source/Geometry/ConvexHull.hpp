@@ -0,0 +1,49 @@
+#pragma once
+
+#include "glm/vec3.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Geometry
+{
+	// Convex hull of a point cloud built using quickhull (Barber, Dobkin and Huhdanpaa 1996).
+	// Stores the face and vertex adjacency of the hull so collision queries can walk its surface instead of testing every point.
+	// Points within a small tolerance of the hull surface (relative to the extent of the points) are treated as inside, so
+	// coplanar and near duplicate points on the faces of the hull are dropped.
+	class ConvexHull
+	{
+	public:
+		struct Face
+		{
+			std::array<uint32_t, 3> vertices;   // Indices into m_vertices, counter-clockwise seen from outside the hull.
+			std::array<uint32_t, 3> neighbours; // neighbours[i] is the face across the edge vertices[i] -> vertices[(i + 1) % 3].
+			glm::vec3 normal;                   // Outward facing unit normal.
+			float offset;                       // Distance of the face plane from the origin along normal.
+		};
+
+		std::vector<glm::vec3> m_vertices;
+		std::vector<Face> m_faces; // Empty if the hull is flat.
+		// The vertices sharing an edge with each vertex. The neighbours of vertex i are m_adjacency[m_adjacency_offsets[i]] up to m_adjacency[m_adjacency_offsets[i + 1]].
+		// Flat hulls link each vertex to the vertices before and after it around their outline.
+		std::vector<uint32_t> m_adjacency_offsets;
+		std::vector<uint32_t> m_adjacency;
+
+		ConvexHull() = default;
+		//@param p_points Point cloud to wrap. Duplicates are allowed.
+		// If p_points are coplanar the hull is their 2D outline in order, if they are collinear it's the 2 end points.
+		explicit ConvexHull(const std::vector<glm::vec3>& p_points);
+
+		bool empty()   const { return m_vertices.empty(); }
+		bool is_flat() const { return m_faces.empty(); }
+		std::span<const uint32_t> neighbours(uint32_t p_vertex) const;
+		// Index of the vertex furthest in p_direction, found by hill climbing the vertex adjacency from p_start.
+		// Every local maximum on a convex hull is global, so starting from the result of a query in a similar direction visits only a few vertices.
+		//@param p_direction Doesn't have to be normalised.
+		//@param p_start Vertex to start climbing from, typically the last support vertex found on this hull.
+		// The hull must not be empty.
+		uint32_t support_vertex(const glm::vec3& p_direction, uint32_t p_start = 0) const;
+	};
+} // namespace Geometry
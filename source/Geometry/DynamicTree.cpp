@@ -0,0 +1,238 @@
+#include "DynamicTree.hpp"
+
+#include <algorithm>
+
+namespace Geometry
+{
+	namespace
+	{
+		// Half the surface area, the constant factor cancels out when comparing costs.
+		float area(const glm::vec3& p_min, const glm::vec3& p_max)
+		{
+			const glm::vec3 size = p_max - p_min;
+			return size.x * size.y + size.y * size.z + size.z * size.x;
+		}
+		float united_area(const DynamicTree::Node& p_node_1, const DynamicTree::Node& p_node_2)
+		{
+			return area(glm::min(p_node_1.min, p_node_2.min), glm::max(p_node_1.max, p_node_2.max));
+		}
+	} // namespace
+
+	DynamicTree::DynamicTree(float p_margin)
+		: m_nodes{}
+		, m_root{Null}
+		, m_margin{p_margin}
+		, m_free_list{Null}
+		, m_proxy_count{0}
+	{}
+
+	uint32_t DynamicTree::insert(const AABB& p_AABB, size_t p_user_data)
+	{
+		const uint32_t leaf = allocate_node();
+		m_nodes[leaf].min       = p_AABB.m_min - glm::vec3(m_margin);
+		m_nodes[leaf].max       = p_AABB.m_max + glm::vec3(m_margin);
+		m_nodes[leaf].user_data = p_user_data;
+		insert_leaf(leaf);
+		m_proxy_count++;
+		return leaf;
+	}
+	void DynamicTree::remove(uint32_t p_proxy)
+	{
+		ASSERT(p_proxy < m_nodes.size() && m_nodes[p_proxy].height == 0, "[DynamicTree] {} is not a proxy", p_proxy);
+		remove_leaf(p_proxy);
+		free_node(p_proxy);
+		m_proxy_count--;
+	}
+	bool DynamicTree::move(uint32_t p_proxy, const AABB& p_AABB)
+	{
+		ASSERT(p_proxy < m_nodes.size() && m_nodes[p_proxy].height == 0, "[DynamicTree] {} is not a proxy", p_proxy);
+
+		Node& leaf = m_nodes[p_proxy];
+		const bool inside = glm::all(glm::lessThanEqual(leaf.min, p_AABB.m_min)) && glm::all(glm::greaterThanEqual(leaf.max, p_AABB.m_max));
+		// Objects that shrank or moved back are reinserted once their fat AABB is far bigger than them, otherwise they would be returned
+		// by queries they are nowhere near.
+		const glm::vec3 loose_margin = glm::vec3(4.f * m_margin);
+		const bool tight  = glm::all(glm::greaterThanEqual(leaf.min, p_AABB.m_min - loose_margin)) && glm::all(glm::lessThanEqual(leaf.max, p_AABB.m_max + loose_margin));
+		if (inside && tight)
+			return false;
+
+		remove_leaf(p_proxy);
+		leaf.min = p_AABB.m_min - glm::vec3(m_margin);
+		leaf.max = p_AABB.m_max + glm::vec3(m_margin);
+		insert_leaf(p_proxy);
+		return true;
+	}
+	void DynamicTree::clear()
+	{
+		m_nodes.clear();
+		m_root        = Null;
+		m_free_list   = Null;
+		m_proxy_count = 0;
+	}
+
+	uint32_t DynamicTree::allocate_node()
+	{
+		uint32_t node = m_free_list;
+		if (node == Null)
+		{
+			ASSERT_THROW(m_nodes.size() < Null, "[DynamicTree] Too many nodes {}", m_nodes.size());
+			node = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.emplace_back();
+		}
+		else
+			m_free_list = m_nodes[node].parent;
+
+		m_nodes[node] = Node{glm::vec3(0.f), Null, glm::vec3(0.f), 0, Null, Null, 0};
+		return node;
+	}
+	void DynamicTree::free_node(uint32_t p_node)
+	{
+		m_nodes[p_node].parent = m_free_list;
+		m_nodes[p_node].height = -1;
+		m_free_list = p_node;
+	}
+
+	void DynamicTree::insert_leaf(uint32_t p_leaf)
+	{
+		if (m_root == Null)
+		{
+			m_root = p_leaf;
+			m_nodes[p_leaf].parent = Null;
+			return;
+		}
+
+		// Descend towards the sibling for which pairing with the leaf costs the least surface area, counting the growth of every ancestor.
+		// Stop once pairing with the current node is cheaper than any descent.
+		uint32_t sibling = m_root;
+		while (!m_nodes[sibling].is_leaf())
+		{
+			const Node& node           = m_nodes[sibling];
+			const float combined_area  = united_area(node, m_nodes[p_leaf]);
+			const float cost           = 2.f * combined_area;                        // A new parent for this node and the leaf.
+			const float inherited_cost = 2.f * (combined_area - area(node.min, node.max)); // This node grows to include the leaf whichever child is picked.
+			const auto descend_cost    = [&](uint32_t p_child)
+			{
+				const Node& child = m_nodes[p_child];
+				const float grown = united_area(child, m_nodes[p_leaf]);
+				return (child.is_leaf() ? grown : grown - area(child.min, child.max)) + inherited_cost;
+			};
+			const float cost_1 = descend_cost(node.child_1);
+			const float cost_2 = descend_cost(node.child_2);
+			if (cost < cost_1 && cost < cost_2)
+				break;
+
+			sibling = cost_1 < cost_2 ? node.child_1 : node.child_2;
+		}
+
+		const uint32_t old_parent = m_nodes[sibling].parent;
+		const uint32_t new_parent = allocate_node();
+		m_nodes[new_parent].parent  = old_parent;
+		m_nodes[new_parent].child_1 = sibling;
+		m_nodes[new_parent].child_2 = p_leaf;
+		m_nodes[sibling].parent     = new_parent;
+		m_nodes[p_leaf].parent      = new_parent;
+
+		if (old_parent == Null)
+			m_root = new_parent;
+		else if (m_nodes[old_parent].child_1 == sibling)
+			m_nodes[old_parent].child_1 = new_parent;
+		else
+			m_nodes[old_parent].child_2 = new_parent;
+
+		refit_ancestors(new_parent);
+	}
+	void DynamicTree::remove_leaf(uint32_t p_leaf)
+	{
+		if (p_leaf == m_root)
+		{
+			m_root = Null;
+			return;
+		}
+
+		const uint32_t parent      = m_nodes[p_leaf].parent;
+		const uint32_t grandparent = m_nodes[parent].parent;
+		const uint32_t sibling     = m_nodes[parent].child_1 == p_leaf ? m_nodes[parent].child_2 : m_nodes[parent].child_1;
+		free_node(parent);
+
+		// The sibling takes the place of the parent.
+		m_nodes[sibling].parent = grandparent;
+		if (grandparent == Null)
+			m_root = sibling;
+		else
+		{
+			if (m_nodes[grandparent].child_1 == parent)
+				m_nodes[grandparent].child_1 = sibling;
+			else
+				m_nodes[grandparent].child_2 = sibling;
+
+			refit_ancestors(grandparent);
+		}
+	}
+	void DynamicTree::refit_ancestors(uint32_t p_node)
+	{
+		for (uint32_t node = p_node; node != Null; node = m_nodes[node].parent)
+		{
+			refit(node);
+			rotate(node);
+		}
+	}
+	void DynamicTree::rotate(uint32_t p_node)
+	{
+		// With children B and C, swapping B with a child F of C leaves C bounding B and the other child G, so the swap pays off when
+		// united_area(B, G) < area(C). The bounds of p_node are unchanged as it still holds the same leaves.
+		const uint32_t B = m_nodes[p_node].child_1;
+		const uint32_t C = m_nodes[p_node].child_2;
+
+		float best_change = 0.f;
+		uint32_t lowered  = Null; // The child of p_node moving down.
+		uint32_t raised   = Null; // The grandchild moving up in its place.
+		const auto consider = [&](uint32_t p_child, uint32_t p_other_child)
+		{
+			const Node& other = m_nodes[p_other_child];
+			if (other.is_leaf())
+				return;
+
+			const float other_area = area(other.min, other.max);
+			if (const float change = united_area(m_nodes[p_child], m_nodes[other.child_2]) - other_area; change < best_change)
+			{
+				best_change = change;
+				lowered     = p_child;
+				raised      = other.child_1;
+			}
+			if (const float change = united_area(m_nodes[p_child], m_nodes[other.child_1]) - other_area; change < best_change)
+			{
+				best_change = change;
+				lowered     = p_child;
+				raised      = other.child_2;
+			}
+		};
+		consider(B, C);
+		consider(C, B);
+		if (lowered == Null)
+			return;
+
+		const uint32_t other = lowered == B ? C : B;
+		if (m_nodes[p_node].child_1 == lowered)
+			m_nodes[p_node].child_1 = raised;
+		else
+			m_nodes[p_node].child_2 = raised;
+		if (m_nodes[other].child_1 == raised)
+			m_nodes[other].child_1 = lowered;
+		else
+			m_nodes[other].child_2 = lowered;
+
+		m_nodes[raised].parent  = p_node;
+		m_nodes[lowered].parent = other;
+		refit(other);
+		refit(p_node);
+	}
+	void DynamicTree::refit(uint32_t p_node)
+	{
+		Node& node = m_nodes[p_node];
+		const Node& child_1 = m_nodes[node.child_1];
+		const Node& child_2 = m_nodes[node.child_2];
+		node.min    = glm::min(child_1.min, child_2.min);
+		node.max    = glm::max(child_1.max, child_2.max);
+		node.height = 1 + std::max(child_1.height, child_2.height);
+	}
+} // namespace Geometry
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "AABB.hpp"
+#include "Intersect.hpp"
+#include "Ray.hpp"
+#include "Sphere.hpp"
+#include "TreeTraversal.hpp"
+
+#include "Utility/Logger.hpp"
+
+#include "glm/glm.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace Geometry
+{
+	class Frustrum;
+
+	// Bounding volume tree over moving objects, updated one object at a time instead of rebuilt (Box2D's b2DynamicTree).
+	// Each object is a proxy: a leaf storing its AABB grown by a margin, so small movements stay inside the fat AABB and leave the tree untouched.
+	// Leaves are inserted next to the sibling that grows the tree surface area the least, then the ancestors are rotated to undo any
+	// area increase the insertion caused, keeping queries close to O(log n) as objects come and go.
+	class DynamicTree
+	{
+	public:
+		static constexpr uint32_t Null = std::numeric_limits<uint32_t>::max();
+
+		struct Node
+		{
+			glm::vec3 min;
+			uint32_t parent; // Null for the root. Free nodes store the next free node here.
+			glm::vec3 max;
+			int32_t height;  // 0 for leaves, -1 for free nodes.
+			uint32_t child_1;
+			uint32_t child_2;
+			size_t user_data; // Leaves only, the value passed to insert.
+
+			bool is_leaf() const { return child_1 == Null; }
+		};
+		struct Hit
+		{
+			size_t user_data;
+			float distance;
+		};
+
+		std::vector<Node> m_nodes; // Pool of nodes, proxies are indices into it. Removed nodes are reused.
+		uint32_t m_root;
+
+		//@param p_margin Distance the AABB of each proxy is grown by. Larger margins move proxies in the tree less often but make queries less tight.
+		explicit DynamicTree(float p_margin = 0.1f);
+
+		// Add an object to the tree.
+		//@param p_user_data Value handed to query callbacks for this proxy, e.g. the entity it bounds.
+		//@return The proxy of the object, valid until it is removed.
+		uint32_t insert(const AABB& p_AABB, size_t p_user_data);
+		void remove(uint32_t p_proxy);
+		// Update the bounds of p_proxy. The tree only changes if p_AABB left the fat AABB of the proxy or is far smaller than it.
+		//@return True if the proxy was reinserted.
+		bool move(uint32_t p_proxy, const AABB& p_AABB);
+		void clear();
+
+		bool empty() const                       { return m_root == Null; }
+		size_t size() const                      { return m_proxy_count; }
+		// Height of the tree, a lone leaf has height 0.
+		int32_t height() const                   { return empty() ? 0 : m_nodes[m_root].height; }
+		// Bounds of every proxy, grown by up to the margin.
+		AABB bounds() const                      { return empty() ? AABB() : AABB(m_nodes[m_root].min, m_nodes[m_root].max); }
+		AABB fat_AABB(uint32_t p_proxy) const    { return AABB(m_nodes[p_proxy].min, m_nodes[p_proxy].max); }
+		size_t user_data(uint32_t p_proxy) const { return m_nodes[p_proxy].user_data; }
+
+		// Calls p_callback(user_data) for each proxy whose fat AABB overlaps p_AABB.
+		template <typename Callback>
+		void query(const AABB& p_AABB, const Callback& p_callback) const
+		{
+			for_each_leaf([&p_AABB](const Node& p_node) { return Traversal::overlaps(p_node.min, p_node.max, p_AABB); }, p_callback);
+		}
+		// Calls p_callback(user_data) for each proxy whose fat AABB is inside or intersecting p_frustrum.
+		template <typename Callback>
+		void query(const Frustrum& p_frustrum, const Callback& p_callback) const
+		{
+			for_each_leaf([&p_frustrum](const Node& p_node) { return intersecting(p_frustrum, AABB(p_node.min, p_node.max)); }, p_callback);
+		}
+		// Calls p_callback(user_data) for each proxy whose fat AABB is within p_sphere.m_radius of p_sphere.m_center.
+		template <typename Callback>
+		void query(const Sphere& p_sphere, const Callback& p_callback) const
+		{
+			const float radius_squared = p_sphere.m_radius * p_sphere.m_radius;
+			for_each_leaf([&](const Node& p_node) { return Traversal::distance_squared(p_node.min, p_node.max, p_sphere.m_center) <= radius_squared; }, p_callback);
+		}
+
+		// The closest proxy hit by p_ray, nodes are visited nearest first and skipped once they are further than the closest hit so far.
+		//@param p_intersect Called as p_intersect(user_data, max_distance), returns the distance along p_ray to the object or nullopt if it misses.
+		//@param p_max_distance Hits further than this along p_ray are ignored. Distances are in units of the length of the ray direction.
+		template <typename Intersect>
+		std::optional<Hit> cast_ray(const Ray& p_ray, const Intersect& p_intersect, float p_max_distance = std::numeric_limits<float>::infinity()) const
+		{
+			if (empty())
+				return std::nullopt;
+
+			const glm::vec3 inverse_direction = Traversal::inverse(p_ray.m_direction);
+			std::optional<Hit> closest;
+			float closest_distance = std::min(p_max_distance, std::numeric_limits<float>::max()); // Finite so nodes missed (at infinity) are never visited.
+
+			std::array<std::pair<uint32_t, float>, Max_Stack_Size> stack; // Node index and distance to it.
+			size_t stack_size = 0;
+			if (const float entry = Traversal::ray_entry(m_nodes[m_root].min, m_nodes[m_root].max, p_ray.m_start, inverse_direction, closest_distance); entry <= closest_distance)
+				stack[stack_size++] = {m_root, entry};
+
+			while (stack_size > 0)
+			{
+				const auto [node_index, node_distance] = stack[--stack_size];
+				if (node_distance > closest_distance)
+					continue; // A closer hit was found after this node was pushed.
+
+				const Node& node = m_nodes[node_index];
+				if (node.is_leaf())
+				{
+					if (const std::optional<float> hit_distance = p_intersect(node.user_data, closest_distance); hit_distance && *hit_distance <= closest_distance)
+					{
+						closest_distance = *hit_distance;
+						closest          = Hit{node.user_data, *hit_distance};
+					}
+				}
+				else
+				{
+					float near_entry    = Traversal::ray_entry(m_nodes[node.child_1].min, m_nodes[node.child_1].max, p_ray.m_start, inverse_direction, closest_distance);
+					float far_entry     = Traversal::ray_entry(m_nodes[node.child_2].min, m_nodes[node.child_2].max, p_ray.m_start, inverse_direction, closest_distance);
+					uint32_t near_child = node.child_1;
+					uint32_t far_child  = node.child_2;
+					if (far_entry < near_entry)
+					{
+						std::swap(near_entry, far_entry);
+						std::swap(near_child, far_child);
+					}
+					ASSERT(stack_size + 2 <= stack.size(), "[DynamicTree] Traversal stack overflow, tree height {}", height());
+					// Push the far child first so the near child is popped first.
+					if (far_entry <= closest_distance)
+						stack[stack_size++] = {far_child, far_entry};
+					if (near_entry <= closest_distance)
+						stack[stack_size++] = {near_child, near_entry};
+				}
+			}
+			return closest;
+		}
+
+	private:
+		// Rotations keep the height near 2 log2(n), this fits far more proxies than a scene holds.
+		static constexpr size_t Max_Stack_Size = 256;
+
+		float m_margin;
+		uint32_t m_free_list; // Head of the chain of free nodes through Node::parent.
+		size_t m_proxy_count;
+
+		uint32_t allocate_node();
+		void free_node(uint32_t p_node);
+		void insert_leaf(uint32_t p_leaf);
+		void remove_leaf(uint32_t p_leaf);
+		// Recompute the bounds and height of each node from p_node up to the root, rotating each on the way.
+		void refit_ancestors(uint32_t p_node);
+		// Swap a child of p_node with a grandchild on the other side if that shrinks the surface area of p_node's children.
+		void rotate(uint32_t p_node);
+		void refit(uint32_t p_node);
+
+		// Depth first traversal calling p_callback(user_data) for every leaf reached through nodes passing p_node_test.
+		template <typename NodeTest, typename Callback>
+		void for_each_leaf(const NodeTest& p_node_test, const Callback& p_callback) const
+		{
+			if (empty() || !p_node_test(m_nodes[m_root]))
+				return;
+
+			std::array<uint32_t, Max_Stack_Size> stack;
+			size_t stack_size = 0;
+			stack[stack_size++] = m_root;
+
+			while (stack_size > 0)
+			{
+				const Node& node = m_nodes[stack[--stack_size]];
+				if (node.is_leaf())
+					p_callback(node.user_data);
+				else
+				{
+					ASSERT(stack_size + 2 <= stack.size(), "[DynamicTree] Traversal stack overflow, tree height {}", height());
+					if (p_node_test(m_nodes[node.child_2]))
+						stack[stack_size++] = node.child_2;
+					if (p_node_test(m_nodes[node.child_1]))
+						stack[stack_size++] = node.child_1;
+				}
+			}
+		}
+	};
+} // namespace Geometry
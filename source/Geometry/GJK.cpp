@@ -6,6 +6,9 @@
 #include "glm/gtc/quaternion.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
 #include <stdexcept>
 
 namespace GJK
@@ -38,20 +41,23 @@ namespace GJK
 	}
 
 	glm::vec3 support_point(const glm::vec3& p_direction,
-	                        const std::vector<glm::vec3>& p_points_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
-	                        const std::vector<glm::vec3>& p_points_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2)
+	                        const Geometry::ConvexHull& p_hull_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
+	                        const Geometry::ConvexHull& p_hull_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2,
+	                        SupportCache& p_cache)
 	{
-		// We transform p_direction into each shape's object-space orientation to get the support points in object space.
+		// We rotate p_direction into each shape's object-space orientation to get the support points in object space.
 		// We then transform the support points into world space and return the difference.
 		// This allows us to transform just the two points rather than the entire point set.
+		// The orientations are unit quaternions so their conjugate is their inverse.
 
-		const auto shape_1_object_space_dir =   glm::inverse(p_orientation_1) * p_direction;
-		const auto shape_2_object_space_dir = -(glm::inverse(p_orientation_2) * p_direction);
+		const auto shape_1_object_space_dir =   glm::conjugate(p_orientation_1) * p_direction;
+		const auto shape_2_object_space_dir = -(glm::conjugate(p_orientation_2) * p_direction);
 
-		const auto mesh_1_support_point_object_space = support_point(shape_1_object_space_dir, p_points_1);
-		const auto mesh_1_support_point_world_space  = p_transform_1 * glm::vec4(mesh_1_support_point_object_space, 1.f);
-		const auto mesh_2_support_point_object_space = support_point(shape_2_object_space_dir, p_points_2);
-		const auto mesh_2_support_point_world_space  = p_transform_2 * glm::vec4(mesh_2_support_point_object_space, 1.f);
+		p_cache.vertex_1 = p_hull_1.support_vertex(shape_1_object_space_dir, p_cache.vertex_1);
+		p_cache.vertex_2 = p_hull_2.support_vertex(shape_2_object_space_dir, p_cache.vertex_2);
+
+		const auto mesh_1_support_point_world_space = p_transform_1 * glm::vec4(p_hull_1.m_vertices[p_cache.vertex_1], 1.f);
+		const auto mesh_2_support_point_world_space = p_transform_2 * glm::vec4(p_hull_2.m_vertices[p_cache.vertex_2], 1.f);
 
 		return mesh_1_support_point_world_space - mesh_2_support_point_world_space;
 	}
@@ -228,21 +234,30 @@ namespace GJK
 		}
 	}
 
-	bool intersecting(const std::vector<glm::vec3>& p_points_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
-	                  const std::vector<glm::vec3>& p_points_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2,
-	                  const glm::vec3& p_initial_direction)
+	bool intersecting(const Geometry::ConvexHull& p_hull_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
+	                  const Geometry::ConvexHull& p_hull_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2,
+	                  const glm::vec3& p_initial_direction, SupportCache* p_cache, Simplex* p_simplex)
 	{
+		// A collider without a hull, e.g. from an imported mesh built without one, has no support vertices and can't intersect anything.
+		if (p_hull_1.empty() || p_hull_2.empty())
+			return false;
+
+		SupportCache local_cache;
+		SupportCache& cache = p_cache ? *p_cache : local_cache;
+		Simplex local_simplex;
+		Simplex& simplex = p_simplex ? *p_simplex : local_simplex;
+
 		glm::vec3 direction = p_initial_direction;
-		Simplex simplex = {support_point(direction,
-		                                 p_points_1, p_transform_1, p_orientation_1,
-		                                 p_points_2, p_transform_2, p_orientation_2)};
+		simplex = {support_point(direction,
+		                         p_hull_1, p_transform_1, p_orientation_1,
+		                         p_hull_2, p_transform_2, p_orientation_2, cache)};
 		direction = -simplex[0]; // AO, search in the direction of the origin. Reversed direction to point towards the origin.
 
 		while (true) // Main GJK loop. Converge on A simplex that encloses the origin.
 		{
 			auto new_support_point = support_point(direction,
-			                                       p_points_1, p_transform_1, p_orientation_1,
-			                                       p_points_2, p_transform_2, p_orientation_2);
+			                                       p_hull_1, p_transform_1, p_orientation_1,
+			                                       p_hull_2, p_transform_2, p_orientation_2, cache);
 
 			// If the new support point is not past the origin then its impossible to enclose the origin.
 			if (glm::dot(new_support_point, direction) <= 0.f)
@@ -256,179 +271,165 @@ namespace GJK
 		}
 	}
 
-	// Tests if the reverse of an edge already exists in the list and if so, removes it.
-	void add_if_unique_edge(std::vector<std::pair<unsigned int, unsigned int>>& edges, const std::vector<unsigned int>& faces, unsigned int a, unsigned int b)
+	namespace
 	{
-		// By virtue of winding order, if a neighbouring face shares an edge, it will be in reverse order.
-		// We only want to store the edges that we are going to save because every edge gets removed first, then we repair.
+		// Capacity of the EPA polytope. Convergence usually takes well under this many iterations, if it's reached the closest face so far is returned.
+		constexpr size_t EPA_Max_Vertices = 64;
+		constexpr size_t EPA_Max_Faces    = 2 * EPA_Max_Vertices - 4; // Closed triangle mesh with V vertices has 2V - 4 faces.
+		constexpr float EPA_Tolerance     = 0.001f;                   // Stop once a new support point is no further than this past the closest face.
+		static_assert(EPA_Max_Vertices <= 256, "Polytope vertex indices are stored as uint8_t.");
 
-		auto reverse = std::find(edges.begin(), edges.end(), std::make_pair(faces[b], faces[a]));
+		struct PolytopeFace
+		{
+			std::array<uint8_t, 3> vertices; // Counter-clockwise seen from outside the polytope.
+			glm::vec3 normal;                // Outward facing unit normal.
+			float distance;                  // Distance of the face plane from the origin along normal.
+		};
 
-		if (reverse != edges.end())
-			edges.erase(reverse);
-		else
-			edges.emplace_back(faces[a], faces[b]);
-	}
+		// Minkowski difference polytope grown by EPA in fixed capacity inline storage so an EPA call never allocates.
+		struct Polytope
+		{
+			std::array<glm::vec3, EPA_Max_Vertices> vertices;
+			std::array<PolytopeFace, EPA_Max_Faces> faces; // Unordered, faces are swap-removed.
+			size_t vertex_count = 0;
+			size_t face_count   = 0;
 
-	// Returns a list of face normals and the index of the closest face.
-	//@param polytope: The list of points that define the polytope.
-	//@param faces: The list of indices that define the faces of the polytope.
-	//@returns A pair containing the list of face normals (xyz pos + w distance) and the index of the closest face.
-	std::pair<std::vector<glm::vec4>, size_t> get_face_normals(const std::vector<glm::vec3>& polytope, const std::vector<unsigned int>& faces)
-	{
-		std::vector<glm::vec4> face_normals;
-		face_normals.reserve(faces.size() / 3);
-		unsigned int min_triangle   = 0;
-		float min_distance = std::numeric_limits<float>::max();
+			// The normal and distance are computed once when a face is added, they never change while the face is on the polytope.
+			void add_face(uint8_t p_a, uint8_t p_b, uint8_t p_c)
+			{
+				PolytopeFace& face = faces[face_count++];
+				face.vertices      = {p_a, p_b, p_c};
+				face.normal        = glm::normalize(glm::cross(vertices[p_b] - vertices[p_a], vertices[p_c] - vertices[p_a]));
+				face.distance      = glm::dot(face.normal, vertices[p_a]);
+			}
+			size_t closest_face() const
+			{
+				size_t closest = 0;
+				for (size_t i = 1; i < face_count; i++)
+				{
+					if (faces[i].distance < faces[closest].distance)
+						closest = i;
+				}
+				return closest;
+			}
+		};
 
-		for (unsigned int i = 0; i < static_cast<unsigned int>(faces.size()); i += 3)
+		// The boundary of the faces removed by adding a support point, keyed by vertex pair.
+		// Neighbouring faces share edges in opposite directions, so adding the reverse of an edge already in the table cancels it, leaving only the horizon.
+		struct HorizonEdges
 		{
-			glm::vec3 a = polytope[faces[i]];
-			glm::vec3 b = polytope[faces[i + 1]];
-			glm::vec3 c = polytope[faces[i + 2]];
-
-			glm::vec3 normal = glm::normalize(glm::cross(b - a, c - a));
-			float distance   = glm::dot(normal, a);
+			std::bitset<EPA_Max_Vertices * EPA_Max_Vertices> present;     // Bit a * EPA_Max_Vertices + b is set for the edge a -> b.
+			std::array<std::pair<uint8_t, uint8_t>, EPA_Max_Faces * 3> edges; // Every edge added, including cancelled ones.
+			size_t edge_count = 0;
 
-			if (distance < 0)
+			void add(uint8_t p_from, uint8_t p_to)
 			{
-				normal   *= -1;
-				distance *= -1;
+				const size_t reverse = p_to * EPA_Max_Vertices + p_from;
+				if (present[reverse])
+					present.reset(reverse);
+				else
+				{
+					present.set(p_from * EPA_Max_Vertices + p_to);
+					edges[edge_count++] = {p_from, p_to};
+				}
 			}
-			face_normals.emplace_back(normal, distance);
-
-			if (distance < min_distance)
+			// Call p_func for every edge of the horizon and reset the table for the next iteration.
+			template <typename Func>
+			void consume(Func&& p_func)
 			{
-				min_triangle = i / 3u;
-				min_distance = distance;
+				for (size_t i = 0; i < edge_count; i++)
+				{
+					const size_t key = edges[i].first * EPA_Max_Vertices + edges[i].second;
+					if (present[key])
+					{
+						present.reset(key);
+						p_func(edges[i].first, edges[i].second);
+					}
+				}
+				edge_count = 0;
 			}
-		}
-
-		return {face_normals, min_triangle};
-	}
+		};
+	} // namespace
 
 	CollisionPoint EPA(const Simplex& p_simplex,
-	                   const std::vector<glm::vec3>& p_points_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
-	                   const std::vector<glm::vec3>& p_points_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2)
+	                   const Geometry::ConvexHull& p_hull_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
+	                   const Geometry::ConvexHull& p_hull_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2,
+	                   SupportCache* p_cache)
 	{
 		if (p_simplex.size != 4)
 			throw std::runtime_error("[GJK] Invalid simplex size in EPA function. EPA expects incoming simplex to be a tetrahedron.");
 
-		std::vector<glm::vec3> polytope = {p_simplex[0], p_simplex[1], p_simplex[2], p_simplex[3]};
-		std::vector<unsigned int> faces = {
-		    0, 1, 2,
-		    0, 3, 1,
-		    0, 2, 3,
-		    1, 3, 2};
-		auto [face_normals, min_face] = get_face_normals(polytope, faces);
+		SupportCache local_cache;
+		SupportCache& cache = p_cache ? *p_cache : local_cache;
 
-		glm::vec3 min_normal = face_normals[min_face];
-		float min_distance   = std::numeric_limits<float>::max();
-
-		while (min_distance == std::numeric_limits<float>::max())
-		{
-			min_normal   = face_normals[min_face];
-			min_distance = face_normals[min_face].w;
+		Polytope polytope;
+		HorizonEdges horizon;
+		polytope.vertices     = {p_simplex[0], p_simplex[1], p_simplex[2], p_simplex[3]};
+		polytope.vertex_count = 4;
 
-			glm::vec3 support = support_point(min_normal,
-			                                  p_points_1, p_transform_1, p_orientation_1,
-			                                  p_points_2, p_transform_2, p_orientation_2);
-			float s_distance  = dot(min_normal, support);
-
-			if (std::abs(s_distance - min_distance) > 0.001f)
-			{
-				min_distance = std::numeric_limits<float>::max();
-
-				// When expanding the polytope, we cannot just add a vertex, we need to repair the faces as well.
-				// When two faces result in the same support point being added, duplicate faces end up inside the polytope and cause incorrect results.
-				// We have to remove every face that is pointing in the direction of the support point relative to the triangle.
-				// To repair afterwards, we keep track of unique_edges and use those along with the support point's index to make new faces.
-				std::vector<std::pair<unsigned int, unsigned int>> unique_edges;
-				for (unsigned int i = 0; i < face_normals.size(); i++)
-				{
-					// This line compares the shortest distance of two parallel planes and the origin,
-					// passing by a forced point (support vertex vs point of current face).
-					// If the distance of the support point is lower, then the result would be a concave polytope, which is undesired.
-					// if ( normals[i].dot(support) > normals[i].dot(polytope[faces[i*3]]))
-					// Check same_direction relative to the triangle, not just the face normal.
+		// Wind the tetrahedron so every face points away from the vertex opposite it.
+		if (glm::dot(glm::cross(p_simplex[1] - p_simplex[0], p_simplex[2] - p_simplex[0]), p_simplex[3] - p_simplex[0]) > 0.f)
+			std::swap(polytope.vertices[1], polytope.vertices[2]);
+		polytope.add_face(0, 1, 2);
+		polytope.add_face(0, 3, 1);
+		polytope.add_face(0, 2, 3);
+		polytope.add_face(1, 3, 2);
 
-					if (same_direction(face_normals[i], support - polytope[faces[i * 3]]))
-					{
-						unsigned int face_index = i * 3;
-
-						add_if_unique_edge(unique_edges, faces, face_index, face_index + 1);
-						add_if_unique_edge(unique_edges, faces, face_index + 1, face_index + 2);
-						add_if_unique_edge(unique_edges, faces, face_index + 2, face_index);
-
-						faces[face_index + 2] = faces.back();
-						faces.pop_back();
-						faces[face_index + 1] = faces.back();
-						faces.pop_back();
-						faces[face_index] = faces.back();
-						faces.pop_back();
+		size_t min_face = polytope.closest_face();
+		while (polytope.vertex_count < EPA_Max_Vertices)
+		{
+			const glm::vec3 min_normal = polytope.faces[min_face].normal;
+			const glm::vec3 support    = support_point(min_normal,
+			                                           p_hull_1, p_transform_1, p_orientation_1,
+			                                           p_hull_2, p_transform_2, p_orientation_2, cache);
 
-						face_normals[i] = face_normals.back(); // pop-erase
-						face_normals.pop_back();
+			if (glm::dot(min_normal, support) - polytope.faces[min_face].distance <= EPA_Tolerance)
+				break; // The closest face is on the boundary of the Minkowski difference.
 
-						i--;
-					}
-				}
-				if (unique_edges.size() == 0)
-					break;
+			// When expanding the polytope, we cannot just add a vertex, we need to repair the faces as well.
+			// Every face the support point is in front of is removed and the hole is filled with a fan of faces from its horizon to the support point.
+			const auto support_index = static_cast<uint8_t>(polytope.vertex_count);
+			polytope.vertices[polytope.vertex_count++] = support;
 
-				// Now that we have a list of unique_edges, we can add the new_faces to a list and add the supporting point to the polytope.
-				// Storing the new_faces in their own list allows us to calculate only the normals of these new_faces.
-				std::vector<unsigned int> new_faces;
-				for (auto [edge_index_1, edge_index_2] : unique_edges)
-				{
-					new_faces.push_back(edge_index_1);
-					new_faces.push_back(edge_index_2);
-					new_faces.push_back(static_cast<unsigned int>(polytope.size()));
-				}
-				polytope.push_back(support);
-				auto [new_normals, new_min_face] = get_face_normals(polytope, new_faces);
-
-				// After calculating the new normals, we need to find the new closest face.
-				// We only iterate over the old normals, and compare the closest one to the closest face of the new normals.
-				// Then we can add these new faces and normals to the end of faces and face_normals respectively.
-				float new_min_distance = std::numeric_limits<float>::max();
-				for (size_t i = 0; i < face_normals.size(); i++)
-				{
-					if (face_normals[i].w < new_min_distance)
-					{
-						new_min_distance = face_normals[i].w;
-						min_face         = i;
-					}
-				}
-				if (new_normals[new_min_face].w < new_min_distance)
+			for (size_t i = 0; i < polytope.face_count;)
+			{
+				const PolytopeFace& face = polytope.faces[i];
+				if (same_direction(face.normal, support - polytope.vertices[face.vertices[0]]))
 				{
-					min_face = new_min_face + face_normals.size();
+					horizon.add(face.vertices[0], face.vertices[1]);
+					horizon.add(face.vertices[1], face.vertices[2]);
+					horizon.add(face.vertices[2], face.vertices[0]);
+					polytope.faces[i] = polytope.faces[--polytope.face_count]; // pop-erase
 				}
-
-				faces.insert(faces.end(), new_faces.begin(), new_faces.end());
-				face_normals.insert(face_normals.end(), new_normals.begin(), new_normals.end());
+				else
+					i++;
 			}
-		}
-
-		if (min_distance == std::numeric_limits<float>::max())
-			throw std::runtime_error("[GJK] EPA failed to find a collision point. This should never happen.");
 
+			bool full = false;
+			horizon.consume([&](uint8_t p_from, uint8_t p_to)
+			{
+				if (polytope.face_count < EPA_Max_Faces)
+					polytope.add_face(p_from, p_to, support_index);
+				else
+					full = true;
+			});
+			if (full || polytope.face_count == 0)
+				throw std::runtime_error("[GJK] EPA failed to repair the polytope. This should never happen.");
+
+			min_face = polytope.closest_face();
+		}
 
 		// The closest face of the polytope to the origin of the Minkowski difference is the face that represents the deepest penetration.
 		// The normal of this face is the collision normal, and its distance to the origin is the penetration depth.
 		// The collision point is the point on the face closest to the origin.
+		const PolytopeFace& closest = polytope.faces[min_face];
+		const auto closest_point    = Geometry::closest_point(Geometry::Triangle(polytope.vertices[closest.vertices[0]], polytope.vertices[closest.vertices[1]], polytope.vertices[closest.vertices[2]]), glm::vec3(0.f));
 
-		auto min_face_a = polytope[faces[min_face * 3]]; // * 3 because faces is a list of indices, not points.
-		auto min_face_b = polytope[faces[min_face * 3 + 1]];
-		auto min_face_c = polytope[faces[min_face * 3 + 2]];
-		auto closest_point = Geometry::closest_point(Geometry::Triangle(min_face_a, min_face_b, min_face_c), glm::vec3(0.f));
-		// Once a supporting point isn't found further from the closest face,
-		// We return that face's normal and its distance in a CollisionPoint.
 		CollisionPoint point;
-		point.normal            = min_normal;
-		point.A                 = glm::inverse(p_transform_1) * glm::vec4(closest_point + point.normal * min_distance, 1.f);
-		point.B                 = glm::inverse(p_transform_2) * glm::vec4(closest_point - point.normal * min_distance, 1.f);
-		point.penetration_depth = min_distance + 0.001f;
+		point.normal            = closest.normal;
+		point.A                 = glm::inverse(p_transform_1) * glm::vec4(closest_point + point.normal * closest.distance, 1.f);
+		point.B                 = glm::inverse(p_transform_2) * glm::vec4(closest_point - point.normal * closest.distance, 1.f);
+		point.penetration_depth = closest.distance + EPA_Tolerance;
 		return point;
 	}
 } // namespace GJK
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "ConvexHull.hpp"
+
 #include "glm/vec3.hpp"
 #include "glm/fwd.hpp"
 
 #include <array>
+#include <cstdint>
 #include <vector>
 #include <initializer_list>
 #include <stdexcept>
@@ -57,6 +60,14 @@ namespace GJK
 		const glm::vec3& operator[](int index) const { return points[index]; }
 	};
 
+	// The last support vertex found on each shape of a pair. Support queries hill climb from these so a query in a similar direction to
+	// the one before (the next GJK or EPA iteration, or the same pair next frame) visits only a few vertices of each hull.
+	struct SupportCache
+	{
+		uint32_t vertex_1 = 0; // Index into the first hull's m_vertices.
+		uint32_t vertex_2 = 0; // Index into the second hull's m_vertices.
+	};
+
 	// Is a and b in the same direction?
 	//@param a,b: The direction vectors to compare. These don't have to be normalized since we only care about direction.
 	//@return True if a and b are in the same direction, false otherwise.
@@ -68,17 +79,19 @@ namespace GJK
 	//@param p_points The object-space point set that defines convex shape.
 	glm::vec3 support_point(const glm::vec3& p_direction, const std::vector<glm::vec3>& p_points);
 
-	// Given two convex shapes defined by a set of points in object space, find the furthest point in p_direction and return the difference.
+	// Given two convex shapes defined by their hulls in object space, find the furthest point in p_direction and return the difference.
 	// By providing the transform and orientation of each convex shape, we can find the furthest point in world space.
-	// This is a brute force implementation of O(2n) complexity.
+	// The direction is rotated into the object space of each shape and the hulls are hill climbed from p_cache, close to O(1) when the direction changes little between queries.
 	//@param p_direction: The direction to search in world space. Doesn't have to be normalized since we only care about direction.
-	//@param p_points_1,p_points_2: The object-space point set that defines the convex shapes in object space.
+	//@param p_hull_1,p_hull_2: The convex hulls of the shapes in object space.
 	//@param p_transform_1,p_transform_2: The object->world space transform of the convex shapes.
 	//@param p_orientation_1,p_orientation_2 The orientation of the convex shapes.
+	//@param p_cache The support vertices to start climbing from, updated to the support vertices found.
 	//@return The difference between the furthest point of the convex shapes and the furthest point of the second convex shape in world space.
 	glm::vec3 support_point(const glm::vec3& p_direction,
-	                        const std::vector<glm::vec3>& p_points_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
-	                        const std::vector<glm::vec3>& p_points_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2);
+	                        const Geometry::ConvexHull& p_hull_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
+	                        const Geometry::ConvexHull& p_hull_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2,
+	                        SupportCache& p_cache);
 
 	// Performs an iteration of the GJK algorithm on p_simplex.
 	// The p_simplex and p_direction are updated in place.
@@ -87,24 +100,29 @@ namespace GJK
 	//@returns True if the origin is contained in the simplex, false otherwise (with the updated p_simplex and p_direction).
 	bool do_simplex(Simplex& p_simplex, glm::vec3& p_direction);
 
-	// Given two convex shapes defined by a set of points in object space, and their transforms and orientations, determine if they intersect.
-	//@param p_points_1,p_points_2: The object-space point set that defines the convex shapes in object space.
+	// Given two convex shapes defined by their hulls in object space, and their transforms and orientations, determine if they intersect.
+	//@param p_hull_1,p_hull_2: The convex hulls of the shapes in object space.
 	//@param p_transform_1,p_transform_2: The object->world space transform of the convex shapes.
 	//@param p_orientation_1,p_orientation_2 The orientation of the convex shapes.
 	//@param p_initial_direction The initial direction to search in. Defaults to (1,0,0) arbitrarily. A good initial direction is the vector between the two shapes in world space.
-	//@return True if the two convex shapes intersect, false otherwise.
-	bool intersecting(const std::vector<glm::vec3>& p_points_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
-	                  const std::vector<glm::vec3>& p_points_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2,
-	                  const glm::vec3& p_initial_direction = glm::vec3(1.f, 0.f, 0.f));
+	//@param p_cache Optional support vertices to start from, see SupportCache. Keep one per pair of shapes across frames to make use of their small change in orientation.
+	//@param p_simplex Optional output of the final simplex. If the shapes intersect it encloses the origin and can be passed to EPA.
+	//@return True if the two convex shapes intersect, false otherwise. False if either hull is empty.
+	bool intersecting(const Geometry::ConvexHull& p_hull_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
+	                  const Geometry::ConvexHull& p_hull_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2,
+	                  const glm::vec3& p_initial_direction = glm::vec3(1.f, 0.f, 0.f), SupportCache* p_cache = nullptr, Simplex* p_simplex = nullptr);
 
 	// Expanding Polytope Algorithm (EPA).
-	// Given two convex shapes defined by a set of points in object space, and their transforms and orientations, determine their collision point.
+	// Given two convex shapes defined by their hulls in object space, and their transforms and orientations, determine their collision point.
 	// This function assumes that the two convex shapes intersect. Use the intersecting function and pass the resulting simplex if true.
-	//@param p_points_1,p_points_2: The object-space point set that defines the convex shapes in object space.
+	// The polytope is grown in fixed capacity inline buffers so the call never allocates.
+	//@param p_hull_1,p_hull_2: The convex hulls of the shapes in object space.
 	//@param p_transform_1,p_transform_2: The object->world space transform of the convex shapes.
 	//@param p_orientation_1,p_orientation_2 The orientation of the convex shapes.
 	//@param p_simplex The simplex that contains the origin as returned by the GJK algorithm.
+	//@param p_cache Optional support vertices to start from, see SupportCache. Passing the cache used by intersecting continues from where GJK finished.
 	CollisionPoint EPA(const Simplex& p_simplex,
-	                   const std::vector<glm::vec3>& p_points_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
-	                   const std::vector<glm::vec3>& p_points_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2);
+	                   const Geometry::ConvexHull& p_hull_1, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1,
+	                   const Geometry::ConvexHull& p_hull_2, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2,
+	                   SupportCache* p_cache = nullptr);
 } // namespace GJK
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Geometry/AABB.hpp"
 #include "Geometry/Cone.hpp"
 #include "Geometry/Cylinder.hpp"
+#include "Geometry/Frustrum.hpp"
 #include "Geometry/Plane.hpp"
 #include "Geometry/Ray.hpp"
 #include "Geometry/Sphere.hpp"
@@ -12,7 +13,9 @@
 #include "Utility/Logger.hpp"
 
 #include <glm/glm.hpp>
+#include <array>
 #include <limits>
+#include <utility>
 
 // This intersections source file is composed of header definitions as well as cpp-static-functions that are used as helpers for them.
 namespace Geometry
@@ -490,6 +493,25 @@ namespace Geometry
 		else
 			return true;
 	}
+	bool intersecting(const Frustrum& frustrum, const AABB& AABB)
+	{
+		// The AABB is outside if it's entirely on the outside of any plane, tested using the corner furthest along the inside direction of the plane.
+		// Conservative: AABBs outside the frustrum near its edges and corners aren't behind any single plane and are reported as intersecting.
+		// Plane equations are ax + by + cz + d >= 0 inside. The near and far planes of Frustrum are stored negated so flip them back.
+		const std::array<std::pair<const Plane*, float>, 6> planes = {{
+			{&frustrum.m_left, 1.f}, {&frustrum.m_right, 1.f}, {&frustrum.m_bottom, 1.f}, {&frustrum.m_top, 1.f}, {&frustrum.m_near, -1.f}, {&frustrum.m_far, -1.f}}};
+
+		for (const auto& [plane, sign] : planes)
+		{
+			const glm::vec3 normal = plane->m_normal * sign;
+			const glm::vec3 furthest_corner = glm::vec3(normal.x >= 0.f ? AABB.m_max.x : AABB.m_min.x,
+			                                            normal.y >= 0.f ? AABB.m_max.y : AABB.m_min.y,
+			                                            normal.z >= 0.f ? AABB.m_max.z : AABB.m_min.z);
+			if (glm::dot(normal, furthest_corner) + plane->m_distance * sign < 0.f)
+				return false;
+		}
+		return true;
+	}
 	bool intersecting(const AABB& AABB, const Ray& ray)
 	{
 		// Adapted from: Real-Time Collision Detection (Christer Ericson) - 5.3.3 Intersecting Ray or Segment Against Box pg 180
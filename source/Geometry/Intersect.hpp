@@ -14,6 +14,7 @@ namespace Geometry
 	class Cone;
 	class Cuboid;
 	class Cylinder;
+	class Frustrum;
 	class Plane;
 	class Quad;
 	class Ray;
@@ -103,6 +104,7 @@ namespace Geometry
 //==============================================================================================================================
 	bool intersecting(const AABB& AABB_1,         const AABB& AABB_2);
 	bool intersecting(const AABB& AABB,           const Ray& ray);
+	bool intersecting(const Frustrum& frustrum,   const AABB& AABB);
 	bool intersecting(const Line& line,           const Triangle& triangle);
 	bool intersecting(const Plane& plane_1,       const Plane& plane_2);
 	bool intersecting(const Plane& plane,         const Sphere& sphere);
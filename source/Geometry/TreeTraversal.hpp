@@ -0,0 +1,47 @@
+#pragma once
+
+#include "AABB.hpp"
+
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Node bounds tests shared by the bounding volume trees (BVH, DynamicTree).
+// Nodes store their bounds as a min and max point so these take the two points rather than an AABB.
+namespace Geometry::Traversal
+{
+	inline bool overlaps(const glm::vec3& p_min, const glm::vec3& p_max, const AABB& p_AABB)
+	{
+		return p_min.x <= p_AABB.m_max.x && p_max.x >= p_AABB.m_min.x
+		    && p_min.y <= p_AABB.m_max.y && p_max.y >= p_AABB.m_min.y
+		    && p_min.z <= p_AABB.m_max.z && p_max.z >= p_AABB.m_min.z;
+	}
+	// Squared distance from p_point to the closest point in the bounds, 0 if p_point is inside.
+	inline float distance_squared(const glm::vec3& p_min, const glm::vec3& p_max, const glm::vec3& p_point)
+	{
+		const glm::vec3 outside = glm::max(glm::max(p_min - p_point, p_point - p_max), glm::vec3(0.f));
+		return glm::dot(outside, outside);
+	}
+	// Reciprocal of a ray direction, see Geometry::Batch for why parallel components become a large finite value.
+	inline glm::vec3 inverse(const glm::vec3& p_direction)
+	{
+		const auto inverse_component = [](float p_component)
+		{
+			return std::abs(p_component) < std::numeric_limits<float>::epsilon() ? std::copysign(1e30f, p_component) : 1.f / p_component;
+		};
+		return {inverse_component(p_direction.x), inverse_component(p_direction.y), inverse_component(p_direction.z)};
+	}
+	// Distance along the ray it enters the bounds (0 if it starts inside), infinity if it misses or enters beyond p_max_distance.
+	inline float ray_entry(const glm::vec3& p_min, const glm::vec3& p_max, const glm::vec3& p_origin, const glm::vec3& p_inverse_direction, float p_max_distance)
+	{
+		const glm::vec3 t_1 = (p_min - p_origin) * p_inverse_direction;
+		const glm::vec3 t_2 = (p_max - p_origin) * p_inverse_direction;
+		const glm::vec3 t_near = glm::min(t_1, t_2);
+		const glm::vec3 t_far  = glm::max(t_1, t_2);
+		const float entry = std::max(std::max(0.f, t_near.x), std::max(t_near.y, t_near.z));
+		const float exit  = std::min(std::min(p_max_distance, t_far.x), std::min(t_far.y, t_far.z));
+		return entry <= exit ? entry : std::numeric_limits<float>::infinity();
+	}
+} // namespace Geometry::Traversal
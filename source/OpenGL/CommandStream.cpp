@@ -0,0 +1,375 @@
+#include "CommandStream.hpp"
+
+#include "Utility/Logger.hpp"
+
+#include "glad/glad.h"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace OpenGL
+{
+	namespace
+	{
+		struct HandlePayload         { GLHandle handle; };
+		struct BufferRangePayload    { GLuint index; GLHandle buffer; GLintptr offset; GLsizeiptr size; };
+		struct TextureUnitPayload    { GLuint texture_unit; GLHandle texture; };
+		struct BoolPayload           { bool value; };
+		struct PolygonOffsetPayload  { GLfloat factor; GLfloat units; };
+		struct BlendFuncPayload      { BlendFactorType source_factor; BlendFactorType destination_factor; };
+		struct ViewportPayload       { GLint x; GLint y; GLsizei width; GLsizei height; };
+		struct UniformPayload        { GLint location; ShaderDataType type; }; // Followed by the value.
+		struct BufferSubDataPayload  { GLHandle buffer; GLintptr offset; GLsizeiptr size; }; // Followed by size bytes of data.
+		struct CopyBufferPayload     { GLHandle source_buffer; GLHandle destination_buffer; GLintptr source_offset; GLintptr destination_offset; GLsizeiptr size; };
+		struct ClearBufferPayload    { GLHandle buffer; GLenum internal_format; GLintptr offset; GLsizeiptr size; GLenum format; GLenum type; };
+		struct BlockBindingPayload   { GLHandle shader_program; GLuint block_index; GLuint binding; };
+		struct ClearColourPayload    { GLHandle FBO; glm::vec4 colour; };
+		struct ClearDepthPayload     { GLHandle FBO; GLfloat depth; GLint stencil; };
+		struct ClearRegionPayload    { GLHandle texture; glm::uvec2 offset; glm::uvec2 size; GLfloat depth; };
+		struct BlitPayload           { GLHandle source_FBO; GLHandle destination_FBO; glm::uvec2 src_min; glm::uvec2 src_max; glm::uvec2 dst_min; glm::uvec2 dst_max; GLuint mask; GLenum filter; };
+		struct DrawPayload           { PrimitiveMode primitive_mode; GLint first; GLsizei count; GLsizei instance_count; };
+		struct DispatchPayload       { GLuint num_groups_x; GLuint num_groups_y; GLuint num_groups_z; };
+		struct MemoryBarrierPayload  { GLuint bitfield; };
+
+		template <typename Payload>
+		Payload read(const std::byte* p_payload)
+		{
+			Payload payload;
+			std::memcpy(&payload, p_payload, sizeof(Payload));
+			return payload;
+		}
+	} // namespace
+
+	template <typename Payload>
+	void CommandStream::push(Command p_command, const Payload& p_payload, const void* p_data, size_t p_data_size)
+	{
+		static_assert(std::is_trivially_copyable_v<Payload>, "Payload is copied into the stream byte wise.");
+		ASSERT(sizeof(Payload) + p_data_size <= std::numeric_limits<uint32_t>::max(), "Command payload of {}B too large for the stream.", sizeof(Payload) + p_data_size);
+
+		const Header header = {p_command, static_cast<uint32_t>(sizeof(Payload) + p_data_size)};
+		const size_t start  = m_bytes.size();
+		m_bytes.resize(start + sizeof(Header) + header.payload_size);
+		std::memcpy(m_bytes.data() + start, &header, sizeof(Header));
+		std::memcpy(m_bytes.data() + start + sizeof(Header), &p_payload, sizeof(Payload));
+		if (p_data_size > 0)
+			std::memcpy(m_bytes.data() + start + sizeof(Header) + sizeof(Payload), p_data, p_data_size);
+
+		m_counts[static_cast<size_t>(p_command)]++;
+		m_command_count++;
+	}
+
+	void CommandStream::clear()
+	{
+		m_bytes.clear();
+		m_counts        = {};
+		m_command_count = 0;
+	}
+	size_t CommandStream::draw_count() const
+	{
+		return count(Command::DrawArrays) + count(Command::DrawArraysInstanced) + count(Command::DrawElements) + count(Command::DrawElementsInstanced) + count(Command::DispatchCompute);
+	}
+
+	void CommandStream::use_program(GLHandle p_shader_program) { push(Command::UseProgram, HandlePayload{p_shader_program}); }
+	void CommandStream::bind_VAO(GLHandle p_VAO)               { push(Command::BindVAO, HandlePayload{p_VAO}); }
+	void CommandStream::bind_FBO(GLHandle p_FBO)               { push(Command::BindFBO, HandlePayload{p_FBO}); }
+	void CommandStream::bind_shader_storage_buffer(GLuint p_index, GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_size)
+	{
+		push(Command::BindShaderStorageBuffer, BufferRangePayload{p_index, p_buffer, p_offset, p_size});
+	}
+	void CommandStream::bind_uniform_buffer(GLuint p_index, GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_size)
+	{
+		push(Command::BindUniformBuffer, BufferRangePayload{p_index, p_buffer, p_offset, p_size});
+	}
+	void CommandStream::bind_texture_unit(GLuint p_texture_unit, GLHandle p_texture)
+	{
+		push(Command::BindTextureUnit, TextureUnitPayload{p_texture_unit, p_texture});
+	}
+
+	void CommandStream::set_depth_write(bool p_write_to_depth_buffer)    { push(Command::DepthWrite, BoolPayload{p_write_to_depth_buffer}); }
+	void CommandStream::set_depth_test(bool p_depth_test)                { push(Command::DepthTest, BoolPayload{p_depth_test}); }
+	void CommandStream::set_depth_test_type(DepthTestType p_type)        { push(Command::DepthTestType, p_type); }
+	void CommandStream::set_polygon_offset(bool p_polygon_offset)        { push(Command::PolygonOffset, BoolPayload{p_polygon_offset}); }
+	void CommandStream::set_polygon_offset_factor(GLfloat p_polygon_offset_factor, GLfloat p_polygon_offset_units)
+	{
+		push(Command::PolygonOffsetFactor, PolygonOffsetPayload{p_polygon_offset_factor, p_polygon_offset_units});
+	}
+	void CommandStream::set_blending(bool p_blend)                       { push(Command::Blending, BoolPayload{p_blend}); }
+	void CommandStream::set_blend_func(BlendFactorType p_source_factor, BlendFactorType p_destination_factor)
+	{
+		push(Command::BlendFunc, BlendFuncPayload{p_source_factor, p_destination_factor});
+	}
+	void CommandStream::set_cull_face(bool p_cull)                       { push(Command::CullFace, BoolPayload{p_cull}); }
+	void CommandStream::set_cull_face_type(CullFaceType p_cull_face_type) { push(Command::CullFaceType, p_cull_face_type); }
+	void CommandStream::set_front_face_orientation(FrontFaceOrientation p_front_face_orientation)
+	{
+		push(Command::FrontFaceOrientation, p_front_face_orientation);
+	}
+	void CommandStream::set_polygon_mode(PolygonMode p_polygon_mode)     { push(Command::PolygonMode, p_polygon_mode); }
+	void CommandStream::set_viewport(GLint p_x, GLint p_y, GLsizei p_width, GLsizei p_height)
+	{
+		push(Command::Viewport, ViewportPayload{p_x, p_y, p_width, p_height});
+	}
+
+	void CommandStream::set_uniform(GLint p_location, int p_value)              { push(Command::Uniform, UniformPayload{p_location, ShaderDataType::Int}, &p_value, sizeof(p_value)); }
+	void CommandStream::set_uniform(GLint p_location, unsigned int p_value)     { push(Command::Uniform, UniformPayload{p_location, ShaderDataType::UnsignedInt}, &p_value, sizeof(p_value)); }
+	void CommandStream::set_uniform(GLint p_location, float p_value)            { push(Command::Uniform, UniformPayload{p_location, ShaderDataType::Float}, &p_value, sizeof(p_value)); }
+	void CommandStream::set_uniform(GLint p_location, const glm::vec2& p_value) { push(Command::Uniform, UniformPayload{p_location, ShaderDataType::Vec2}, &p_value, sizeof(p_value)); }
+	void CommandStream::set_uniform(GLint p_location, const glm::vec3& p_value) { push(Command::Uniform, UniformPayload{p_location, ShaderDataType::Vec3}, &p_value, sizeof(p_value)); }
+	void CommandStream::set_uniform(GLint p_location, const glm::vec4& p_value) { push(Command::Uniform, UniformPayload{p_location, ShaderDataType::Vec4}, &p_value, sizeof(p_value)); }
+	void CommandStream::set_uniform(GLint p_location, const glm::mat2& p_value) { push(Command::Uniform, UniformPayload{p_location, ShaderDataType::Mat2}, &p_value, sizeof(p_value)); }
+	void CommandStream::set_uniform(GLint p_location, const glm::mat3& p_value) { push(Command::Uniform, UniformPayload{p_location, ShaderDataType::Mat3}, &p_value, sizeof(p_value)); }
+	void CommandStream::set_uniform(GLint p_location, const glm::mat4& p_value) { push(Command::Uniform, UniformPayload{p_location, ShaderDataType::Mat4}, &p_value, sizeof(p_value)); }
+
+	void CommandStream::named_buffer_sub_data(GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_size, const void* p_data)
+	{
+		push(Command::BufferSubData, BufferSubDataPayload{p_buffer, p_offset, p_size}, p_data, static_cast<size_t>(p_size));
+	}
+	void CommandStream::copy_named_buffer_sub_data(GLHandle p_source_buffer, GLHandle p_destination_buffer, GLintptr p_source_offset, GLintptr p_destination_offset, GLsizeiptr p_size)
+	{
+		push(Command::CopyBufferSubData, CopyBufferPayload{p_source_buffer, p_destination_buffer, p_source_offset, p_destination_offset, p_size});
+	}
+	void CommandStream::clear_named_buffer_sub_data(GLHandle p_buffer, GLenum p_internal_format, GLintptr p_offset, GLsizeiptr p_size, GLenum p_format, GLenum p_type)
+	{
+		push(Command::ClearBufferSubData, ClearBufferPayload{p_buffer, p_internal_format, p_offset, p_size, p_format, p_type});
+	}
+	void CommandStream::delete_buffer(GLHandle p_buffer) { push(Command::DeleteBuffer, HandlePayload{p_buffer}); }
+
+	void CommandStream::uniform_block_binding(GLHandle p_shader_program, GLuint p_block_index, GLuint p_binding)
+	{
+		push(Command::UniformBlockBinding, BlockBindingPayload{p_shader_program, p_block_index, p_binding});
+	}
+	void CommandStream::shader_storage_block_binding(GLHandle p_shader_program, GLuint p_block_index, GLuint p_binding)
+	{
+		push(Command::ShaderStorageBlockBinding, BlockBindingPayload{p_shader_program, p_block_index, p_binding});
+	}
+
+	void CommandStream::clear_colour(GLHandle p_FBO, const glm::vec4& p_colour) { push(Command::ClearColour, ClearColourPayload{p_FBO, p_colour}); }
+	void CommandStream::clear_depth(GLHandle p_FBO, GLfloat p_depth)            { push(Command::ClearDepth, ClearDepthPayload{p_FBO, p_depth, 0}); }
+	void CommandStream::clear_depth_stencil(GLHandle p_FBO, GLfloat p_depth, GLint p_stencil)
+	{
+		push(Command::ClearDepthStencil, ClearDepthPayload{p_FBO, p_depth, p_stencil});
+	}
+	void CommandStream::clear_stencil(GLHandle p_FBO, GLint p_stencil)          { push(Command::ClearStencil, ClearDepthPayload{p_FBO, 0.f, p_stencil}); }
+	void CommandStream::clear_depth_region(GLHandle p_texture, const glm::uvec2& p_offset, const glm::uvec2& p_size, GLfloat p_depth)
+	{
+		push(Command::ClearDepthRegion, ClearRegionPayload{p_texture, p_offset, p_size, p_depth});
+	}
+	void CommandStream::blit(GLHandle p_source_FBO, GLHandle p_destination_FBO, const glm::uvec2& p_src_min, const glm::uvec2& p_src_max,
+	                         const glm::uvec2& p_dst_min, const glm::uvec2& p_dst_max, GLuint p_mask, GLenum p_filter)
+	{
+		push(Command::Blit, BlitPayload{p_source_FBO, p_destination_FBO, p_src_min, p_src_max, p_dst_min, p_dst_max, p_mask, p_filter});
+	}
+
+	void CommandStream::draw_arrays(PrimitiveMode p_primitive_mode, GLint p_first, GLsizei p_count)
+	{
+		push(Command::DrawArrays, DrawPayload{p_primitive_mode, p_first, p_count, 1});
+	}
+	void CommandStream::draw_arrays_instanced(PrimitiveMode p_primitive_mode, GLint p_first, GLsizei p_array_size, GLsizei p_instance_count)
+	{
+		push(Command::DrawArraysInstanced, DrawPayload{p_primitive_mode, p_first, p_array_size, p_instance_count});
+	}
+	void CommandStream::draw_elements(PrimitiveMode p_primitive_mode, GLsizei p_elements_size, GLsizei p_first_element)
+	{
+		push(Command::DrawElements, DrawPayload{p_primitive_mode, p_first_element, p_elements_size, 1});
+	}
+	void CommandStream::draw_elements_instanced(PrimitiveMode p_primitive_mode, GLsizei p_elements_size, GLsizei p_instance_count, GLsizei p_first_element)
+	{
+		push(Command::DrawElementsInstanced, DrawPayload{p_primitive_mode, p_first_element, p_elements_size, p_instance_count});
+	}
+	void CommandStream::dispatch_compute(GLuint p_num_groups_x, GLuint p_num_groups_y, GLuint p_num_groups_z)
+	{
+		push(Command::DispatchCompute, DispatchPayload{p_num_groups_x, p_num_groups_y, p_num_groups_z});
+	}
+	void CommandStream::memory_barrier(MemoryBarrierBitfield p_barrier_bitfield)
+	{
+		push(Command::MemoryBarrier, MemoryBarrierPayload{p_barrier_bitfield.bitfield});
+	}
+
+	void CommandStream::replay() const
+	{
+		ASSERT(State::Get().recording() == nullptr, "Replaying a CommandStream while recording would record it again.");
+		auto& state = State::Get();
+
+		for (size_t offset = 0; offset < m_bytes.size();)
+		{
+			const auto header        = read<Header>(m_bytes.data() + offset);
+			const std::byte* payload = m_bytes.data() + offset + sizeof(Header);
+			offset += sizeof(Header) + header.payload_size;
+
+			switch (header.command)
+			{
+				case Command::UseProgram: state.use_program(read<HandlePayload>(payload).handle); break;
+				case Command::BindVAO:    state.bind_VAO(read<HandlePayload>(payload).handle);    break;
+				case Command::BindFBO:    state.bind_FBO(read<HandlePayload>(payload).handle);    break;
+				case Command::BindShaderStorageBuffer:
+				{
+					const auto range = read<BufferRangePayload>(payload);
+					state.bind_shader_storage_buffer(range.index, range.buffer, range.offset, range.size);
+					break;
+				}
+				case Command::BindUniformBuffer:
+				{
+					const auto range = read<BufferRangePayload>(payload);
+					state.bind_uniform_buffer(range.index, range.buffer, range.offset, range.size);
+					break;
+				}
+				case Command::BindTextureUnit:
+				{
+					const auto binding = read<TextureUnitPayload>(payload);
+					state.bind_texture_unit(binding.texture_unit, binding.texture);
+					break;
+				}
+				case Command::DepthWrite:    state.set_depth_write(read<BoolPayload>(payload).value);        break;
+				case Command::DepthTest:     state.set_depth_test(read<BoolPayload>(payload).value);         break;
+				case Command::DepthTestType: state.set_depth_test_type(read<DepthTestType>(payload));        break;
+				case Command::PolygonOffset: state.set_polygon_offset(read<BoolPayload>(payload).value);     break;
+				case Command::PolygonOffsetFactor:
+				{
+					const auto polygon_offset = read<PolygonOffsetPayload>(payload);
+					state.set_polygon_offset_factor(polygon_offset.factor, polygon_offset.units);
+					break;
+				}
+				case Command::Blending: state.set_blending(read<BoolPayload>(payload).value); break;
+				case Command::BlendFunc:
+				{
+					const auto blend_func = read<BlendFuncPayload>(payload);
+					state.set_blend_func(blend_func.source_factor, blend_func.destination_factor);
+					break;
+				}
+				case Command::CullFace:             state.set_cull_face(read<BoolPayload>(payload).value);                      break;
+				case Command::CullFaceType:         state.set_cull_face_type(read<CullFaceType>(payload));                      break;
+				case Command::FrontFaceOrientation: state.set_front_face_orientation(read<FrontFaceOrientation>(payload));      break;
+				case Command::PolygonMode:          state.set_polygon_mode(read<PolygonMode>(payload));                        break;
+				case Command::Viewport:
+				{
+					const auto viewport = read<ViewportPayload>(payload);
+					state.set_viewport(viewport.x, viewport.y, viewport.width, viewport.height);
+					break;
+				}
+				case Command::Uniform:
+				{
+					const auto uniform     = read<UniformPayload>(payload);
+					const std::byte* value = payload + sizeof(UniformPayload);
+					switch (uniform.type)
+					{
+						case ShaderDataType::Int:         glUniform1i(uniform.location, read<GLint>(value));                                       break;
+						case ShaderDataType::UnsignedInt: glUniform1ui(uniform.location, read<GLuint>(value));                                     break;
+						case ShaderDataType::Float:       glUniform1f(uniform.location, read<GLfloat>(value));                                     break;
+						case ShaderDataType::Vec2:        glUniform2fv(uniform.location, 1, glm::value_ptr(read<glm::vec2>(value)));               break;
+						case ShaderDataType::Vec3:        glUniform3fv(uniform.location, 1, glm::value_ptr(read<glm::vec3>(value)));               break;
+						case ShaderDataType::Vec4:        glUniform4fv(uniform.location, 1, glm::value_ptr(read<glm::vec4>(value)));               break;
+						case ShaderDataType::Mat2:        glUniformMatrix2fv(uniform.location, 1, GL_FALSE, glm::value_ptr(read<glm::mat2>(value))); break;
+						case ShaderDataType::Mat3:        glUniformMatrix3fv(uniform.location, 1, GL_FALSE, glm::value_ptr(read<glm::mat3>(value))); break;
+						case ShaderDataType::Mat4:        glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(read<glm::mat4>(value))); break;
+						default: ASSERT(false, "Uniform type not supported by CommandStream."); break;
+					}
+					break;
+				}
+				case Command::BufferSubData:
+				{
+					const auto upload = read<BufferSubDataPayload>(payload);
+					OpenGL::named_buffer_sub_data(upload.buffer, upload.offset, upload.size, payload + sizeof(BufferSubDataPayload));
+					break;
+				}
+				case Command::CopyBufferSubData:
+				{
+					const auto copy = read<CopyBufferPayload>(payload);
+					OpenGL::copy_named_buffer_sub_data(copy.source_buffer, copy.destination_buffer, copy.source_offset, copy.destination_offset, copy.size);
+					break;
+				}
+				case Command::ClearBufferSubData:
+				{
+					const auto clear = read<ClearBufferPayload>(payload);
+					OpenGL::clear_named_buffer_sub_data(clear.buffer, clear.internal_format, clear.offset, clear.size, clear.format, clear.type, nullptr);
+					break;
+				}
+				case Command::DeleteBuffer: state.delete_buffer(read<HandlePayload>(payload).handle); break;
+				case Command::UniformBlockBinding:
+				{
+					const auto binding = read<BlockBindingPayload>(payload);
+					glUniformBlockBinding(binding.shader_program, binding.block_index, binding.binding);
+					break;
+				}
+				case Command::ShaderStorageBlockBinding:
+				{
+					const auto binding = read<BlockBindingPayload>(payload);
+					glShaderStorageBlockBinding(binding.shader_program, binding.block_index, binding.binding);
+					break;
+				}
+				case Command::ClearColour:
+				{
+					const auto clear = read<ClearColourPayload>(payload);
+					glClearNamedFramebufferfv(clear.FBO, GL_COLOR, 0, glm::value_ptr(clear.colour));
+					break;
+				}
+				case Command::ClearDepth:
+				{
+					const auto clear = read<ClearDepthPayload>(payload);
+					glClearNamedFramebufferfv(clear.FBO, GL_DEPTH, 0, &clear.depth);
+					break;
+				}
+				case Command::ClearDepthStencil:
+				{
+					const auto clear = read<ClearDepthPayload>(payload);
+					glClearNamedFramebufferfi(clear.FBO, GL_DEPTH_STENCIL, 0, clear.depth, clear.stencil);
+					break;
+				}
+				case Command::ClearStencil:
+				{
+					const auto clear = read<ClearDepthPayload>(payload);
+					glClearNamedFramebufferiv(clear.FBO, GL_STENCIL, 0, &clear.stencil);
+					break;
+				}
+				case Command::ClearDepthRegion:
+				{
+					const auto clear = read<ClearRegionPayload>(payload);
+					glClearTexSubImage(clear.texture, 0, clear.offset.x, clear.offset.y, 0, clear.size.x, clear.size.y, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &clear.depth);
+					break;
+				}
+				case Command::Blit:
+				{
+					const auto blit = read<BlitPayload>(payload);
+					glBlitNamedFramebuffer(blit.source_FBO, blit.destination_FBO,
+					                       blit.src_min.x, blit.src_min.y, blit.src_max.x, blit.src_max.y,
+					                       blit.dst_min.x, blit.dst_min.y, blit.dst_max.x, blit.dst_max.y,
+					                       blit.mask, blit.filter);
+					break;
+				}
+				case Command::DrawArrays:
+				{
+					const auto draw = read<DrawPayload>(payload);
+					OpenGL::draw_arrays(draw.primitive_mode, draw.first, draw.count);
+					break;
+				}
+				case Command::DrawArraysInstanced:
+				{
+					const auto draw = read<DrawPayload>(payload);
+					OpenGL::draw_arrays_instanced(draw.primitive_mode, draw.first, draw.count, draw.instance_count);
+					break;
+				}
+				case Command::DrawElements:
+				{
+					const auto draw = read<DrawPayload>(payload);
+					OpenGL::draw_elements(draw.primitive_mode, draw.count, draw.first);
+					break;
+				}
+				case Command::DrawElementsInstanced:
+				{
+					const auto draw = read<DrawPayload>(payload);
+					OpenGL::draw_elements_instanced(draw.primitive_mode, draw.count, draw.instance_count, draw.first);
+					break;
+				}
+				case Command::DispatchCompute:
+				{
+					const auto dispatch = read<DispatchPayload>(payload);
+					OpenGL::dispatch_compute(dispatch.num_groups_x, dispatch.num_groups_y, dispatch.num_groups_z);
+					break;
+				}
+				case Command::MemoryBarrier: glMemoryBarrier(read<MemoryBarrierPayload>(payload).bitfield); break;
+				default: ASSERT(false, "Unknown CommandStream command {}.", static_cast<int>(header.command)); break;
+			}
+		}
+	}
+} // namespace OpenGL
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "GLState.hpp"
+
+#include "glm/mat2x2.hpp"
+#include "glm/mat3x3.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OpenGL
+{
+	// The GL commands of a frame recorded into a byte stream instead of being issued to the context.
+	// While a stream is recording (State::begin_recording), State, the draw and buffer upload, copy and clear functions, the Shader uniform and block bindings
+	// and the FBO clears and blits append their command to the stream. GL objects are still created and allocated on the context, only the commands issued
+	// per frame are recorded. Buffer deletes are recorded too so the buffers the earlier commands use outlive them.
+	// Recording needs a current context, creating the shaders and mapping the buffers a frame uses queries it, so a stream is not a headless capture.
+	// Recording a frame defers issuing its commands, separating the CPU cost of building it from the driver and counting its draws for regression tests.
+	class CommandStream
+	{
+	public:
+		enum class Command : uint8_t
+		{
+			UseProgram,
+			BindVAO,
+			BindFBO,
+			BindShaderStorageBuffer,
+			BindUniformBuffer,
+			BindTextureUnit,
+			DepthWrite,
+			DepthTest,
+			DepthTestType,
+			PolygonOffset,
+			PolygonOffsetFactor,
+			Blending,
+			BlendFunc,
+			CullFace,
+			CullFaceType,
+			FrontFaceOrientation,
+			PolygonMode,
+			Viewport,
+			Uniform,
+			BufferSubData,
+			CopyBufferSubData,
+			ClearBufferSubData,
+			DeleteBuffer,
+			UniformBlockBinding,
+			ShaderStorageBlockBinding,
+			ClearColour,
+			ClearDepth,
+			ClearDepthStencil,
+			ClearStencil,
+			ClearDepthRegion,
+			Blit,
+			DrawArrays,
+			DrawArraysInstanced,
+			DrawElements,
+			DrawElementsInstanced,
+			DispatchCompute,
+			MemoryBarrier,
+			Count
+		};
+		static constexpr size_t Command_Count = static_cast<size_t>(Command::Count);
+
+		// Issue the recorded commands to the context in order.
+		// Binds and state changes go through State so its cache follows the context. Ranges of a RingBuffer the stream binds are only valid
+		// until the ring reuses them, replay a frame before RingBuffer::Region_Count more frames have ended.
+		void replay() const;
+		void clear();
+
+		bool empty() const                       { return m_command_count == 0; }
+		size_t command_count() const             { return m_command_count; }
+		size_t count(Command p_command) const    { return m_counts[static_cast<size_t>(p_command)]; }
+		// Draws and compute dispatches recorded.
+		size_t draw_count() const;
+		// Bytes the stream holds, including the copies of the uploaded buffer data.
+		size_t size_bytes() const                { return m_bytes.size(); }
+
+		void use_program(GLHandle p_shader_program);
+		void bind_VAO(GLHandle p_VAO);
+		void bind_FBO(GLHandle p_FBO);
+		void bind_shader_storage_buffer(GLuint p_index, GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_size);
+		void bind_uniform_buffer(GLuint p_index, GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_size);
+		void bind_texture_unit(GLuint p_texture_unit, GLHandle p_texture);
+
+		void set_depth_write(bool p_write_to_depth_buffer);
+		void set_depth_test(bool p_depth_test);
+		void set_depth_test_type(DepthTestType p_type);
+		void set_polygon_offset(bool p_polygon_offset);
+		void set_polygon_offset_factor(GLfloat p_polygon_offset_factor, GLfloat p_polygon_offset_units);
+		void set_blending(bool p_blend);
+		void set_blend_func(BlendFactorType p_source_factor, BlendFactorType p_destination_factor);
+		void set_cull_face(bool p_cull);
+		void set_cull_face_type(CullFaceType p_cull_face_type);
+		void set_front_face_orientation(FrontFaceOrientation p_front_face_orientation);
+		void set_polygon_mode(PolygonMode p_polygon_mode);
+		void set_viewport(GLint p_x, GLint p_y, GLsizei p_width, GLsizei p_height);
+
+		// Set the uniform at p_location of the program in use when the command is replayed.
+		void set_uniform(GLint p_location, int p_value);
+		void set_uniform(GLint p_location, unsigned int p_value);
+		void set_uniform(GLint p_location, float p_value);
+		void set_uniform(GLint p_location, const glm::vec2& p_value);
+		void set_uniform(GLint p_location, const glm::vec3& p_value);
+		void set_uniform(GLint p_location, const glm::vec4& p_value);
+		void set_uniform(GLint p_location, const glm::mat2& p_value);
+		void set_uniform(GLint p_location, const glm::mat3& p_value);
+		void set_uniform(GLint p_location, const glm::mat4& p_value);
+
+		// Copies p_size bytes of p_data into the stream, p_data can be reused as soon as this returns.
+		void named_buffer_sub_data(GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_size, const void* p_data);
+		void copy_named_buffer_sub_data(GLHandle p_source_buffer, GLHandle p_destination_buffer, GLintptr p_source_offset, GLintptr p_destination_offset, GLsizeiptr p_size);
+		// Clear the range to zero, clearing to a value is not recorded.
+		void clear_named_buffer_sub_data(GLHandle p_buffer, GLenum p_internal_format, GLintptr p_offset, GLsizeiptr p_size, GLenum p_format, GLenum p_type);
+		// Buffers deleted while recording stay alive until replay, earlier commands of the stream can still reference them.
+		void delete_buffer(GLHandle p_buffer);
+
+		// Assign the block p_block_index of p_shader_program to a binding point, Shader::bind_uniform_block and bind_shader_storage_block.
+		void uniform_block_binding(GLHandle p_shader_program, GLuint p_block_index, GLuint p_binding);
+		void shader_storage_block_binding(GLHandle p_shader_program, GLuint p_block_index, GLuint p_binding);
+
+		void clear_colour(GLHandle p_FBO, const glm::vec4& p_colour);
+		void clear_depth(GLHandle p_FBO, GLfloat p_depth);
+		void clear_depth_stencil(GLHandle p_FBO, GLfloat p_depth, GLint p_stencil);
+		void clear_stencil(GLHandle p_FBO, GLint p_stencil);
+		// Clear a region of the depth texture p_texture, see FBO::clear_depth.
+		void clear_depth_region(GLHandle p_texture, const glm::uvec2& p_offset, const glm::uvec2& p_size, GLfloat p_depth);
+		//@param p_mask Combination of the GL colour, depth and stencil buffer bits to copy.
+		//@param p_filter GL interpolation filter applied if the source and destination sizes differ.
+		void blit(GLHandle p_source_FBO, GLHandle p_destination_FBO, const glm::uvec2& p_src_min, const glm::uvec2& p_src_max,
+		          const glm::uvec2& p_dst_min, const glm::uvec2& p_dst_max, GLuint p_mask, GLenum p_filter);
+
+		void draw_arrays(PrimitiveMode p_primitive_mode, GLint p_first, GLsizei p_count);
+		void draw_arrays_instanced(PrimitiveMode p_primitive_mode, GLint p_first, GLsizei p_array_size, GLsizei p_instance_count);
+		void draw_elements(PrimitiveMode p_primitive_mode, GLsizei p_elements_size, GLsizei p_first_element);
+		void draw_elements_instanced(PrimitiveMode p_primitive_mode, GLsizei p_elements_size, GLsizei p_instance_count, GLsizei p_first_element);
+		void dispatch_compute(GLuint p_num_groups_x, GLuint p_num_groups_y, GLuint p_num_groups_z);
+		void memory_barrier(MemoryBarrierBitfield p_barrier_bitfield);
+
+	private:
+		// Every command is a Header followed by its payload, payload_size bytes that are copied in and out unaligned.
+		struct Header
+		{
+			Command command;
+			uint32_t payload_size;
+		};
+		template <typename Payload>
+		void push(Command p_command, const Payload& p_payload, const void* p_data = nullptr, size_t p_data_size = 0);
+
+		std::vector<std::byte> m_bytes;
+		std::array<size_t, Command_Count> m_counts = {};
+		size_t m_command_count                     = 0;
+	};
+} // namespace OpenGL
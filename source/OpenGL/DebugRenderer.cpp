@@ -1,6 +1,7 @@
 #include "DebugRenderer.hpp"
 #include "OpenGL/GLState.hpp"
 #include "OpenGL/DrawCall.hpp"
+#include "OpenGL/UniformIDs.hpp"
 
 #include "Component/Collider.hpp"
 #include "Component/Lights.hpp"
@@ -36,34 +37,48 @@ namespace OpenGL
 		m_bound_shader          = {"uniformColour"};
 		m_light_position_shader = {"light_position"};
 
+		{// The debug geometry is rebuilt every frame, its vertices are streamed into the RingBuffer and drawn through these.
+			constexpr GLuint vertex_buffer_binding_point = 0;
+			const std::vector<VertexAttributeMeta> attributes = {
+				{0, 3, BufferDataType::Float, offsetof(Data::ColourVertex, position), vertex_buffer_binding_point, false},
+				{2, 4, BufferDataType::Float, offsetof(Data::ColourVertex, colour),   vertex_buffer_binding_point, false}
+			};
+			m_line_VAO.emplace();
+			m_line_VAO->set_vertex_attrib_pointers(PrimitiveMode::Lines, attributes);
+			m_tri_VAO.emplace();
+			m_tri_VAO->set_vertex_attrib_pointers(PrimitiveMode::Triangles, attributes);
+		}
+
 		{// Create a cube meshes to represent AABBs.
 			{
 				auto mb = Utility::MeshBuilder<Data::PositionVertex, PrimitiveMode::Lines>{};
 				mb.add_cuboid(Geometry::Cuboid(glm::vec3(0.f), glm::vec3(0.5f)));
-				m_AABB_outline_mesh = mb.get_mesh();
+				m_AABB_outline_mesh = mb.get_indexed_mesh();
 			}
 			{
 				auto mb = Utility::MeshBuilder<Data::PositionVertex, PrimitiveMode::Triangles>{};
 				mb.add_cuboid(Geometry::Cuboid(glm::vec3(0.f), glm::vec3(0.5f)));
-				m_AABB_filled_mesh = mb.get_mesh();
+				m_AABB_filled_mesh = mb.get_indexed_mesh();
 			}
 		}
 		{// Make the point light mesh
 			auto mb = Utility::MeshBuilder<Data::PositionVertex, OpenGL::PrimitiveMode::Triangles>{};
 			mb.add_icosphere(glm::vec3(0.f), 1.f, 1);
-			m_point_light_mesh = mb.get_mesh();
+			m_point_light_mesh = mb.get_indexed_mesh();
 		}
 	}
 	void DebugRenderer::deinit()
 	{
 		m_debug_shader.reset();
+		m_line_VAO.reset();
+		m_tri_VAO.reset();
 	}
 	void DebugRenderer::clear()
 	{
 		m_line_mb.clear();
 		m_tri_mb.clear();
 	}
-	void DebugRenderer::render(System::SceneSystem& p_scene, const Buffer& p_view_properties, const Buffer& p_point_lights_buffer, const FBO& p_target_FBO)
+	void DebugRenderer::render(System::SceneSystem& p_scene, const RingBuffer::Range& p_view_properties, const Buffer& p_point_lights_buffer, const FBO& p_target_FBO, RingBuffer& p_frame_data)
 	{
 		PERF(DebugRendererRender);
 
@@ -84,9 +99,9 @@ namespace OpenGL
 					dc.m_polygon_offset_enabled = true;
 					dc.m_polygon_offset_factor  = opt.m_position_offset_factor;
 					dc.m_polygon_offset_units   = opt.m_position_offset_units;
-					dc.set_uniform("model", model);
-					dc.set_uniform("colour", glm::vec4(opt.m_bounding_box_colour, 1.f));
-					dc.set_UBO("ViewProperties", p_view_properties);
+					dc.set_uniform(Uniform::model, model);
+					dc.set_uniform(Uniform::colour, glm::vec4(opt.m_bounding_box_colour, 1.f));
+					dc.set_UBO(Uniform::ViewProperties, p_view_properties);
 					dc.submit(*m_bound_shader, m_AABB_outline_mesh->get_VAO(), p_target_FBO);
 				}
 				if (opt.m_fill_bounding_box)
@@ -97,9 +112,9 @@ namespace OpenGL
 					dc.m_polygon_offset_enabled = true;
 					dc.m_polygon_offset_factor  = opt.m_position_offset_factor;
 					dc.m_polygon_offset_units   = opt.m_position_offset_units;
-					dc.set_uniform("model", model);
-					dc.set_uniform("colour", glm::vec4(opt.m_bounding_box_colour, 0.2f));
-					dc.set_UBO("ViewProperties", p_view_properties);
+					dc.set_uniform(Uniform::model, model);
+					dc.set_uniform(Uniform::colour, glm::vec4(opt.m_bounding_box_colour, 0.2f));
+					dc.set_UBO(Uniform::ViewProperties, p_view_properties);
 					dc.submit(*m_bound_shader, m_AABB_filled_mesh->get_VAO(), p_target_FBO);
 				}
 			});
@@ -111,31 +126,28 @@ namespace OpenGL
 			if (point_light_count > 0)
 			{
 				DrawCall dc;
-				dc.set_uniform("scale", opt.m_light_position_scale);
-				dc.set_UBO("ViewProperties", p_view_properties);
-				dc.set_SSBO("PointLightsBuffer", p_point_lights_buffer);
+				dc.set_uniform(Uniform::scale, opt.m_light_position_scale);
+				dc.set_UBO(Uniform::ViewProperties, p_view_properties);
+				dc.set_SSBO(Uniform::PointLightsBuffer, p_point_lights_buffer);
 				dc.submit_instanced(*m_light_position_shader, m_point_light_mesh->get_VAO(), p_target_FBO, point_light_count);
 			}
 		}
 
-		if (!m_line_mb.empty())
+		const auto draw_streamed = [&](const auto& p_mesh_builder, VAO& p_VAO)
 		{
-			auto line_mesh = m_line_mb.get_mesh();
+			const auto& vertices = p_mesh_builder.get_data();
+			p_VAO.attach_buffer(p_frame_data.push(vertices), 0, sizeof(Data::ColourVertex), static_cast<GLsizei>(vertices.size()));
+
 			DrawCall dc;
 			dc.m_cull_face_enabled = false;
-			dc.m_blending_enabled  = line_mesh.has_alpha;
-			dc.set_UBO("ViewProperties", p_view_properties);
-			dc.submit(m_debug_shader.value(), line_mesh.get_VAO(), p_target_FBO);
-		}
+			dc.m_blending_enabled  = p_mesh_builder.get_descriptor().has_alpha;
+			dc.set_UBO(Uniform::ViewProperties, p_view_properties);
+			dc.submit(m_debug_shader.value(), p_VAO, p_target_FBO);
+		};
+		if (!m_line_mb.empty())
+			draw_streamed(m_line_mb, *m_line_VAO);
 		if (!m_tri_mb.empty())
-		{
-			auto tri_mesh = m_tri_mb.get_mesh();
-			DrawCall dc;
-			dc.m_cull_face_enabled = false;
-			dc.m_blending_enabled  = tri_mesh.has_alpha;
-			dc.set_UBO("ViewProperties", p_view_properties);
-			dc.submit(m_debug_shader.value(), tri_mesh.get_VAO(), p_target_FBO);
-		}
+			draw_streamed(m_tri_mb, *m_tri_VAO);
 	}
 
 	void DebugRenderer::add(const Geometry::Triangle& p_triangle, const glm::vec4& p_colour)
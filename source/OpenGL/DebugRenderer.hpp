@@ -1,6 +1,8 @@
 #pragma once
 
+#include "RingBuffer.hpp"
 #include "Shader.hpp"
+#include "Types.hpp"
 
 #include "Utility/MeshBuilder.hpp"
 #include "Component/Mesh.hpp"
@@ -42,6 +44,8 @@ namespace OpenGL
 	{
 		static inline Utility::MeshBuilder<Data::ColourVertex, PrimitiveMode::Lines> m_line_mb    = {};
 		static inline Utility::MeshBuilder<Data::ColourVertex, PrimitiveMode::Triangles> m_tri_mb = {};
+		static inline std::optional<VAO> m_line_VAO                                               = {}; // Draws m_line_mb streamed into the frame's RingBuffer.
+		static inline std::optional<VAO> m_tri_VAO                                                = {}; // Draws m_tri_mb streamed into the frame's RingBuffer.
 		static inline std::optional<Shader> m_debug_shader                                        = {};
 		static inline std::optional<Shader> m_bound_shader                                        = {};
 		static inline std::optional<Data::Mesh> m_AABB_outline_mesh                               = {};
@@ -76,7 +80,8 @@ namespace OpenGL
 		static void init();
 		static void deinit();
 		static void clear();
-		static void render(System::SceneSystem& p_scene, const Buffer& p_view_properties, const Buffer& p_point_lights_buffer, const FBO& p_target_FBO);
+		// The lines and triangles added this frame are written into p_frame_data instead of a new buffer every frame.
+		static void render(System::SceneSystem& p_scene, const RingBuffer::Range& p_view_properties, const Buffer& p_point_lights_buffer, const FBO& p_target_FBO, RingBuffer& p_frame_data);
 
 		static void add(const Geometry::Cone& p_cone,         const glm::vec4& p_colour = glm::vec4(1.f), size_t segments = m_debug_options.m_segments);
 		static void add(const Geometry::Cylinder& p_cylinder, const glm::vec4& p_colour = glm::vec4(1.f), size_t segments = m_debug_options.m_segments);
@@ -26,52 +26,56 @@ namespace OpenGL
 		, m_cull_face_type{CullFaceType::Back}
 		, m_front_face_orientation{FrontFaceOrientation::CounterClockwise}
 		, m_polygon_mode{PolygonMode::Fill}
+		, m_first_element{0}
+		, m_element_count{0}
 	{}
 
-	void DrawCall::set_texture(const std::string_view& p_identifier, const Texture& p_texture)
+	void DrawCall::set_texture(UniformID p_ID, const Texture& p_texture)
 	{
 		if (m_texture_count == max_textures)
 			throw std::logic_error{"Too many textures set for this drawcall. Up the max_textures variable!"};
-		if (p_identifier.size() >= max_texture_identifier_len)
-			throw std::logic_error("Texture name is too long! Up the max_texture_identifier_len variable!");
-		if (std::find_if(m_textures.begin(), m_textures.end(), [&p_identifier](const auto& p_texture) { return p_texture.m_identifier == p_identifier; }) != m_textures.end())
+		if (std::any_of(m_textures.begin(), m_textures.begin() + m_texture_count, [&p_ID](const auto& p_texture) { return p_texture.m_ID == p_ID; }))
 			throw std::logic_error{"Texture already set for this drawcall!"};
 
 		m_textures[m_texture_count].m_handle = p_texture.m_handle;
-		p_identifier.copy(m_textures[m_texture_count].m_identifier, p_identifier.size());
+		m_textures[m_texture_count].m_ID     = p_ID;
 		++m_texture_count;
 	}
-	void DrawCall::set_SSBO(const std::string_view& p_identifier, const Buffer& p_SSBO)
+	void DrawCall::set_SSBO(UniformID p_ID, const Buffer& p_SSBO)
+	{
+		// We bind the entire buffer to the SSBO binding point.
+		set_SSBO(p_ID, RingBuffer::Range{p_SSBO.m_handle, 0, static_cast<GLsizeiptr>(p_SSBO.m_used_capacity)});
+	}
+	void DrawCall::set_SSBO(UniformID p_ID, const RingBuffer::Range& p_range)
 	{
 		if (m_SSBO_count == max_SSBOs)
 			throw std::logic_error{"Too many SSBOs set for this drawcall. Up the max_SSBOs variable!"};
-		if (p_identifier.size() >= max_SSBO_identifier_len)
-			throw std::logic_error("SSBO name is too long! Up the max_SSBO_identifier_len variable!");
-		if (std::find_if(m_SSBOs.begin(), m_SSBOs.end(), [&p_identifier](const auto& p_SSBO) { return p_SSBO.m_identifier == p_identifier; }) != m_SSBOs.end())
+		if (std::any_of(m_SSBOs.begin(), m_SSBOs.begin() + m_SSBO_count, [&p_ID](const auto& p_SSBO) { return p_SSBO.m_ID == p_ID; }))
 			throw std::logic_error{"SSBO already set for this drawcall!"};
 
-		p_identifier.copy(m_SSBOs[m_SSBO_count].m_identifier, p_identifier.size());
-		m_SSBOs[m_SSBO_count].m_handle = p_SSBO.m_handle;
-		// We bind the entire buffer to the SSBO binding point.
-		m_SSBOs[m_SSBO_count].m_offset = 0;
-		m_SSBOs[m_SSBO_count].m_size   = p_SSBO.m_used_capacity;
+		m_SSBOs[m_SSBO_count].m_ID     = p_ID;
+		m_SSBOs[m_SSBO_count].m_handle = p_range.handle;
+		m_SSBOs[m_SSBO_count].m_offset = p_range.offset;
+		m_SSBOs[m_SSBO_count].m_size   = p_range.size;
 
 		++m_SSBO_count;
 	}
-	void DrawCall::set_UBO(const std::string_view& p_identifier, const Buffer& p_UBO)
+	void DrawCall::set_UBO(UniformID p_ID, const Buffer& p_UBO)
+	{
+		// We bind the entire buffer to the UBO binding point.
+		set_UBO(p_ID, RingBuffer::Range{p_UBO.m_handle, 0, static_cast<GLsizeiptr>(p_UBO.m_used_capacity)});
+	}
+	void DrawCall::set_UBO(UniformID p_ID, const RingBuffer::Range& p_range)
 	{
 		if (m_UBO_count == max_UBOs)
 			throw std::logic_error{"Too many UBOs set for this drawcall. Up the max_UBOs variable!"};
-		if (p_identifier.size() >= max_UBO_identifier_len)
-			throw std::logic_error("UBO name is too long! Up the max_UBO_identifier_len variable!");
-		if (std::find_if(m_UBOs.begin(), m_UBOs.end(), [&p_identifier](const auto& p_UBO) { return p_UBO.m_identifier == p_identifier; }) != m_UBOs.end())
+		if (std::any_of(m_UBOs.begin(), m_UBOs.begin() + m_UBO_count, [&p_ID](const auto& p_UBO) { return p_UBO.m_ID == p_ID; }))
 			throw std::logic_error{"UBO already set for this drawcall!"};
 
-		p_identifier.copy(m_UBOs[m_UBO_count].m_identifier, p_identifier.size());
-		m_UBOs[m_UBO_count].m_handle = p_UBO.m_handle;
-		// We bind the entire buffer to the UBO binding point.
-		m_UBOs[m_UBO_count].m_offset = 0;
-		m_UBOs[m_UBO_count].m_size   = p_UBO.m_used_capacity;
+		m_UBOs[m_UBO_count].m_ID     = p_ID;
+		m_UBOs[m_UBO_count].m_handle = p_range.handle;
+		m_UBOs[m_UBO_count].m_offset = p_range.offset;
+		m_UBOs[m_UBO_count].m_size   = p_range.size;
 		++m_UBO_count;
 	}
 
@@ -103,25 +107,25 @@ namespace OpenGL
 		State::Get().bind_VAO(p_VAO.m_handle);
 
 		for (GLuint i = 0; i < m_uniform_count; ++i)
-			std::visit([&](auto&& arg) { p_shader.set_uniform(m_uniforms[i].m_identifier, arg); }, m_uniforms[i].m_data);
+			std::visit([&](auto&& arg) { p_shader.set_uniform(m_uniforms[i].m_ID, arg); }, m_uniforms[i].m_data);
 
 		for (GLuint i = 0; i < m_texture_count; ++i)
 		{
 			// Set uniform sampler2D to the texture unit index.
 			// Then bind the texture to the same texture unit.
-			p_shader.bind_sampler_2D(m_textures[i].m_identifier, i);
+			p_shader.bind_sampler_2D(m_textures[i].m_ID, i);
 			State::Get().bind_texture_unit(i, m_textures[i].m_handle);
 		}
 		for (GLuint i = 0; i < m_SSBO_count; ++i)
 		{
 			// Bind the Shader storage block of the shader and the SSBO to the same binding point.
-			p_shader.bind_shader_storage_block(m_SSBOs[i].m_identifier, i);
+			p_shader.bind_shader_storage_block(m_SSBOs[i].m_ID, i);
 			State::Get().bind_shader_storage_buffer(i, m_SSBOs[i].m_handle, m_SSBOs[i].m_offset, m_SSBOs[i].m_size);
 		}
 		for (GLuint i = 0; i < m_UBO_count; ++i)
 		{
 			// Bind the Uniform block of the shader and the UBO to the same binding point.
-			p_shader.bind_uniform_block(m_UBOs[i].m_identifier, i);
+			p_shader.bind_uniform_block(m_UBOs[i].m_ID, i);
 			State::Get().bind_uniform_buffer(i, m_UBOs[i].m_handle, m_UBOs[i].m_offset, m_UBOs[i].m_size);
 		}
 	}
@@ -133,10 +137,11 @@ namespace OpenGL
 
 		pre_draw_call(p_shader, p_VAO, p_FBO.m_handle, p_viewport_pos, p_viewport_size);
 
+		const GLsizei count = m_element_count > 0 ? m_element_count : p_VAO.draw_count();
 		if (p_VAO.is_indexed())
-			draw_elements(p_VAO.draw_primitive_mode(), p_VAO.draw_count());
+			draw_elements(p_VAO.draw_primitive_mode(), count, m_first_element);
 		else
-			draw_arrays(p_VAO.draw_primitive_mode(), 0, p_VAO.draw_count());
+			draw_arrays(p_VAO.draw_primitive_mode(), m_first_element, count);
 	}
 	void DrawCall::submit(Shader& p_shader, const VAO& p_VAO, const FBO& p_FBO) const
 	{
@@ -144,12 +149,17 @@ namespace OpenGL
 	}
 	void DrawCall::submit_instanced(Shader& p_shader, const VAO& p_VAO, const FBO& p_FBO, GLsizei p_instanced_count) const
 	{
-		pre_draw_call(p_shader, p_VAO, p_FBO.m_handle, {0, 0}, p_FBO.m_resolution);
+		submit_instanced(p_shader, p_VAO, p_FBO, {0, 0}, p_FBO.m_resolution, p_instanced_count);
+	}
+	void DrawCall::submit_instanced(Shader& p_shader, const VAO& p_VAO, const FBO& p_FBO, const glm::uvec2& p_viewport_pos, const glm::uvec2& p_viewport_size, GLsizei p_instanced_count) const
+	{
+		pre_draw_call(p_shader, p_VAO, p_FBO.m_handle, p_viewport_pos, p_viewport_size);
 
+		const GLsizei count = m_element_count > 0 ? m_element_count : p_VAO.draw_count();
 		if (p_VAO.is_indexed())
-			draw_elements_instanced(p_VAO.draw_primitive_mode(), p_VAO.draw_count(), p_instanced_count);
+			draw_elements_instanced(p_VAO.draw_primitive_mode(), count, p_instanced_count, m_first_element);
 		else
-			draw_arrays_instanced(p_VAO.draw_primitive_mode(), 0, p_VAO.draw_count(), p_instanced_count);
+			draw_arrays_instanced(p_VAO.draw_primitive_mode(), m_first_element, count, p_instanced_count);
 	}
 	void DrawCall::submit_compute(Shader& p_shader, GLuint p_num_groups_x, GLuint p_num_groups_y, GLuint p_num_groups_z) const
 	{
@@ -159,19 +169,19 @@ namespace OpenGL
 		{
 			State::Get().use_program(p_shader.m_handle);
 			for (GLuint i = 0; i < m_uniform_count; ++i)
-				std::visit([&](auto&& arg) { p_shader.set_uniform(m_uniforms[i].m_identifier, arg); }, m_uniforms[i].m_data);
+				std::visit([&](auto&& arg) { p_shader.set_uniform(m_uniforms[i].m_ID, arg); }, m_uniforms[i].m_data);
 		}
 
 		for (GLuint i = 0; i < m_SSBO_count; ++i)
 		{
 			// Bind the Shader storage block of the shader and the SSBO to the same binding point.
-			p_shader.bind_shader_storage_block(m_SSBOs[i].m_identifier, i);
+			p_shader.bind_shader_storage_block(m_SSBOs[i].m_ID, i);
 			State::Get().bind_shader_storage_buffer(i, m_SSBOs[i].m_handle, m_SSBOs[i].m_offset, m_SSBOs[i].m_size);
 		}
 		for (GLuint i = 0; i < m_UBO_count; ++i)
 		{
 			// Bind the Uniform block of the shader and the UBO to the same binding point.
-			p_shader.bind_uniform_block(m_UBOs[i].m_identifier, i);
+			p_shader.bind_uniform_block(m_UBOs[i].m_ID, i);
 			State::Get().bind_uniform_buffer(i, m_UBOs[i].m_handle, m_UBOs[i].m_offset, m_UBOs[i].m_size);
 		}
 
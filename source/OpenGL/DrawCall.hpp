@@ -1,6 +1,8 @@
 #pragma once
 
 #include "GLState.hpp"
+#include "RingBuffer.hpp"
+#include "UniformID.hpp"
 
 #include "glm/glm.hpp"
 
@@ -8,6 +10,7 @@
 #include <array>
 #include <stdexcept>
 #include <string_view>
+#include <utility>
 #include <variant>
 
 namespace OpenGL
@@ -22,18 +25,14 @@ namespace OpenGL
 	// The DrawCall is submitted to the GL context by calling submit().
 	class DrawCall
 	{
-		static constexpr size_t max_uniforms               = 8;
-		static constexpr size_t max_uniform_identifier_len = 16;
-		static constexpr size_t max_textures               = 8;
-		static constexpr size_t max_texture_identifier_len = 16;
-		static constexpr size_t max_SSBO_identifier_len    = 32;
-		static constexpr size_t max_SSBOs                  = 8;
-		static constexpr size_t max_UBO_identifier_len     = 16;
-		static constexpr size_t max_UBOs                   = 8;
+		static constexpr size_t max_uniforms = 8;
+		static constexpr size_t max_textures = 8;
+		static constexpr size_t max_SSBOs    = 8;
+		static constexpr size_t max_UBOs     = 8;
 
 		struct UniformSetData // The data requires to set a uniform variable of a shader.
 		{
-			char m_identifier[max_uniform_identifier_len] = {};
+			UniformID m_ID;
 			std::variant<bool, unsigned int, int, float, glm::vec2, glm::vec3, glm::vec4, glm::mat2, glm::mat3, glm::mat4> m_data;
 		};
 		std::array<UniformSetData, max_uniforms> m_uniforms;
@@ -41,28 +40,28 @@ namespace OpenGL
 
 		struct TextureSetData // The data required to set a uniform sampler2D of a shader.
 		{
-			char m_identifier[max_texture_identifier_len] = {};
-			GLHandle m_handle                             = {};
+			UniformID m_ID;
+			GLHandle m_handle = {};
 		};
 		std::array<TextureSetData, max_textures> m_textures;
 		GLuint m_texture_count;
 
 		struct SSBOSetData
 		{
-			char m_identifier[max_SSBO_identifier_len] = {};
-			GLHandle m_handle                          = {};
-			GLintptr m_offset                          = 0;
-			GLsizeiptr m_size                          = 0;
+			UniformID m_ID;
+			GLHandle m_handle = {};
+			GLintptr m_offset = 0;
+			GLsizeiptr m_size = 0;
 		};
 		std::array<SSBOSetData, max_SSBOs> m_SSBOs;
 		GLuint m_SSBO_count;
 
 		struct UBOSetData
 		{
-			char m_identifier[max_UBO_identifier_len] = {};
-			GLHandle m_handle                         = {};
-			GLintptr m_offset                         = 0;
-			GLsizeiptr m_size                         = 0;
+			UniformID m_ID;
+			GLHandle m_handle = {};
+			GLintptr m_offset = 0;
+			GLsizeiptr m_size = 0;
 		};
 		std::array<UBOSetData, max_UBOs> m_UBOs;
 		GLuint m_UBO_count;
@@ -83,26 +82,38 @@ namespace OpenGL
 		CullFaceType m_cull_face_type;
 		FrontFaceOrientation m_front_face_orientation;
 		PolygonMode m_polygon_mode;
+		GLsizei m_first_element; // First index (vertex if the VAO is not indexed) to draw from. Used to draw a Data::MeshLOD.
+		GLsizei m_element_count; // Number of indices (vertices if the VAO is not indexed) to draw. 0 draws the whole VAO.
 
 		DrawCall() noexcept;
 
+		// Set the GLSL uniform p_ID of the shader the draw is submitted with.
+		// The identifier overloads intern the identifier on every call, draws set often should keep a UniformID.
 		template <typename T>
-		void set_uniform(const std::string_view& p_identifier, T&& p_value)
+		void set_uniform(UniformID p_ID, T&& p_value)
 		{
 			if (m_uniform_count == max_uniforms)
 				throw std::logic_error{"Too many uniforms set for this drawcall. Up the max_uniforms variable!"};
-			if (p_identifier.size() >= max_uniform_identifier_len)
-				throw std::logic_error("Uniform name is too long! Up the max_uniform_identifier_len variable!");
-			if (std::find_if(m_uniforms.begin(), m_uniforms.end(), [&p_identifier](const auto& p_uniform) { return p_uniform.m_identifier == p_identifier; }) != m_uniforms.end())
+			if (std::any_of(m_uniforms.begin(), m_uniforms.begin() + m_uniform_count, [&p_ID](const auto& p_uniform) { return p_uniform.m_ID == p_ID; }))
 				throw std::logic_error{"Uniform already set for this drawcall!"};
 
 			m_uniforms[m_uniform_count].m_data = p_value;
-			p_identifier.copy(m_uniforms[m_uniform_count].m_identifier, p_identifier.size());
+			m_uniforms[m_uniform_count].m_ID   = p_ID;
 			++m_uniform_count;
 		}
-		void set_texture(const std::string_view& p_identifier, const Texture& p_texture);
-		void set_SSBO(const std::string_view& p_identifier, const Buffer& p_SSBO);
-		void set_UBO(const std::string_view& p_identifier, const Buffer& p_UBO);
+		template <typename T>
+		void set_uniform(std::string_view p_identifier, T&& p_value) { set_uniform(UniformID{p_identifier}, std::forward<T>(p_value)); }
+		void set_texture(UniformID p_ID, const Texture& p_texture);
+		void set_texture(std::string_view p_identifier, const Texture& p_texture) { set_texture(UniformID{p_identifier}, p_texture); }
+		void set_SSBO(UniformID p_ID, const Buffer& p_SSBO);
+		void set_SSBO(std::string_view p_identifier, const Buffer& p_SSBO) { set_SSBO(UniformID{p_identifier}, p_SSBO); }
+		// Bind a range of a RingBuffer allocated this frame, the range must outlive the submit of this drawcall.
+		void set_SSBO(UniformID p_ID, const RingBuffer::Range& p_range);
+		void set_SSBO(std::string_view p_identifier, const RingBuffer::Range& p_range) { set_SSBO(UniformID{p_identifier}, p_range); }
+		void set_UBO(UniformID p_ID, const Buffer& p_UBO);
+		void set_UBO(std::string_view p_identifier, const Buffer& p_UBO) { set_UBO(UniformID{p_identifier}, p_UBO); }
+		void set_UBO(UniformID p_ID, const RingBuffer::Range& p_range);
+		void set_UBO(std::string_view p_identifier, const RingBuffer::Range& p_range) { set_UBO(UniformID{p_identifier}, p_range); }
 
 		// Submit the drawcall to the GL context using the provided p_shader and p_VAO drawing into the p_FBO.
 		//@param p_shader The shader to use for the drawcall.
@@ -122,6 +133,14 @@ namespace OpenGL
 		//@param p_instanced_count The number of instances to draw.
 		//@param p_FBO The FBO to draw into.
 		void submit_instanced(Shader& p_shader, const VAO& p_VAO, const FBO& p_FBO, GLsizei p_instanced_count) const;
+		// Submit the drawcall to the GL context using the provided p_shader and p_VAO drawing into the p_FBO with a specified viewport position and size.
+		//@param p_shader The shader to use for the drawcall.
+		//@param p_VAO The VAO to use for the drawcall.
+		//@param p_FBO The FBO to draw into.
+		//@param p_viewport_pos The position of the viewport.
+		//@param p_viewport_size The size of the viewport.
+		//@param p_instanced_count The number of instances to draw.
+		void submit_instanced(Shader& p_shader, const VAO& p_VAO, const FBO& p_FBO, const glm::uvec2& p_viewport_pos, const glm::uvec2& p_viewport_size, GLsizei p_instanced_count) const;
 
 		// Launch a compute shader p_shader with the provided number of groups.
 		void submit_compute(Shader& p_shader, GLuint p_num_groups_x, GLuint p_num_groups_y, GLuint p_num_groups_z) const;
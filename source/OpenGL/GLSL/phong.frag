@@ -1,29 +1,55 @@
 #version 460 core
 
-uniform float shininess;
-
-#ifdef UNIFORM_COLOUR
-	uniform vec4 uColour;
+#ifdef INSTANCED
+	// The material of each instance is passed on from the InstancesBuffer by phong.vert.
+	#define shininess fs_in.instance_shininess
+	#define uColour fs_in.instance_colour
 #else
-	uniform sampler2D diffuse;
-	uniform sampler2D specular;
+	uniform float shininess;
+	uniform vec4 uColour; // Unused without UNIFORM_COLOUR.
 #endif
+// Unused with UNIFORM_COLOUR.
+uniform sampler2D diffuse;
+uniform sampler2D specular;
 
 #ifdef SHADOWS
 	uniform float PCF_bias;
-	uniform sampler2D shadow_map;
+	uniform sampler2D shadow_map; // Atlas of the depth maps of each cascade.
 
-	float shadow_calculation(vec4 frag_position_light_space)
+	// Matches OpenGL::ShadowMapper::Cascade.
+	struct ShadowCascade
 	{
-		// If the depth of the frag_position_light_space is larger than the closest depth from the light perspective.
-		// The fragment being rendered is ocluded.
+		mat4 light_proj_view;
+		vec4 atlas_rect; // xy: Offset, zw: Scale of the cascade inside shadow_map.
+	};
+	layout(std430) readonly buffer ShadowCascadesBuffer
+	{
+		vec4 cascade_splits; // View depth each cascade covers up to.
+		uint cascade_count;
+		ShadowCascade cascades[];
+	};
 
+	float shadow_calculation(vec3 p_frag_position, float p_view_depth)
+	{
+		// Use the nearest cascade covering the fragment, past the last cascade nothing is shadowed.
+		if (cascade_count == 0 || p_view_depth > cascade_splits[cascade_count - 1])
+			return 1.0;
+		uint cascade = 0;
+		while (p_view_depth > cascade_splits[cascade])
+			cascade++;
+
+		// If the depth of the fragment in light space is larger than the closest depth from the light perspective.
+		// The fragment being rendered is ocluded.
+		vec4 frag_position_light_space = cascades[cascade].light_proj_view * vec4(p_frag_position, 1.0);
 		// perform perspective divide + transfrom to [0,1] texture space
 		vec3 projected_coords = ((frag_position_light_space.xyz / frag_position_light_space.w) * 0.5) + 0.5;
+		if (any(lessThan(projected_coords, vec3(0.0))) || any(greaterThan(projected_coords, vec3(1.0))))
+			return 1.0;
 		// get depth of current fragment from light's perspective
 		float frag_depth_light_space = projected_coords.z;
-		// get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-		float closest_depth = texture(shadow_map, projected_coords.xy).r;
+		// get closest depth value from light's perspective from the tile of the cascade in the atlas
+		vec2 atlas_coords   = cascades[cascade].atlas_rect.xy + projected_coords.xy * cascades[cascade].atlas_rect.zw;
+		float closest_depth = texture(shadow_map, atlas_coords).r;
 		// check whether current frag pos is in shadow
 		return frag_depth_light_space + PCF_bias > closest_depth ? 0.5 : 1.0;
 	}
@@ -89,13 +115,42 @@ layout(std430) buffer SpotLightsBuffer
 };
 vec4 spot_light_contribution(SpotLight p_light, vec3 p_frag_normal, vec3 p_frag_pos, vec3 p_view_direction);
 
+
+// The view frustrum split into a grid of clusters, each listing the point and spot lights reaching it. Matches OpenGL::LightClusters.
+struct LightCluster
+{
+	uint offset;      // Index into light_indices of the first point light, the spot lights follow the point lights.
+	uint point_count;
+	uint spot_count;
+	uint padding;
+};
+layout(std430) readonly buffer LightClustersBuffer
+{
+	uvec4 cluster_grid;    // xyz: Cluster count along each axis.
+	vec4 cluster_slicing;  // xy: Size in pixels of the screen tile of a cluster. z, w: Scale and bias mapping log(view depth) to a depth slice.
+	LightCluster clusters[];
+};
+layout(std430) readonly buffer LightIndicesBuffer
+{
+	uint light_indices[];
+};
+LightCluster find_cluster(vec2 p_frag_coord, float p_view_depth)
+{
+	uvec2 tile  = uvec2(max(p_frag_coord / cluster_slicing.xy, vec2(0.0)));
+	uint slice  = uint(max(log(p_view_depth) * cluster_slicing.z + cluster_slicing.w, 0.0));
+	uvec3 index = min(uvec3(tile, slice), cluster_grid.xyz - uvec3(1));
+	return clusters[index.x + cluster_grid.x * (index.y + cluster_grid.y * index.z)];
+}
+
 in VS_OUT {
 	vec3 position;
 	vec3 normal;
 	vec2 tex_coord;
 	vec4 camera_position;
-#ifdef SHADOWS
-	vec4 position_light_space;
+	float view_depth;
+#ifdef INSTANCED
+	flat vec4 instance_colour;
+	flat float instance_shininess;
 #endif
 } fs_in;
 out vec4 Colour;
@@ -107,13 +162,16 @@ void main()
 	vec3 frag_normal    = normalize(fs_in.normal);
 	vec3 view_direction = normalize(vec3(fs_in.camera_position) - fs_in.position);
 
-	for (uint i = 0; i < number_of_point_lights; i++)
+	// Only the lights reaching the cluster of this fragment contribute.
+	LightCluster cluster = find_cluster(gl_FragCoord.xy, fs_in.view_depth);
+	for (uint i = 0; i < cluster.point_count; i++)
 	{
-		Colour += point_light_contribution(point_lights[i], frag_normal, fs_in.position, view_direction);
+		Colour += point_light_contribution(point_lights[light_indices[cluster.offset + i]], frag_normal, fs_in.position, view_direction);
 	}
-	for (uint i = 0; i < number_of_spot_lights; i++)
+	uint spot_offset = cluster.offset + cluster.point_count;
+	for (uint i = 0; i < cluster.spot_count; i++)
 	{
-		Colour += spot_light_contribution(spot_lights[i], frag_normal, fs_in.position, view_direction);
+		Colour += spot_light_contribution(spot_lights[light_indices[spot_offset + i]], frag_normal, fs_in.position, view_direction);
 	}
 	for (uint i = 0; i < number_of_directional_lights; i++)
 	{
@@ -148,7 +206,7 @@ vec4 directional_light_contribution(DirectionalLight p_light, vec3 p_frag_normal
 	#endif
 
 	#ifdef SHADOWS
-		float shadow = shadow_calculation(fs_in.position_light_space);
+		float shadow = shadow_calculation(fs_in.position, fs_in.view_depth);
 		return vec4((ambient + (shadow * (diffuse + specular))).xyz, 1.0);
 	#else
 		return vec4((ambient + diffuse + specular).xyz, 1.0);
@@ -1,10 +1,32 @@
 #version 460 core
 
 layout (location = 0) in vec3 VertexPosition;
-layout (location = 1) in vec3 VertexNormal;
+#ifdef QUANTISED
+	layout (location = 1) in vec2 VertexNormal; // Octahedral encoded, see Data::Quantise::to_octahedral.
+#else
+	layout (location = 1) in vec3 VertexNormal;
+#endif
 layout (location = 3) in vec2 VertexTexCoord;
 
-uniform mat4 model;
+#ifdef INSTANCED
+	// Matches OpenGL::InstanceData.
+	struct Instance
+	{
+		mat4 model;
+		vec4 colour;
+		float shininess;
+	};
+	layout(std430) readonly buffer InstancesBuffer
+	{
+		Instance instances[];
+	};
+	uniform uint instance_offset; // Index of the first instance of this draw in instances.
+#else
+	uniform mat4 model;
+#endif
+#ifdef QUANTISED
+	uniform mat4 dequantise; // Maps the [0, 1] quantised positions into the mesh AABB, see Data::Mesh::dequantise_matrix.
+#endif
 
 layout(shared) uniform ViewProperties
 {
@@ -13,28 +35,50 @@ layout(shared) uniform ViewProperties
 	vec4 camera_position; // w component unused
 } viewProperties;
 
-#ifdef SHADOWS
-	uniform mat4 light_proj_view;
-#endif
-
 out VS_OUT {
 	vec3 position;
 	vec3 normal;
 	vec2 tex_coord;
 	vec4 camera_position;
-#ifdef SHADOWS
-	vec4 position_light_space;
+	float view_depth; // Distance along the view direction, picks the depth slice of the light cluster in phong.frag.
+#ifdef INSTANCED
+	flat vec4 instance_colour;
+	flat float instance_shininess;
 #endif
 } vs_out;
 
+#ifdef QUANTISED
+vec3 oct_decode(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+#endif
+
 void main()
 {
-	vs_out.position             = vec3(model * vec4(VertexPosition, 1.0));
-	vs_out.normal               = mat3(transpose(inverse(model))) * VertexNormal;
-	vs_out.tex_coord            = VertexTexCoord;
-#ifdef SHADOWS
-	vs_out.position_light_space = light_proj_view * vec4(vs_out.position, 1.0);
+#ifdef INSTANCED
+	Instance instance         = instances[instance_offset + gl_InstanceID];
+	mat4 model                = instance.model;
+	vs_out.instance_colour    = instance.colour;
+	vs_out.instance_shininess = instance.shininess;
 #endif
+#ifdef QUANTISED
+	vec4 local_position = dequantise * vec4(VertexPosition, 1.0);
+	vec3 local_normal   = oct_decode(VertexNormal);
+#else
+	vec4 local_position = vec4(VertexPosition, 1.0);
+	vec3 local_normal   = VertexNormal;
+#endif
+
+	vs_out.position             = vec3(model * local_position);
+	vs_out.normal               = mat3(transpose(inverse(model))) * local_normal;
+	vs_out.tex_coord            = VertexTexCoord;
 	vs_out.camera_position      = viewProperties.camera_position;
-	gl_Position                 = viewProperties.projection * viewProperties.view * model * vec4(VertexPosition, 1.0);
+	vec4 view_position          = viewProperties.view * model * local_position;
+	vs_out.view_depth           = -view_position.z;
+	gl_Position                 = viewProperties.projection * view_position;
 }
\ No newline at end of file
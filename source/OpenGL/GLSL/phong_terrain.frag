@@ -70,6 +70,33 @@ layout(std430) buffer SpotLightsBuffer
 };
 vec4 spot_light_contribution(SpotLight p_light, vec3 p_frag_col, vec3 p_frag_normal, vec3 p_frag_pos, vec3 p_view_direction);
 
+
+// The view frustrum split into a grid of clusters, each listing the point and spot lights reaching it. Matches OpenGL::LightClusters.
+struct LightCluster
+{
+	uint offset;      // Index into light_indices of the first point light, the spot lights follow the point lights.
+	uint point_count;
+	uint spot_count;
+	uint padding;
+};
+layout(std430) readonly buffer LightClustersBuffer
+{
+	uvec4 cluster_grid;    // xyz: Cluster count along each axis.
+	vec4 cluster_slicing;  // xy: Size in pixels of the screen tile of a cluster. z, w: Scale and bias mapping log(view depth) to a depth slice.
+	LightCluster clusters[];
+};
+layout(std430) readonly buffer LightIndicesBuffer
+{
+	uint light_indices[];
+};
+LightCluster find_cluster(vec2 p_frag_coord, float p_view_depth)
+{
+	uvec2 tile  = uvec2(max(p_frag_coord / cluster_slicing.xy, vec2(0.0)));
+	uint slice  = uint(max(log(p_view_depth) * cluster_slicing.z + cluster_slicing.w, 0.0));
+	uvec3 index = min(uvec3(tile, slice), cluster_grid.xyz - uvec3(1));
+	return clusters[index.x + cluster_grid.x * (index.y + cluster_grid.y * index.z)];
+}
+
 // Function to calculate contribution based on slope (steepness)
 //@returns a value between 0.0 and 1.0 where 0.0 is flat and 1.0 is steep
 float slope_factor(vec3 normal)
@@ -94,7 +121,7 @@ in VS_OUT {
 	vec3 normal;
 	vec4 camera_position;
 	vec2 tex_coord;
-
+	float view_depth;
 } fs_in;
 out vec4 Colour;
 
@@ -128,13 +155,16 @@ void main()
 	// Blend the textures based on the calculated contributions
 	vec3 frag_col = grass_col.xyz + rock_col.xyz + snow_col.xyz;
 
-	for (uint i = 0; i < number_of_point_lights; i++)
+	// Only the lights reaching the cluster of this fragment contribute.
+	LightCluster cluster = find_cluster(gl_FragCoord.xy, fs_in.view_depth);
+	for (uint i = 0; i < cluster.point_count; i++)
 	{
-		Colour += point_light_contribution(point_lights[i], frag_col, frag_normal, fs_in.position, view_direction);
+		Colour += point_light_contribution(point_lights[light_indices[cluster.offset + i]], frag_col, frag_normal, fs_in.position, view_direction);
 	}
-	for (uint i = 0; i < number_of_spot_lights; i++)
+	uint spot_offset = cluster.offset + cluster.point_count;
+	for (uint i = 0; i < cluster.spot_count; i++)
 	{
-		Colour += spot_light_contribution(spot_lights[i], frag_col, frag_normal, fs_in.position, view_direction);
+		Colour += spot_light_contribution(spot_lights[light_indices[spot_offset + i]], frag_col, frag_normal, fs_in.position, view_direction);
 	}
 	for (uint i = 0; i < number_of_directional_lights; i++)
 	{
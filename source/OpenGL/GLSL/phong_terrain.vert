@@ -1,7 +1,7 @@
 #version 460 core
 
 layout (location = 0) in vec3 VertexPosition;
-layout (location = 1) in vec3 VertexNormal;
+layout (location = 1) in vec2 VertexNormal; // Octahedral encoded, see Data::Quantise::to_octahedral.
 layout (location = 3) in vec2 VertexTexCoord;
 
 uniform mat4 model;
@@ -18,13 +18,25 @@ out VS_OUT {
 	vec3 normal;
 	vec4 camera_position;
 	vec2 tex_coord;
+	float view_depth; // Distance along the view direction, picks the depth slice of the light cluster in phong_terrain.frag.
 } vs_out;
 
+vec3 oct_decode(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
 void main()
 {
 	vs_out.position        = vec3(model * vec4(VertexPosition, 1.0));
 	vs_out.camera_position = viewProperties.camera_position;
 	vs_out.tex_coord       = VertexTexCoord;
-	vs_out.normal          = mat3(transpose(inverse(model))) * VertexNormal;
-	gl_Position            = viewProperties.projection * viewProperties.view * model * vec4(VertexPosition, 1.0);
+	vs_out.normal          = mat3(transpose(inverse(model))) * oct_decode(VertexNormal);
+	vec4 view_position     = viewProperties.view * model * vec4(VertexPosition, 1.0);
+	vs_out.view_depth      = -view_position.z;
+	gl_Position            = viewProperties.projection * view_position;
 }
\ No newline at end of file
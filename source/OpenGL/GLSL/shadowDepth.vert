@@ -3,9 +3,28 @@
 layout (location = 0) in vec3 VertexPosition;
 
 uniform mat4 light_space_mat;
-uniform mat4 model;
+#ifdef INSTANCED
+	// Matches OpenGL::InstanceData, only the model matrix is read.
+	struct Instance
+	{
+		mat4 model;
+		vec4 colour;
+		float shininess;
+	};
+	layout(std430) readonly buffer InstancesBuffer
+	{
+		Instance instances[];
+	};
+	uniform uint instance_offset; // Index of the first instance of this draw in instances.
+	uniform mat4 dequantise;      // Data::Mesh::dequantise_matrix of the instanced mesh.
+#else
+	uniform mat4 model;
+#endif
 
 void main()
 {
+#ifdef INSTANCED
+	mat4 model = instances[instance_offset + gl_InstanceID].model * dequantise;
+#endif
 	gl_Position = light_space_mat * model * vec4(VertexPosition, 1.0);
-}
\ No newline at end of file
+}
@@ -1,4 +1,5 @@
 #include "GLState.hpp"
+#include "CommandStream.hpp"
 
 #include "Utility/Logger.hpp"
 
@@ -11,27 +12,41 @@
 namespace OpenGL
 {
 	State::State()
-		: write_to_depth_buffer{true}
-		, depth_test_enabled{true}
-		, depth_test_type{DepthTestType::Less}
-		, polygon_offset_enabled{false}
-		, polygon_offset_factor{0.0f}
-		, polygon_offset_units{0.0f}
-		, blending_enabled{false}
-		, source_factor{BlendFactorType::SourceAlpha}
-		, destination_factor{BlendFactorType::OneMinusSourceAlpha}
-		, cull_face_enabled{true}
-		, cull_face_type{CullFaceType::Back}
-		, front_face_orientation{FrontFaceOrientation::CounterClockwise}
-		, polygon_mode{PolygonMode::Fill}
-		, viewport_position{0, 0}
-		, viewport_size{0, 0}
-		, current_bound_shader_program{0}
-		, current_bound_VAO{0}
-		, current_bound_FBO{0}
-		, current_bound_SSBO{std::vector<std::optional<GLHandle>>(get_max_shader_storage_buffer_bindings(), std::nullopt)}
-		, current_bound_UBO{std::vector<std::optional<GLHandle>>(get_max_uniform_buffer_bindings(), std::nullopt)}
-		, current_bound_texture{std::vector<std::optional<GLHandle>>(get_max_combined_texture_image_units(), std::nullopt)} // #BUG #TODO: Combined is the sum of all texture units for every shader stage. Maybe we want the min of all the stages?
+		: recording_stream{nullptr}
+	{
+		reset_context();
+	}
+	void State::reset_context()
+	{
+		ASSERT(recording_stream == nullptr, "Cannot reset the context while recording, end_recording first.");
+
+		write_to_depth_buffer        = true;
+		depth_test_enabled           = true;
+		depth_test_type              = DepthTestType::Less;
+		polygon_offset_enabled       = false;
+		polygon_offset_factor        = 0.0f;
+		polygon_offset_units         = 0.0f;
+		blending_enabled             = false;
+		source_factor                = BlendFactorType::SourceAlpha;
+		destination_factor           = BlendFactorType::OneMinusSourceAlpha;
+		cull_face_enabled            = true;
+		cull_face_type               = CullFaceType::Back;
+		front_face_orientation       = FrontFaceOrientation::CounterClockwise;
+		polygon_mode                 = PolygonMode::Fill;
+		viewport_position            = {0, 0};
+		viewport_size                = {0, 0};
+		current_bound_shader_program = 0;
+		current_bound_VAO            = 0;
+		current_bound_FBO            = 0;
+		// The limits of the new context may differ.
+		current_bound_SSBO    = std::vector<std::optional<BufferRange>>(get_max_shader_storage_buffer_bindings(), std::nullopt);
+		current_bound_UBO     = std::vector<std::optional<BufferRange>>(get_max_uniform_buffer_bindings(), std::nullopt);
+		current_bound_texture = std::vector<std::optional<GLHandle>>(get_max_combined_texture_image_units(), std::nullopt); // #BUG #TODO: Combined is the sum of all texture units for every shader stage. Maybe we want the min of all the stages?
+		state_changes         = {};
+
+		apply_to_context();
+	}
+	void State::apply_to_context() const
 	{
 		glDepthMask(write_to_depth_buffer ? GL_TRUE : GL_FALSE);
 
@@ -67,12 +82,56 @@ namespace OpenGL
 		glBindVertexArray(current_bound_VAO);
 		glBindFramebuffer(GL_FRAMEBUFFER, current_bound_FBO);
 	}
+	void State::reset_bindings()
+	{
+		std::fill(current_bound_SSBO.begin(), current_bound_SSBO.end(), std::nullopt);
+		std::fill(current_bound_UBO.begin(), current_bound_UBO.end(), std::nullopt);
+		std::fill(current_bound_texture.begin(), current_bound_texture.end(), std::nullopt);
+	}
+	void State::begin_recording(CommandStream& p_stream)
+	{
+		ASSERT(recording_stream == nullptr, "Already recording, end_recording before recording another stream.");
+		recording_stream = &p_stream;
+
+		p_stream.set_depth_write(write_to_depth_buffer);
+		p_stream.set_depth_test(depth_test_enabled);
+		p_stream.set_depth_test_type(depth_test_type);
+		p_stream.set_polygon_offset(polygon_offset_enabled);
+		p_stream.set_polygon_offset_factor(polygon_offset_factor, polygon_offset_units);
+		// The blend function can only be set while blending is enabled.
+		p_stream.set_blending(true);
+		p_stream.set_blend_func(source_factor, destination_factor);
+		p_stream.set_blending(blending_enabled);
+		p_stream.set_cull_face(cull_face_enabled);
+		p_stream.set_cull_face_type(cull_face_type);
+		p_stream.set_front_face_orientation(front_face_orientation);
+		p_stream.set_polygon_mode(polygon_mode);
+		p_stream.set_viewport(viewport_position.x, viewport_position.y, viewport_size.x, viewport_size.y);
+		p_stream.use_program(current_bound_shader_program);
+		p_stream.bind_VAO(current_bound_VAO);
+		p_stream.bind_FBO(current_bound_FBO);
+		reset_bindings();
+	}
+	void State::end_recording()
+	{
+		ASSERT(recording_stream != nullptr, "end_recording called without begin_recording.");
+		recording_stream = nullptr;
+
+		// The context never saw the recorded changes, bring it up to the state they left State with.
+		apply_to_context();
+		reset_bindings();
+	}
+
 	void State::bind_VAO(GLHandle p_VAO)
 	{
 		if (current_bound_VAO == p_VAO)
 			return;
 
-		glBindVertexArray(p_VAO);
+		if (recording_stream)
+			recording_stream->bind_VAO(p_VAO);
+		else
+			glBindVertexArray(p_VAO);
+		state_changes.VAOs++;
 		current_bound_VAO = p_VAO;
 	}
 	void State::unbind_VAO()
@@ -93,7 +152,11 @@ namespace OpenGL
 		if (current_bound_FBO == p_FBO)
 			return;
 
-		glBindFramebuffer(GL_FRAMEBUFFER, p_FBO);
+		if (recording_stream)
+			recording_stream->bind_FBO(p_FBO);
+		else
+			glBindFramebuffer(GL_FRAMEBUFFER, p_FBO);
+		state_changes.FBOs++;
 		current_bound_FBO = p_FBO;
 	}
 	void State::unbind_FBO()
@@ -111,19 +174,29 @@ namespace OpenGL
 
 	void State::bind_shader_storage_buffer(GLuint p_index, GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_size)
 	{
-		if (current_bound_SSBO[p_index] == p_buffer)
+		const auto range = BufferRange{p_buffer, p_offset, p_size};
+		if (current_bound_SSBO[p_index] == range)
 			return;
 
-		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, p_index, p_buffer, p_offset, p_size);
-		current_bound_SSBO[p_index] = p_buffer;
+		if (recording_stream)
+			recording_stream->bind_shader_storage_buffer(p_index, p_buffer, p_offset, p_size);
+		else
+			glBindBufferRange(GL_SHADER_STORAGE_BUFFER, p_index, p_buffer, p_offset, p_size);
+		state_changes.buffers++;
+		current_bound_SSBO[p_index] = range;
 	}
 	void State::bind_uniform_buffer(GLuint p_index, GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_size)
 	{
-		if (current_bound_UBO[p_index] == p_buffer)
+		const auto range = BufferRange{p_buffer, p_offset, p_size};
+		if (current_bound_UBO[p_index] == range)
 			return;
 
-		glBindBufferRange(GL_UNIFORM_BUFFER, p_index, p_buffer, p_offset, p_size);
-		current_bound_UBO[p_index] = p_buffer;
+		if (recording_stream)
+			recording_stream->bind_uniform_buffer(p_index, p_buffer, p_offset, p_size);
+		else
+			glBindBufferRange(GL_UNIFORM_BUFFER, p_index, p_buffer, p_offset, p_size);
+		state_changes.buffers++;
+		current_bound_UBO[p_index] = range;
 	}
 
 	void State::delete_buffer(GLHandle p_buffer)
@@ -131,15 +204,18 @@ namespace OpenGL
 		// If the buffer is bound to an SSBO or UBO target, we need to unbind it.
 		for (auto& SSBO : current_bound_SSBO)
 		{
-			if (SSBO == p_buffer)
+			if (SSBO && SSBO->handle == p_buffer)
 				SSBO.reset();
 		}
 		for (auto& UBO : current_bound_UBO)
 		{
-			if (UBO == p_buffer)
+			if (UBO && UBO->handle == p_buffer)
 				UBO.reset();
 		}
 
+		if (recording_stream)
+			return recording_stream->delete_buffer(p_buffer);
+
 		glDeleteBuffers(1, &p_buffer);
 	}
 	GLHandle State::create_buffer()
@@ -154,7 +230,11 @@ namespace OpenGL
 		if (current_bound_texture[p_texture_unit] == p_texture)
 			return;
 
-		glBindTextureUnit(p_texture_unit, p_texture);
+		if (recording_stream)
+			recording_stream->bind_texture_unit(p_texture_unit, p_texture);
+		else
+			glBindTextureUnit(p_texture_unit, p_texture);
+		state_changes.textures++;
 
 		current_bound_texture[p_texture_unit] = p_texture;
 	}
@@ -172,8 +252,15 @@ namespace OpenGL
 
 	void State::use_program(GLHandle p_shader_program)
 	{
+		if (current_bound_shader_program == p_shader_program)
+			return;
+
+		if (recording_stream)
+			recording_stream->use_program(p_shader_program);
+		else
+			glUseProgram(p_shader_program);
 		current_bound_shader_program = p_shader_program;
-		glUseProgram(p_shader_program);
+		state_changes.programs++;
 	}
 	void State::delete_program(GLHandle p_shader_program)
 	{
@@ -188,7 +275,11 @@ namespace OpenGL
 		if (p_write_to_depth_buffer == write_to_depth_buffer)
 			return;
 
-		glDepthMask(p_write_to_depth_buffer ? GL_TRUE : GL_FALSE);
+		if (recording_stream)
+			recording_stream->set_depth_write(p_write_to_depth_buffer);
+		else
+			glDepthMask(p_write_to_depth_buffer ? GL_TRUE : GL_FALSE);
+		state_changes.fixed_function++;
 		write_to_depth_buffer = p_write_to_depth_buffer;
 	}
 
@@ -197,18 +288,25 @@ namespace OpenGL
 		if (p_depth_test == depth_test_enabled)
 			return;
 
-		if (p_depth_test)
+		if (recording_stream)
+			recording_stream->set_depth_test(p_depth_test);
+		else if (p_depth_test)
 			glEnable(GL_DEPTH_TEST);
 		else
 			glDisable(GL_DEPTH_TEST);
 		depth_test_enabled = p_depth_test;
+		state_changes.fixed_function++;
 	}
 	void State::set_depth_test_type(DepthTestType p_type)
 	{
 		if (p_type == depth_test_type)
 			return;
 
-		glDepthFunc(convert(p_type));
+		if (recording_stream)
+			recording_stream->set_depth_test_type(p_type);
+		else
+			glDepthFunc(convert(p_type));
+		state_changes.fixed_function++;
 		depth_test_type = p_type;
 	}
 	void State::set_polygon_offset(bool p_polygon_offset)
@@ -216,17 +314,24 @@ namespace OpenGL
 		if (p_polygon_offset == polygon_offset_enabled)
 			return;
 
-		if (p_polygon_offset)
+		if (recording_stream)
+			recording_stream->set_polygon_offset(p_polygon_offset);
+		else if (p_polygon_offset)
 			glEnable(GL_POLYGON_OFFSET_FILL);
 		else
 			glDisable(GL_POLYGON_OFFSET_FILL);
 		polygon_offset_enabled = p_polygon_offset;
+		state_changes.fixed_function++;
 	}
 	void State::set_polygon_offset_factor(GLfloat p_polygon_offset_factor, GLfloat p_polygon_offset_units)
 	{
 		if (p_polygon_offset_factor != polygon_offset_factor || p_polygon_offset_units != polygon_offset_units)
 		{
-			glPolygonOffset(p_polygon_offset_factor, p_polygon_offset_units);
+			if (recording_stream)
+				recording_stream->set_polygon_offset_factor(p_polygon_offset_factor, p_polygon_offset_units);
+			else
+				glPolygonOffset(p_polygon_offset_factor, p_polygon_offset_units);
+			state_changes.fixed_function++;
 			polygon_offset_factor = p_polygon_offset_factor;
 			polygon_offset_units  = p_polygon_offset_units;
 		}
@@ -236,12 +341,15 @@ namespace OpenGL
 		if (p_blend == blending_enabled)
 			return;
 
-		if (p_blend)
+		if (recording_stream)
+			recording_stream->set_blending(p_blend);
+		else if (p_blend)
 			glEnable(GL_BLEND);
 		else
 			glDisable(GL_BLEND);
 
 		blending_enabled = p_blend;
+		state_changes.fixed_function++;
 	}
 	void State::set_blend_func(BlendFactorType p_source_factor, BlendFactorType p_destination_factor)
 	{
@@ -249,7 +357,11 @@ namespace OpenGL
 
 		if (p_source_factor != source_factor || p_destination_factor != destination_factor)
 		{
-			glBlendFunc(convert(p_source_factor), convert(p_destination_factor)); // It is also possible to set individual RGBA factors using glBlendFuncSeparate().
+			if (recording_stream)
+				recording_stream->set_blend_func(p_source_factor, p_destination_factor);
+			else
+				glBlendFunc(convert(p_source_factor), convert(p_destination_factor)); // It is also possible to set individual RGBA factors using glBlendFuncSeparate().
+			state_changes.fixed_function++;
 			source_factor      = p_source_factor;
 			destination_factor = p_destination_factor;
 		}
@@ -259,19 +371,26 @@ namespace OpenGL
 		if (p_cull == cull_face_enabled)
 			return;
 
-		if (p_cull)
+		if (recording_stream)
+			recording_stream->set_cull_face(p_cull);
+		else if (p_cull)
 			glEnable(GL_CULL_FACE);
 		else
 			glDisable(GL_CULL_FACE);
 
 		cull_face_enabled = p_cull;
+		state_changes.fixed_function++;
 	}
 	void State::set_cull_face_type(CullFaceType p_cull_face_type)
 	{
 		if (p_cull_face_type == cull_face_type)
 			return;
 
-		glCullFace(convert(p_cull_face_type));
+		if (recording_stream)
+			recording_stream->set_cull_face_type(p_cull_face_type);
+		else
+			glCullFace(convert(p_cull_face_type));
+		state_changes.fixed_function++;
 		cull_face_type = p_cull_face_type;
 	}
 	void State::set_front_face_orientation(FrontFaceOrientation p_front_face_orientation)
@@ -279,7 +398,11 @@ namespace OpenGL
 		if (p_front_face_orientation == front_face_orientation)
 			return;
 
-		glFrontFace(convert(p_front_face_orientation));
+		if (recording_stream)
+			recording_stream->set_front_face_orientation(p_front_face_orientation);
+		else
+			glFrontFace(convert(p_front_face_orientation));
+		state_changes.fixed_function++;
 		front_face_orientation = p_front_face_orientation;
 	}
 	void State::set_polygon_mode(PolygonMode p_polygon_mode)
@@ -287,14 +410,22 @@ namespace OpenGL
 		if (p_polygon_mode == polygon_mode)
 			return;
 
-		glPolygonMode(GL_FRONT_AND_BACK, convert(p_polygon_mode));
+		if (recording_stream)
+			recording_stream->set_polygon_mode(p_polygon_mode);
+		else
+			glPolygonMode(GL_FRONT_AND_BACK, convert(p_polygon_mode));
+		state_changes.fixed_function++;
 		polygon_mode = p_polygon_mode;
 	}
 	void State::set_viewport(GLint p_x, GLint p_y, GLsizei p_width, GLsizei p_height)
 	{
 		if (p_x != viewport_position.x || p_y != viewport_position.y || p_width != viewport_size.x || p_height != viewport_size.y)
 		{
-			glViewport(p_x, p_y, p_width, p_height);
+			if (recording_stream)
+				recording_stream->set_viewport(p_x, p_y, p_width, p_height);
+			else
+				glViewport(p_x, p_y, p_width, p_height);
+			state_changes.fixed_function++;
 			viewport_position = { p_x, p_y };
 			viewport_size     = { p_width, p_height };
 		}
@@ -361,22 +492,37 @@ namespace OpenGL
 {
 	void draw_arrays(PrimitiveMode p_primitive_mode, GLint p_first, GLsizei p_count)
 	{
+		if (auto* stream = State::Get().recording())
+			return stream->draw_arrays(p_primitive_mode, p_first, p_count);
+
 		glDrawArrays(convert(p_primitive_mode), p_first, p_count);
 	}
 	void draw_arrays_instanced(PrimitiveMode p_primitive_mode, GLint p_first, GLsizei p_array_size, GLsizei p_instance_count)
 	{
+		if (auto* stream = State::Get().recording())
+			return stream->draw_arrays_instanced(p_primitive_mode, p_first, p_array_size, p_instance_count);
+
 		glDrawArraysInstanced(convert(p_primitive_mode), p_first, p_array_size, p_instance_count);
 	}
-	void draw_elements(PrimitiveMode p_primitive_mode, GLsizei p_elements_size)
+	void draw_elements(PrimitiveMode p_primitive_mode, GLsizei p_elements_size, GLsizei p_first_element)
 	{
-		glDrawElements(convert(p_primitive_mode), p_elements_size, GL_UNSIGNED_INT, 0);
+		if (auto* stream = State::Get().recording())
+			return stream->draw_elements(p_primitive_mode, p_elements_size, p_first_element);
+
+		glDrawElements(convert(p_primitive_mode), p_elements_size, GL_UNSIGNED_INT, reinterpret_cast<const void*>(p_first_element * sizeof(GLuint)));
 	}
-	void draw_elements_instanced(PrimitiveMode p_primitive_mode, GLsizei p_elements_size, GLsizei p_instance_count)
+	void draw_elements_instanced(PrimitiveMode p_primitive_mode, GLsizei p_elements_size, GLsizei p_instance_count, GLsizei p_first_element)
 	{
-		glDrawElementsInstanced(convert(p_primitive_mode), p_elements_size, GL_UNSIGNED_INT, 0, p_instance_count);
+		if (auto* stream = State::Get().recording())
+			return stream->draw_elements_instanced(p_primitive_mode, p_elements_size, p_instance_count, p_first_element);
+
+		glDrawElementsInstanced(convert(p_primitive_mode), p_elements_size, GL_UNSIGNED_INT, reinterpret_cast<const void*>(p_first_element * sizeof(GLuint)), p_instance_count);
 	}
 	void dispatch_compute(GLuint p_num_groups_x, GLuint p_num_groups_y, GLuint p_num_groups_z)
 	{
+		if (auto* stream = State::Get().recording())
+			return stream->dispatch_compute(p_num_groups_x, p_num_groups_y, p_num_groups_z);
+
 		glDispatchCompute(p_num_groups_x, p_num_groups_y, p_num_groups_z);
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 	}
@@ -506,6 +652,18 @@ namespace OpenGL
 		glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &texture_units);
 		return texture_units;
 	}
+	GLint get_uniform_buffer_offset_alignment()
+	{
+		GLint alignment;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		return alignment;
+	}
+	GLint get_shader_storage_buffer_offset_alignment()
+	{
+		GLint alignment;
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		return alignment;
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -531,6 +689,12 @@ namespace OpenGL
 
 	void clear_named_buffer_sub_data(GLHandle p_buffer, GLenum p_internal_format, GLintptr p_offset, GLsizeiptr p_size, GLenum p_format, GLenum p_type, const void* data)
 	{
+		if (auto* stream = State::Get().recording())
+		{
+			ASSERT(data == nullptr, "Only clearing buffer {} to zero can be recorded.", p_buffer);
+			return stream->clear_named_buffer_sub_data(p_buffer, p_internal_format, p_offset, p_size, p_format, p_type);
+		}
+
 		glClearNamedBufferSubData(p_buffer, p_internal_format, p_offset, p_size, p_format, p_type, data);
 	}
 	void named_buffer_storage(GLHandle p_buffer, GLsizeiptr p_size, const void* p_data, BufferStorageBitfield p_flags)
@@ -543,10 +707,16 @@ namespace OpenGL
 	}
 	void named_buffer_sub_data(GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_size, const void* p_data)
 	{
+		if (auto* stream = State::Get().recording())
+			return stream->named_buffer_sub_data(p_buffer, p_offset, p_size, p_data);
+
 		glNamedBufferSubData(p_buffer, p_offset, p_size, p_data);
 	}
 	void copy_named_buffer_sub_data(GLHandle p_source_buffer, GLHandle p_destination_buffer, GLintptr p_source_offset, GLintptr p_destination_offset, GLsizeiptr p_size)
 	{
+		if (auto* stream = State::Get().recording())
+			return stream->copy_named_buffer_sub_data(p_source_buffer, p_destination_buffer, p_source_offset, p_destination_offset, p_size);
+
 		glCopyNamedBufferSubData(p_source_buffer, p_destination_buffer, p_source_offset, p_destination_offset, p_size);
 	}
 	void bind_buffer_range(BufferType p_target, GLuint p_index, GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_size)
@@ -555,8 +725,41 @@ namespace OpenGL
 	}
 	void memory_barrier(MemoryBarrierBitfield p_barrier_bitfield)
 	{
+		if (auto* stream = State::Get().recording())
+			return stream->memory_barrier(p_barrier_bitfield);
+
 		glMemoryBarrier(p_barrier_bitfield.bitfield);
 	}
+	void* map_named_buffer_range(GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_length, BufferStorageBitfield p_access)
+	{
+		return glMapNamedBufferRange(p_buffer, p_offset, p_length, p_access.bitfield);
+	}
+	void unmap_named_buffer(GLHandle p_buffer)
+	{
+		glUnmapNamedBuffer(p_buffer);
+	}
+
+	GLsync fence_sync()
+	{
+		return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	bool client_wait_sync(GLsync p_sync, GLuint64 p_timeout)
+	{
+		switch (glClientWaitSync(p_sync, GL_SYNC_FLUSH_COMMANDS_BIT, p_timeout))
+		{
+			case GL_ALREADY_SIGNALED:
+			case GL_CONDITION_SATISFIED: return true;
+			case GL_TIMEOUT_EXPIRED:     return false;
+			case GL_WAIT_FAILED:
+			default:
+				LOG_ERROR(false, "[OPENGL] glClientWaitSync failed, treating the fence as signalled");
+				return true;
+		}
+	}
+	void delete_sync(GLsync p_sync)
+	{
+		glDeleteSync(p_sync);
+	}
 } // namespace OpenGL
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -594,7 +797,9 @@ namespace OpenGL
 			case BufferDataType::UnsignedShort: return GL_UNSIGNED_SHORT;
 			case BufferDataType::Int:           return GL_INT;
 			case BufferDataType::UnsignedInt:   return GL_UNSIGNED_INT;
+			case BufferDataType::Fixed:         return GL_FIXED;
 			case BufferDataType::Float:         return GL_FLOAT;
+			case BufferDataType::HalfFloat:     return GL_HALF_FLOAT;
 			case BufferDataType::Double:        return GL_DOUBLE;
 			default: ASSERT_FAIL("[OPENGL] Unknown BufferDataType requested");
 		}
@@ -26,6 +26,8 @@ using GLdouble   = double;
 using GLsizei    = int;
 using GLsizeiptr = std::ptrdiff_t;
 using GLintptr   = std::ptrdiff_t;
+using GLuint64   = uint64_t;
+using GLsync     = struct __GLsync*; // Opaque fence object, same declaration as the loader so the two are interchangeable.
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// STRONGLY TYPED ENUM WRAPPERS
@@ -216,6 +218,12 @@ namespace OpenGL
 		DEPTH32F_STENCIL8,  // GL_DEPTH32F_STENCIL8
 		DEPTH24_STENCIL8,   // GL_DEPTH24_STENCIL8
 		STENCIL_INDEX8,     // GL_STENCIL_INDEX8
+		// Block compressed formats. Pixel data for these must be uploaded via Texture::upload_compressed_level.
+		BC1_RGB,            // GL_COMPRESSED_RGB_S3TC_DXT1_EXT      4x4 block, 8 bytes
+		BC3_RGBA,           // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT     4x4 block, 16 bytes
+		BC4_R,              // GL_COMPRESSED_RED_RGTC1              4x4 block, 8 bytes
+		BC5_RG,             // GL_COMPRESSED_RG_RGTC2               4x4 block, 16 bytes
+		BC7_RGBA,           // GL_COMPRESSED_RGBA_BPTC_UNORM        4x4 block, 16 bytes
 	};
 	// The data type of the pixel data.
 	// https://registry.khronos.org/OpenGL-Refpages/gl4/html/glTexSubImage2D.xhtml
@@ -358,8 +366,11 @@ namespace OpenGL
 /// STATE FUNCTIONS
 namespace OpenGL
 {
+	class CommandStream;
+
 	// OpenGL::State encapsulates the state of the OpenGL context.
 	// State prevents excess gl function calls by only allowing them to be called if there is a required state change.
+	// While recording, the state changes and the commands of the wrapper functions are appended to a CommandStream instead of being issued.
 	class State
 	{
 		bool write_to_depth_buffer;
@@ -392,11 +403,55 @@ namespace OpenGL
 		// We dont know the number of binding points at compile time hence these are vectors.
 		// State will resize these on construction and they are never resized after that point.
 
-		std::vector<std::optional<GLHandle>> current_bound_SSBO;    // Per binding point the current bound SSBO.
-		std::vector<std::optional<GLHandle>> current_bound_UBO;     // Per binding point the current bound UBO.
+		// The range of a buffer bound to a binding point, a buffer bound again with a different range has to be rebound.
+		struct BufferRange
+		{
+			GLHandle handle;
+			GLintptr offset;
+			GLsizeiptr size;
+
+			bool operator==(const BufferRange& p_other) const = default;
+		};
+		std::vector<std::optional<BufferRange>> current_bound_SSBO; // Per binding point the current bound SSBO.
+		std::vector<std::optional<BufferRange>> current_bound_UBO;  // Per binding point the current bound UBO.
 		std::vector<std::optional<GLHandle>> current_bound_texture; // Per binding point the current bound texture unit.
 
+		CommandStream* recording_stream; // The stream commands are recorded into in place of the context, nullptr when not recording.
+
+	public:
+		// The number of gl calls State made to change each kind of state. Redundant changes State skipped are not counted.
+		struct StateChanges
+		{
+			size_t programs       = 0;
+			size_t VAOs           = 0;
+			size_t FBOs           = 0;
+			size_t textures       = 0;
+			size_t buffers        = 0; // SSBO and UBO binding points.
+			size_t fixed_function = 0; // Depth, polygon offset, blending, culling, polygon mode and viewport.
+
+			size_t total() const { return programs + VAOs + FBOs + textures + buffers + fixed_function; }
+		};
+
+	private:
+		StateChanges state_changes;
+
 	public:
+		// State changes since the last reset_state_changes, call once per frame to get per frame counts.
+		const StateChanges& get_state_changes() const { return state_changes; }
+		void reset_state_changes()                    { state_changes = {}; }
+
+		// Record the commands issued from now on into p_stream instead of issuing them to the context, until end_recording.
+		// The stream starts with the current fixed function state and bindings so it replays the same from any state. The buffer and texture
+		// bindings are forgotten, every one used while recording is recorded and counted as a state change.
+		void begin_recording(CommandStream& p_stream);
+		// Stop recording and issue the state the recording left State with to the context, so the two agree again.
+		void end_recording();
+		// The stream being recorded into, nullptr if the commands are issued to the context.
+		CommandStream* recording() const { return recording_stream; }
+		// Forget the state of the previous context and issue the defaults to the current one.
+		// Call after the GL functions are loaded for another context, the handles State holds belong to the previous one.
+		void reset_context();
+
 		void bind_VAO(GLHandle p_VAO);
 		void unbind_VAO();
 		void delete_VAO(GLHandle p_VAO);
@@ -476,6 +531,10 @@ namespace OpenGL
 
 	private:
 		State(); // Private constructor to prevent instantiation outside Get().
+		// Issue the fixed function state and the program, VAO and FBO bindings State holds to the context.
+		void apply_to_context() const;
+		// Forget the buffer and texture bindings, the next bind of each binding point is issued regardless.
+		void reset_bindings();
 	};
 }
 
@@ -524,11 +583,12 @@ namespace OpenGL
 	// draw_elements specifies multiple geometric primitives with very few subroutine calls. Instead of calling a GL function to pass each individual vertex, normal, texture coordinate, edge flag, or color, you can prespecify separate arrays of vertices, normals, and so on, and use them to construct a sequence of primitives with a single call to glDrawElements.
 	// When draw_elements is called, it uses p_elements_size sequential elements from an enabled array, starting at indices to construct a sequence of geometric primitives. p_primitive_mode specifies what kind of primitives are constructed and how the array elements construct these primitives. If more than one array is enabled, each is used.
 	// Vertex attributes that are modified by draw_elements have an unspecified value after draw_elements returns. Attributes that aren't modified maintain their previous values.
-	void draw_elements(PrimitiveMode p_primitive_mode, GLsizei p_elements_size);
+	//@param p_first_element Offset into the bound element buffer in indices to start reading from.
+	void draw_elements(PrimitiveMode p_primitive_mode, GLsizei p_elements_size, GLsizei p_first_element = 0);
 	// Draw multiple instances of a set of elements.
 	// draw_elements_instanced behaves identically to draw_elements except that p_instance_count of the set of elements are executed and the value of the internal counter instanceID advances for each iteration.
 	// instanceID is an internal 32-bit integer counter that may be read by a vertex shader as gl_InstanceID.
-	void draw_elements_instanced(PrimitiveMode p_primitive_mode, GLsizei p_elements_size, GLsizei p_instance_count);
+	void draw_elements_instanced(PrimitiveMode p_primitive_mode, GLsizei p_elements_size, GLsizei p_instance_count, GLsizei p_first_element = 0);
 	// Launch one or more compute work groups.
 	// Each work group is processed by the active program object for the compute shader stage.
 	// The individual shader invocations within a work group are executed as a unit, work groups are executed completely independently and in unspecified order.
@@ -622,6 +682,10 @@ namespace OpenGL
 	// Get the max number of texture units available for binding.
 	//GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS
 	GLint get_max_combined_texture_image_units();
+	// Get the alignment in bytes the offset of a range bound with bind_buffer_range to a UniformBuffer binding point must have.
+	GLint get_uniform_buffer_offset_alignment();
+	// Get the alignment in bytes the offset of a range bound with bind_buffer_range to a ShaderStorageBuffer binding point must have.
+	GLint get_shader_storage_buffer_offset_alignment();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -712,6 +776,23 @@ namespace OpenGL
 	// Defines a barrier ordering memory transactions.
 	// Memory_barrier defines a barrier ordering memory transactions issued prior to the barrier relative to memory transactions issued after the barrier.
 	void memory_barrier(MemoryBarrierBitfield p_barrier_bitfield);
+	// Map all or part of a buffer object's data store into the client's address space.
+	// The Map bits of BufferStorageFlag share their values with the map access bits, p_access must be a subset of the flags the storage was created with.
+	//@param p_buffer Name of the buffer object to map.
+	//@param p_offset Starting offset in bytes of the range to map.
+	//@param p_length Length in bytes of the range to map.
+	//@param p_access Combination of MapReadBit, MapWriteBit, MapPersistentBit and MapCoherentBit.
+	//@return Pointer to the mapped range, nullptr on failure.
+	void* map_named_buffer_range(GLHandle p_buffer, GLintptr p_offset, GLsizeiptr p_length, BufferStorageBitfield p_access);
+	// Release the mapping of a buffer object's data store. Ranges mapped with MapPersistentBit stay mapped until unmapped.
+	void unmap_named_buffer(GLHandle p_buffer);
+
+	// Create a fence signalled once every command issued before it has completed on the GPU.
+	GLsync fence_sync();
+	// Block until p_sync is signalled or p_timeout nanoseconds have passed, flushing the commands before p_sync so it can be signalled.
+	//@return True if p_sync was signalled, false if the wait timed out.
+	bool client_wait_sync(GLsync p_sync, GLuint64 p_timeout);
+	void delete_sync(GLsync p_sync);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
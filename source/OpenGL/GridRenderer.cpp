@@ -58,7 +58,7 @@ namespace OpenGL
 		mb.add_arrow(glm::vec3(0.f), glm::vec3(0.f, 0.f, 1.f));
 		mb.set_colour(glm::vec4(1.f));
 		mb.add_icosphere(glm::vec3(0.f), 0.1f, 1);
-		return mb.get_mesh();
+		return mb.get_indexed_mesh();
 	}
 
 	GridRenderer::GridRenderer() noexcept
@@ -0,0 +1,91 @@
+#include "InstanceBatcher.hpp"
+
+#include "Utility/Logger.hpp"
+#include "Utility/Performance.hpp"
+#include "Utility/RadixSort.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <tuple>
+
+namespace OpenGL
+{
+	namespace
+	{
+		// Groups are ordered by shader then textures so consecutive groups share as much state as possible.
+		// Pointers are compared as integers, the built-in < doesn't order pointers to unrelated objects.
+		auto ordering(const InstanceBatcher::Key& p_key)
+		{
+			return std::make_tuple(reinterpret_cast<std::uintptr_t>(p_key.shader), reinterpret_cast<std::uintptr_t>(p_key.diffuse),
+				reinterpret_cast<std::uintptr_t>(p_key.specular), reinterpret_cast<std::uintptr_t>(p_key.mesh), p_key.LOD);
+		}
+		bool key_less(const InstanceBatcher::Key& p_lhs, const InstanceBatcher::Key& p_rhs)
+		{
+			return ordering(p_lhs) < ordering(p_rhs);
+		}
+	} // namespace
+
+	InstanceBatcher::InstanceBatcher() noexcept
+		: m_pushed{}
+		, m_order{}
+		, m_order_scratch{}
+		, m_groups{}
+		, m_instances{}
+	{}
+
+	void InstanceBatcher::push(const Key& p_key, const InstanceData& p_instance, float p_depth)
+	{
+		ASSERT(m_pushed.size() < std::numeric_limits<uint32_t>::max(), "[InstanceBatcher] Too many instances pushed {}", m_pushed.size());
+		m_pushed.push_back({p_key, p_instance, p_depth});
+	}
+	void InstanceBatcher::build()
+	{
+		PERF(InstanceBatcherBuild);
+
+		m_order.resize(m_pushed.size());
+		std::iota(m_order.begin(), m_order.end(), 0u);
+		// Stable so the instances of a group keep the order they were pushed in.
+		std::stable_sort(m_order.begin(), m_order.end(), [this](uint32_t p_lhs, uint32_t p_rhs) { return key_less(m_pushed[p_lhs].key, m_pushed[p_rhs].key); });
+
+		group_in_order();
+	}
+	void InstanceBatcher::build_back_to_front()
+	{
+		PERF(InstanceBatcherBuildBackToFront);
+
+		m_order.resize(m_pushed.size());
+		std::iota(m_order.begin(), m_order.end(), 0u);
+		// Inverting the depth keys sorts the farthest first. Stable so instances at equal depth keep the order they were pushed in.
+		Utility::radix_sort(m_order, m_order_scratch, [this](uint32_t p_index) { return ~Utility::sortable_key(m_pushed[p_index].depth); });
+
+		group_in_order();
+	}
+	void InstanceBatcher::group_in_order()
+	{
+		m_groups.clear();
+		m_instances.clear();
+		m_instances.reserve(m_pushed.size());
+
+		for (const auto index : m_order)
+		{
+			const Pushed& pushed = m_pushed[index];
+			if (m_groups.empty() || m_groups.back().key != pushed.key)
+				m_groups.push_back({pushed.key, static_cast<uint32_t>(m_instances.size()), 0, pushed.depth});
+
+			auto& group = m_groups.back();
+			group.instance_count++;
+			group.depth = std::max(group.depth, pushed.depth);
+			m_instances.push_back(pushed.instance);
+		}
+
+		m_pushed.clear();
+	}
+	RingBuffer::Range InstanceBatcher::upload(RingBuffer& p_ring) const
+	{
+		if (m_instances.empty())
+			return {};
+
+		return p_ring.push(m_instances);
+	}
+} // namespace OpenGL
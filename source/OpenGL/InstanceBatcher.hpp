@@ -0,0 +1,90 @@
+#pragma once
+
+#include "RingBuffer.hpp"
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Data
+{
+	class Mesh;
+}
+namespace OpenGL
+{
+	class Shader;
+	class Texture;
+
+	// Per instance data read by the INSTANCED shader variants from the InstancesBuffer SSBO.
+	// Laid out to match the std430 array stride of the GLSL Instance struct, see phong.vert.
+	struct InstanceData
+	{
+		glm::mat4 model;
+		glm::vec4 colour;
+		float shininess;
+		float padding[3] = {};
+	};
+	static_assert(sizeof(InstanceData) == 96, "InstanceData must match the std430 stride of the GLSL Instance struct.");
+
+	// Groups the draws of a frame sharing a mesh LOD, shader and textures so each group can be issued as a single instanced draw.
+	// Instances of a group are contiguous in instances(), in the order they were pushed.
+	// Blended draws are built with build_back_to_front instead, which keeps them in depth order and only groups neighbouring draws.
+	class InstanceBatcher
+	{
+	public:
+		// Draws are grouped when every member matches.
+		struct Key
+		{
+			const Data::Mesh* mesh;
+			size_t LOD;
+			Shader* shader;
+			const Texture* diffuse;  // nullptr if the shader doesn't sample a diffuse texture.
+			const Texture* specular; // nullptr if the shader doesn't sample a specular texture.
+
+			bool operator==(const Key& p_other) const = default;
+		};
+		struct Group
+		{
+			Key key;
+			uint32_t first_instance; // Index into instances(), the "instance_offset" uniform of the instanced shaders.
+			uint32_t instance_count;
+			float depth; // Largest depth the instances of the group were pushed with.
+		};
+
+		InstanceBatcher() noexcept;
+
+		//@param p_depth View depth of the instance, orders the instances in build_back_to_front.
+		void push(const Key& p_key, const InstanceData& p_instance, float p_depth = 0.f);
+		// Sort the instances pushed since the last build into groups, replacing the groups and instances of the last build.
+		void build();
+		// Sort the instances pushed since the last build farthest first and group the runs of consecutive instances sharing a key.
+		// The groups drawn in order draw every instance back to front, so blending is correct. A mesh interleaved in depth with others takes several groups.
+		void build_back_to_front();
+		// Copy the instances of the last build into a range of p_ring, bind the range as the InstancesBuffer SSBO of the groups.
+		//@return The range holding instances(), empty if there are none.
+		RingBuffer::Range upload(RingBuffer& p_ring) const;
+
+		const std::vector<Group>& groups() const           { return m_groups; }
+		const std::vector<InstanceData>& instances() const { return m_instances; }
+
+	private:
+		// Build the groups and instances from the pushed instances in m_order and clear the pushed instances.
+		void group_in_order();
+
+		struct Pushed
+		{
+			Key key;
+			InstanceData instance;
+			float depth;
+		};
+
+		std::vector<Pushed> m_pushed;
+		std::vector<uint32_t> m_order; // Indices into m_pushed sorted by key, kept between builds to avoid reallocating.
+		std::vector<uint32_t> m_order_scratch;
+		std::vector<Group> m_groups;
+		std::vector<InstanceData> m_instances;
+	};
+} // namespace OpenGL
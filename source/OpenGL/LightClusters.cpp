@@ -0,0 +1,250 @@
+#include "LightClusters.hpp"
+
+#include "Utility/Logger.hpp"
+#include "Utility/Parallel.hpp"
+#include "Utility/Performance.hpp"
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+#include "glm/matrix.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace OpenGL
+{
+	namespace
+	{
+		// Depth slices past this are too coarse to be worth splitting, the last slice extends from here to the far plane.
+		constexpr float Slice_Depth_Limit = 2000.f;
+		// Bounds the far side of the last slice, infinite or very distant far planes would overflow the cluster bounds tests.
+		constexpr float Max_Depth = 1e18f;
+		// Light vs cluster tests worth giving a worker thread, spawning threads for less costs more than it saves.
+		constexpr size_t Min_Tests_Per_Thread = 16384;
+
+		bool intersects(const Geometry::AABB& p_bounds, const glm::vec3& p_centre, float p_radius)
+		{
+			const glm::vec3 closest = glm::clamp(p_centre, p_bounds.m_min, p_bounds.m_max);
+			const glm::vec3 offset  = closest - p_centre;
+			return glm::dot(offset, offset) <= p_radius * p_radius;
+		}
+		// Cone vs the bounding sphere of p_bounds, conservative so clusters near the cone edge may be kept.
+		bool intersects(const Geometry::AABB& p_bounds, const LightClusters::SpotLight& p_light, float p_cos_angle, float p_sin_angle)
+		{
+			if (!intersects(p_bounds, p_light.position, p_light.range))
+				return false;
+
+			const glm::vec3 centre = p_bounds.get_center();
+			const float radius     = glm::length(p_bounds.get_size()) * 0.5f;
+
+			const glm::vec3 to_centre    = centre - p_light.position;
+			const float along_axis       = glm::dot(to_centre, p_light.direction);
+			const float from_axis        = std::sqrt(std::max(glm::dot(to_centre, to_centre) - (along_axis * along_axis), 0.f));
+			const float distance_to_cone = (p_cos_angle * from_axis) - (along_axis * p_sin_angle);
+
+			return distance_to_cone <= radius && along_axis <= radius + p_light.range && along_axis >= -radius;
+		}
+	} // namespace
+
+	LightClusters::LightClusters(const glm::uvec3& p_grid) noexcept
+		: m_grid{glm::max(p_grid, glm::uvec3(1))}
+		, m_projection{0.f}
+		, m_resolution{0}
+		, m_header{}
+		, m_bounds{}
+		, m_slice_depths{}
+		, m_clusters{}
+		, m_light_indices{}
+		, m_slice_indices{}
+		, m_max_cluster_lights{0}
+	{}
+
+	void LightClusters::set_grid(const glm::uvec3& p_grid)
+	{
+		if (glm::max(p_grid, glm::uvec3(1)) == m_grid)
+			return;
+
+		m_grid = glm::max(p_grid, glm::uvec3(1));
+		m_bounds.clear(); // Force the next build_grid to rebuild.
+	}
+
+	void LightClusters::build_grid(const glm::mat4& p_projection, const glm::uvec2& p_resolution)
+	{
+		if (!m_bounds.empty() && p_projection == m_projection && p_resolution == m_resolution)
+			return;
+
+		PERF(LightClustersBuildGrid);
+		m_projection = p_projection;
+		m_resolution = p_resolution;
+
+		const glm::mat4 inverse_projection = glm::inverse(p_projection);
+		auto unproject = [&inverse_projection](const glm::vec2& p_NDC, float p_NDC_depth)
+		{
+			const glm::vec4 position = inverse_projection * glm::vec4(p_NDC, p_NDC_depth, 1.f);
+			return glm::vec3(position) / position.w;
+		};
+
+		// Depths are distances along -z, the view direction.
+		// A far plane too distant to unproject in single precision comes back infinite or garbage, treat it as Max_Depth.
+		const float near_depth = std::max(-unproject(glm::vec2(0.f), -1.f).z, 1e-4f);
+		float far_depth        = -unproject(glm::vec2(0.f), 1.f).z;
+		if (!std::isfinite(far_depth) || far_depth > Max_Depth)
+			far_depth = Max_Depth;
+		far_depth = std::max(far_depth, near_depth * 1.001f);
+
+		// Exponentially spaced slices keep clusters roughly cube shaped, near slices are thin and distant ones deep.
+		// Past Slice_Depth_Limit a single last slice covers the rest of the view volume.
+		const bool clamped_slices = far_depth > Slice_Depth_Limit && m_grid.z > 1;
+		const auto log_slices     = static_cast<float>(clamped_slices ? m_grid.z - 1 : m_grid.z);
+		const float log_ratio     = std::log(std::min(far_depth, Slice_Depth_Limit) / near_depth);
+		const float slice_scale   = log_slices / log_ratio;
+
+		m_slice_depths.resize(m_grid.z + 1);
+		for (uint32_t z = 0; z <= m_grid.z; z++)
+			m_slice_depths[z] = near_depth * std::exp(static_cast<float>(z) / slice_scale);
+		m_slice_depths.back() = far_depth;
+
+		m_header.grid    = glm::uvec4(m_grid, 0u);
+		m_header.slicing = glm::vec4(static_cast<float>(p_resolution.x) / static_cast<float>(m_grid.x), static_cast<float>(p_resolution.y) / static_cast<float>(m_grid.y),
+			slice_scale, -slice_scale * std::log(near_depth));
+
+		m_bounds.resize(static_cast<size_t>(m_grid.x) * m_grid.y * m_grid.z);
+		for (uint32_t y = 0; y < m_grid.y; y++)
+		{
+			for (uint32_t x = 0; x < m_grid.x; x++)
+			{
+				// Tile (0, 0) is the bottom left of the screen, matching the origin of gl_FragCoord.
+				const glm::vec2 tile_min = glm::vec2(-1.f) + (2.f * glm::vec2(x, y) / glm::vec2(m_grid));
+				const glm::vec2 tile_max = glm::vec2(-1.f) + (2.f * glm::vec2(x + 1, y + 1) / glm::vec2(m_grid));
+				const std::array<glm::vec2, 4> corners = {tile_min, glm::vec2(tile_max.x, tile_min.y), glm::vec2(tile_min.x, tile_max.y), tile_max};
+
+				// Each corner is a line through the view volume, through the origin for perspective and parallel to z for orthographic.
+				// The line is found from the near and mid planes, points on the far plane share its precision problems.
+				std::array<glm::vec3, 4> near_points;
+				std::array<glm::vec3, 4> directions; // Change in position per unit of depth along the corner line.
+				for (size_t i = 0; i < corners.size(); i++)
+				{
+					near_points[i]        = unproject(corners[i], -1.f);
+					const glm::vec3 mid   = unproject(corners[i], 0.f);
+					directions[i]         = (mid - near_points[i]) / (near_points[i].z - mid.z);
+				}
+
+				for (uint32_t z = 0; z < m_grid.z; z++)
+				{
+					Geometry::AABB bounds{glm::vec3(std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::lowest())};
+					for (size_t i = 0; i < corners.size(); i++)
+					{
+						const float near_point_depth = -near_points[i].z;
+						bounds.unite(near_points[i] + directions[i] * (m_slice_depths[z]     - near_point_depth));
+						bounds.unite(near_points[i] + directions[i] * (m_slice_depths[z + 1] - near_point_depth));
+					}
+					m_bounds[cluster_index({x, y, z})] = bounds;
+				}
+			}
+		}
+	}
+
+	void LightClusters::assign(std::span<const PointLight> p_point_lights, std::span<const SpotLight> p_spot_lights)
+	{
+		PERF(LightClustersAssign);
+		ASSERT(!m_bounds.empty(), "[OPENGL][LIGHT CLUSTERS] build_grid must be called before assigning lights.");
+
+		const size_t tile_count  = static_cast<size_t>(m_grid.x) * m_grid.y;
+		const size_t light_count = p_point_lights.size() + p_spot_lights.size();
+		m_clusters.assign(m_bounds.size(), Cluster{});
+		m_slice_indices.resize(m_grid.z);
+
+		// Every slice is independent, each writes the clusters of its tiles and its own index list.
+		const size_t min_slices_per_thread = std::max<size_t>(Min_Tests_Per_Thread / std::max<size_t>(tile_count * light_count, 1), 1);
+		Utility::parallel_for(m_grid.z, min_slices_per_thread, [&](size_t p_begin, size_t p_end)
+		{
+			std::vector<uint32_t> point_candidates;
+			std::vector<uint32_t> spot_candidates;
+			std::vector<glm::vec2> spot_angles; // Cos and sin of the outer angle of each spot candidate.
+
+			for (size_t z = p_begin; z < p_end; z++)
+			{
+				// Only lights overlapping the depth range of the slice can touch its clusters.
+				const float slice_near = m_slice_depths[z];
+				const float slice_far  = m_slice_depths[z + 1];
+				auto overlaps_slice = [slice_near, slice_far](const glm::vec3& p_position, float p_radius)
+				{
+					return -p_position.z + p_radius >= slice_near && -p_position.z - p_radius <= slice_far;
+				};
+
+				point_candidates.clear();
+				for (uint32_t i = 0; i < p_point_lights.size(); i++)
+					if (overlaps_slice(p_point_lights[i].position, p_point_lights[i].radius))
+						point_candidates.push_back(i);
+
+				spot_candidates.clear();
+				spot_angles.clear();
+				for (uint32_t i = 0; i < p_spot_lights.size(); i++)
+				{
+					if (overlaps_slice(p_spot_lights[i].position, p_spot_lights[i].range))
+					{
+						spot_candidates.push_back(i);
+						spot_angles.emplace_back(std::cos(p_spot_lights[i].outer_angle), std::sin(p_spot_lights[i].outer_angle));
+					}
+				}
+
+				auto& indices = m_slice_indices[z];
+				indices.clear();
+				for (size_t tile = 0; tile < tile_count; tile++)
+				{
+					const size_t index     = (z * tile_count) + tile;
+					const auto& bounds     = m_bounds[index];
+					Cluster& cluster       = m_clusters[index];
+					cluster.offset         = static_cast<uint32_t>(indices.size()); // Relative to the slice until the slices are concatenated.
+
+					for (const auto i : point_candidates)
+						if (intersects(bounds, p_point_lights[i].position, p_point_lights[i].radius))
+							indices.push_back(i);
+					cluster.point_count = static_cast<uint32_t>(indices.size()) - cluster.offset;
+
+					for (size_t c = 0; c < spot_candidates.size(); c++)
+						if (intersects(bounds, p_spot_lights[spot_candidates[c]], spot_angles[c].x, spot_angles[c].y))
+							indices.push_back(spot_candidates[c]);
+					cluster.spot_count = static_cast<uint32_t>(indices.size()) - cluster.offset - cluster.point_count;
+				}
+			}
+		});
+
+		m_light_indices.clear();
+		m_max_cluster_lights = 0;
+		for (size_t z = 0; z < m_grid.z; z++)
+		{
+			const auto slice_offset = static_cast<uint32_t>(m_light_indices.size());
+			for (size_t tile = 0; tile < tile_count; tile++)
+			{
+				Cluster& cluster      = m_clusters[(z * tile_count) + tile];
+				cluster.offset       += slice_offset;
+				m_max_cluster_lights  = std::max<size_t>(m_max_cluster_lights, cluster.point_count + cluster.spot_count);
+			}
+			m_light_indices.insert(m_light_indices.end(), m_slice_indices[z].begin(), m_slice_indices[z].end());
+		}
+	}
+
+	glm::uvec3 LightClusters::cluster_at(const glm::vec2& p_pixel, float p_view_depth) const
+	{
+		const glm::vec2 tile = glm::max(p_pixel / glm::vec2(m_header.slicing.x, m_header.slicing.y), glm::vec2(0.f));
+		const float slice    = std::max((std::log(p_view_depth) * m_header.slicing.z) + m_header.slicing.w, 0.f);
+		return glm::min(glm::uvec3(static_cast<uint32_t>(tile.x), static_cast<uint32_t>(tile.y), static_cast<uint32_t>(slice)), m_grid - glm::uvec3(1));
+	}
+
+	float LightClusters::attenuation_radius(float p_constant, float p_linear, float p_quadratic, float p_intensity)
+	{
+		// The shaders attenuate by 1 / (constant + linear * d + quadratic * d^2), solve for the d where that reaches 1 / (256 * intensity).
+		const float threshold = 256.f * p_intensity;
+		if (p_constant >= threshold)
+			return 0.f;
+		if (p_quadratic > 0.f)
+			return (-p_linear + std::sqrt((p_linear * p_linear) - (4.f * p_quadratic * (p_constant - threshold)))) / (2.f * p_quadratic);
+		if (p_linear > 0.f)
+			return (threshold - p_constant) / p_linear;
+
+		return std::numeric_limits<float>::infinity();
+	}
+} // namespace OpenGL
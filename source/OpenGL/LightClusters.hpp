@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Geometry/AABB.hpp"
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace OpenGL
+{
+	// Splits the view frustrum into a grid of clusters, screen tiles along x and y and exponentially spaced depth slices along z,
+	// and assigns point and spot lights to the clusters their volume of influence overlaps.
+	// The phong shaders find the cluster of each fragment and only loop over its lights, see phong.frag.
+	// Works on the CPU only, the caller uploads header(), clusters() and light_indices() to the LightClustersBuffer and LightIndicesBuffer SSBOs.
+	class LightClusters
+	{
+	public:
+		// A point light in view space.
+		struct PointLight
+		{
+			glm::vec3 position;
+			float radius; // Distance past which the light no longer contributes, see attenuation_radius.
+		};
+		// A spot light in view space.
+		struct SpotLight
+		{
+			glm::vec3 position;
+			float range;        // Distance past which the light no longer contributes, see attenuation_radius.
+			glm::vec3 direction; // Normalised.
+			float outer_angle;  // Half angle of the cone in radians.
+		};
+		// The lights of one cluster, light_indices()[offset, offset + point_count) index the point lights,
+		// the spot_count indices after them index the spot lights.
+		// Matches the std430 layout of the GLSL LightCluster struct.
+		struct Cluster
+		{
+			uint32_t offset      = 0;
+			uint32_t point_count = 0;
+			uint32_t spot_count  = 0;
+			uint32_t padding     = 0;
+		};
+		static_assert(sizeof(Cluster) == 16, "Cluster must match the std430 stride of the GLSL LightCluster struct.");
+		// The fixed portion of the LightClustersBuffer SSBO the shaders use to find the cluster of a fragment.
+		struct Header
+		{
+			glm::uvec4 grid;    // xyz: Cluster count along each axis. w unused.
+			glm::vec4 slicing;  // xy: Size in pixels of the screen tile of a cluster. z, w: Scale and bias mapping log(view depth) to a depth slice.
+		};
+		static_assert(sizeof(Header) == 32, "Header must match the std430 layout of the LightClustersBuffer fixed portion.");
+
+		static constexpr glm::uvec3 Default_Grid = {16, 9, 24};
+
+		LightClusters(const glm::uvec3& p_grid = Default_Grid) noexcept;
+
+		// Change the cluster count along each axis, takes effect on the next build_grid.
+		void set_grid(const glm::uvec3& p_grid);
+		// Build the view space bounds of every cluster for the view volume of p_projection, only recomputed when the projection or grid changed.
+		// Orthographic and perspective projections are both supported.
+		//@param p_resolution Size in pixels of the target the clusters cover.
+		void build_grid(const glm::mat4& p_projection, const glm::uvec2& p_resolution);
+		// Assign the lights to the clusters their volume overlaps, replacing the previous assignment.
+		// Depth slices are processed in parallel when there's enough work to be worth the threads.
+		void assign(std::span<const PointLight> p_point_lights, std::span<const SpotLight> p_spot_lights);
+
+		const Header& header() const                         { return m_header; }
+		const std::vector<Cluster>& clusters() const         { return m_clusters; }
+		const std::vector<uint32_t>& light_indices() const   { return m_light_indices; }
+		const std::vector<Geometry::AABB>& bounds() const    { return m_bounds; }
+		// The cluster a fragment at p_pixel with a view depth of p_view_depth (distance along -z) reads its lights from, mirrors phong.frag.
+		glm::uvec3 cluster_at(const glm::vec2& p_pixel, float p_view_depth) const;
+		// Index into clusters() and bounds() of the cluster at p_cluster.
+		size_t cluster_index(const glm::uvec3& p_cluster) const { return p_cluster.x + m_grid.x * (p_cluster.y + m_grid.y * p_cluster.z); }
+		// The largest number of lights in a single cluster in the last assign.
+		size_t max_cluster_lights() const                    { return m_max_cluster_lights; }
+
+		// Distance from a light at which its attenuation drops its contribution below 1/256, the precision of an 8 bit target.
+		// Infinity if the attenuation never gets there, lights without linear or quadratic falloff light every cluster.
+		//@param p_intensity Largest colour component the light contributes before attenuation.
+		static float attenuation_radius(float p_constant, float p_linear, float p_quadratic, float p_intensity);
+
+	private:
+		glm::uvec3 m_grid;
+		glm::mat4 m_projection; // Projection m_bounds were built for.
+		glm::uvec2 m_resolution;
+		Header m_header;
+		std::vector<Geometry::AABB> m_bounds; // View space bounds of each cluster, indexed by cluster_index.
+		std::vector<float> m_slice_depths;    // Near view depth of each depth slice followed by the far depth of the last.
+		std::vector<Cluster> m_clusters;
+		std::vector<uint32_t> m_light_indices;
+		std::vector<std::vector<uint32_t>> m_slice_indices; // Light indices of each depth slice, written in parallel then concatenated.
+		size_t m_max_cluster_lights;
+	};
+} // namespace OpenGL
@@ -0,0 +1,933 @@
+#include "NullGL.hpp"
+#include "GLState.hpp"
+
+#include "Utility/Logger.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenGL::NullGL
+{
+	namespace
+	{
+		// GLSL REFLECTION
+		// The program interface a context reports after linking, rebuilt from the declarations in the sources of the attached shaders.
+		// Covers the subset of GLSL the engine's shaders declare: loose uniforms, structs, std140/std430 interface blocks and vertex attributes.
+		// Unlike a context, every declared uniform is active, none are optimised away.
+
+		// A member of a struct or interface block, or a loose uniform.
+		struct Declaration
+		{
+			std::string type;
+			std::string name;
+			std::optional<GLint> array_size; // 0 for an unsized array.
+		};
+		struct BlockDeclaration
+		{
+			std::string name;
+			bool has_instance_name = false; // Members of a block with an instance name are prefixed with the block name.
+			bool storage           = false; // A shader storage block, otherwise a uniform block.
+			bool std430            = false; // Otherwise std140, shared and packed blocks are laid out as std140.
+			GLint binding          = 0;
+			std::vector<Declaration> members;
+		};
+		struct Declarations
+		{
+			std::unordered_map<std::string, std::vector<Declaration>> structs;
+			std::vector<std::pair<Declaration, GLint>> uniforms;          // With their explicit location, -1 if not given.
+			std::vector<BlockDeclaration> blocks;
+			std::vector<std::pair<std::string, GLint>> attributes; // Vertex inputs with an explicit location.
+		};
+
+		// An active variable of the program interface.
+		struct Variable
+		{
+			std::string name;
+			GLenum type                  = GL_NONE;
+			GLint offset                 = -1;
+			GLint array_size             = 1;
+			GLint array_stride           = -1;
+			GLint matrix_stride          = -1;
+			GLint location               = -1;
+			GLint block_index            = -1;
+			GLint top_level_array_size   = 1;
+			GLint top_level_array_stride = 0;
+		};
+		struct Block
+		{
+			std::string name;
+			GLint binding   = 0;
+			GLint data_size = 0;
+			std::vector<GLint> variables; // Indices of the active variables of the block.
+		};
+		struct ProgramInterface
+		{
+			std::vector<Variable> uniforms;         // The loose uniforms followed by the members of the uniform blocks.
+			std::vector<Variable> buffer_variables; // The members of the shader storage blocks.
+			std::vector<Block> uniform_blocks;
+			std::vector<Block> storage_blocks;
+			std::vector<std::pair<std::string, GLint>> attributes;
+		};
+
+		struct BasicType
+		{
+			GLenum type;
+			GLint rows;    // Components of a vector or a column of a matrix, 0 for opaque types.
+			GLint columns;
+		};
+		std::optional<BasicType> basic_type(const std::string& p_type)
+		{
+			static const std::unordered_map<std::string, BasicType> types = {
+				{"float", {GL_FLOAT, 1, 1}},        {"vec2", {GL_FLOAT_VEC2, 2, 1}},        {"vec3", {GL_FLOAT_VEC3, 3, 1}},        {"vec4", {GL_FLOAT_VEC4, 4, 1}},
+				{"int", {GL_INT, 1, 1}},            {"ivec2", {GL_INT_VEC2, 2, 1}},         {"ivec3", {GL_INT_VEC3, 3, 1}},         {"ivec4", {GL_INT_VEC4, 4, 1}},
+				{"uint", {GL_UNSIGNED_INT, 1, 1}},  {"uvec2", {GL_UNSIGNED_INT_VEC2, 2, 1}}, {"uvec3", {GL_UNSIGNED_INT_VEC3, 3, 1}}, {"uvec4", {GL_UNSIGNED_INT_VEC4, 4, 1}},
+				{"bool", {GL_BOOL, 1, 1}},          {"bvec2", {GL_BOOL_VEC2, 2, 1}},        {"bvec3", {GL_BOOL_VEC3, 3, 1}},        {"bvec4", {GL_BOOL_VEC4, 4, 1}},
+				{"mat2", {GL_FLOAT_MAT2, 2, 2}},    {"mat3", {GL_FLOAT_MAT3, 3, 3}},        {"mat4", {GL_FLOAT_MAT4, 4, 4}},
+				{"mat2x3", {GL_FLOAT_MAT2x3, 3, 2}}, {"mat2x4", {GL_FLOAT_MAT2x4, 4, 2}},   {"mat3x2", {GL_FLOAT_MAT3x2, 2, 3}},
+				{"mat3x4", {GL_FLOAT_MAT3x4, 4, 3}}, {"mat4x2", {GL_FLOAT_MAT4x2, 2, 4}},   {"mat4x3", {GL_FLOAT_MAT4x3, 3, 4}},
+				{"sampler2D", {GL_SAMPLER_2D, 0, 0}},             {"sampler3D", {GL_SAMPLER_3D, 0, 0}},               {"samplerCube", {GL_SAMPLER_CUBE, 0, 0}},
+				{"sampler2DArray", {GL_SAMPLER_2D_ARRAY, 0, 0}},  {"sampler2DShadow", {GL_SAMPLER_2D_SHADOW, 0, 0}}, {"isampler2D", {GL_INT_SAMPLER_2D, 0, 0}},
+				{"usampler2D", {GL_UNSIGNED_INT_SAMPLER_2D, 0, 0}}};
+
+			auto it = types.find(p_type);
+			return it != types.end() ? std::optional<BasicType>(it->second) : std::nullopt;
+		}
+
+		// Split p_source into identifiers, numbers and single character symbols, dropping comments and preprocessor lines.
+		// Shader::process_code has resolved the #ifdef blocks before the source reaches the context.
+		std::vector<std::string> tokenise(const std::string& p_source)
+		{
+			std::vector<std::string> tokens;
+			size_t i = 0;
+			while (i < p_source.size())
+			{
+				const char c = p_source[i];
+				if (std::isspace(static_cast<unsigned char>(c)))
+					i++;
+				else if (p_source.compare(i, 2, "//") == 0 || c == '#')
+					i = std::min(p_source.find('\n', i), p_source.size());
+				else if (p_source.compare(i, 2, "/*") == 0)
+					i = std::min(p_source.find("*/", i), p_source.size() - 2) + 2;
+				else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+				{
+					const size_t start = i;
+					while (i < p_source.size() && (std::isalnum(static_cast<unsigned char>(p_source[i])) || p_source[i] == '_'))
+						i++;
+					tokens.emplace_back(p_source.substr(start, i - start));
+				}
+				else
+					tokens.emplace_back(1, p_source[i++]);
+			}
+			return tokens;
+		}
+
+		// The tokens of a declaration with its layout and qualifiers other than the storage qualifier removed.
+		struct Statement
+		{
+			std::vector<std::string> tokens;
+			bool std430    = false;
+			GLint binding  = 0;
+			GLint location = -1;
+
+			bool has(std::string_view p_token) const { return std::find(tokens.begin(), tokens.end(), p_token) != tokens.end(); }
+		};
+		Statement make_statement(const std::vector<std::string>& p_tokens)
+		{
+			static const std::vector<std::string_view> ignored_qualifiers = {"const", "readonly", "writeonly", "coherent", "volatile", "restrict",
+				"highp", "mediump", "lowp", "flat", "smooth", "noperspective", "centroid", "invariant", "precise"};
+
+			Statement statement;
+			for (size_t i = 0; i < p_tokens.size(); i++)
+			{
+				if (p_tokens[i] == "layout")
+				{ // layout(std430, binding = 0)
+					for (i += 2; i < p_tokens.size() && p_tokens[i] != ")"; i++)
+					{
+						auto value = [&]() { return i + 2 < p_tokens.size() && p_tokens[i + 1] == "=" ? static_cast<GLint>(std::stoi(p_tokens[i + 2])) : 0; };
+						if (p_tokens[i] == "std430")        statement.std430   = true;
+						else if (p_tokens[i] == "binding")  statement.binding  = value();
+						else if (p_tokens[i] == "location") statement.location = value();
+					}
+				}
+				else if (std::find(ignored_qualifiers.begin(), ignored_qualifiers.end(), p_tokens[i]) == ignored_qualifiers.end())
+					statement.tokens.push_back(p_tokens[i]);
+			}
+			return statement;
+		}
+		// Parse the names following the type of p_statement, 'vec3 a, b[4];' declares a and b.
+		void add_declarations(const Statement& p_statement, std::vector<Declaration>& p_declarations)
+		{
+			if (p_statement.tokens.size() < 2)
+				return;
+
+			const auto& type = p_statement.tokens[0];
+			for (size_t i = 1; i < p_statement.tokens.size(); i++)
+			{
+				if (p_statement.tokens[i] == "=")
+					break; // Initialiser of a loose uniform.
+				if (p_statement.tokens[i] == ",")
+					continue;
+
+				Declaration declaration{type, p_statement.tokens[i], std::nullopt};
+				if (i + 1 < p_statement.tokens.size() && p_statement.tokens[i + 1] == "[")
+				{
+					const bool sized         = p_statement.tokens[i + 2] != "]";
+					declaration.array_size = sized ? static_cast<GLint>(std::stoi(p_statement.tokens[i + 2])) : 0;
+					i += sized ? 3 : 2;
+				}
+				p_declarations.push_back(std::move(declaration));
+			}
+		}
+		// Parse the member declarations between the braces starting at p_tokens[p_index] into p_members.
+		//@return The index of the closing brace.
+		size_t parse_members(const std::vector<std::string>& p_tokens, size_t p_index, std::vector<Declaration>& p_members)
+		{
+			std::vector<std::string> member;
+			for (size_t i = p_index + 1; i < p_tokens.size(); i++)
+			{
+				if (p_tokens[i] == "}")
+					return i;
+				if (p_tokens[i] == ";")
+				{
+					add_declarations(make_statement(member), p_members);
+					member.clear();
+				}
+				else
+					member.push_back(p_tokens[i]);
+			}
+			return p_tokens.size();
+		}
+		void parse(const std::string& p_source, GLenum p_stage, Declarations& p_declarations)
+		{
+			const auto tokens = tokenise(p_source);
+			std::vector<std::string> current;
+			for (size_t i = 0; i < tokens.size(); i++)
+			{
+				if (tokens[i] == "{")
+				{
+					const auto statement = make_statement(current);
+					current.clear();
+					if (statement.tokens.size() == 2 && statement.tokens[0] == "struct")
+					{
+						i = parse_members(tokens, i, p_declarations.structs[statement.tokens[1]]);
+					}
+					else if (!statement.tokens.empty() && (statement.has("uniform") || statement.has("buffer")))
+					{
+						BlockDeclaration block;
+						block.name    = statement.tokens.back();
+						block.storage = statement.has("buffer");
+						block.std430  = statement.std430;
+						block.binding = statement.binding;
+						i = parse_members(tokens, i, block.members);
+						block.has_instance_name = i + 1 < tokens.size() && tokens[i + 1] != ";";
+						p_declarations.blocks.push_back(std::move(block));
+					}
+					else
+					{ // A function body or an in/out block, skip to the matching brace.
+						for (size_t depth = 1; depth > 0 && ++i < tokens.size();)
+						{
+							if (tokens[i] == "{")      depth++;
+							else if (tokens[i] == "}") depth--;
+						}
+					}
+				}
+				else if (tokens[i] == ";")
+				{
+					auto statement = make_statement(current);
+					current.clear();
+					if (!statement.tokens.empty() && statement.tokens[0] == "uniform")
+					{
+						statement.tokens.erase(statement.tokens.begin());
+						std::vector<Declaration> uniforms;
+						add_declarations(statement, uniforms);
+						for (auto& uniform : uniforms)
+							p_declarations.uniforms.emplace_back(std::move(uniform), statement.location);
+					}
+					else if (p_stage == GL_VERTEX_SHADER && statement.location != -1 && statement.tokens.size() == 3 && statement.tokens[0] == "in")
+						p_declarations.attributes.emplace_back(statement.tokens[2], statement.location);
+				}
+				else
+					current.push_back(tokens[i]);
+			}
+		}
+
+		GLint align_up(GLint p_value, GLint p_alignment)
+		{
+			return (p_value + p_alignment - 1) / p_alignment * p_alignment;
+		}
+
+		// Lays out the declarations of a block by the std140 or std430 rules and lists their active variables named as a context names them.
+		class Reflector
+		{
+			const Declarations& m_declarations;
+			bool m_std430;
+
+		public:
+			struct Layout
+			{
+				GLint alignment     = 0;
+				GLint size          = 0; // An array counts one element if unsized.
+				GLint array_stride  = 0;
+				GLint matrix_stride = 0;
+			};
+
+			Reflector(const Declarations& p_declarations, bool p_std430) : m_declarations{p_declarations}, m_std430{p_std430} {}
+
+			// Layout of a single element of p_type.
+			Layout type_layout(const std::string& p_type) const
+			{
+				if (auto basic = basic_type(p_type))
+				{
+					ASSERT_THROW(basic->rows > 0, "Opaque type {} cannot be a member of an interface block", p_type);
+					const GLint vector_size      = basic->rows * 4;
+					const GLint vector_alignment = basic->rows == 1 ? 4 : basic->rows == 2 ? 8 : 16;
+					if (basic->columns == 1)
+						return {vector_alignment, vector_size, 0, 0};
+
+					// A matrix is laid out as an array of its column vectors.
+					const GLint column_alignment = m_std430 ? vector_alignment : 16;
+					return {column_alignment, column_alignment * basic->columns, 0, column_alignment};
+				}
+
+				auto it = m_declarations.structs.find(p_type);
+				ASSERT_THROW(it != m_declarations.structs.end(), "Unknown GLSL type {}", p_type);
+
+				Layout layout{m_std430 ? 0 : 16, 0, 0, 0};
+				for (const auto& member : it->second)
+				{
+					const auto member_layout = declaration_layout(member);
+					layout.size      = align_up(layout.size, member_layout.alignment) + member_layout.size;
+					layout.alignment = std::max(layout.alignment, member_layout.alignment);
+				}
+				layout.size = align_up(layout.size, layout.alignment);
+				return layout;
+			}
+			Layout declaration_layout(const Declaration& p_declaration) const
+			{
+				auto layout = type_layout(p_declaration.type);
+				if (!p_declaration.array_size)
+					return layout;
+
+				if (!m_std430) // std140 rounds the alignment of array elements up to a vec4.
+					layout.alignment = align_up(layout.alignment, 16);
+				layout.array_stride = align_up(layout.size, layout.alignment);
+				layout.size         = layout.array_stride * std::max(*p_declaration.array_size, 1);
+				return layout;
+			}
+
+			// Append the active variables of p_declaration placed at p_offset.
+			//@param p_prefix Prepended to the names of the variables, the names of the enclosing structs.
+			//@param p_top_level_storage A member of a shader storage block, arrays of structs at the top level only list their first element.
+			void add_variables(const Declaration& p_declaration, const std::string& p_prefix, GLint p_offset, bool p_top_level_storage, std::vector<Variable>& p_variables) const
+			{
+				const auto layout = declaration_layout(p_declaration);
+				if (auto basic = basic_type(p_declaration.type))
+				{
+					Variable variable;
+					variable.name          = p_prefix + p_declaration.name + (p_declaration.array_size ? "[0]" : "");
+					variable.type          = basic->type;
+					variable.offset        = p_offset;
+					variable.array_size    = p_declaration.array_size.value_or(1);
+					variable.array_stride  = layout.array_stride;
+					variable.matrix_stride = layout.matrix_stride;
+					p_variables.push_back(std::move(variable));
+					return;
+				}
+
+				const auto& members    = m_declarations.structs.at(p_declaration.type);
+				const GLint elements = !p_declaration.array_size || p_top_level_storage ? 1 : *p_declaration.array_size;
+				for (GLint element = 0; element < elements; element++)
+				{
+					const auto prefix = p_prefix + p_declaration.name + (p_declaration.array_size ? "[" + std::to_string(element) + "]." : ".");
+					GLint offset      = p_offset + element * layout.array_stride;
+					for (const auto& member : members)
+					{
+						const auto member_layout = declaration_layout(member);
+						offset = align_up(offset, member_layout.alignment);
+						add_variables(member, prefix, offset, false, p_variables);
+						offset += member_layout.size;
+					}
+				}
+			}
+
+			// Append the block and its active variables to p_interface.
+			void add_block(const BlockDeclaration& p_block, ProgramInterface& p_interface) const
+			{
+				auto& blocks    = p_block.storage ? p_interface.storage_blocks : p_interface.uniform_blocks;
+				auto& variables = p_block.storage ? p_interface.buffer_variables : p_interface.uniforms;
+				const std::string prefix = p_block.has_instance_name ? p_block.name + "." : "";
+
+				Block block{p_block.name, p_block.binding, 0, {}};
+				GLint offset    = 0;
+				GLint alignment = m_std430 ? 4 : 16;
+				for (const auto& member : p_block.members)
+				{
+					const auto layout = declaration_layout(member);
+					offset            = align_up(offset, layout.alignment);
+					alignment         = std::max(alignment, layout.alignment);
+
+					const size_t first = variables.size();
+					add_variables(member, prefix, offset, p_block.storage, variables);
+					// Only arrays of structs count as top level arrays, an array of a basic type is the variable itself.
+					const bool struct_array = member.array_size && !basic_type(member.type);
+					for (size_t i = first; i < variables.size(); i++)
+					{
+						variables[i].block_index            = static_cast<GLint>(blocks.size());
+						variables[i].top_level_array_size   = struct_array ? *member.array_size : 1;
+						variables[i].top_level_array_stride = struct_array ? layout.array_stride : 0;
+						block.variables.push_back(static_cast<GLint>(i));
+					}
+					offset += layout.size;
+				}
+				block.data_size = align_up(offset, alignment);
+				blocks.push_back(std::move(block));
+			}
+		};
+
+		// Build the interface of a program linked from p_sources (stage, source). Declarations repeated across stages are listed once.
+		ProgramInterface reflect(const std::vector<std::pair<GLenum, std::string>>& p_sources)
+		{
+			Declarations declarations;
+			for (const auto& [stage, source] : p_sources)
+				parse(source, stage, declarations);
+
+			ProgramInterface program_interface;
+			GLint next_location = 0;
+			for (const auto& [uniform, location] : declarations.uniforms)
+			{
+				const auto name = uniform.name + (uniform.array_size ? "[0]" : "");
+				if (std::any_of(program_interface.uniforms.begin(), program_interface.uniforms.end(), [&name](const auto& p_uniform) { return p_uniform.name == name; }))
+					continue;
+
+				Variable variable;
+				variable.name       = name;
+				variable.type       = basic_type(uniform.type).value_or(BasicType{GL_NONE, 0, 0}).type;
+				variable.array_size = uniform.array_size.value_or(1);
+				variable.location   = location != -1 ? location : next_location;
+				next_location       = std::max(next_location, variable.location + variable.array_size);
+				program_interface.uniforms.push_back(std::move(variable));
+			}
+
+			std::vector<std::string> added_blocks;
+			for (const auto& block : declarations.blocks)
+			{
+				if (std::find(added_blocks.begin(), added_blocks.end(), block.name) != added_blocks.end())
+					continue;
+
+				added_blocks.push_back(block.name);
+				Reflector(declarations, block.std430).add_block(block, program_interface);
+			}
+
+			program_interface.attributes = std::move(declarations.attributes);
+			return program_interface;
+		}
+
+
+		// CONTEXT
+		struct Buffer
+		{
+			std::vector<std::byte> data;
+			bool immutable = false;
+		};
+		struct ShaderObject
+		{
+			GLenum stage;
+			std::string source;
+		};
+		struct Program
+		{
+			std::vector<GLuint> shaders;
+			ProgramInterface program_interface;
+		};
+		struct Context
+		{
+			GLuint next_handle = 1; // Every kind of object shares one namespace, 0 is never a valid handle.
+			GLsync next_sync   = nullptr;
+			std::unordered_map<GLuint, Buffer> buffers;
+			std::unordered_map<GLuint, ShaderObject> shaders;
+			std::unordered_map<GLuint, Program> programs;
+			size_t draw_count = 0;
+		};
+		Context& context()
+		{
+			static Context instance;
+			return instance;
+		}
+
+		void APIENTRY create_objects(GLsizei p_count, GLuint* p_handles)
+		{
+			for (GLsizei i = 0; i < p_count; i++)
+				p_handles[i] = context().next_handle++;
+		}
+		Buffer& get_buffer(GLuint p_buffer)
+		{
+			auto it = context().buffers.find(p_buffer);
+			ASSERT_THROW(it != context().buffers.end(), "Buffer {} does not exist in the null context", p_buffer);
+			return it->second;
+		}
+		ProgramInterface& get_interface(GLuint p_program)
+		{
+			auto it = context().programs.find(p_program);
+			ASSERT_THROW(it != context().programs.end(), "Program {} does not exist in the null context", p_program);
+			return it->second.program_interface;
+		}
+		const std::vector<Variable>& get_variables(GLuint p_program, GLenum p_interface)
+		{
+			return p_interface == GL_BUFFER_VARIABLE ? get_interface(p_program).buffer_variables : get_interface(p_program).uniforms;
+		}
+		const std::vector<Block>& get_blocks(GLuint p_program, GLenum p_interface)
+		{
+			return p_interface == GL_SHADER_STORAGE_BLOCK ? get_interface(p_program).storage_blocks : get_interface(p_program).uniform_blocks;
+		}
+		bool is_block_interface(GLenum p_interface)
+		{
+			return p_interface == GL_UNIFORM_BLOCK || p_interface == GL_SHADER_STORAGE_BLOCK;
+		}
+
+
+		// GL FUNCTIONS
+		// Functions with no effect without a GPU return a zero initialised value.
+		template <typename Proc>
+		struct NoOp;
+		template <typename Return, typename... Args>
+		struct NoOp<Return (APIENTRYP)(Args...)>
+		{
+			static Return APIENTRY call(Args...)
+			{
+				if constexpr (!std::is_void_v<Return>)
+					return Return{};
+			}
+		};
+
+		const GLubyte* APIENTRY get_string(GLenum p_name)
+		{
+			switch (p_name)
+			{
+				case GL_VERSION:                  return reinterpret_cast<const GLubyte*>("4.6.0 Null");
+				case GL_SHADING_LANGUAGE_VERSION: return reinterpret_cast<const GLubyte*>("4.60 Null");
+				case GL_VENDOR:                   return reinterpret_cast<const GLubyte*>("Spirit");
+				case GL_RENDERER:                 return reinterpret_cast<const GLubyte*>("Null");
+				default:                          return reinterpret_cast<const GLubyte*>("");
+			}
+		}
+		const GLubyte* APIENTRY get_string_i(GLenum, GLuint)
+		{
+			return reinterpret_cast<const GLubyte*>("GL_SPIRIT_null");
+		}
+		void APIENTRY get_integer_v(GLenum p_name, GLint* p_data)
+		{
+			switch (p_name)
+			{
+				case GL_NUM_EXTENSIONS:                        *p_data = 1;         break; // The loader requires at least one extension.
+				case GL_MAX_TEXTURE_SIZE:                      *p_data = 16384;     break;
+				case GL_MAX_3D_TEXTURE_SIZE:                   *p_data = 2048;      break;
+				case GL_MAX_CUBE_MAP_TEXTURE_SIZE:             *p_data = 16384;     break;
+				case GL_MAX_ARRAY_TEXTURE_LAYERS:              *p_data = 2048;      break;
+				case GL_MAX_TEXTURE_IMAGE_UNITS:               *p_data = 16;        break;
+				case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:        *p_data = 16;        break;
+				case GL_MAX_GEOMETRY_TEXTURE_IMAGE_UNITS:      *p_data = 16;        break;
+				case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:      *p_data = 80;        break;
+				case GL_MAX_UNIFORM_BUFFER_BINDINGS:           *p_data = 84;        break;
+				case GL_MAX_UNIFORM_BLOCK_SIZE:                *p_data = 16384;     break;
+				case GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS:    *p_data = 8;         break;
+				case GL_MAX_SHADER_STORAGE_BLOCK_SIZE:         *p_data = 134217728; break;
+				case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:       *p_data = 256;       break; // The largest alignment the spec allows.
+				case GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT: *p_data = 256;      break;
+				default:                                       *p_data = 0;         break;
+			}
+		}
+
+		void APIENTRY create_buffers(GLsizei p_count, GLuint* p_buffers)
+		{
+			create_objects(p_count, p_buffers);
+			for (GLsizei i = 0; i < p_count; i++)
+				context().buffers[p_buffers[i]];
+		}
+		void APIENTRY delete_buffers(GLsizei p_count, const GLuint* p_buffers)
+		{
+			for (GLsizei i = 0; i < p_count; i++)
+				context().buffers.erase(p_buffers[i]);
+		}
+		void APIENTRY named_buffer_storage(GLuint p_buffer, GLsizeiptr p_size, const void* p_data, GLbitfield)
+		{
+			auto& buffer = get_buffer(p_buffer);
+			ASSERT_THROW(!buffer.immutable, "Buffer {} storage is immutable", p_buffer);
+			buffer.immutable = true;
+			buffer.data.assign(static_cast<size_t>(p_size), std::byte{0});
+			if (p_data)
+				std::memcpy(buffer.data.data(), p_data, static_cast<size_t>(p_size));
+		}
+		void APIENTRY named_buffer_sub_data(GLuint p_buffer, GLintptr p_offset, GLsizeiptr p_size, const void* p_data)
+		{
+			std::memcpy(get_buffer(p_buffer).data.data() + p_offset, p_data, static_cast<size_t>(p_size));
+		}
+		void APIENTRY get_named_buffer_sub_data(GLuint p_buffer, GLintptr p_offset, GLsizeiptr p_size, void* p_data)
+		{
+			std::memcpy(p_data, get_buffer(p_buffer).data.data() + p_offset, static_cast<size_t>(p_size));
+		}
+		void APIENTRY copy_named_buffer_sub_data(GLuint p_read_buffer, GLuint p_write_buffer, GLintptr p_read_offset, GLintptr p_write_offset, GLsizeiptr p_size)
+		{
+			std::memmove(get_buffer(p_write_buffer).data.data() + p_write_offset, get_buffer(p_read_buffer).data.data() + p_read_offset, static_cast<size_t>(p_size));
+		}
+		void APIENTRY clear_named_buffer_sub_data(GLuint p_buffer, GLenum, GLintptr p_offset, GLsizeiptr p_size, GLenum, GLenum, const void* p_data)
+		{
+			ASSERT_THROW(p_data == nullptr, "The null context only clears buffers to zero");
+			std::memset(get_buffer(p_buffer).data.data() + p_offset, 0, static_cast<size_t>(p_size));
+		}
+		void APIENTRY get_named_buffer_parameter_iv(GLuint p_buffer, GLenum p_name, GLint* p_params)
+		{
+			const auto& buffer = get_buffer(p_buffer);
+			switch (p_name)
+			{
+				case GL_BUFFER_IMMUTABLE_STORAGE: *p_params = buffer.immutable ? GL_TRUE : GL_FALSE;      break;
+				case GL_BUFFER_SIZE:              *p_params = static_cast<GLint>(buffer.data.size()); break;
+				default:                          *p_params = 0;                                      break;
+			}
+		}
+		void* APIENTRY map_named_buffer_range(GLuint p_buffer, GLintptr p_offset, GLsizeiptr, GLbitfield)
+		{
+			return get_buffer(p_buffer).data.data() + p_offset;
+		}
+		GLboolean APIENTRY unmap_named_buffer(GLuint)
+		{
+			return GL_TRUE;
+		}
+
+		GLsync APIENTRY fence_sync(GLenum, GLbitfield)
+		{
+			auto& sync = context().next_sync;
+			sync = reinterpret_cast<GLsync>(reinterpret_cast<std::uintptr_t>(sync) + 1);
+			return sync;
+		}
+		GLenum APIENTRY client_wait_sync(GLsync, GLbitfield, GLuint64)
+		{
+			return GL_ALREADY_SIGNALED; // Nothing is ever in flight.
+		}
+
+		void APIENTRY create_textures(GLenum, GLsizei p_count, GLuint* p_textures)
+		{
+			create_objects(p_count, p_textures);
+		}
+		void APIENTRY get_texture_image(GLuint, GLint, GLenum, GLenum, GLsizei p_size, void* p_pixels)
+		{
+			std::memset(p_pixels, 0, static_cast<size_t>(p_size));
+		}
+		GLenum APIENTRY check_named_framebuffer_status(GLuint, GLenum)
+		{
+			return GL_FRAMEBUFFER_COMPLETE;
+		}
+
+		GLuint APIENTRY create_shader(GLenum p_stage)
+		{
+			const GLuint handle        = context().next_handle++;
+			context().shaders[handle] = {p_stage, ""};
+			return handle;
+		}
+		void APIENTRY delete_shader(GLuint p_shader)
+		{
+			context().shaders.erase(p_shader);
+		}
+		void APIENTRY shader_source(GLuint p_shader, GLsizei p_count, const GLchar* const* p_strings, const GLint* p_lengths)
+		{
+			auto& source = context().shaders.at(p_shader).source;
+			source.clear();
+			for (GLsizei i = 0; i < p_count; i++)
+				source.append(p_strings[i], p_lengths && p_lengths[i] >= 0 ? static_cast<size_t>(p_lengths[i]) : std::strlen(p_strings[i]));
+		}
+		void APIENTRY get_shader_iv(GLuint p_shader, GLenum p_name, GLint* p_params)
+		{
+			switch (p_name)
+			{
+				case GL_COMPILE_STATUS: *p_params = GL_TRUE;                                                       break;
+				case GL_SHADER_TYPE:    *p_params = static_cast<GLint>(context().shaders.at(p_shader).stage); break;
+				default:                *p_params = 0;                                                             break;
+			}
+		}
+		GLuint APIENTRY create_program()
+		{
+			const GLuint handle         = context().next_handle++;
+			context().programs[handle] = {};
+			return handle;
+		}
+		void APIENTRY delete_program(GLuint p_program)
+		{
+			context().programs.erase(p_program);
+		}
+		void APIENTRY attach_shader(GLuint p_program, GLuint p_shader)
+		{
+			context().programs.at(p_program).shaders.push_back(p_shader);
+		}
+		void APIENTRY link_program(GLuint p_program)
+		{
+			auto& program = context().programs.at(p_program);
+			std::vector<std::pair<GLenum, std::string>> sources;
+			for (auto shader : program.shaders)
+			{
+				const auto& shader_object = context().shaders.at(shader);
+				sources.emplace_back(shader_object.stage, shader_object.source);
+			}
+			program.program_interface = reflect(sources);
+		}
+		void APIENTRY get_program_iv(GLuint, GLenum p_name, GLint* p_params)
+		{
+			*p_params = p_name == GL_LINK_STATUS ? GL_TRUE : 0;
+		}
+		void APIENTRY get_program_interface_iv(GLuint p_program, GLenum p_interface, GLenum p_name, GLint* p_params)
+		{
+			std::vector<std::string_view> names;
+			if (is_block_interface(p_interface))
+				for (const auto& block : get_blocks(p_program, p_interface)) names.push_back(block.name);
+			else
+				for (const auto& variable : get_variables(p_program, p_interface)) names.push_back(variable.name);
+
+			switch (p_name)
+			{
+				case GL_ACTIVE_RESOURCES: *p_params = static_cast<GLint>(names.size()); break;
+				case GL_MAX_NAME_LENGTH:
+					*p_params = 0;
+					for (auto name : names)
+						*p_params = std::max(*p_params, static_cast<GLint>(name.size() + 1));
+					break;
+				default: *p_params = 0; break;
+			}
+		}
+		void APIENTRY get_program_resource_iv(GLuint p_program, GLenum p_interface, GLuint p_index, GLsizei p_property_count, const GLenum* p_properties, GLsizei p_count, GLsizei* p_length, GLint* p_params)
+		{
+			std::vector<GLint> values;
+			for (GLsizei i = 0; i < p_property_count; i++)
+			{
+				if (is_block_interface(p_interface))
+				{
+					const auto& block = get_blocks(p_program, p_interface).at(p_index);
+					switch (p_properties[i])
+					{
+						case GL_NAME_LENGTH:            values.push_back(static_cast<GLint>(block.name.size() + 1));      break;
+						case GL_NUM_ACTIVE_VARIABLES:   values.push_back(static_cast<GLint>(block.variables.size()));     break;
+						case GL_BUFFER_BINDING:         values.push_back(block.binding);                                  break;
+						case GL_BUFFER_DATA_SIZE:       values.push_back(block.data_size);                                break;
+						case GL_ACTIVE_VARIABLES:       values.insert(values.end(), block.variables.begin(), block.variables.end()); break;
+						default:                        values.push_back(0);                                              break;
+					}
+				}
+				else
+				{
+					const auto& variable = get_variables(p_program, p_interface).at(p_index);
+					switch (p_properties[i])
+					{
+						case GL_NAME_LENGTH:              values.push_back(static_cast<GLint>(variable.name.size() + 1)); break;
+						case GL_TYPE:                     values.push_back(static_cast<GLint>(variable.type));            break;
+						case GL_OFFSET:                   values.push_back(variable.offset);                              break;
+						case GL_ARRAY_SIZE:               values.push_back(variable.array_size);                          break;
+						case GL_ARRAY_STRIDE:             values.push_back(variable.array_stride);                        break;
+						case GL_MATRIX_STRIDE:            values.push_back(variable.matrix_stride);                       break;
+						case GL_LOCATION:                 values.push_back(variable.location);                            break;
+						case GL_BLOCK_INDEX:              values.push_back(variable.block_index);                         break;
+						case GL_TOP_LEVEL_ARRAY_SIZE:     values.push_back(variable.top_level_array_size);                break;
+						case GL_TOP_LEVEL_ARRAY_STRIDE:   values.push_back(variable.top_level_array_stride);              break;
+						default:                          values.push_back(0);                                            break; // GL_IS_ROW_MAJOR
+					}
+				}
+			}
+
+			const auto written = std::min(values.size(), static_cast<size_t>(p_count));
+			std::copy_n(values.begin(), written, p_params);
+			if (p_length)
+				*p_length = static_cast<GLsizei>(written);
+		}
+		void APIENTRY get_program_resource_name(GLuint p_program, GLenum p_interface, GLuint p_index, GLsizei p_size, GLsizei* p_length, GLchar* p_name)
+		{
+			const std::string& name = is_block_interface(p_interface) ? get_blocks(p_program, p_interface).at(p_index).name : get_variables(p_program, p_interface).at(p_index).name;
+			if (p_size <= 0)
+				return;
+
+			const auto written = std::min(name.size(), static_cast<size_t>(p_size - 1));
+			std::memcpy(p_name, name.data(), written);
+			p_name[written] = '\0';
+			if (p_length)
+				*p_length = static_cast<GLsizei>(written);
+		}
+		GLint APIENTRY get_uniform_location(GLuint p_program, const GLchar* p_name)
+		{
+			const std::string name = p_name;
+			for (const auto& uniform : get_interface(p_program).uniforms)
+				if (uniform.block_index == -1 && (uniform.name == name || uniform.name == name + "[0]"))
+					return uniform.location;
+			return -1;
+		}
+		GLint APIENTRY get_attrib_location(GLuint p_program, const GLchar* p_name)
+		{
+			for (const auto& [name, location] : get_interface(p_program).attributes)
+				if (name == p_name)
+					return location;
+			return -1;
+		}
+		void APIENTRY uniform_block_binding(GLuint p_program, GLuint p_block_index, GLuint p_binding)
+		{
+			get_interface(p_program).uniform_blocks.at(p_block_index).binding = static_cast<GLint>(p_binding);
+		}
+		void APIENTRY shader_storage_block_binding(GLuint p_program, GLuint p_block_index, GLuint p_binding)
+		{
+			get_interface(p_program).storage_blocks.at(p_block_index).binding = static_cast<GLint>(p_binding);
+		}
+
+		void APIENTRY draw_arrays(GLenum, GLint, GLsizei)                                     { context().draw_count++; }
+		void APIENTRY draw_arrays_instanced(GLenum, GLint, GLsizei, GLsizei)                  { context().draw_count++; }
+		void APIENTRY draw_elements(GLenum, GLsizei, GLenum, const void*)                     { context().draw_count++; }
+		void APIENTRY draw_elements_instanced(GLenum, GLsizei, GLenum, const void*, GLsizei)  { context().draw_count++; }
+		void APIENTRY dispatch_compute(GLuint, GLuint, GLuint)                                 { context().draw_count++; }
+
+		// Converting checks p_function has the signature of the GL function it stands in for.
+		template <typename Proc>
+		void* proc(Proc p_function)
+		{
+			return reinterpret_cast<void*>(p_function);
+		}
+		template <typename Proc>
+		void* no_op()
+		{
+			return reinterpret_cast<void*>(&NoOp<Proc>::call);
+		}
+
+		void* get_proc_address(const char* p_name)
+		{
+			static const std::unordered_map<std::string_view, void*> functions = {
+				{"glGetString",                   proc<PFNGLGETSTRINGPROC>(&get_string)},
+				{"glGetStringi",                  proc<PFNGLGETSTRINGIPROC>(&get_string_i)},
+				{"glGetIntegerv",                 proc<PFNGLGETINTEGERVPROC>(&get_integer_v)},
+				{"glDebugMessageCallback",        no_op<PFNGLDEBUGMESSAGECALLBACKPROC>()},
+				{"glDebugMessageControl",         no_op<PFNGLDEBUGMESSAGECONTROLPROC>()},
+
+				// Buffers
+				{"glCreateBuffers",               proc<PFNGLCREATEBUFFERSPROC>(&create_buffers)},
+				{"glDeleteBuffers",               proc<PFNGLDELETEBUFFERSPROC>(&delete_buffers)},
+				{"glNamedBufferStorage",          proc<PFNGLNAMEDBUFFERSTORAGEPROC>(&named_buffer_storage)},
+				{"glNamedBufferSubData",          proc<PFNGLNAMEDBUFFERSUBDATAPROC>(&named_buffer_sub_data)},
+				{"glGetNamedBufferSubData",       proc<PFNGLGETNAMEDBUFFERSUBDATAPROC>(&get_named_buffer_sub_data)},
+				{"glCopyNamedBufferSubData",      proc<PFNGLCOPYNAMEDBUFFERSUBDATAPROC>(&copy_named_buffer_sub_data)},
+				{"glClearNamedBufferSubData",     proc<PFNGLCLEARNAMEDBUFFERSUBDATAPROC>(&clear_named_buffer_sub_data)},
+				{"glGetNamedBufferParameteriv",   proc<PFNGLGETNAMEDBUFFERPARAMETERIVPROC>(&get_named_buffer_parameter_iv)},
+				{"glMapNamedBufferRange",         proc<PFNGLMAPNAMEDBUFFERRANGEPROC>(&map_named_buffer_range)},
+				{"glUnmapNamedBuffer",            proc<PFNGLUNMAPNAMEDBUFFERPROC>(&unmap_named_buffer)},
+				{"glBindBufferRange",             no_op<PFNGLBINDBUFFERRANGEPROC>()},
+				{"glMemoryBarrier",               no_op<PFNGLMEMORYBARRIERPROC>()},
+				{"glFenceSync",                   proc<PFNGLFENCESYNCPROC>(&fence_sync)},
+				{"glClientWaitSync",              proc<PFNGLCLIENTWAITSYNCPROC>(&client_wait_sync)},
+				{"glDeleteSync",                  no_op<PFNGLDELETESYNCPROC>()},
+
+				// Vertex arrays
+				{"glCreateVertexArrays",          proc<PFNGLCREATEVERTEXARRAYSPROC>(&create_objects)},
+				{"glDeleteVertexArrays",          no_op<PFNGLDELETEVERTEXARRAYSPROC>()},
+				{"glBindVertexArray",             no_op<PFNGLBINDVERTEXARRAYPROC>()},
+				{"glVertexArrayVertexBuffer",     no_op<PFNGLVERTEXARRAYVERTEXBUFFERPROC>()},
+				{"glVertexArrayElementBuffer",    no_op<PFNGLVERTEXARRAYELEMENTBUFFERPROC>()},
+				{"glVertexArrayAttribFormat",     no_op<PFNGLVERTEXARRAYATTRIBFORMATPROC>()},
+				{"glVertexArrayAttribIFormat",    no_op<PFNGLVERTEXARRAYATTRIBIFORMATPROC>()},
+				{"glVertexArrayAttribLFormat",    no_op<PFNGLVERTEXARRAYATTRIBLFORMATPROC>()},
+				{"glVertexArrayAttribBinding",    no_op<PFNGLVERTEXARRAYATTRIBBINDINGPROC>()},
+				{"glEnableVertexArrayAttrib",     no_op<PFNGLENABLEVERTEXARRAYATTRIBPROC>()},
+
+				// Textures and framebuffers
+				{"glCreateTextures",              proc<PFNGLCREATETEXTURESPROC>(&create_textures)},
+				{"glDeleteTextures",              no_op<PFNGLDELETETEXTURESPROC>()},
+				{"glTextureStorage2D",            no_op<PFNGLTEXTURESTORAGE2DPROC>()},
+				{"glTextureSubImage2D",           no_op<PFNGLTEXTURESUBIMAGE2DPROC>()},
+				{"glCompressedTextureSubImage2D", no_op<PFNGLCOMPRESSEDTEXTURESUBIMAGE2DPROC>()},
+				{"glTextureParameteri",           no_op<PFNGLTEXTUREPARAMETERIPROC>()},
+				{"glGenerateTextureMipmap",       no_op<PFNGLGENERATETEXTUREMIPMAPPROC>()},
+				{"glClearTexSubImage",            no_op<PFNGLCLEARTEXSUBIMAGEPROC>()},
+				{"glGetTextureImage",             proc<PFNGLGETTEXTUREIMAGEPROC>(&get_texture_image)},
+				{"glBindTextureUnit",             no_op<PFNGLBINDTEXTUREUNITPROC>()},
+				{"glPixelStorei",                 no_op<PFNGLPIXELSTOREIPROC>()},
+				{"glCreateFramebuffers",          proc<PFNGLCREATEFRAMEBUFFERSPROC>(&create_objects)},
+				{"glDeleteFramebuffers",          no_op<PFNGLDELETEFRAMEBUFFERSPROC>()},
+				{"glBindFramebuffer",             no_op<PFNGLBINDFRAMEBUFFERPROC>()},
+				{"glNamedFramebufferTexture",     no_op<PFNGLNAMEDFRAMEBUFFERTEXTUREPROC>()},
+				{"glCheckNamedFramebufferStatus", proc<PFNGLCHECKNAMEDFRAMEBUFFERSTATUSPROC>(&check_named_framebuffer_status)},
+				{"glClearNamedFramebufferfv",     no_op<PFNGLCLEARNAMEDFRAMEBUFFERFVPROC>()},
+				{"glClearNamedFramebufferiv",     no_op<PFNGLCLEARNAMEDFRAMEBUFFERIVPROC>()},
+				{"glClearNamedFramebufferfi",     no_op<PFNGLCLEARNAMEDFRAMEBUFFERFIPROC>()},
+				{"glBlitNamedFramebuffer",        no_op<PFNGLBLITNAMEDFRAMEBUFFERPROC>()},
+				{"glReadPixels",                  no_op<PFNGLREADPIXELSPROC>()},
+
+				// Shaders
+				{"glCreateShader",                proc<PFNGLCREATESHADERPROC>(&create_shader)},
+				{"glDeleteShader",                proc<PFNGLDELETESHADERPROC>(&delete_shader)},
+				{"glShaderSource",                proc<PFNGLSHADERSOURCEPROC>(&shader_source)},
+				{"glCompileShader",               no_op<PFNGLCOMPILESHADERPROC>()},
+				{"glGetShaderiv",                 proc<PFNGLGETSHADERIVPROC>(&get_shader_iv)},
+				{"glGetShaderInfoLog",            no_op<PFNGLGETSHADERINFOLOGPROC>()},
+				{"glCreateProgram",               proc<PFNGLCREATEPROGRAMPROC>(&create_program)},
+				{"glDeleteProgram",               proc<PFNGLDELETEPROGRAMPROC>(&delete_program)},
+				{"glAttachShader",                proc<PFNGLATTACHSHADERPROC>(&attach_shader)},
+				{"glLinkProgram",                 proc<PFNGLLINKPROGRAMPROC>(&link_program)},
+				{"glGetProgramiv",                proc<PFNGLGETPROGRAMIVPROC>(&get_program_iv)},
+				{"glGetProgramInfoLog",           no_op<PFNGLGETPROGRAMINFOLOGPROC>()},
+				{"glGetProgramInterfaceiv",       proc<PFNGLGETPROGRAMINTERFACEIVPROC>(&get_program_interface_iv)},
+				{"glGetProgramResourceiv",        proc<PFNGLGETPROGRAMRESOURCEIVPROC>(&get_program_resource_iv)},
+				{"glGetProgramResourceName",      proc<PFNGLGETPROGRAMRESOURCENAMEPROC>(&get_program_resource_name)},
+				{"glGetUniformLocation",          proc<PFNGLGETUNIFORMLOCATIONPROC>(&get_uniform_location)},
+				{"glGetAttribLocation",           proc<PFNGLGETATTRIBLOCATIONPROC>(&get_attrib_location)},
+				{"glUniformBlockBinding",         proc<PFNGLUNIFORMBLOCKBINDINGPROC>(&uniform_block_binding)},
+				{"glShaderStorageBlockBinding",   proc<PFNGLSHADERSTORAGEBLOCKBINDINGPROC>(&shader_storage_block_binding)},
+				{"glUseProgram",                  no_op<PFNGLUSEPROGRAMPROC>()},
+				{"glUniform1i",                   no_op<PFNGLUNIFORM1IPROC>()},
+				{"glUniform1ui",                  no_op<PFNGLUNIFORM1UIPROC>()},
+				{"glUniform1f",                   no_op<PFNGLUNIFORM1FPROC>()},
+				{"glUniform2fv",                  no_op<PFNGLUNIFORM2FVPROC>()},
+				{"glUniform3fv",                  no_op<PFNGLUNIFORM3FVPROC>()},
+				{"glUniform4fv",                  no_op<PFNGLUNIFORM4FVPROC>()},
+				{"glUniformMatrix2fv",            no_op<PFNGLUNIFORMMATRIX2FVPROC>()},
+				{"glUniformMatrix3fv",            no_op<PFNGLUNIFORMMATRIX3FVPROC>()},
+				{"glUniformMatrix4fv",            no_op<PFNGLUNIFORMMATRIX4FVPROC>()},
+
+				// Fixed function state and draws
+				{"glEnable",                      no_op<PFNGLENABLEPROC>()},
+				{"glDisable",                     no_op<PFNGLDISABLEPROC>()},
+				{"glViewport",                    no_op<PFNGLVIEWPORTPROC>()},
+				{"glDepthMask",                   no_op<PFNGLDEPTHMASKPROC>()},
+				{"glDepthFunc",                   no_op<PFNGLDEPTHFUNCPROC>()},
+				{"glPolygonOffset",               no_op<PFNGLPOLYGONOFFSETPROC>()},
+				{"glPolygonMode",                 no_op<PFNGLPOLYGONMODEPROC>()},
+				{"glBlendFunc",                   no_op<PFNGLBLENDFUNCPROC>()},
+				{"glBlendFuncSeparate",           no_op<PFNGLBLENDFUNCSEPARATEPROC>()},
+				{"glCullFace",                    no_op<PFNGLCULLFACEPROC>()},
+				{"glFrontFace",                   no_op<PFNGLFRONTFACEPROC>()},
+				{"glDrawArrays",                  proc<PFNGLDRAWARRAYSPROC>(&draw_arrays)},
+				{"glDrawArraysInstanced",         proc<PFNGLDRAWARRAYSINSTANCEDPROC>(&draw_arrays_instanced)},
+				{"glDrawElements",                proc<PFNGLDRAWELEMENTSPROC>(&draw_elements)},
+				{"glDrawElementsInstanced",       proc<PFNGLDRAWELEMENTSINSTANCEDPROC>(&draw_elements_instanced)},
+				{"glDispatchCompute",             proc<PFNGLDISPATCHCOMPUTEPROC>(&dispatch_compute)}};
+
+			// Functions the engine doesn't call are left unloaded.
+			auto it = functions.find(p_name);
+			return it != functions.end() ? it->second : nullptr;
+		}
+	} // namespace
+
+	void initialise()
+	{
+		context() = {};
+		const int version = gladLoadGLLoader(static_cast<GLADloadproc>(&get_proc_address));
+		ASSERT_THROW(version != 0, "[INIT] Failed to load the null OpenGL backend");
+		State::Get().reset_context();
+		LOG("[INIT] Initialised null OpenGL, GL calls are not issued to a GPU");
+	}
+	void deinitialise()
+	{
+		context() = {};
+	}
+	size_t draw_count()
+	{
+		return context().draw_count;
+	}
+} // namespace OpenGL::NullGL
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+namespace OpenGL::NullGL
+{
+	// Load a GL backend with no context behind it in place of the functions of a context, so the renderers run without a window or GPU.
+	// Objects are given fake handles, buffers are backed by CPU memory a map returns directly and shaders are reflected from the GLSL
+	// declarations of their sources, so Shader finds the uniforms, blocks and std140/std430 offsets it would on a context. Nothing is drawn.
+	// Limits are the minimums the GL 4.6 spec guarantees, what runs on the null backend runs on any context.
+	// Replaces the functions of a context loaded before and resets OpenGL::State, objects created on that context must be destroyed first.
+	void initialise();
+	// Free the memory of every object created since initialise. The GL functions stay loaded.
+	void deinitialise();
+
+	// Number of draw and compute dispatch calls issued to the backend since initialise.
+	size_t draw_count();
+}
@@ -1,6 +1,7 @@
 #include "OpenGLRenderer.hpp"
 #include "DebugRenderer.hpp"
 #include "DrawCall.hpp"
+#include "UniformIDs.hpp"
 
 #include "Component/Collider.hpp"
 #include "Component/FirstPersonCamera.hpp"
@@ -8,6 +9,7 @@
 #include "Component/Terrain.hpp"
 #include "Component/Transform.hpp"
 #include "ECS/Storage.hpp"
+#include "Geometry/Frustrum.hpp"
 #include "System/AssetManager.hpp"
 #include "System/SceneSystem.hpp"
 
@@ -21,6 +23,8 @@
 
 #include "imgui.h"
 
+#include <utility>
+
 namespace OpenGL
 {
 	Data::Mesh make_screen_quad_mesh()
@@ -40,13 +44,13 @@ namespace OpenGL
 		mb.add_cylinder(glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f), radius, segments_per_cylinder); // Y
 		mb.set_colour(glm::vec3(0.f, 0.f, 1.f));
 		mb.add_cylinder(glm::vec3(0.f), glm::vec3(0.f, 0.f, 1.f), radius, segments_per_cylinder); // Z
-		return mb.get_mesh();
+		return mb.get_indexed_mesh();
 	}
 
 	OpenGLRenderer::OpenGLRenderer(System::AssetManager& p_asset_manager, System::SceneSystem& p_scene_system) noexcept
 		: m_asset_manager{p_asset_manager}
 		, m_scene_system{p_scene_system}
-		, m_view_properties_buffer{{OpenGL::BufferStorageFlag::DynamicStorageBit}, sizeof(Component::ViewInformation)}
+		, m_frame_data{1024 * 1024}
 		, m_uniform_colour_shader{"uniformColour"}
 		, m_colour_shader{"colour"}
 		, m_texture_shader{"texture1"}
@@ -63,7 +67,20 @@ namespace OpenGL
 		, m_screen_quad{make_screen_quad_mesh()}
 		, m_axis_mesh{make_axis_mesh()}
 		, m_post_processing_options{}
+		, m_render_queue{}
+		, m_instance_batcher{}
+		, m_transparent_batcher{}
+		, m_frame_state_changes{}
+		, m_captured_frame{}
+		, m_capture_frame{false}
+		, m_visible_entities{}
+		, m_culled_count{0}
+		, m_frustrum_culling{true}
+		, m_instancing{true}
+		, m_light_clustering{true}
 		, m_draw_shadows{false}
+		, m_use_LODs{true}
+		, m_LOD_pixel_error{1.f}
 		, m_draw_grid{false}
 		, m_draw_axes{true}
 		, m_draw_terrain_nodes{false}
@@ -89,7 +106,6 @@ namespace OpenGL
 				, "ViewProperties.view_position block variable mismatch. Has the shader or the Component::ViewInformation struct changed?");
 		}
 		#endif
-		m_view_properties_buffer.set_data(m_scene_system.get_current_scene_view_info(), 0);
 
 		LOG("[OPENGL] Constructed new OpenGLRenderer instance");
 	}
@@ -98,12 +114,34 @@ namespace OpenGL
 	{
 		PERF(OpenGLRendererDraw);
 
+		m_frame_state_changes = State::Get().get_state_changes();
+		State::Get().reset_state_changes();
+
+		// Draws made while recording are only appended to m_captured_frame, the frame is replayed to the context at the end of the draw.
+		// Skipped if the caller is already recording the draw.
+		const bool capture_frame = std::exchange(m_capture_frame, false) && !State::Get().recording();
+		if (capture_frame)
+		{
+			m_captured_frame.clear();
+			State::Get().begin_recording(m_captured_frame);
+		}
+
 		auto& entities  = m_scene_system.get_current_scene_entities();
 		auto& scene     = m_scene_system.get_current_scene();
 		auto& view_info = m_scene_system.get_current_scene_view_info();
 
-		m_view_properties_buffer.set_data(view_info, 0);
-		m_shadow_mapper.shadow_pass(scene);
+		const auto view_properties = m_frame_data.push(view_info);
+		select_LODs(scene, view_info, static_cast<float>(target_FBO.resolution().y));
+		m_shadow_mapper.shadow_pass(scene, view_info, m_frustrum_culling, m_instancing, m_frame_data);
+
+		m_visible_entities.clear();
+		if (m_frustrum_culling)
+			m_culled_count = scene.cull(Geometry::Frustrum(view_info.m_projection * view_info.m_view), m_visible_entities);
+		else
+		{
+			m_visible_entities = scene.m_entity_AABB_owners;
+			m_culled_count     = 0;
+		}
 
 		{ // Prepare target_FBO for rendering
 			auto clear_colour = Platform::Core::s_theme.background;
@@ -113,85 +151,173 @@ namespace OpenGL
 			ASSERT(target_FBO.is_complete(), "Screen framebuffer not complete, have you attached a colour or depth buffer to it?");
 		}
 
-		glm::mat4 light_proj_view = glm::identity<glm::mat4>();
-		if (m_draw_shadows)
-		{
-			entities.foreach([&](Component::DirectionalLight& p_light)
-			{
-				light_proj_view = p_light.get_view_proj(scene.m_rendered_bounds);
-				return;
-			});
-		}
-
 		if (m_draw_grid)
 			m_grid_renderer.draw(target_FBO);
 
 		m_phong_renderer.update_light_data(scene);
+		m_phong_renderer.update_light_clusters(scene, view_info, target_FBO.resolution(), m_light_clustering, m_frame_data);
 		const auto& directional_light_buffer = m_phong_renderer.get_directional_lights_buffer();
 		const auto& point_light_buffer       = m_phong_renderer.get_point_lights_buffer();
 		const auto& spot_light_buffer        = m_phong_renderer.get_spot_lights_buffer();
+		const auto& light_clusters           = m_phong_renderer.get_light_clusters_range();
+		const auto& light_indices            = m_phong_renderer.get_light_indices_range();
+		const auto& shadow_cascades          = m_shadow_mapper.get_cascades_range();
+		// Distance along the view direction, blended draws are ordered by it farthest first.
+		auto view_depth = [&view_info](const glm::vec3& p_position) { return -(view_info.m_view * glm::vec4(p_position, 1.f)).z; };
 
-		entities.foreach([&](ECS::Entity& p_entity, Component::Transform& p_transform, Component::Mesh& mesh_comp)
+		for (const auto& entity : m_visible_entities)
 		{
+			if (!entities.has_components<Component::Transform, Component::Mesh>(entity))
+				continue; // Removed since the scene was updated.
+
+			auto& transform = entities.get_component<Component::Transform>(entity);
+			auto& mesh_comp = entities.get_component<Component::Mesh>(entity);
 			if (mesh_comp.m_mesh)
 			{
-				Shader* mesh_shader = nullptr;
+				Shader* mesh_shader     = nullptr;
+				const Texture* material = nullptr; // Identifies the material in the sort key.
+				const bool quantised    = mesh_comp.m_mesh->quantised;
 				DrawCall dc;
 
-				if (entities.has_components<Component::Texture>(p_entity))
+				if (entities.has_components<Component::Texture>(entity))
 				{
-					auto& texComponent = entities.get_component<Component::Texture>(p_entity);
-					dc.set_SSBO("DirectionalLightsBuffer", directional_light_buffer);
-					dc.set_SSBO("PointLightsBuffer",       point_light_buffer);
-					dc.set_SSBO("SpotLightsBuffer",        spot_light_buffer);
-					dc.set_uniform("shininess",            texComponent.m_shininess);
+					auto& texComponent     = entities.get_component<Component::Texture>(entity);
+					const bool textured    = texComponent.m_diffuse.has_value();
+					const bool transparent = !textured && texComponent.m_colour.a < 1.f;
+					if (m_instancing)
+					{
+						// Opaque draws are grouped with the draws sharing their mesh LOD, shader and textures and submitted as instanced draws below.
+						// Transparent draws are only grouped with their neighbours once ordered back to front.
+						const Texture* diffuse  = textured ? &texComponent.m_diffuse->m_GL_texture : nullptr;
+						const Texture* specular = !textured ? nullptr
+							: texComponent.m_specular.has_value() ? &texComponent.m_specular->m_GL_texture : &m_blank_texture->m_GL_texture;
+						Shader& instanced_shader = textured
+							? (m_draw_shadows ? m_phong_renderer.get_texture_shadow_shader(quantised, true) : m_phong_renderer.get_texture_shader(quantised, true))
+							: (m_draw_shadows ? m_phong_renderer.get_uniform_colour_shadow_shader(quantised, true) : m_phong_renderer.get_uniform_colour_shader(quantised, true));
+						auto& batcher = transparent ? m_transparent_batcher : m_instance_batcher;
+						batcher.push({&*mesh_comp.m_mesh, mesh_comp.m_LOD, &instanced_shader, diffuse, specular},
+						             {transform.get_model(), texComponent.m_colour, texComponent.m_shininess}, view_depth(transform.m_position));
+						continue;
+					}
+
+					dc.set_SSBO(Uniform::DirectionalLightsBuffer, directional_light_buffer);
+					dc.set_SSBO(Uniform::PointLightsBuffer,       point_light_buffer);
+					dc.set_SSBO(Uniform::SpotLightsBuffer,        spot_light_buffer);
+					dc.set_SSBO(Uniform::LightClustersBuffer,     light_clusters);
+					dc.set_SSBO(Uniform::LightIndicesBuffer,      light_indices);
+					dc.set_uniform(Uniform::shininess,            texComponent.m_shininess);
 
 					if (texComponent.m_diffuse.has_value())
 					{
-						dc.set_texture("diffuse",  texComponent.m_diffuse->m_GL_texture);
-						dc.set_texture("specular", texComponent.m_specular.has_value() ? texComponent.m_specular->m_GL_texture : m_blank_texture->m_GL_texture);
+						dc.set_texture(Uniform::diffuse,  texComponent.m_diffuse->m_GL_texture);
+						material = &texComponent.m_diffuse->m_GL_texture;
+						dc.set_texture(Uniform::specular, texComponent.m_specular.has_value() ? texComponent.m_specular->m_GL_texture : m_blank_texture->m_GL_texture);
 
 						if (m_draw_shadows)
-							mesh_shader = &m_phong_renderer.get_texture_shadow_shader();
+							mesh_shader = &m_phong_renderer.get_texture_shadow_shader(quantised);
 						else
-							mesh_shader = &m_phong_renderer.get_texture_shader();
+							mesh_shader = &m_phong_renderer.get_texture_shader(quantised);
 					}
 					else
 					{
-						dc.set_uniform("uColour", texComponent.m_colour);
+						dc.set_uniform(Uniform::uColour, texComponent.m_colour);
 
 						// Dont write transparent pixels to the depth buffer. This prevents transparent objects from culling other objects behind them.
-						// TODO: Group all these together and draw in a single pass ordering them by distance to camera.
-						if (texComponent.m_colour.a < 1.f)
+						// The render queue draws them after the opaque draws, farthest first.
+						if (transparent)
 						{
 							dc.m_write_to_depth_buffer = false;
 							dc.m_blending_enabled = true;
 						}
 						if (m_draw_shadows)
-							mesh_shader = &m_phong_renderer.get_uniform_colour_shadow_shader();
+							mesh_shader = &m_phong_renderer.get_uniform_colour_shadow_shader(quantised);
 						else
-							mesh_shader = &m_phong_renderer.get_uniform_colour_shader();
+							mesh_shader = &m_phong_renderer.get_uniform_colour_shader(quantised);
 					}
 
 					if (m_draw_shadows)
 					{
-						dc.set_uniform("PCF_bias",        Component::DirectionalLight::PCF_bias);
-						dc.set_uniform("light_proj_view", light_proj_view);
-						dc.set_texture("shadow_map",      m_shadow_mapper.get_depth_map());
+						dc.set_uniform(Uniform::PCF_bias,            Component::DirectionalLight::PCF_bias);
+						dc.set_SSBO(Uniform::ShadowCascadesBuffer,   shadow_cascades);
+						dc.set_texture(Uniform::shadow_map,          m_shadow_mapper.get_depth_map());
 					}
+					if (quantised)
+						dc.set_uniform(Uniform::dequantise, mesh_comp.m_mesh->dequantise_matrix());
 				}
 				else
 				{
 					// Fallback to rendering using default colour and no lighting.
-					dc.set_uniform("colour", glm::vec4(0.06f, 0.44f, 0.81f, 1.f));
+					dc.set_uniform(Uniform::colour, glm::vec4(0.06f, 0.44f, 0.81f, 1.f));
 					mesh_shader = &m_uniform_colour_shader;
 				}
 
-				dc.set_UBO("ViewProperties", m_view_properties_buffer);
-				dc.set_uniform("model", p_transform.get_model());
-				dc.submit(*mesh_shader, mesh_comp.m_mesh->get_VAO(), target_FBO);
+				const auto& LOD = mesh_comp.m_mesh->LODs[mesh_comp.m_LOD];
+				dc.m_first_element = static_cast<GLsizei>(LOD.first_index);
+				dc.m_element_count = static_cast<GLsizei>(LOD.index_count);
+				dc.set_UBO(Uniform::ViewProperties, view_properties);
+				if (mesh_shader == &m_uniform_colour_shader) // Position only shaders take the dequantisation as part of the model matrix.
+					dc.set_uniform(Uniform::model, transform.get_model() * mesh_comp.m_mesh->dequantise_matrix());
+				else
+					dc.set_uniform(Uniform::model, transform.get_model());
+
+				const auto pass   = dc.m_blending_enabled ? RenderQueue::Pass::Transparent : RenderQueue::Pass::Opaque;
+				const float depth = dc.m_blending_enabled ? view_depth(transform.m_position) : glm::distance(glm::vec3(view_info.m_view_position), transform.m_position);
+				m_render_queue.push(RenderQueue::make_key(pass, *mesh_shader, material, mesh_comp.m_mesh->get_VAO(), depth), dc, *mesh_shader, mesh_comp.m_mesh->get_VAO(), target_FBO);
 			}
-		});
+		}
+
+		m_instance_batcher.build();
+		m_transparent_batcher.build_back_to_front();
+		auto queue_instanced = [&](const InstanceBatcher& p_batcher, RenderQueue::Pass p_pass)
+		{
+			const auto instances = p_batcher.upload(m_frame_data);
+			for (const auto& group : p_batcher.groups())
+			{
+				const auto& mesh = *group.key.mesh;
+				DrawCall dc;
+				if (p_pass == RenderQueue::Pass::Transparent)
+				{
+					dc.m_write_to_depth_buffer = false;
+					dc.m_blending_enabled      = true;
+				}
+				dc.set_SSBO(Uniform::DirectionalLightsBuffer, directional_light_buffer);
+				dc.set_SSBO(Uniform::PointLightsBuffer,       point_light_buffer);
+				dc.set_SSBO(Uniform::SpotLightsBuffer,        spot_light_buffer);
+				dc.set_SSBO(Uniform::LightClustersBuffer,     light_clusters);
+				dc.set_SSBO(Uniform::LightIndicesBuffer,      light_indices);
+				dc.set_SSBO(Uniform::InstancesBuffer,         instances);
+				dc.set_uniform(Uniform::instance_offset,      group.first_instance);
+				if (group.key.diffuse)
+				{
+					dc.set_texture(Uniform::diffuse,  *group.key.diffuse);
+					dc.set_texture(Uniform::specular, *group.key.specular);
+				}
+				if (m_draw_shadows)
+				{
+					dc.set_uniform(Uniform::PCF_bias,            Component::DirectionalLight::PCF_bias);
+					dc.set_SSBO(Uniform::ShadowCascadesBuffer,   shadow_cascades);
+					dc.set_texture(Uniform::shadow_map,          m_shadow_mapper.get_depth_map());
+				}
+				if (mesh.quantised)
+					dc.set_uniform(Uniform::dequantise, mesh.dequantise_matrix());
+
+				const auto& LOD = mesh.LODs[group.key.LOD];
+				dc.m_first_element = static_cast<GLsizei>(LOD.first_index);
+				dc.m_element_count = static_cast<GLsizei>(LOD.index_count);
+				dc.set_UBO(Uniform::ViewProperties, view_properties);
+
+				// Opaque instances are spread across the scene, the group has no single depth to order it by.
+				// Transparent groups are runs of the back to front order, ordering them by their farthest instance keeps that order.
+				const float depth = p_pass == RenderQueue::Pass::Transparent ? group.depth : 0.f;
+				const auto key    = RenderQueue::make_key(p_pass, *group.key.shader, group.key.diffuse, mesh.get_VAO(), depth);
+				m_render_queue.push(key, dc, *group.key.shader, mesh.get_VAO(), target_FBO, static_cast<GLsizei>(group.instance_count));
+			}
+		};
+		queue_instanced(m_instance_batcher,    RenderQueue::Pass::Opaque);
+		queue_instanced(m_transparent_batcher, RenderQueue::Pass::Transparent);
+		// Every opaque draw has to be in the depth buffer before the transparent pass blends over it.
+		// The terrain doesn't go through the queue so it's drawn between the passes, opaque draws added later must go before Pass::Transparent too.
+		m_render_queue.submit(RenderQueue::Pass::Opaque);
 
 		{// Draw terrain
 			entities.foreach([&](Component::Terrain& p_terrain)
@@ -230,32 +356,36 @@ namespace OpenGL
 
 				if (m_draw_terrain_wireframe) dc.m_polygon_mode = PolygonMode::Line;
 
-				dc.set_SSBO("DirectionalLightsBuffer", directional_light_buffer);
-				dc.set_SSBO("PointLightsBuffer",       point_light_buffer);
-				dc.set_SSBO("SpotLightsBuffer",        spot_light_buffer);
-				dc.set_UBO("ViewProperties",           m_view_properties_buffer);
+				dc.set_SSBO(Uniform::DirectionalLightsBuffer, directional_light_buffer);
+				dc.set_SSBO(Uniform::PointLightsBuffer,       point_light_buffer);
+				dc.set_SSBO(Uniform::SpotLightsBuffer,        spot_light_buffer);
+				dc.set_SSBO(Uniform::LightClustersBuffer,     light_clusters);
+				dc.set_SSBO(Uniform::LightIndicesBuffer,      light_indices);
+				dc.set_UBO(Uniform::ViewProperties,           view_properties);
 
-				dc.set_uniform("model",                glm::identity<glm::mat4>());
-				dc.set_uniform("shininess",            1000000.f); // Force terrain to not be shiny.
+				dc.set_uniform(Uniform::model,                glm::identity<glm::mat4>());
+				dc.set_uniform(Uniform::shininess,            1000000.f); // Force terrain to not be shiny.
 				// TODO: calc instead of using amplitude... use the actual height of the terrain.
-				dc.set_uniform("min_height", -p_terrain.noise_params.height);
-				dc.set_uniform("max_height",  p_terrain.noise_params.height);
+				dc.set_uniform(Uniform::min_height, -p_terrain.noise_params.height);
+				dc.set_uniform(Uniform::max_height,  p_terrain.noise_params.height);
 
-				dc.set_uniform("debug_normals", m_visualise_terrain_normals);
+				dc.set_uniform(Uniform::debug_normals, m_visualise_terrain_normals);
 
-				dc.set_texture("grass", p_terrain.m_grass_tex->m_GL_texture);
-				dc.set_texture("rock",  p_terrain.m_rock_tex->m_GL_texture);
-				dc.set_texture("snow",  p_terrain.m_snow_tex->m_GL_texture);
+				dc.set_texture(Uniform::grass, p_terrain.m_grass_tex->m_GL_texture);
+				dc.set_texture(Uniform::rock,  p_terrain.m_rock_tex->m_GL_texture);
+				dc.set_texture(Uniform::snow,  p_terrain.m_snow_tex->m_GL_texture);
 
 				dc.submit(m_terrain_shader, p_terrain.get_VAO(), target_FBO);
 			});
 		}
 
-		m_particle_renderer.update(delta_time, scene, view_info.m_view_position, m_view_properties_buffer, target_FBO);
+		m_render_queue.submit(RenderQueue::Pass::Transparent);
+
+		m_particle_renderer.update(delta_time, scene, view_info.m_view_position, view_properties, target_FBO);
 
-		m_selection_renderer.selection_pass(p_selected_entities, entities, m_view_properties_buffer, target_FBO);
+		m_selection_renderer.selection_pass(p_selected_entities, entities, view_properties, target_FBO);
 
-		OpenGL::DebugRenderer::render(m_scene_system, m_view_properties_buffer, m_phong_renderer.get_point_lights_buffer(), target_FBO);
+		OpenGL::DebugRenderer::render(m_scene_system, view_properties, m_phong_renderer.get_point_lights_buffer(), target_FBO, m_frame_data);
 
 		if (m_post_processing_options.any_active())
 		{
@@ -271,13 +401,13 @@ namespace OpenGL
 			post_process_dc.m_cull_face_enabled     = false;
 			post_process_dc.m_polygon_mode          = PolygonMode::Fill;
 			post_process_dc.m_write_to_depth_buffer = false;
-			post_process_dc.set_uniform("invertColours", m_post_processing_options.mInvertColours);
-			post_process_dc.set_uniform("grayScale", m_post_processing_options.mGrayScale);
-			post_process_dc.set_uniform("sharpen", m_post_processing_options.mSharpen);
-			post_process_dc.set_uniform("blur", m_post_processing_options.mBlur);
-			post_process_dc.set_uniform("edgeDetection", m_post_processing_options.mEdgeDetection);
-			post_process_dc.set_uniform("offset", m_post_processing_options.mKernelOffset);
-			post_process_dc.set_texture("screen_texture", m_post_processing_FBO->color_attachment());
+			post_process_dc.set_uniform(Uniform::invertColours, m_post_processing_options.mInvertColours);
+			post_process_dc.set_uniform(Uniform::grayScale, m_post_processing_options.mGrayScale);
+			post_process_dc.set_uniform(Uniform::sharpen, m_post_processing_options.mSharpen);
+			post_process_dc.set_uniform(Uniform::blur, m_post_processing_options.mBlur);
+			post_process_dc.set_uniform(Uniform::edgeDetection, m_post_processing_options.mEdgeDetection);
+			post_process_dc.set_uniform(Uniform::offset, m_post_processing_options.mKernelOffset);
+			post_process_dc.set_texture(Uniform::screen_texture, m_post_processing_FBO->color_attachment());
 			post_process_dc.submit(m_screen_texture_shader, m_screen_quad.get_VAO(), *m_post_processing_FBO);
 			m_post_processing_FBO->blit_to_fbo(target_FBO, true, false, false, InterpolationFilter::Nearest);
 		}
@@ -285,14 +415,13 @@ namespace OpenGL
 		{
 			DrawCall axes_dc;
 			float axis_size = 1.f;
-			axes_dc.set_uniform("model", glm::scale(glm::identity<glm::mat4>(), glm::vec3(axis_size)));
+			axes_dc.set_uniform(Uniform::model, glm::scale(glm::identity<glm::mat4>(), glm::vec3(axis_size)));
 
 			// Copy and modify the view information to create an orthographic projection with no translation
 			auto view_prop         = m_scene_system.get_current_scene_view_info();
 			view_prop.m_view       = glm::mat4(glm::mat3(view_prop.m_view)); // Remove translation from view matrix.
 			view_prop.m_projection = glm::ortho(-axis_size, axis_size, -axis_size, axis_size, -axis_size, axis_size);
-			m_view_properties_buffer.set_data(view_prop, 0);
-			axes_dc.set_UBO("ViewProperties", m_view_properties_buffer);
+			axes_dc.set_UBO(Uniform::ViewProperties, m_frame_data.push(view_prop));
 
 			axes_dc.m_depth_test_enabled    = true;
 			axes_dc.m_write_to_depth_buffer = true;
@@ -303,6 +432,53 @@ namespace OpenGL
 			glm::uvec2 axes_padding = glm::uvec2{std::min(res.x, res.y) / 64u};
 			axes_dc.submit(m_colour_shader, m_axis_mesh.get_VAO(), target_FBO, axes_padding, axes_size);
 		}
+
+		if (capture_frame)
+		{
+			State::Get().end_recording();
+			m_captured_frame.replay();
+		}
+
+		m_frame_data.end_frame();
+	}
+
+	void OpenGLRenderer::select_LODs(System::Scene& p_scene, const Component::ViewInformation& p_view_info, float p_viewport_height)
+	{
+		PERF(SelectLODs);
+
+		// Pixels covered by one unit at a view distance of 1 (perspective) or at any distance (orthographic).
+		const float pixels_per_unit = p_view_info.m_projection[1][1] * p_viewport_height * 0.5f;
+		const bool orthographic     = p_view_info.m_projection[3][3] == 1.f;
+		const glm::vec3 view_position{p_view_info.m_view_position};
+
+		p_scene.m_entities.foreach([&](Component::Transform& p_transform, Component::Mesh& p_mesh)
+		{
+			if (!p_mesh.m_mesh)
+				return;
+
+			if (!m_use_LODs)
+			{
+				p_mesh.m_LOD = 0;
+				return;
+			}
+
+			// Measure from the nearest point of the bounding sphere so a LOD never coarsens while part of the mesh is close.
+			const auto& AABB      = p_mesh.m_mesh->AABB;
+			const auto scale      = glm::abs(p_transform.m_scale);
+			const float max_scale = std::max({scale.x, scale.y, scale.z});
+			const auto size       = AABB.get_size();
+			const float extent    = std::max({size.x, size.y, size.z}) * max_scale;
+			const float radius    = glm::length(size) * 0.5f * max_scale;
+			const glm::vec3 centre{p_transform.get_model() * glm::vec4(AABB.get_center(), 1.f)};
+			const float distance  = glm::length(centre - view_position) - radius;
+
+			if (orthographic)
+				p_mesh.m_LOD = p_mesh.m_mesh->select_LOD(extent * pixels_per_unit, m_LOD_pixel_error);
+			else if (distance <= 0.f)
+				p_mesh.m_LOD = 0;
+			else
+				p_mesh.m_LOD = p_mesh.m_mesh->select_LOD(extent * pixels_per_unit / distance, m_LOD_pixel_error);
+		});
 	}
 
 	void OpenGLRenderer::draw_UI()
@@ -313,6 +489,36 @@ namespace OpenGL
 		ImGui::Checkbox("Draw terrain nodes",     &m_draw_terrain_nodes);
 		ImGui::Checkbox("Draw terrain wireframe", &m_draw_terrain_wireframe);
 		ImGui::Checkbox("Debug terrain Normals",  &m_visualise_terrain_normals);
+		ImGui::Checkbox("Mesh LODs",              &m_use_LODs);
+		ImGui::Checkbox("Frustrum culling",       &m_frustrum_culling);
+		ImGui::Checkbox("Instancing",             &m_instancing);
+		ImGui::Checkbox("Clustered lighting",     &m_light_clustering);
+		ImGui::Text("Meshes drawn %zu culled %zu", m_visible_entities.size(), m_culled_count);
+		ImGui::Text("Instances %zu in %zu instanced draws", m_instance_batcher.instances().size(), m_instance_batcher.groups().size());
+		ImGui::Text("Transparent instances %zu in %zu instanced draws", m_transparent_batcher.instances().size(), m_transparent_batcher.groups().size());
+		ImGui::Text("Light buffer uploads %zu", m_phong_renderer.light_upload_count());
+		{
+			const auto& light_clusters = m_phong_renderer.get_light_clusters();
+			const auto& grid           = light_clusters.header().grid;
+			ImGui::Text("Light clusters %ux%ux%u, %zu light indices, at most %zu lights per cluster", grid.x, grid.y, grid.z, light_clusters.light_indices().size(), light_clusters.max_cluster_lights());
+		}
+		ImGui::Text("State changes %zu (programs %zu, VAOs %zu, textures %zu, buffers %zu, FBOs %zu, fixed function %zu)",
+			m_frame_state_changes.total(), m_frame_state_changes.programs, m_frame_state_changes.VAOs, m_frame_state_changes.textures,
+			m_frame_state_changes.buffers, m_frame_state_changes.FBOs, m_frame_state_changes.fixed_function);
+		if (ImGui::Button("Capture frame commands"))
+			m_capture_frame = true;
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("Records the GL commands of the next frame then replays them.");
+		if (!m_captured_frame.empty())
+		{
+			ImGui::SameLine();
+			ImGui::Text("%zu commands, %zu draws, %zu uniforms, %zu buffer uploads, %zuB", m_captured_frame.command_count(), m_captured_frame.draw_count(),
+				m_captured_frame.count(CommandStream::Command::Uniform), m_captured_frame.count(CommandStream::Command::BufferSubData), m_captured_frame.size_bytes());
+		}
+		m_shadow_mapper.draw_UI();
+		if (!m_use_LODs) ImGui::BeginDisabled();
+			ImGui::SliderFloat("LOD pixel error", &m_LOD_pixel_error, 0.25f, 8.f);
+		if (!m_use_LODs) ImGui::EndDisabled();
 
 		if (ImGui::Button("Reload Shaders"))
 			reload_shaders();
@@ -343,6 +549,8 @@ namespace OpenGL
 		m_draw_terrain_nodes        = false;
 		m_draw_terrain_wireframe    = false;
 		m_visualise_terrain_normals = false;
+		m_use_LODs                  = true;
+		m_LOD_pixel_error           = 1.f;
 		m_post_processing_options   = {};
 	}
 	void OpenGLRenderer::reload_shaders()
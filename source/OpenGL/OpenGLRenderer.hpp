@@ -1,8 +1,12 @@
 #pragma once
 
+#include "CommandStream.hpp"
 #include "GridRenderer.hpp"
+#include "InstanceBatcher.hpp"
 #include "ParticleRenderer.hpp"
 #include "PhongRenderer.hpp"
+#include "RenderQueue.hpp"
+#include "RingBuffer.hpp"
 #include "SelectionRenderer.hpp"
 #include "Shader.hpp"
 #include "ShadowMapper.hpp"
@@ -17,6 +21,7 @@
 #include "glm/gtc/matrix_transform.hpp"
 
 #include <span>
+#include <vector>
 
 namespace ECS
 {
@@ -26,6 +31,11 @@ namespace System
 {
 	class AssetManager;
 	class SceneSystem;
+	class Scene;
+}
+namespace Component
+{
+	struct ViewInformation;
 }
 namespace Platform
 {
@@ -50,7 +60,7 @@ namespace OpenGL
 		System::AssetManager& m_asset_manager;
 		System::SceneSystem& m_scene_system;
 
-		Buffer m_view_properties_buffer; // Contains the view and projection matrices shared across all shaders.
+		RingBuffer m_frame_data; // Transient data written every frame, the ViewProperties UBO shared across all shaders and the instances of the instanced draws.
 		Shader m_uniform_colour_shader;
 		Shader m_colour_shader;
 		Shader m_texture_shader;
@@ -71,7 +81,24 @@ namespace OpenGL
 		Data::Mesh m_axis_mesh;
 
 		PostProcessingOptions m_post_processing_options;
+		RenderQueue m_render_queue;                  // Mesh draws sorted to share state between neighbours.
+		InstanceBatcher m_instance_batcher;          // Opaque phong draws grouped into instanced draws.
+		InstanceBatcher m_transparent_batcher;       // Blended phong draws ordered back to front, neighbours sharing a mesh grouped into instanced draws.
+		State::StateChanges m_frame_state_changes;   // State changes made over the last frame.
+		CommandStream m_captured_frame;              // The commands of the last frame captured from the UI, replayed once recorded so it's still displayed.
+		bool m_capture_frame;                        // Record the next draw into m_captured_frame.
+		std::vector<ECS::Entity> m_visible_entities; // Mesh entities in the camera frustrum this frame, reused across frames.
+		size_t m_culled_count;                       // Mesh entities outside the camera frustrum this frame.
+		bool m_frustrum_culling;
+		bool m_instancing;
+		bool m_light_clustering; // Only shade the lights of the cluster of each fragment, otherwise every light touching the view.
 		bool m_draw_shadows;
+		bool m_use_LODs;
+		float m_LOD_pixel_error; // How far in pixels a LOD may deviate from the full detail mesh before a finer LOD is drawn.
+
+		// Set the Component::Mesh::m_LOD of every mesh entity from the size its bounds project to on screen.
+		//@param p_viewport_height Height of the target in pixels.
+		void select_LODs(System::Scene& p_scene, const Component::ViewInformation& p_view_info, float p_viewport_height);
 
 	public:
 		bool m_draw_grid;
@@ -1,6 +1,7 @@
 #include "ParticleRenderer.hpp"
 #include "GLState.hpp"
 #include "DrawCall.hpp"
+#include "UniformIDs.hpp"
 
 #include "System/SceneSystem.hpp"
 #include "Component/ParticleEmitter.hpp"
@@ -77,7 +78,7 @@ namespace OpenGL
 		m_particle_update.reload();
 	}
 
-	void ParticleRenderer::update(const DeltaTime& p_delta_time, System::Scene& p_scene, const glm::vec3& p_camera_position, const Buffer& p_view_properties, const FBO& p_target_FBO)
+	void ParticleRenderer::update(const DeltaTime& p_delta_time, System::Scene& p_scene, const glm::vec3& p_camera_position, const RingBuffer::Range& p_view_properties, const FBO& p_target_FBO)
 	{ (void)p_camera_position;
 		p_scene.m_entities.foreach([&](Component::ParticleEmitter& p_emitter)
 		{
@@ -133,9 +134,9 @@ namespace OpenGL
 			{
 				// Update the particles
 				DrawCall comp;
-				comp.set_SSBO("ParticlesBuffer", p_emitter.particle_buf);
+				comp.set_SSBO(Uniform::ParticlesBuffer, p_emitter.particle_buf);
 				comp.set_uniform<float>("delta_time", p_delta_time.count());
-				comp.set_uniform("u_acceleration", p_emitter.acceleration);
+				comp.set_uniform(Uniform::u_acceleration, p_emitter.acceleration);
 				comp.submit_compute(m_particle_update, p_emitter.alive_count, 1, 1);
 				OpenGL::memory_barrier({OpenGL::MemoryBarrierFlag::ShaderStorageBarrierBit});
 
@@ -158,7 +159,7 @@ namespace OpenGL
 				else
 					ASSERT_FAIL("Unknown blending style.");
 
-				dc.set_UBO("ViewProperties", p_view_properties);
+				dc.set_UBO(Uniform::ViewProperties, p_view_properties);
 
 				auto emitter_colour_source = p_emitter.get_colour_source();
 				auto size_source           = p_emitter.get_size_source();
@@ -166,38 +167,38 @@ namespace OpenGL
 				switch (emitter_colour_source)
 				{
 					case Component::ParticleEmitter::ColourSource::ConstantColour:
-						dc.set_uniform("colour", p_emitter.start_colour.value());
+						dc.set_uniform(Uniform::colour, p_emitter.start_colour.value());
 						break;
 					case Component::ParticleEmitter::ColourSource::ConstantTexture:
-						dc.set_texture("diffuse", p_emitter.start_texture->m_GL_texture);
+						dc.set_texture(Uniform::diffuse, p_emitter.start_texture->m_GL_texture);
 						break;
 					case Component::ParticleEmitter::ColourSource::ConstantColourAndTexture:
-						dc.set_uniform("colour", p_emitter.start_colour.value());
-						dc.set_texture("diffuse", p_emitter.start_texture->m_GL_texture);
+						dc.set_uniform(Uniform::colour, p_emitter.start_colour.value());
+						dc.set_texture(Uniform::diffuse, p_emitter.start_texture->m_GL_texture);
 						break;
 					case Component::ParticleEmitter::ColourSource::VaryingColour:
-						dc.set_uniform("start_colour", p_emitter.start_colour.value());
-						dc.set_uniform("end_colour", p_emitter.end_colour.value());
+						dc.set_uniform(Uniform::start_colour, p_emitter.start_colour.value());
+						dc.set_uniform(Uniform::end_colour, p_emitter.end_colour.value());
 						break;
 					case Component::ParticleEmitter::ColourSource::VaryingTexture:
-						dc.set_texture("start_diffuse", p_emitter.start_texture->m_GL_texture);
-						dc.set_texture("end_diffuse", p_emitter.end_texture->m_GL_texture);
+						dc.set_texture(Uniform::start_diffuse, p_emitter.start_texture->m_GL_texture);
+						dc.set_texture(Uniform::end_diffuse, p_emitter.end_texture->m_GL_texture);
 						break;
 					case Component::ParticleEmitter::ColourSource::VaryingColourConstantTexture:
-						dc.set_uniform("start_colour", p_emitter.start_colour.value());
-						dc.set_uniform("end_colour", p_emitter.end_colour.value());
-						dc.set_texture("diffuse", p_emitter.start_texture->m_GL_texture);
+						dc.set_uniform(Uniform::start_colour, p_emitter.start_colour.value());
+						dc.set_uniform(Uniform::end_colour, p_emitter.end_colour.value());
+						dc.set_texture(Uniform::diffuse, p_emitter.start_texture->m_GL_texture);
 						break;
 					case Component::ParticleEmitter::ColourSource::ConstantColourVaryingTexture:
-						dc.set_uniform("colour", p_emitter.start_colour.value());
-						dc.set_texture("start_diffuse", p_emitter.start_texture->m_GL_texture);
-						dc.set_texture("end_diffuse", p_emitter.end_texture->m_GL_texture);
+						dc.set_uniform(Uniform::colour, p_emitter.start_colour.value());
+						dc.set_texture(Uniform::start_diffuse, p_emitter.start_texture->m_GL_texture);
+						dc.set_texture(Uniform::end_diffuse, p_emitter.end_texture->m_GL_texture);
 						break;
 					case Component::ParticleEmitter::ColourSource::VaryingColourAndTexture:
-						dc.set_uniform("start_colour", p_emitter.start_colour.value());
-						dc.set_uniform("end_colour", p_emitter.end_colour.value());
-						dc.set_texture("start_diffuse", p_emitter.start_texture->m_GL_texture);
-						dc.set_texture("end_diffuse", p_emitter.end_texture->m_GL_texture);
+						dc.set_uniform(Uniform::start_colour, p_emitter.start_colour.value());
+						dc.set_uniform(Uniform::end_colour, p_emitter.end_colour.value());
+						dc.set_texture(Uniform::start_diffuse, p_emitter.start_texture->m_GL_texture);
+						dc.set_texture(Uniform::end_diffuse, p_emitter.end_texture->m_GL_texture);
 						break;
 					default:
 						ASSERT_FAIL("Unknown colour source");
@@ -205,11 +206,11 @@ namespace OpenGL
 				switch (size_source)
 				{
 					case Component::ParticleEmitter::SizeSource::Constant:
-						dc.set_uniform("size", p_emitter.start_size);
+						dc.set_uniform(Uniform::size, p_emitter.start_size);
 						break;
 					case Component::ParticleEmitter::SizeSource::Varying:
-						dc.set_uniform("start_size", p_emitter.start_size);
-						dc.set_uniform("end_size", p_emitter.end_size.value());
+						dc.set_uniform(Uniform::start_size, p_emitter.start_size);
+						dc.set_uniform(Uniform::end_size, p_emitter.end_size.value());
 						break;
 					default:
 						ASSERT_FAIL("Unknown size source");
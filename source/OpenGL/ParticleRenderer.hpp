@@ -1,5 +1,6 @@
 #pragma once
 
+#include "RingBuffer.hpp"
 #include "Shader.hpp"
 #include "Types.hpp"
 #include "Utility/Config.hpp"
@@ -38,6 +39,6 @@ namespace OpenGL
 		ParticleRenderer();
 
 		void reload_shaders();
-		void update(const DeltaTime& p_delta_time, System::Scene& p_scene, const glm::vec3& p_camera_position, const Buffer& p_view_properties, const FBO& p_target_FBO);
+		void update(const DeltaTime& p_delta_time, System::Scene& p_scene, const glm::vec3& p_camera_position, const RingBuffer::Range& p_view_properties, const FBO& p_target_FBO);
 	};
 }
\ No newline at end of file
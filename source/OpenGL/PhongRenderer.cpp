@@ -1,20 +1,35 @@
 #include "PhongRenderer.hpp"
 
 #include "Component/Lights.hpp"
+#include "Component/ViewInformation.hpp"
 
 #include "ECS/Storage.hpp"
 #include "System/SceneSystem.hpp"
 
 #include "glm/gtc/matrix_transform.hpp"
+#include "glm/geometric.hpp"
+#include "glm/mat3x3.hpp"
 #include "glm/mat4x4.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 namespace OpenGL
 {
+	namespace
+	{
+		// Copy p_value into p_staging at p_offset, the layout of the light blocks is queried from the shader so offsets are in bytes.
+		template <typename T>
+		void stage(std::vector<std::byte>& p_staging, GLsizeiptr p_offset, const T& p_value)
+		{
+			ASSERT(static_cast<size_t>(p_offset) + sizeof(T) <= p_staging.size(), "[OPENGL][PHONG] Staging light data out of bounds.");
+			std::memcpy(p_staging.data() + p_offset, &p_value, sizeof(T));
+		}
+	} // namespace
+
 	PhongRenderer::PhongRenderer()
-		: m_phong_texture{"phong"}
-		, m_phong_texture_shadow{"phong", {"SHADOWS"}}
-		, m_phong_uniform_colour{"phong", {"UNIFORM_COLOUR"}}
-		, m_phong_uniform_colour_shadow{"phong", {"UNIFORM_COLOUR", "SHADOWS"}}
+		: m_variants{}
 		, m_directional_lights_buffer{{OpenGL::BufferStorageFlag::DynamicStorageBit}}
 		, m_directional_light_fixed_size{0}
 		, m_directional_light_count_offset{0}
@@ -48,7 +63,28 @@ namespace OpenGL
 		, m_spot_light_ambient_offset{0}
 		, m_spot_light_diffuse_offset{0}
 		, m_spot_light_specular_offset{0}
+		, m_directional_lights_data{}
+		, m_point_lights_data{}
+		, m_spot_lights_data{}
+		, m_light_staging{}
+		, m_light_uploads{0}
+		, m_light_clusters{}
+		, m_view_point_lights{}
+		, m_view_spot_lights{}
+		, m_light_clusters_range{}
+		, m_light_indices_range{}
 	{
+		m_variants.reserve(Variant_Count);
+		for (size_t variant = 0; variant < Variant_Count; variant++)
+		{
+			std::vector<const char*> defines;
+			if (variant & Uniform_Colour) defines.push_back("UNIFORM_COLOUR");
+			if (variant & Shadows)        defines.push_back("SHADOWS");
+			if (variant & Quantised)      defines.push_back("QUANTISED");
+			if (variant & Instanced)      defines.push_back("INSTANCED");
+			m_variants.emplace_back("phong", defines);
+		}
+
 		auto get_block_array_stride = [](const InterfaceBlock& p_block, const char* p_block_array_identifier)
 		{
 			// All block array members have the same stride, so we can just query the first one.
@@ -66,7 +102,7 @@ namespace OpenGL
 
 		{ // Initialise offsets
 			{ // DirectionalLight
-				const auto& directional_light_block = m_phong_texture.get_shader_storage_block("DirectionalLightsBuffer");
+				const auto& directional_light_block = m_variants[0].get_shader_storage_block("DirectionalLightsBuffer");
 
 				m_directional_light_array_stride = get_block_array_stride(directional_light_block, "directional_lights[0]");
 				// Fixed portion of a shader storage block is the GL_BUFFER_DATA_SIZE (total size) minus GL_TOP_LEVEL_ARRAY_STRIDE (size of the variable-sized-array).
@@ -95,7 +131,7 @@ namespace OpenGL
 				ASSERT(directional_light_specular_var.m_type == ShaderDataType::Vec3, "[OPENGL][PHONG] Expected directional_lights[0].specular to be a vec3.");
 			}
 			{ // PointLight
-				const auto& point_light_block = m_phong_texture.get_shader_storage_block("PointLightsBuffer");
+				const auto& point_light_block = m_variants[0].get_shader_storage_block("PointLightsBuffer");
 
 				m_point_light_array_stride = get_block_array_stride(point_light_block, "point_lights[0]");
 				// Fixed portion of a shader storage block is the GL_BUFFER_DATA_SIZE (total size) minus GL_TOP_LEVEL_ARRAY_STRIDE (size of the variable-sized-array).
@@ -136,7 +172,7 @@ namespace OpenGL
 				ASSERT(point_light_specular_var.m_type == ShaderDataType::Vec3, "[OPENGL][PHONG] Expected point_lights[0].specular to be a vec3.");
 			}
 			{ // SpotLight
-				const auto& spot_light_block = m_phong_texture.get_shader_storage_block("SpotLightsBuffer");
+				const auto& spot_light_block = m_variants[0].get_shader_storage_block("SpotLightsBuffer");
 
 				m_spot_light_array_stride = get_block_array_stride(spot_light_block, "spot_lights[0]");
 				// Fixed portion of a shader storage block is the GL_BUFFER_DATA_SIZE (total size) minus GL_TOP_LEVEL_ARRAY_STRIDE (size of the variable-sized-array).
@@ -193,95 +229,127 @@ namespace OpenGL
 
 	void PhongRenderer::update_light_data(System::Scene& p_scene)
 	{
-		// TODO: Seperate the light storage blocks into meta data and data, so we can push the entire light data in one go per instance.
-
-		{ // Set DirectonalLight buffer data
+		{ // Stage DirectonalLight buffer data
 			GLuint directional_light_count = static_cast<GLuint>(p_scene.m_entities.count_components<Component::DirectionalLight>());
+			m_light_staging.assign(m_directional_light_fixed_size + (m_directional_light_array_stride * directional_light_count), std::byte{0});
+			stage(m_light_staging, m_directional_light_count_offset, directional_light_count);
 
-			const size_t required_capacity = m_directional_light_fixed_size + (m_directional_light_array_stride * directional_light_count);
-			if (required_capacity > m_directional_lights_buffer.capacity())
-				m_directional_lights_buffer.reserve(required_capacity);
-
-			m_directional_lights_buffer.set_data(directional_light_count, m_directional_light_count_offset);
-
-			GLuint i = 0;
+			GLsizeiptr light_offset = 0;
 			p_scene.m_entities.foreach([&](Component::DirectionalLight& p_directional_light)
 			{
 				const glm::vec3 diffuse  = p_directional_light.m_colour * p_directional_light.m_diffuse_intensity;
 				const glm::vec3 ambient  = p_directional_light.m_colour * p_directional_light.m_ambient_intensity;
 				const glm::vec3 specular = glm::vec3(p_directional_light.m_specular_intensity);
 
-				m_directional_lights_buffer.set_data(p_directional_light.m_direction, m_directional_light_direction_offset + (m_directional_light_array_stride * i));
-				m_directional_lights_buffer.set_data(ambient,                         m_directional_light_ambient_offset   + (m_directional_light_array_stride * i));
-				m_directional_lights_buffer.set_data(diffuse,                         m_directional_light_diffuse_offset   + (m_directional_light_array_stride * i));
-				m_directional_lights_buffer.set_data(specular,                        m_directional_light_specular_offset  + (m_directional_light_array_stride * i));
+				stage(m_light_staging, m_directional_light_direction_offset + light_offset, p_directional_light.m_direction);
+				stage(m_light_staging, m_directional_light_ambient_offset   + light_offset, ambient);
+				stage(m_light_staging, m_directional_light_diffuse_offset   + light_offset, diffuse);
+				stage(m_light_staging, m_directional_light_specular_offset  + light_offset, specular);
 
-				i++;
+				light_offset += m_directional_light_array_stride;
 			});
+			upload_if_changed(m_directional_lights_buffer, m_directional_lights_data);
 		}
-		{ // Set PointLight buffer data
+		{ // Stage PointLight buffer data
 			GLuint point_light_count = static_cast<GLuint>(p_scene.m_entities.count_components<Component::PointLight>());
+			m_light_staging.assign(m_point_light_fixed_size + (m_point_light_array_stride * point_light_count), std::byte{0});
+			stage(m_light_staging, m_point_light_count_offset, point_light_count);
+
+			GLsizeiptr light_offset = 0;
+			p_scene.m_entities.foreach([&](Component::PointLight& p_point_light)
 			{
-				const size_t required_capacity = m_point_light_fixed_size + (m_point_light_array_stride * point_light_count);
-				if (required_capacity > m_point_lights_buffer.capacity())
-					m_point_lights_buffer.reserve(required_capacity);
-
-				m_point_lights_buffer.set_data(point_light_count, m_point_light_count_offset);
-
-				GLuint i = 0;
-				p_scene.m_entities.foreach([&](Component::PointLight& p_point_light)
-				{
-					const glm::vec3 diffuse  = p_point_light.m_colour * p_point_light.m_diffuse_intensity;
-					const glm::vec3 ambient  = p_point_light.m_colour * p_point_light.m_ambient_intensity;
-					const glm::vec3 specular = glm::vec3(p_point_light.m_specular_intensity);
-
-					m_point_lights_buffer.set_data(p_point_light.m_position,  m_point_light_position_offset  + (m_point_light_array_stride * i));
-					m_point_lights_buffer.set_data(p_point_light.m_constant,  m_point_light_constant_offset  + (m_point_light_array_stride * i));
-					m_point_lights_buffer.set_data(p_point_light.m_linear,    m_point_light_linear_offset    + (m_point_light_array_stride * i));
-					m_point_lights_buffer.set_data(p_point_light.m_quadratic, m_point_light_quadratic_offset + (m_point_light_array_stride * i));
-					m_point_lights_buffer.set_data(ambient,                   m_point_light_ambient_offset   + (m_point_light_array_stride * i));
-					m_point_lights_buffer.set_data(diffuse,                   m_point_light_diffuse_offset   + (m_point_light_array_stride * i));
-					m_point_lights_buffer.set_data(specular,                  m_point_light_specular_offset  + (m_point_light_array_stride * i));
-
-					i++;
-				});
-			}
+				const glm::vec3 diffuse  = p_point_light.m_colour * p_point_light.m_diffuse_intensity;
+				const glm::vec3 ambient  = p_point_light.m_colour * p_point_light.m_ambient_intensity;
+				const glm::vec3 specular = glm::vec3(p_point_light.m_specular_intensity);
+
+				stage(m_light_staging, m_point_light_position_offset  + light_offset, p_point_light.m_position);
+				stage(m_light_staging, m_point_light_constant_offset  + light_offset, p_point_light.m_constant);
+				stage(m_light_staging, m_point_light_linear_offset    + light_offset, p_point_light.m_linear);
+				stage(m_light_staging, m_point_light_quadratic_offset + light_offset, p_point_light.m_quadratic);
+				stage(m_light_staging, m_point_light_ambient_offset   + light_offset, ambient);
+				stage(m_light_staging, m_point_light_diffuse_offset   + light_offset, diffuse);
+				stage(m_light_staging, m_point_light_specular_offset  + light_offset, specular);
+
+				light_offset += m_point_light_array_stride;
+			});
+			upload_if_changed(m_point_lights_buffer, m_point_lights_data);
 		}
-		{ // Set Spotlight buffer data
+		{ // Stage Spotlight buffer data
 			GLuint spot_light_count = static_cast<GLuint>(p_scene.m_entities.count_components<Component::SpotLight>());
+			m_light_staging.assign(m_spot_light_fixed_size + (m_spot_light_array_stride * spot_light_count), std::byte{0});
+			stage(m_light_staging, m_spot_light_count_offset, spot_light_count);
+
+			GLsizeiptr light_offset = 0;
+			p_scene.m_entities.foreach([&](Component::SpotLight& p_spotlight)
 			{
-				const size_t required_capacity = m_spot_light_fixed_size + (m_spot_light_array_stride * spot_light_count);
-				if (required_capacity > m_spot_lights_buffer.capacity())
-					m_spot_lights_buffer.reserve(required_capacity);
-
-				m_spot_lights_buffer.set_data(spot_light_count, m_spot_light_count_offset);
-
-				GLuint i = 0;
-				p_scene.m_entities.foreach([&](Component::SpotLight& p_spotlight)
-				{
-					const glm::vec3 diffuse  = p_spotlight.m_colour * p_spotlight.m_diffuse_intensity;
-					const glm::vec3 ambient  = p_spotlight.m_colour * p_spotlight.m_ambient_intensity;
-					const glm::vec3 specular = glm::vec3(p_spotlight.m_specular_intensity);
-
-					m_spot_lights_buffer.set_data(p_spotlight.m_position,     m_spot_light_position_offset     + (m_spot_light_array_stride * i));
-					m_spot_lights_buffer.set_data(p_spotlight.m_direction,    m_spot_light_direction_offset    + (m_spot_light_array_stride * i));
-					m_spot_lights_buffer.set_data(p_spotlight.m_cutoff,       m_spot_light_cutoff_offset       + (m_spot_light_array_stride * i));
-					m_spot_lights_buffer.set_data(p_spotlight.m_outer_cutoff, m_spot_light_outer_cutoff_offset + (m_spot_light_array_stride * i));
-					m_spot_lights_buffer.set_data(p_spotlight.m_constant,     m_spot_light_constant_offset     + (m_spot_light_array_stride * i));
-					m_spot_lights_buffer.set_data(p_spotlight.m_linear,       m_spot_light_linear_offset       + (m_spot_light_array_stride * i));
-					m_spot_lights_buffer.set_data(p_spotlight.m_quadratic,    m_spot_light_quadratic_offset    + (m_spot_light_array_stride * i));
-					m_spot_lights_buffer.set_data(ambient,                    m_spot_light_ambient_offset      + (m_spot_light_array_stride * i));
-					m_spot_lights_buffer.set_data(diffuse,                    m_spot_light_diffuse_offset      + (m_spot_light_array_stride * i));
-					m_spot_lights_buffer.set_data(specular,                   m_spot_light_specular_offset     + (m_spot_light_array_stride * i));
-					i++;
-				});
-			}
+				const glm::vec3 diffuse  = p_spotlight.m_colour * p_spotlight.m_diffuse_intensity;
+				const glm::vec3 ambient  = p_spotlight.m_colour * p_spotlight.m_ambient_intensity;
+				const glm::vec3 specular = glm::vec3(p_spotlight.m_specular_intensity);
+
+				stage(m_light_staging, m_spot_light_position_offset     + light_offset, p_spotlight.m_position);
+				stage(m_light_staging, m_spot_light_direction_offset    + light_offset, p_spotlight.m_direction);
+				stage(m_light_staging, m_spot_light_cutoff_offset       + light_offset, p_spotlight.m_cutoff);
+				stage(m_light_staging, m_spot_light_outer_cutoff_offset + light_offset, p_spotlight.m_outer_cutoff);
+				stage(m_light_staging, m_spot_light_constant_offset     + light_offset, p_spotlight.m_constant);
+				stage(m_light_staging, m_spot_light_linear_offset       + light_offset, p_spotlight.m_linear);
+				stage(m_light_staging, m_spot_light_quadratic_offset    + light_offset, p_spotlight.m_quadratic);
+				stage(m_light_staging, m_spot_light_ambient_offset      + light_offset, ambient);
+				stage(m_light_staging, m_spot_light_diffuse_offset      + light_offset, diffuse);
+				stage(m_light_staging, m_spot_light_specular_offset     + light_offset, specular);
+
+				light_offset += m_spot_light_array_stride;
+			});
+			upload_if_changed(m_spot_lights_buffer, m_spot_lights_data);
 		}
 	}
+	void PhongRenderer::update_light_clusters(System::Scene& p_scene, const Component::ViewInformation& p_view_info, const glm::uvec2& p_resolution, bool p_clustering, RingBuffer& p_frame_data)
+	{
+		m_view_point_lights.clear();
+		p_scene.m_entities.foreach([&](Component::PointLight& p_point_light)
+		{
+			const float intensity = (std::max({p_point_light.m_colour.r, p_point_light.m_colour.g, p_point_light.m_colour.b}) * (p_point_light.m_ambient_intensity + p_point_light.m_diffuse_intensity)) + p_point_light.m_specular_intensity;
+			const float radius    = LightClusters::attenuation_radius(p_point_light.m_constant, p_point_light.m_linear, p_point_light.m_quadratic, intensity);
+			m_view_point_lights.push_back({glm::vec3(p_view_info.m_view * glm::vec4(p_point_light.m_position, 1.f)), radius});
+		});
+		m_view_spot_lights.clear();
+		p_scene.m_entities.foreach([&](Component::SpotLight& p_spotlight)
+		{
+			const float intensity = (std::max({p_spotlight.m_colour.r, p_spotlight.m_colour.g, p_spotlight.m_colour.b}) * (p_spotlight.m_ambient_intensity + p_spotlight.m_diffuse_intensity)) + p_spotlight.m_specular_intensity;
+			const float range     = LightClusters::attenuation_radius(p_spotlight.m_constant, p_spotlight.m_linear, p_spotlight.m_quadratic, intensity);
+			const glm::vec3 direction = glm::normalize(glm::mat3(p_view_info.m_view) * p_spotlight.m_direction);
+			// The cone is treated as at most a hemisphere, the cone vs cluster test doesn't hold past it.
+			const float outer_angle = std::acos(glm::clamp(p_spotlight.m_outer_cutoff, 0.f, 1.f));
+			m_view_spot_lights.push_back({glm::vec3(p_view_info.m_view * glm::vec4(p_spotlight.m_position, 1.f)), range, direction, outer_angle});
+		});
+
+		m_light_clusters.set_grid(p_clustering ? LightClusters::Default_Grid : glm::uvec3(1));
+		m_light_clusters.build_grid(p_view_info.m_projection, p_resolution);
+		m_light_clusters.assign(m_view_point_lights, m_view_spot_lights);
+
+		const auto& header   = m_light_clusters.header();
+		const auto& clusters = m_light_clusters.clusters();
+		m_light_clusters_range = p_frame_data.allocate(sizeof(header) + (clusters.size() * sizeof(LightClusters::Cluster)));
+		std::memcpy(m_light_clusters_range.data, &header, sizeof(header));
+		std::memcpy(m_light_clusters_range.data + sizeof(header), clusters.data(), clusters.size() * sizeof(LightClusters::Cluster));
+
+		const auto& light_indices = m_light_clusters.light_indices();
+		m_light_indices_range = light_indices.empty() ? p_frame_data.push(uint32_t(0)) : p_frame_data.push(light_indices); // An empty range can't be bound.
+	}
+	void PhongRenderer::upload_if_changed(Buffer& p_buffer, std::vector<std::byte>& p_uploaded)
+	{
+		if (m_light_staging == p_uploaded)
+			return;
+
+		if (m_light_staging.size() > p_buffer.capacity())
+			p_buffer.reserve(m_light_staging.size());
+
+		p_buffer.set_data(m_light_staging, 0);
+		std::swap(m_light_staging, p_uploaded);
+		m_light_uploads++;
+	}
 	void PhongRenderer::reload_shaders()
 	{
-		m_phong_texture.reload();
-		m_phong_uniform_colour.reload();
-		m_phong_texture_shadow.reload();
+		for (auto& variant : m_variants)
+			variant.reload();
 	}
 } // namespace OpenGL
\ No newline at end of file
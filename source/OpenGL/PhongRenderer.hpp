@@ -1,8 +1,19 @@
 #pragma once
 
+#include "LightClusters.hpp"
+#include "RingBuffer.hpp"
 #include "Shader.hpp"
 #include "Types.hpp"
 
+#include "glm/vec2.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace Component
+{
+	struct ViewInformation;
+}
 namespace ECS
 {
 	class Storage;
@@ -15,10 +26,17 @@ namespace OpenGL
 {
 	class PhongRenderer
 	{
-		Shader m_phong_texture;               // Variation of phong shader that uses specular and diffuse textures. Used to fetch the Directional, Point and spot light buffers.
-		Shader m_phong_texture_shadow;        // Same as texture but supports shadows
-		Shader m_phong_uniform_colour;        // Variation of phong shader that uses a uniform colour instead of a texture.
-		Shader m_phong_uniform_colour_shadow; // Same as uniform colour but supports shadows
+		enum Variant : size_t
+		{
+			Uniform_Colour = 1 << 0, // UNIFORM_COLOUR: A uniform colour instead of specular and diffuse textures.
+			Shadows        = 1 << 1, // SHADOWS: Samples the shadow cascades of the first directional light, see ShadowMapper.
+			Quantised      = 1 << 2, // QUANTISED: Reads the Data::QuantisedVertex layout of imported meshes.
+			Instanced      = 1 << 3, // INSTANCED: Reads the model matrix and material of each instance from the InstancesBuffer, see OpenGL::InstanceData.
+			Variant_Count  = 1 << 4
+		};
+		// Every combination of the phong shader defines, indexed by the Variant bits.
+		// The texture variant (no bits set) is used to fetch the layout of the Directional, Point and Spot light buffers.
+		std::vector<Shader> m_variants;
 
 		Buffer m_directional_lights_buffer; // The buffer used across shaders to bind DirectionalLight data.
 		GLsizeiptr m_directional_light_fixed_size; // Size in bytes of the fixed portion of the directional light shader storage block (excludes any variable-sized-array variables sizes).
@@ -56,20 +74,55 @@ namespace OpenGL
 		GLsizeiptr m_spot_light_diffuse_offset;
 		GLsizeiptr m_spot_light_specular_offset;
 
+		// The light blocks as last uploaded to each buffer. The next image is staged in full and only uploaded if it differs.
+		std::vector<std::byte> m_directional_lights_data;
+		std::vector<std::byte> m_point_lights_data;
+		std::vector<std::byte> m_spot_lights_data;
+		std::vector<std::byte> m_light_staging; // The block image being built, swapped with the uploaded image of its buffer on upload.
+		size_t m_light_uploads; // Number of light buffer uploads since construction.
+
+		LightClusters m_light_clusters;
+		std::vector<LightClusters::PointLight> m_view_point_lights; // Point lights in view space, in PointLightsBuffer order.
+		std::vector<LightClusters::SpotLight> m_view_spot_lights;   // Spot lights in view space, in SpotLightsBuffer order.
+		RingBuffer::Range m_light_clusters_range; // LightClustersBuffer SSBO of the frame.
+		RingBuffer::Range m_light_indices_range;  // LightIndicesBuffer SSBO of the frame.
+
 	public:
 		PhongRenderer();
 
-		Shader& get_texture_shader()                        { return m_phong_texture; }
-		Shader& get_texture_shadow_shader()                 { return m_phong_texture_shadow; }
-		Shader& get_uniform_colour_shader()                 { return m_phong_uniform_colour; }
-		Shader& get_uniform_colour_shadow_shader()          { return m_phong_uniform_colour_shadow; }
+		// All the shaders expect the "LightClustersBuffer" and "LightIndicesBuffer" SSBOs of update_light_clusters alongside the light buffers.
+		// The quantised shaders expect the "dequantise" uniform set to Data::Mesh::dequantise_matrix.
+		// The instanced shaders expect the "InstancesBuffer" SSBO and the "instance_offset" uniform in place of the "model", "shininess" and "uColour" uniforms.
+		Shader& get_texture_shader(bool p_quantised = false, bool p_instanced = false)               { return get_variant(0, p_quantised, p_instanced); }
+		Shader& get_texture_shadow_shader(bool p_quantised = false, bool p_instanced = false)        { return get_variant(Shadows, p_quantised, p_instanced); }
+		Shader& get_uniform_colour_shader(bool p_quantised = false, bool p_instanced = false)        { return get_variant(Uniform_Colour, p_quantised, p_instanced); }
+		Shader& get_uniform_colour_shadow_shader(bool p_quantised = false, bool p_instanced = false) { return get_variant(Uniform_Colour | Shadows, p_quantised, p_instanced); }
 		const Buffer& get_directional_lights_buffer() const { return m_directional_lights_buffer; }
 		const Buffer& get_point_lights_buffer() const       { return m_point_lights_buffer; }
 		const Buffer& get_spot_lights_buffer() const        { return m_spot_lights_buffer; }
+		const RingBuffer::Range& get_light_clusters_range() const { return m_light_clusters_range; }
+		const RingBuffer::Range& get_light_indices_range() const  { return m_light_indices_range; }
+		const LightClusters& get_light_clusters() const           { return m_light_clusters; }
 
 		// Given a p_scene, updates the buffers with the light data from the scene's entities.
-		// Only needs to happen once per frame or on changes to a light.
+		// Each buffer is written with one upload of its whole block, skipped if no light of its type changed since the last update.
 		void update_light_data(System::Scene& p_scene);
+		size_t light_upload_count() const { return m_light_uploads; }
+		// Assign the point and spot lights of p_scene to the clusters of the view and write the clusters and their light lists into p_frame_data.
+		// Call after update_light_data, the cluster light lists index the light buffers in the order it wrote them.
+		//@param p_resolution Size in pixels of the target the phong shaders draw into.
+		//@param p_clustering Split the view into LightClusters::Default_Grid clusters, otherwise a single cluster holds every light touching the view.
+		void update_light_clusters(System::Scene& p_scene, const Component::ViewInformation& p_view_info, const glm::uvec2& p_resolution, bool p_clustering, RingBuffer& p_frame_data);
 		void reload_shaders();
+
+	private:
+		Shader& get_variant(size_t p_variant, bool p_quantised, bool p_instanced)
+		{
+			if (p_quantised) p_variant |= Quantised;
+			if (p_instanced) p_variant |= Instanced;
+			return m_variants[p_variant];
+		}
+		// Upload m_light_staging into p_buffer unless it matches p_uploaded, the block image p_buffer already holds.
+		void upload_if_changed(Buffer& p_buffer, std::vector<std::byte>& p_uploaded);
 	};
 } // namespace OpenGL
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "RenderQueue.hpp"
+#include "Shader.hpp"
+#include "Types.hpp"
+
+#include "Utility/Logger.hpp"
+#include "Utility/Performance.hpp"
+#include "Utility/RadixSort.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace OpenGL
+{
+	uint64_t RenderQueue::make_key(Pass p_pass, const Shader& p_shader, const Texture* p_texture, const VAO& p_VAO, float p_depth)
+	{
+		const auto pass         = static_cast<uint64_t>(p_pass);
+		const auto shader       = static_cast<uint64_t>(p_shader.m_handle);
+		const auto vertex_array = static_cast<uint64_t>(p_VAO.m_handle);
+		if (p_pass == Pass::Transparent)
+		{
+			// Inverting the key sorts the farthest draws first.
+			const auto depth = static_cast<uint64_t>(~Utility::sortable_key(p_depth));
+			return (pass & 0xF) << 60 | depth << 28 | (shader & 0xFFF) << 16 | (vertex_array & 0xFFFF);
+		}
+
+		// Non-negative floats order the same as their bit patterns, the top 16 bits keep the exponent and 7 bits of mantissa.
+		const auto depth   = static_cast<uint64_t>(std::bit_cast<uint32_t>(std::max(p_depth, 0.f)) >> 16);
+		const auto texture = static_cast<uint64_t>(p_texture ? p_texture->m_handle : 0);
+		return (pass & 0xF) << 60 | (shader & 0xFFF) << 48 | (texture & 0xFFFF) << 32 | (vertex_array & 0xFFFF) << 16 | depth;
+	}
+
+	RenderQueue::RenderQueue() noexcept
+		: m_entries{}
+		, m_keys{}
+		, m_sort_scratch{}
+		, m_submitted_count{0}
+	{}
+
+	void RenderQueue::push(uint64_t p_key, const DrawCall& p_draw_call, Shader& p_shader, const VAO& p_VAO, const FBO& p_FBO, GLsizei p_instance_count)
+	{
+		ASSERT(m_entries.size() < std::numeric_limits<uint32_t>::max(), "[RenderQueue] Too many draws queued {}", m_entries.size());
+
+		m_keys.push_back({p_key, static_cast<uint32_t>(m_entries.size())});
+		m_entries.push_back({p_draw_call, &p_shader, &p_VAO, &p_FBO, p_instance_count});
+	}
+	void RenderQueue::submit(Pass p_pass)
+	{
+		PERF(RenderQueueSubmit);
+
+		// Stable so draws with equal keys keep the order they were pushed in.
+		// The pass is the top of the key so the draws of each pass are a contiguous run of the sorted keys.
+		Utility::radix_sort(m_keys, m_sort_scratch, [](const SortKey& p_key) { return p_key.key; });
+		auto in_pass     = [p_pass](const SortKey& p_key) { return static_cast<Pass>(p_key.key >> 60) == p_pass; };
+		const auto begin = std::find_if(m_keys.begin(), m_keys.end(), in_pass);
+		const auto end   = std::find_if_not(begin, m_keys.end(), in_pass);
+		for (auto key = begin; key != end; ++key)
+		{
+			const Entry& entry = m_entries[key->entry];
+			if (entry.instance_count > 0)
+				entry.draw_call.submit_instanced(*entry.shader, *entry.vertex_array, *entry.target, entry.instance_count);
+			else
+				entry.draw_call.submit(*entry.shader, *entry.vertex_array, *entry.target);
+		}
+
+		m_submitted_count = static_cast<size_t>(end - begin);
+		m_keys.erase(begin, end);
+		if (m_keys.empty())
+			m_entries.clear(); // Entries of the remaining passes are referenced by index until every pass is submitted.
+	}
+} // namespace OpenGL
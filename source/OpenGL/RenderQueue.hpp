@@ -0,0 +1,73 @@
+#pragma once
+
+#include "DrawCall.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OpenGL
+{
+	class Shader;
+	class VAO;
+	class FBO;
+	class Texture;
+
+	// Collects the draw calls of a frame and submits them ordered by a 64-bit sort key instead of the order they were pushed in.
+	// Draws sharing a shader, texture and VAO end up next to each other so OpenGL::State skips the binds between them.
+	// Opaque draws are grouped by state, key layout from the most significant bit:
+	// | pass 4 | shader 12 | texture 16 | VAO 16 | depth 16 |
+	// Transparent draws blend over what's behind them so they are ordered farthest first, then by state:
+	// | pass 4 | far to near depth 32 | shader 12 | VAO 16 |
+	class RenderQueue
+	{
+	public:
+		// Passes are submitted in this order.
+		enum class Pass : uint8_t
+		{
+			Opaque,
+			Transparent
+		};
+
+		// Build the sort key of a draw.
+		// Handles are truncated to their field, handles that collide only put unrelated draws next to each other.
+		//@param p_texture The texture that best identifies the material of the draw, nullptr if it has none.
+		//@param p_depth View space distance to the draw. Opaque draws with equal state are submitted nearest first, transparent draws farthest first.
+		static uint64_t make_key(Pass p_pass, const Shader& p_shader, const Texture* p_texture, const VAO& p_VAO, float p_depth);
+
+		RenderQueue() noexcept;
+
+		// Queue a copy of p_draw_call to be submitted with the provided shader and VAO into p_FBO.
+		// p_shader, p_VAO and p_FBO must stay alive until submit.
+		//@param p_instance_count Submit with DrawCall::submit_instanced drawing this many instances, 0 to submit a regular draw.
+		void push(uint64_t p_key, const DrawCall& p_draw_call, Shader& p_shader, const VAO& p_VAO, const FBO& p_FBO, GLsizei p_instance_count = 0);
+		// Sort the queued draws by key and submit the draws of p_pass in order, the draws of other passes stay queued.
+		// Passes are submitted separately so draws that don't go through the queue can be drawn between them.
+		void submit(Pass p_pass);
+
+		size_t size() const  { return m_keys.size(); }
+		bool empty() const   { return m_keys.empty(); }
+		// Number of draws the last submit sent.
+		size_t submitted_count() const { return m_submitted_count; }
+
+	private:
+		struct Entry
+		{
+			DrawCall draw_call;
+			Shader* shader;
+			const VAO* vertex_array;
+			const FBO* target;
+			GLsizei instance_count;
+		};
+		struct SortKey
+		{
+			uint64_t key;
+			uint32_t entry; // Index into m_entries.
+		};
+
+		std::vector<Entry> m_entries;
+		std::vector<SortKey> m_keys;
+		std::vector<SortKey> m_sort_scratch; // Kept between frames so sorting doesn't allocate.
+		size_t m_submitted_count;
+	};
+} // namespace OpenGL
@@ -0,0 +1,119 @@
+#include "RingBuffer.hpp"
+
+#include "Utility/Logger.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace OpenGL
+{
+	namespace
+	{
+		size_t align_up(size_t p_value, size_t p_alignment)
+		{
+			return (p_value + p_alignment - 1) / p_alignment * p_alignment;
+		}
+		const BufferStorageBitfield& mapping_flags()
+		{
+			static const BufferStorageBitfield flags = {BufferStorageFlag::MapWriteBit, BufferStorageFlag::MapPersistentBit, BufferStorageFlag::MapCoherentBit};
+			return flags;
+		}
+	} // namespace
+
+	RingBuffer::RingBuffer(size_t p_region_size)
+		: m_handle{0}
+		, m_mapped{nullptr}
+		, m_region_size{0}
+		, m_alignment{static_cast<size_t>(std::max(get_uniform_buffer_offset_alignment(), get_shader_storage_buffer_offset_alignment()))}
+		, m_region{0}
+		, m_head{0}
+		, m_fences{}
+		, m_retired{}
+		, m_stall_count{0}
+	{
+		m_region_size = align_up(std::max(p_region_size, m_alignment), m_alignment);
+		create_storage();
+	}
+	RingBuffer::~RingBuffer()
+	{
+		for (auto& fence : m_fences)
+			if (fence)
+				delete_sync(fence);
+
+		release_storage();
+		for (auto handle : m_retired)
+			State::Get().delete_buffer(handle);
+	}
+
+	RingBuffer::Range RingBuffer::allocate(size_t p_size)
+	{
+		const size_t size = align_up(std::max(p_size, size_t(1)), m_alignment);
+		if (m_head + size > m_region_size)
+		{
+			// Keep the full storage alive until end_frame, the draws of this frame still hold its handle.
+			// Then grow and start the frame over from the beginning of the current region of the new storage.
+			LOG_WARN(false, "[OPENGL][RING BUFFER] Region of {}B full, growing to {}B", m_region_size, std::max(m_region_size * 2, size));
+			ASSERT(m_handle != 0, "[OPENGL][RING BUFFER] No storage to retire");
+			unmap_named_buffer(m_handle);
+			m_retired.push_back(std::exchange(m_handle, 0));
+			m_mapped = nullptr;
+
+			for (auto& fence : m_fences) // The new storage is not read by any command yet.
+				if (fence)
+					delete_sync(std::exchange(fence, nullptr));
+
+			m_region_size = std::max(m_region_size * 2, size);
+			m_head        = 0;
+			create_storage();
+		}
+
+		if (m_head == 0 && m_fences[m_region])
+		{
+			// First write to this region since it was fenced Region_Count frames ago, the GPU may still be reading it.
+			if (!client_wait_sync(m_fences[m_region], 0))
+			{
+				m_stall_count++;
+				while (!client_wait_sync(m_fences[m_region], 1'000'000)) {}
+			}
+			delete_sync(std::exchange(m_fences[m_region], nullptr));
+		}
+
+		const size_t offset = m_region * m_region_size + m_head;
+		m_head += size;
+		return Range{m_handle, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(p_size), m_mapped + offset};
+	}
+	void RingBuffer::end_frame()
+	{
+		if (m_head > 0)
+		{
+			ASSERT(!m_fences[m_region], "[OPENGL][RING BUFFER] Region {} fenced twice", m_region);
+			m_fences[m_region] = fence_sync();
+			m_region = (m_region + 1) % Region_Count;
+			m_head   = 0;
+		}
+
+		for (auto handle : m_retired)
+			State::Get().delete_buffer(handle);
+		m_retired.clear();
+	}
+
+	void RingBuffer::create_storage()
+	{
+		const auto capacity = static_cast<GLsizeiptr>(m_region_size * Region_Count);
+		m_handle = State::Get().create_buffer();
+		named_buffer_storage(m_handle, capacity, nullptr, mapping_flags());
+		m_mapped = static_cast<std::byte*>(map_named_buffer_range(m_handle, 0, capacity, mapping_flags()));
+		ASSERT_THROW(m_mapped != nullptr, "[OPENGL][RING BUFFER] Failed to map {}B", capacity);
+
+		if constexpr (LogGLTypeEvents || LogGLBufferEvents) LOG("[OPENGL][RING BUFFER] Created ring buffer {} with {} regions of {}B", m_handle, Region_Count, m_region_size);
+	}
+	void RingBuffer::release_storage()
+	{
+		if (m_handle == 0)
+			return;
+
+		unmap_named_buffer(m_handle);
+		State::Get().delete_buffer(std::exchange(m_handle, 0));
+		m_mapped = nullptr;
+	}
+} // namespace OpenGL
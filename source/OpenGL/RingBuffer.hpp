@@ -0,0 +1,80 @@
+#pragma once
+
+#include "GLState.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace OpenGL
+{
+	// A persistently and coherently mapped buffer for transient data written every frame, such as the ViewProperties UBO or instance SSBOs.
+	// The buffer is split into Region_Count regions, the CPU writes the data of a frame into one region while the GPU reads the regions of
+	// the frames before it. Each region is fenced at end_frame and waited on before it's written to again Region_Count frames later,
+	// so writes are plain memcpys into mapped memory without the implicit synchronisation of Buffer::set_data.
+	class RingBuffer
+	{
+	public:
+		static constexpr size_t Region_Count = 3;
+
+		// A range of the ring written this frame. Bind it with DrawCall::set_UBO or DrawCall::set_SSBO.
+		// Only valid until end_frame, the range is overwritten Region_Count frames later.
+		struct Range
+		{
+			GLHandle handle   = 0;
+			GLintptr offset   = 0;
+			GLsizeiptr size   = 0;
+			std::byte* data   = nullptr; // The mapped memory of the range to write through.
+		};
+
+		//@param p_region_size Bytes available to a frame. A frame needing more grows the ring, see allocate.
+		explicit RingBuffer(size_t p_region_size);
+		~RingBuffer();
+		RingBuffer(const RingBuffer&)            = delete;
+		RingBuffer& operator=(const RingBuffer&) = delete;
+
+		// Reserve p_size bytes in the region of the current frame, aligned so the range can be bound as a UBO or SSBO.
+		// If the region is full the ring is replaced by one with regions twice the size, ranges allocated earlier in the frame stay valid.
+		Range allocate(size_t p_size);
+		// Allocate and copy p_data into the ring.
+		template <typename T>
+		Range push(const T& p_data)
+		{
+			const Range range = allocate(sizeof(T));
+			std::memcpy(range.data, &p_data, sizeof(T));
+			return range;
+		}
+		template <typename T>
+		Range push(const std::vector<T>& p_data)
+		{
+			const Range range = allocate(sizeof(T) * p_data.size());
+			if (!p_data.empty())
+				std::memcpy(range.data, p_data.data(), sizeof(T) * p_data.size());
+			return range;
+		}
+		// Fence the commands issued so far reading this frame's region and move on to the next region.
+		// Call once all the draws using the ranges of the frame have been submitted.
+		void end_frame();
+
+		size_t region_size() const { return m_region_size; }
+		// Number of times allocate had to wait for the GPU to finish reading a region.
+		size_t stall_count() const { return m_stall_count; }
+
+	private:
+		// Create the buffer storage of Region_Count regions of m_region_size and map it.
+		void create_storage();
+		// Unmap and delete the storage, its handle stays valid for the commands already issued reading it.
+		void release_storage();
+
+		GLHandle m_handle;
+		std::byte* m_mapped;
+		size_t m_region_size;
+		size_t m_alignment;
+		size_t m_region;    // Index of the region written this frame.
+		size_t m_head;      // Offset into the current region of the next allocation.
+		std::array<GLsync, Region_Count> m_fences; // Signalled once the GPU has finished reading each region, nullptr if the region is free.
+		std::vector<GLHandle> m_retired; // Storage replaced by a grow this frame, released at end_frame once nothing else can reference it.
+		size_t m_stall_count;
+	};
+} // namespace OpenGL
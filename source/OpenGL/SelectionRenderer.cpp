@@ -1,5 +1,6 @@
 #include "SelectionRenderer.hpp"
 #include "DrawCall.hpp"
+#include "UniformIDs.hpp"
 
 #include "Component/Mesh.hpp"
 #include "Component/Transform.hpp"
@@ -27,7 +28,7 @@ namespace OpenGL
 		, m_outline_colour{1.f, 0.f, 0.f, 1.f}
 	{}
 
-	void SelectionRenderer::selection_pass(std::span<const ECS::Entity> p_selected_entities, ECS::Storage& p_entities, const Buffer& p_view_properties, FBO& p_target_FBO)
+	void SelectionRenderer::selection_pass(std::span<const ECS::Entity> p_selected_entities, ECS::Storage& p_entities, const RingBuffer::Range& p_view_properties, FBO& p_target_FBO)
 	{
 		if (p_selected_entities.empty())
 			return;
@@ -62,8 +63,11 @@ namespace OpenGL
 				dc.m_depth_test_enabled    = true;
 				dc.m_depth_test_type       = DepthTestType::Always;
 				dc.m_write_to_depth_buffer = true;
-				dc.set_uniform("model", transform.get_model());
-				dc.set_UBO("ViewProperties", p_view_properties);
+				const auto& LOD = mesh.m_mesh->LODs[mesh.m_LOD]; // Match the LOD drawn so the outline hugs the visible surface.
+				dc.m_first_element = static_cast<GLsizei>(LOD.first_index);
+				dc.m_element_count = static_cast<GLsizei>(LOD.index_count);
+				dc.set_uniform(Uniform::model, transform.get_model() * mesh.m_mesh->dequantise_matrix());
+				dc.set_UBO(Uniform::ViewProperties, p_view_properties);
 				dc.submit(m_mask_shader, mesh.m_mesh->get_VAO(), *m_mask_FBO);
 			}
 
@@ -74,12 +78,12 @@ namespace OpenGL
 				dc.m_depth_test_enabled    = false;
 				dc.m_write_to_depth_buffer = false;
 				dc.m_cull_face_enabled     = false;
-				dc.set_texture("mask", m_mask_FBO->color_attachment());
-				dc.set_texture("mask_depth", m_mask_FBO->depth_attachment());
-				dc.set_texture("scene_depth", p_target_FBO.depth_attachment());
-				dc.set_uniform("colour", m_outline_colour);
-				dc.set_uniform("texel_size", texel_size);
-				dc.set_uniform("radius", m_outline_pixels);
+				dc.set_texture(Uniform::mask, m_mask_FBO->color_attachment());
+				dc.set_texture(Uniform::mask_depth, m_mask_FBO->depth_attachment());
+				dc.set_texture(Uniform::scene_depth, p_target_FBO.depth_attachment());
+				dc.set_uniform(Uniform::colour, m_outline_colour);
+				dc.set_uniform(Uniform::texel_size, texel_size);
+				dc.set_uniform(Uniform::radius, m_outline_pixels);
 				dc.submit(m_edge_shader, m_screen_quad.get_VAO(), p_target_FBO);
 			}
 		}
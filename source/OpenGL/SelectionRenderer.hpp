@@ -1,5 +1,6 @@
 #pragma once
 
+#include "RingBuffer.hpp"
 #include "Shader.hpp"
 #include "Types.hpp"
 
@@ -17,8 +18,6 @@ namespace ECS
 }
 namespace OpenGL
 {
-	class Buffer;
-
 	// Renders screen-space selection outlines around selected entities using a per-entity
 	// two-pass silhouette dilation approach with depth-based occlusion culling.
 	class SelectionRenderer
@@ -37,7 +36,7 @@ namespace OpenGL
 		// Render screen-space outlines around the selected entities into the target FBO.
 		// O(E * P^2) where E = selected entity count, P = outline pixel radius.
 		// Each entity costs two full-screen passes; the edge shader samples a (2*radius+1)^2 neighbourhood per fragment.
-		void selection_pass(std::span<const ECS::Entity> p_selected_entities, ECS::Storage& p_entities, const Buffer& p_view_properties, FBO& p_target_FBO);
+		void selection_pass(std::span<const ECS::Entity> p_selected_entities, ECS::Storage& p_entities, const RingBuffer::Range& p_view_properties, FBO& p_target_FBO);
 
 		void draw_UI();
 		void reload_shaders();
@@ -1,4 +1,5 @@
 #include "Shader.hpp"
+#include "CommandStream.hpp"
 
 #include "Utility/File.hpp"
 #include "Utility/Config.hpp"
@@ -12,6 +13,25 @@
 
 namespace OpenGL
 {
+	namespace
+	{
+		constexpr GLint Unresolved = -1;
+
+		// Look up p_ID in p_table, resolving it with p_resolve the first time it's seen.
+		template <typename ResolveFunc>
+		GLint resolve(std::vector<GLint>& p_table, UniformID p_ID, const ResolveFunc& p_resolve)
+		{
+			// IDs interned after the last use of this shader are past the end of the table.
+			if (p_ID.index() >= p_table.size())
+				p_table.resize(UniformID::count(), Unresolved);
+
+			GLint& resolved = p_table[p_ID.index()];
+			if (resolved == Unresolved)
+				resolved = p_resolve(p_ID.identifier().c_str()); // Throws if the shader doesn't declare the identifier, leaving it unresolved.
+			return resolved;
+		}
+	} // namespace
+
 	Shader::Shader(const char* p_name, const std::vector<const char*>& defines)
 		: m_name{p_name}
 		, m_handle{0}
@@ -20,6 +40,9 @@ namespace OpenGL
 		, m_uniforms{}
 		, m_defines{defines}
 		, is_compute_shader{false}
+		, m_uniform_locations{}
+		, m_uniform_block_indices{}
+		, m_shader_storage_block_indices{}
 	{
 		load_from_file(p_name);
 	}
@@ -152,10 +175,13 @@ namespace OpenGL
 
 	void Shader::reload()
 	{
-		glDeleteProgram(m_handle);
+		State::Get().delete_program(m_handle); // Through State so a new program reusing the handle is still bound.
 		m_uniform_blocks.clear();
 		m_shader_storage_blocks.clear();
 		m_uniforms.clear();
+		m_uniform_locations.clear();
+		m_uniform_block_indices.clear();
+		m_shader_storage_block_indices.clear();
 		load_from_file(m_name.c_str());
 	}
 
@@ -280,79 +306,126 @@ namespace OpenGL
 		return *it;
 	}
 
-	void Shader::set_uniform(const char* p_identifier, bool p_value) const
+	void Shader::set_uniform(UniformID p_ID, bool p_value)
 	{
-		auto location = get_uniform_variable(p_identifier).m_location;
+		auto location = get_uniform_location(p_ID);
+		if (auto* stream = State::Get().recording())
+			return stream->set_uniform(location, (GLint)p_value);
+
 		glUniform1i(location, (GLint)p_value); // Setting a boolean is treated as integer
 	}
-	void Shader::set_uniform(const char* p_identifier, int p_value) const
+	void Shader::set_uniform(UniformID p_ID, int p_value)
 	{
-		auto location = get_uniform_variable(p_identifier).m_location;
+		auto location = get_uniform_location(p_ID);
+		if (auto* stream = State::Get().recording())
+			return stream->set_uniform(location, (GLint)p_value);
+
 		glUniform1i(location, (GLint)p_value);
 	}
-	void Shader::set_uniform(const char* p_identifier, unsigned int p_value) const
+	void Shader::set_uniform(UniformID p_ID, unsigned int p_value)
 	{
-		auto location = get_uniform_variable(p_identifier).m_location;
+		auto location = get_uniform_location(p_ID);
+		if (auto* stream = State::Get().recording())
+			return stream->set_uniform(location, (GLuint)p_value);
+
 		glUniform1ui(location, (GLuint)p_value);
 	}
-	void Shader::set_uniform(const char* p_identifier, float p_value) const
+	void Shader::set_uniform(UniformID p_ID, float p_value)
 	{
-		auto location = get_uniform_variable(p_identifier).m_location;
+		auto location = get_uniform_location(p_ID);
+		if (auto* stream = State::Get().recording())
+			return stream->set_uniform(location, p_value);
+
 		glUniform1f(location, p_value);
 	}
-	void Shader::set_uniform(const char* p_identifier, const glm::vec2& p_value) const
+	void Shader::set_uniform(UniformID p_ID, const glm::vec2& p_value)
 	{
-		auto location = get_uniform_variable(p_identifier).m_location;
+		auto location = get_uniform_location(p_ID);
+		if (auto* stream = State::Get().recording())
+			return stream->set_uniform(location, p_value);
+
 		glUniform2fv(location, 1, glm::value_ptr(p_value));
 	}
-	void Shader::set_uniform(const char* p_identifier, const glm::vec3& p_value) const
+	void Shader::set_uniform(UniformID p_ID, const glm::vec3& p_value)
 	{
-		auto location = get_uniform_variable(p_identifier).m_location;
+		auto location = get_uniform_location(p_ID);
+		if (auto* stream = State::Get().recording())
+			return stream->set_uniform(location, p_value);
+
 		glUniform3fv(location, 1, glm::value_ptr(p_value));
 	}
-	void Shader::set_uniform(const char* p_identifier, const glm::vec4& p_value) const
+	void Shader::set_uniform(UniformID p_ID, const glm::vec4& p_value)
 	{
-		auto location = get_uniform_variable(p_identifier).m_location;
+		auto location = get_uniform_location(p_ID);
+		if (auto* stream = State::Get().recording())
+			return stream->set_uniform(location, p_value);
+
 		glUniform4fv(location, 1, glm::value_ptr(p_value));
 	}
-	void Shader::set_uniform(const char* p_identifier, const glm::mat2& p_value) const
+	void Shader::set_uniform(UniformID p_ID, const glm::mat2& p_value)
 	{
-		auto location = get_uniform_variable(p_identifier).m_location;
+		auto location = get_uniform_location(p_ID);
+		if (auto* stream = State::Get().recording())
+			return stream->set_uniform(location, p_value);
+
 		glUniformMatrix2fv(location, 1, GL_FALSE, glm::value_ptr(p_value));
 	}
-	void Shader::set_uniform(const char* p_identifier, const glm::mat3& p_value) const
+	void Shader::set_uniform(UniformID p_ID, const glm::mat3& p_value)
 	{
-		auto location = get_uniform_variable(p_identifier).m_location;
+		auto location = get_uniform_location(p_ID);
+		if (auto* stream = State::Get().recording())
+			return stream->set_uniform(location, p_value);
+
 		glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(p_value));
 	}
-	void Shader::set_uniform(const char* p_identifier, const glm::mat4& p_value) const
+	void Shader::set_uniform(UniformID p_ID, const glm::mat4& p_value)
 	{
-		auto location = get_uniform_variable(p_identifier).m_location;
+		auto location = get_uniform_location(p_ID);
+		if (auto* stream = State::Get().recording())
+			return stream->set_uniform(location, p_value);
+
 		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(p_value));
 	}
 
-	void Shader::bind_sampler_2D(const char* p_identifier, GLuint p_texture_binding)
+	GLint Shader::get_uniform_location(UniformID p_ID)
+	{
+		return resolve(m_uniform_locations, p_ID, [this](const char* p_identifier) { return get_uniform_variable(p_identifier).m_location; });
+	}
+
+	void Shader::bind_sampler_2D(UniformID p_ID, GLuint p_texture_binding)
 	{
 		GLint index = static_cast<GLint>(p_texture_binding);
-		set_uniform(p_identifier, index);
+		set_uniform(p_ID, index);
 	}
-	void Shader::bind_uniform_block(const char* p_identifier, GLuint p_uniform_block_binding)
+	void Shader::bind_uniform_block(UniformID p_ID, GLuint p_uniform_block_binding)
 	{
-		auto& block = get_uniform_block(p_identifier);
+		const GLint block_index = resolve(m_uniform_block_indices, p_ID, [this](const char* p_identifier)
+			{ return static_cast<GLint>(&get_uniform_block(p_identifier) - m_uniform_blocks.data()); });
+
+		auto& block = m_uniform_blocks[block_index];
 		if (block.m_binding_point == p_uniform_block_binding)
 			return;
 
-		glUniformBlockBinding(m_handle, block.m_block_index, p_uniform_block_binding);
 		block.m_binding_point = p_uniform_block_binding;
+		if (auto* stream = State::Get().recording())
+			return stream->uniform_block_binding(m_handle, block.m_block_index, p_uniform_block_binding);
+
+		glUniformBlockBinding(m_handle, block.m_block_index, p_uniform_block_binding);
 	}
-	void Shader::bind_shader_storage_block(const char* p_identifier, GLuint p_storage_block_binding)
+	void Shader::bind_shader_storage_block(UniformID p_ID, GLuint p_storage_block_binding)
 	{
-		auto& block = get_shader_storage_block(p_identifier);
+		const GLint block_index = resolve(m_shader_storage_block_indices, p_ID, [this](const char* p_identifier)
+			{ return static_cast<GLint>(&get_shader_storage_block(p_identifier) - m_shader_storage_blocks.data()); });
+
+		auto& block = m_shader_storage_blocks[block_index];
 		if (block.m_binding_point == p_storage_block_binding)
 			return;
 
-		glShaderStorageBlockBinding(m_handle, block.m_block_index, p_storage_block_binding);
 		block.m_binding_point = p_storage_block_binding;
+		if (auto* stream = State::Get().recording())
+			return stream->shader_storage_block_binding(m_handle, block.m_block_index, p_storage_block_binding);
+
+		glShaderStorageBlockBinding(m_handle, block.m_block_index, p_storage_block_binding);
 	}
 
 	std::string Shader::process_code(const std::string& source_code, const std::vector<const char*>& defined_variables)
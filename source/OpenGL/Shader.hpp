@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GLState.hpp"
+#include "UniformID.hpp"
 
 #include <string>
 #include <vector>
@@ -74,6 +75,7 @@ namespace OpenGL
 	class Shader
 	{
 		friend class DrawCall; // DrawCall needs to set the uniforms of the shader before draw.
+		friend class RenderQueue; // RenderQueue sorts draws by the program handle.
 
 		std::string m_name;
 		GLHandle m_handle;
@@ -83,21 +85,27 @@ namespace OpenGL
 		std::vector<const char *> m_defines;
 		bool is_compute_shader;
 
+		// Resolved the first time a UniformID is used with this shader, indexed by UniformID::index(). Cleared on reload.
+		std::vector<GLint> m_uniform_locations;            // Location of the loose uniform, -1 until first used.
+		std::vector<GLint> m_uniform_block_indices;        // Index into m_uniform_blocks, -1 until first used.
+		std::vector<GLint> m_shader_storage_block_indices; // Index into m_shader_storage_blocks, -1 until first used.
+		GLint get_uniform_location(UniformID p_ID);
+
 		// Uniform set functions are used only by the DrawCall class hence are private.
-		void set_uniform(const char* p_identifier, bool p_value) const;
-		void set_uniform(const char* p_identifier, int p_value) const;
-		void set_uniform(const char* p_identifier, unsigned int p_value) const;
-		void set_uniform(const char* p_identifier, float p_value) const;
-		void set_uniform(const char* p_identifier, const glm::vec2& p_value) const;
-		void set_uniform(const char* p_identifier, const glm::vec3& p_value) const;
-		void set_uniform(const char* p_identifier, const glm::vec4& p_value) const;
-		void set_uniform(const char* p_identifier, const glm::mat2& p_value) const;
-		void set_uniform(const char* p_identifier, const glm::mat3& p_value) const;
-		void set_uniform(const char* p_identifier, const glm::mat4& p_value) const;
-
-		void bind_sampler_2D(const char* p_identifier, GLuint p_texture_binding);
-		void bind_uniform_block(const char* p_identifier, GLuint p_uniform_block_binding);
-		void bind_shader_storage_block(const char* p_identifier, GLuint p_storage_block_binding);
+		void set_uniform(UniformID p_ID, bool p_value);
+		void set_uniform(UniformID p_ID, int p_value);
+		void set_uniform(UniformID p_ID, unsigned int p_value);
+		void set_uniform(UniformID p_ID, float p_value);
+		void set_uniform(UniformID p_ID, const glm::vec2& p_value);
+		void set_uniform(UniformID p_ID, const glm::vec3& p_value);
+		void set_uniform(UniformID p_ID, const glm::vec4& p_value);
+		void set_uniform(UniformID p_ID, const glm::mat2& p_value);
+		void set_uniform(UniformID p_ID, const glm::mat3& p_value);
+		void set_uniform(UniformID p_ID, const glm::mat4& p_value);
+
+		void bind_sampler_2D(UniformID p_ID, GLuint p_texture_binding);
+		void bind_uniform_block(UniformID p_ID, GLuint p_uniform_block_binding);
+		void bind_shader_storage_block(UniformID p_ID, GLuint p_storage_block_binding);
 
 		static std::string process_code(const std::string& source_code, const std::vector<const char*>& defined_variables);
 
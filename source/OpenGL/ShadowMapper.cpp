@@ -1,48 +1,272 @@
 #include "ShadowMapper.hpp"
 #include "DrawCall.hpp"
+#include "UniformIDs.hpp"
 
 #include "Component/Lights.hpp"
 #include "Component/Mesh.hpp"
 #include "Component/Transform.hpp"
+#include "Component/ViewInformation.hpp"
 #include "ECS/Storage.hpp"
+#include "Geometry/Frustrum.hpp"
 #include "System/SceneSystem.hpp"
 
+#include "glm/geometric.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "imgui.h"
+
+#include <algorithm>
+#include <cmath>
+
 namespace OpenGL
 {
 	ShadowMapper::ShadowMapper(const glm::uvec2& p_resolution) noexcept
-		: m_depth_map_FBO{p_resolution, false, true, false}
+		: m_depth_map_FBO{p_resolution * 2u, false, true, false}
+		, m_cascade_resolution{p_resolution}
 		, m_shadow_depth_shader{"shadowDepth"}
+		, m_shadow_depth_instanced_shader{"shadowDepth", {"INSTANCED"}}
+		, m_instance_batcher{}
+		, m_visible_casters{}
+		, m_cached{}
+		, m_cascades{}
+		, m_cascades_range{}
+		, m_frame{0}
+		, m_cascade_count{static_cast<int>(Max_Cascades)}
+		, m_shadow_distance{250.f}
+		, m_split_lambda{0.75f}
+		, m_padding{0.1f}
+		, m_refresh_intervals{1, 2, 4, 8}
+		, m_drawn_count{0}
+		, m_culled_count{0}
+		, m_rendered_cascades{0}
 	{}
 
-	void ShadowMapper::shadow_pass(System::Scene& p_scene)
+	std::array<float, ShadowMapper::Max_Cascades> ShadowMapper::split_depths(float p_near, float p_far, size_t p_count, float p_lambda)
+	{
+		ASSERT(p_count > 0 && p_count <= Max_Cascades, "[OPENGL][SHADOWS] Cascade count {} outside [1, {}]", p_count, Max_Cascades);
+		ASSERT(p_near > 0.f && p_near < p_far, "[OPENGL][SHADOWS] Invalid cascade depth range [{}, {}]", p_near, p_far);
+
+		std::array<float, Max_Cascades> splits;
+		splits.fill(p_far);
+		for (size_t i = 1; i < p_count; i++)
+		{
+			const float fraction    = static_cast<float>(i) / static_cast<float>(p_count);
+			const float logarithmic = p_near * std::pow(p_far / p_near, fraction);
+			const float uniform     = p_near + (p_far - p_near) * fraction;
+			splits[i - 1] = p_lambda * logarithmic + (1.f - p_lambda) * uniform;
+		}
+		return splits;
+	}
+
+	ShadowMapper::Fit ShadowMapper::fit_cascade(const Component::ViewInformation& p_view_info, float p_near_depth, float p_far_depth, const glm::vec3& p_light_direction,
+	                                            const Geometry::AABB& p_scene_bounds, float p_resolution, float p_padding)
+	{
+		// Each corner of the view volume is a line, through the origin for perspective and parallel to z for orthographic projections.
+		// Unprojecting the near plane and the middle of the depth range gives two points on each without the precision loss of a distant far plane.
+		const glm::mat4 inverse_projection = glm::inverse(p_view_info.m_projection);
+		auto unproject = [&inverse_projection](const glm::vec2& p_NDC, float p_NDC_depth)
+		{
+			const glm::vec4 position = inverse_projection * glm::vec4(p_NDC, p_NDC_depth, 1.f);
+			return glm::vec3(position) / position.w;
+		};
+
+		// The bounding sphere is found in view space so its radius doesn't change as the camera turns.
+		std::array<glm::vec3, 8> corners;
+		const std::array<glm::vec2, 4> NDC_corners = {glm::vec2(-1.f, -1.f), glm::vec2(1.f, -1.f), glm::vec2(-1.f, 1.f), glm::vec2(1.f, 1.f)};
+		for (size_t i = 0; i < NDC_corners.size(); i++)
+		{
+			const glm::vec3 near_point = unproject(NDC_corners[i], -1.f);
+			const glm::vec3 mid_point  = unproject(NDC_corners[i], 0.f);
+			const glm::vec3 per_depth  = (mid_point - near_point) / (near_point.z - mid_point.z);
+			corners[i * 2]     = near_point + per_depth * (p_near_depth + near_point.z);
+			corners[i * 2 + 1] = near_point + per_depth * (p_far_depth + near_point.z);
+		}
+		glm::vec3 view_center(0.f);
+		for (const auto& corner : corners)
+			view_center += corner / static_cast<float>(corners.size());
+		float radius = 0.f;
+		for (const auto& corner : corners)
+			radius = std::max(radius, glm::distance(corner, view_center));
+
+		const glm::vec3 up         = std::abs(p_light_direction.z) > 0.99f ? glm::vec3(0.f, 1.f, 0.f) : glm::vec3(0.f, 0.f, 1.f);
+		const glm::mat4 light_view = glm::lookAt(glm::vec3(0.f), p_light_direction, up);
+		const glm::vec3 center     = glm::vec3(light_view * glm::inverse(p_view_info.m_view) * glm::vec4(view_center, 1.f));
+
+		Fit fit;
+		fit.slice_center = center;
+		fit.slice_radius = radius;
+
+		// Moving the volume in whole texels keeps the world position of each texel fixed, the edges of the shadows stay put as the camera moves.
+		// The volume is a texel wider on each side so the sphere still fits after the centre is snapped.
+		const float padded_radius = std::max(radius * (1.f + p_padding), 1e-3f);
+		const float texel_size    = 2.f * padded_radius / std::max(p_resolution - 2.f, 1.f);
+		fit.center      = glm::round(glm::vec2(center) / texel_size) * texel_size;
+		fit.half_extent = padded_radius + texel_size;
+
+		// Casters between the light and the cascade shadow it, extend the depth range to every caster in the scene along the light direction.
+		fit.min_z = center.z - radius;
+		fit.max_z = center.z + radius;
+		for (size_t i = 0; i < 8; i++)
+		{
+			const glm::vec3 corner = {i & 1 ? p_scene_bounds.m_max.x : p_scene_bounds.m_min.x,
+			                          i & 2 ? p_scene_bounds.m_max.y : p_scene_bounds.m_min.y,
+			                          i & 4 ? p_scene_bounds.m_max.z : p_scene_bounds.m_min.z};
+			const float z = (light_view * glm::vec4(corner, 1.f)).z;
+			fit.min_z = std::min(fit.min_z, z);
+			fit.max_z = std::max(fit.max_z, z);
+		}
+
+		// The light looks down -z, the nearest caster has the largest z.
+		const float depth_margin = std::max((fit.max_z - fit.min_z) * 0.01f, 1e-3f);
+		const glm::mat4 projection = glm::ortho(fit.center.x - fit.half_extent, fit.center.x + fit.half_extent,
+		                                        fit.center.y - fit.half_extent, fit.center.y + fit.half_extent,
+		                                        -fit.max_z - depth_margin, -fit.min_z + depth_margin);
+		fit.light_proj_view = projection * light_view;
+		return fit;
+	}
+	bool ShadowMapper::Fit::covers(const Fit& p_other) const
+	{
+		const glm::vec2 offset = glm::abs(glm::vec2(p_other.slice_center) - center);
+		return std::max(offset.x, offset.y) + p_other.slice_radius <= half_extent
+			&& p_other.min_z >= min_z && p_other.max_z <= max_z;
+	}
+
+	void ShadowMapper::shadow_pass(System::Scene& p_scene, const Component::ViewInformation& p_view_info, bool p_frustrum_culling, bool p_instancing, RingBuffer& p_frame_data)
 	{
-		m_depth_map_FBO.clear();
-		unsigned int directional_light_count = static_cast<unsigned int>(p_scene.m_entities.count_components<Component::DirectionalLight>());
+		m_frame++;
+		m_drawn_count       = 0;
+		m_culled_count      = 0;
+		m_rendered_cascades = 0;
+		m_cascades.count    = 0;
 
-		if (directional_light_count > 0)
+		// Only the first directional light casts shadows, the phong shaders only sample its cascades.
+		const Component::DirectionalLight* light = nullptr;
+		p_scene.m_entities.foreach([&](Component::DirectionalLight& p_light)
 		{
-			// Draw the scene from the perspective of the light
-			p_scene.m_entities.foreach([&](Component::DirectionalLight& p_light)
+			if (!light)
+				light = &p_light;
+		});
+
+		if (light && glm::length(light->m_direction) > 0.f)
+		{
+			const glm::vec3 direction = glm::normalize(light->m_direction);
+
+			const glm::mat4 inverse_projection = glm::inverse(p_view_info.m_projection);
+			const glm::vec4 camera_near        = inverse_projection * glm::vec4(0.f, 0.f, -1.f, 1.f);
+			const glm::vec4 camera_far         = inverse_projection * glm::vec4(0.f, 0.f, 1.f, 1.f);
+			const float near_depth = std::max(-camera_near.z / camera_near.w, 1e-4f);
+			float far_depth        = -camera_far.z / camera_far.w;
+			if (!std::isfinite(far_depth) || far_depth > m_shadow_distance)
+				far_depth = m_shadow_distance;
+			far_depth = std::max(far_depth, near_depth * 1.001f);
+
+			const size_t cascade_count = static_cast<size_t>(m_cascade_count);
+			const auto splits          = split_depths(near_depth, far_depth, cascade_count, m_split_lambda);
+			const size_t revision      = p_scene.revision();
+			for (size_t i = 0; i < cascade_count; i++)
 			{
-				p_scene.m_entities.foreach([&](Component::Transform& p_transform, Component::Mesh& p_mesh)
+				const float cascade_near = i == 0 ? near_depth : splits[i - 1];
+				const Fit fit = fit_cascade(p_view_info, cascade_near, splits[i], direction, p_scene.m_rendered_bounds, static_cast<float>(m_cascade_resolution.x), m_padding);
+
+				// The depth map of a cascade stays valid while its light volume covers its depth range of the camera view.
+				// Moving casters only invalidate it once the refresh interval of the cascade has passed, distant cascades lag behind the scene.
+				auto& cached = m_cached[i];
+				const bool uncovered = !cached.valid || cached.light_direction != direction || cached.near_depth != cascade_near || cached.far_depth != splits[i] || !cached.fit.covers(fit);
+				const bool stale     = cached.scene_revision != revision && m_frame - cached.rendered_frame >= static_cast<size_t>(m_refresh_intervals[i]);
+				if (uncovered || stale)
 				{
-					DrawCall dc;
-					dc.m_cull_face_enabled = false;
-					dc.m_depth_test_enabled = true;
-					dc.m_write_to_depth_buffer = true;
-					dc.m_depth_test_type = DepthTestType::Less;
-					dc.set_uniform("light_space_mat", p_light.get_view_proj(p_scene.m_rendered_bounds));
-					dc.set_uniform("model", p_transform.get_model());
-					dc.submit(m_shadow_depth_shader, p_mesh.m_mesh->get_VAO(), m_depth_map_FBO);
-				});
-			});
+					cached = CachedCascade{fit, direction, cascade_near, splits[i], revision, m_frame, true};
+					render_cascade(p_scene, i, fit.light_proj_view, p_frustrum_culling, p_instancing, p_frame_data);
+					m_rendered_cascades++;
+				}
+
+				const glm::vec2 tile = glm::vec2(static_cast<float>(i % 2), static_cast<float>(i / 2)) * 0.5f;
+				m_cascades.cascades[i] = Cascade{cached.fit.light_proj_view, glm::vec4(tile, 0.5f, 0.5f)};
+				m_cascades.splits[static_cast<glm::length_t>(i)] = splits[i];
+			}
+			m_cascades.count = static_cast<uint32_t>(cascade_count);
+		}
+
+		m_cascades_range = p_frame_data.push(m_cascades);
+	}
+
+	void ShadowMapper::render_cascade(System::Scene& p_scene, size_t p_cascade, const glm::mat4& p_light_proj_view, bool p_frustrum_culling, bool p_instancing, RingBuffer& p_frame_data)
+	{
+		const glm::uvec2 tile_offset = glm::uvec2(static_cast<unsigned int>(p_cascade % 2), static_cast<unsigned int>(p_cascade / 2)) * m_cascade_resolution;
+		m_depth_map_FBO.clear_depth(tile_offset, m_cascade_resolution);
+
+		// Only meshes inside the orthographic volume of the cascade can cast into its depth map.
+		m_visible_casters.clear();
+		if (p_frustrum_culling)
+			m_culled_count += p_scene.cull(Geometry::Frustrum(p_light_proj_view), m_visible_casters);
+		else
+			m_visible_casters = p_scene.m_entity_AABB_owners;
+		m_drawn_count += m_visible_casters.size();
+
+		for (const auto& entity : m_visible_casters)
+		{
+			if (!p_scene.m_entities.has_components<Component::Transform, Component::Mesh>(entity))
+				continue; // Removed since the scene was updated.
+
+			auto& transform = p_scene.m_entities.get_component<Component::Transform>(entity);
+			auto& mesh      = p_scene.m_entities.get_component<Component::Mesh>(entity);
+			if (p_instancing)
+			{
+				m_instance_batcher.push({&*mesh.m_mesh, mesh.m_LOD, &m_shadow_depth_instanced_shader, nullptr, nullptr}, {transform.get_model(), glm::vec4(0.f), 0.f});
+				continue;
+			}
+
+			DrawCall dc;
+			dc.m_cull_face_enabled = false;
+			dc.m_depth_test_enabled = true;
+			dc.m_write_to_depth_buffer = true;
+			dc.m_depth_test_type = DepthTestType::Less;
+			dc.set_uniform(Uniform::light_space_mat, p_light_proj_view);
+			dc.set_uniform(Uniform::model, transform.get_model() * mesh.m_mesh->dequantise_matrix());
+			// Casters use the LOD picked for the camera view, the shadow of a distant mesh doesn't need more detail than the mesh.
+			const auto& LOD    = mesh.m_mesh->LODs[mesh.m_LOD];
+			dc.m_first_element = static_cast<GLsizei>(LOD.first_index);
+			dc.m_element_count = static_cast<GLsizei>(LOD.index_count);
+			dc.submit(m_shadow_depth_shader, mesh.m_mesh->get_VAO(), m_depth_map_FBO, tile_offset, m_cascade_resolution);
+		}
+
+		m_instance_batcher.build();
+		const auto instances = m_instance_batcher.upload(p_frame_data);
+		for (const auto& group : m_instance_batcher.groups())
+		{
+			const auto& mesh_data = *group.key.mesh;
+			DrawCall dc;
+			dc.m_cull_face_enabled = false;
+			dc.m_depth_test_enabled = true;
+			dc.m_write_to_depth_buffer = true;
+			dc.m_depth_test_type = DepthTestType::Less;
+			dc.set_uniform(Uniform::light_space_mat, p_light_proj_view);
+			dc.set_uniform(Uniform::dequantise, mesh_data.dequantise_matrix());
+			dc.set_uniform(Uniform::instance_offset, group.first_instance);
+			dc.set_SSBO(Uniform::InstancesBuffer, instances);
+			const auto& LOD    = mesh_data.LODs[group.key.LOD];
+			dc.m_first_element = static_cast<GLsizei>(LOD.first_index);
+			dc.m_element_count = static_cast<GLsizei>(LOD.index_count);
+			dc.submit_instanced(m_shadow_depth_instanced_shader, mesh_data.get_VAO(), m_depth_map_FBO, tile_offset, m_cascade_resolution, static_cast<GLsizei>(group.instance_count));
 		}
 	}
 
 	void ShadowMapper::draw_UI()
-	{}
+	{
+		ImGui::Text("Shadow casters drawn %zu culled %zu, cascades rendered %zu", m_drawn_count, m_culled_count, m_rendered_cascades);
+		ImGui::SliderInt("Shadow cascades", &m_cascade_count, 1, static_cast<int>(Max_Cascades));
+		ImGui::SliderFloat("Shadow distance", &m_shadow_distance, 10.f, 2000.f);
+		ImGui::SliderFloat("Cascade split lambda", &m_split_lambda, 0.f, 1.f);
+		if (ImGui::SliderFloat("Cascade padding", &m_padding, 0.f, 1.f))
+			for (auto& cached : m_cached)
+				cached.valid = false;
+		// The first cascade is re-rendered every frame the scene changes.
+		constexpr std::array<const char*, Max_Cascades - 1> interval_labels = {"Cascade 2 refresh interval", "Cascade 3 refresh interval", "Cascade 4 refresh interval"};
+		for (size_t i = 1; i < Max_Cascades; i++)
+			ImGui::SliderInt(interval_labels[i - 1], &m_refresh_intervals[i], 1, 32);
+	}
 	void ShadowMapper::reload_shaders()
 	{
 		m_shadow_depth_shader.reload();
+		m_shadow_depth_instanced_shader.reload();
 	}
-} // namespace OpenGL
\ No newline at end of file
+} // namespace OpenGL
@@ -1,29 +1,134 @@
 #pragma once
 
+#include "InstanceBatcher.hpp"
+#include "RingBuffer.hpp"
 #include "Types.hpp"
 #include "Shader.hpp"
 
+#include "ECS/Entity.hpp"
+#include "Geometry/AABB.hpp"
+
+#include "glm/mat4x4.hpp"
 #include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
 
 namespace System
 {
 	class Scene;
 }
+namespace Component
+{
+	struct ViewInformation;
+}
 namespace OpenGL
 {
+	// Renders cascaded shadow maps for the first directional light of the scene.
+	// The camera view is split into up to Max_Cascades depth ranges, each covered by its own orthographic light volume rendered into a tile of one depth map atlas.
+	// Cascades are only re-rendered when their light volume no longer covers their depth range or the scene changed, distant cascades at a lower rate.
 	class ShadowMapper
 	{
-		FBO m_depth_map_FBO;
-		Shader m_shadow_depth_shader;
-
 	public:
+		static constexpr size_t Max_Cascades = 4;
+
+		// A cascade as read by phong.frag, matches the std430 layout of the GLSL ShadowCascade struct.
+		struct Cascade
+		{
+			glm::mat4 light_proj_view; // World space to the light clip space of the cascade.
+			glm::vec4 atlas_rect;      // xy: Offset, zw: Scale from the [0, 1] texture coordinates of the cascade into the depth map atlas.
+		};
+		static_assert(sizeof(Cascade) == 80, "Cascade must match the std430 stride of the GLSL ShadowCascade struct.");
+		// The ShadowCascadesBuffer SSBO.
+		struct CascadesBlock
+		{
+			glm::vec4 splits;     // View depth each cascade covers up to, fragments past the last split are unshadowed.
+			uint32_t count;       // Number of cascades in use, 0 if there is no directional light.
+			uint32_t padding[3];
+			std::array<Cascade, Max_Cascades> cascades;
+		};
+		static_assert(sizeof(CascadesBlock) == 32 + 80 * Max_Cascades, "CascadesBlock must match the std430 layout of the ShadowCascadesBuffer.");
+
+		// The orthographic light volume of a cascade, fitted around the bounding sphere of a depth range of the camera view.
+		struct Fit
+		{
+			glm::mat4 light_proj_view;
+			glm::vec2 center;      // Centre of the volume across the light view, snapped to a texel of the cascade.
+			float half_extent;     // Half the width and height of the volume.
+			float min_z;           // Light view space depth range of the volume, extended to include every caster of the scene bounds.
+			float max_z;
+			glm::vec3 slice_center; // Bounding sphere of the depth range in light view space.
+			float slice_radius;
+
+			// Whether the volume covers p_other's depth range, so the depth map rendered for this fit can be sampled in its place.
+			bool covers(const Fit& p_other) const;
+		};
+
+		//@param p_resolution Resolution of the depth map of each cascade, the atlas is twice as wide and tall.
 		ShadowMapper(const glm::uvec2& p_resolution) noexcept;
 
-		// Renders the scene from the perspective of the light source to fill a depth texture map.
-		void shadow_pass(System::Scene& p_scene);
+		// Re-render the cascades of the first directional light that need it.
+		//@param p_view_info The camera the cascades are fitted to.
+		//@param p_frustrum_culling Skip the meshes outside the light volume of each cascade.
+		//@param p_instancing Draw the casters sharing a mesh LOD with one instanced draw.
+		//@param p_frame_data Ring the instances of the casters and the cascades are written to for the frame.
+		void shadow_pass(System::Scene& p_scene, const Component::ViewInformation& p_view_info, bool p_frustrum_culling, bool p_instancing, RingBuffer& p_frame_data);
 		const Texture& get_depth_map() const { return m_depth_map_FBO.depth_attachment(); };
+		// The ShadowCascadesBuffer of the last shadow_pass.
+		const RingBuffer::Range& get_cascades_range() const { return m_cascades_range; }
 
 		void draw_UI();
 		void reload_shaders();
+
+		// View depths splitting [p_near, p_far] into p_count cascades, blending logarithmic and uniform splits by p_lambda.
+		// The first p_count elements hold the far depth of each cascade, the last is p_far.
+		//@param p_lambda 1 for logarithmic splits, giving near cascades the most resolution, 0 for uniform splits.
+		static std::array<float, Max_Cascades> split_depths(float p_near, float p_far, size_t p_count, float p_lambda);
+		// Fit the light volume of a cascade around the camera view between p_near_depth and p_far_depth.
+		// The volume is sized from the bounding sphere of the range and its centre snapped to a texel, so the shadows don't shimmer as the camera moves or turns.
+		//@param p_light_direction Normalised direction the light travels.
+		//@param p_scene_bounds Casters inside the bounds are inside the depth range of the volume.
+		//@param p_resolution Resolution of the cascade depth map.
+		//@param p_padding Fraction the volume is grown by past the bounding sphere, lets the camera move before the cascade must be re-rendered.
+		static Fit fit_cascade(const Component::ViewInformation& p_view_info, float p_near_depth, float p_far_depth, const glm::vec3& p_light_direction,
+		                       const Geometry::AABB& p_scene_bounds, float p_resolution, float p_padding);
+
+	private:
+		// The last render of a cascade, reused until it no longer covers its depth range or the scene changed.
+		struct CachedCascade
+		{
+			Fit fit;
+			glm::vec3 light_direction;
+			float near_depth;
+			float far_depth;
+			size_t scene_revision;
+			size_t rendered_frame;
+			bool valid = false;
+		};
+		void render_cascade(System::Scene& p_scene, size_t p_cascade, const glm::mat4& p_light_proj_view, bool p_frustrum_culling, bool p_instancing, RingBuffer& p_frame_data);
+
+		FBO m_depth_map_FBO; // 2x2 atlas of cascade depth maps.
+		glm::uvec2 m_cascade_resolution;
+		Shader m_shadow_depth_shader;
+		Shader m_shadow_depth_instanced_shader;
+		InstanceBatcher m_instance_batcher; // Casters grouped by mesh LOD, rebuilt for every cascade.
+		std::vector<ECS::Entity> m_visible_casters; // Reused between passes to avoid reallocating.
+		std::array<CachedCascade, Max_Cascades> m_cached;
+		CascadesBlock m_cascades;
+		RingBuffer::Range m_cascades_range;
+		size_t m_frame;
+
+		int m_cascade_count;
+		float m_shadow_distance; // View depth past which nothing is shadowed.
+		float m_split_lambda;
+		float m_padding;
+		std::array<int, Max_Cascades> m_refresh_intervals; // Frames between re-renders of each cascade while the scene is changing.
+
+		size_t m_drawn_count;
+		size_t m_culled_count;
+		size_t m_rendered_cascades;
 	};
-}
\ No newline at end of file
+}
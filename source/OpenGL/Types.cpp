@@ -1,10 +1,21 @@
 #include "Types.hpp"
+#include "CommandStream.hpp"
 
 #include "Utility/Logger.hpp"
 #include "Utility/File.hpp"
 
 #include "glad/glad.h"
 
+// S3TC is not core OpenGL but is supported by every desktop driver. Define the enums in case the loader was generated without the extension.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+#include <algorithm>
+#include <bit>
 #include <cstring>
 #include <utility>
 
@@ -25,6 +36,17 @@ namespace OpenGL
 		}
 		else if constexpr (LogGLTypeEvents || LogGLBufferEvents) LOG("[OPENGL][BUFFER] Creating empty buffer {}", m_handle);
 	}
+	Buffer::Buffer(BufferStorageBitfield p_flags, const void* p_data, size_t p_size)
+		: m_handle{State::Get().create_buffer()}
+		, m_capacity{p_size}
+		, m_used_capacity{p_size}
+		, m_flags{p_flags}
+	{
+		ASSERT(p_data != nullptr && p_size > 0, "Buffer data is empty.");
+		if constexpr (LogGLTypeEvents || LogGLBufferEvents) LOG("[OPENGL][BUFFER] Creating buffer {} with capacity {}B and copying {}B of data", m_handle, m_capacity, m_used_capacity);
+
+		named_buffer_storage(m_handle, m_capacity, p_data, m_flags);
+	}
 	Buffer::Buffer(const Buffer& p_other)
 		: m_handle{State::Get().create_buffer()}
 		, m_capacity{p_other.m_capacity}
@@ -212,6 +234,12 @@ namespace OpenGL
 		if (!m_is_indexed)
 			m_draw_count = p_vertex_count;
 	}
+	void VAO::attach_buffer(const RingBuffer::Range& p_range, GLuint p_vertex_buffer_binding_point, GLsizei p_stride, GLsizei p_vertex_count)
+	{
+		vertex_array_vertex_buffer(m_handle, p_vertex_buffer_binding_point, p_range.handle, p_range.offset, p_stride);
+		if (!m_is_indexed)
+			m_draw_count = p_vertex_count;
+	}
 	void VAO::attach_element_buffer(Buffer& p_element_buffer, GLsizei p_element_count)
 	{
 		vertex_array_element_buffer(m_handle, p_element_buffer.m_handle);
@@ -248,6 +276,19 @@ namespace OpenGL
 			default: ASSERT(false, "Unknown InterpolationFilter function"); return 0;
 		}
 	}
+	// Minification filter for p_filter, sampling between mip levels when the texture has them.
+	GLenum convert_min_filter(InterpolationFilter p_filter, bool p_has_mip_maps)
+	{
+		if (!p_has_mip_maps)
+			return convert(p_filter);
+
+		switch (p_filter)
+		{
+			case InterpolationFilter::Nearest: return GL_NEAREST_MIPMAP_NEAREST;
+			case InterpolationFilter::Linear:  return GL_LINEAR_MIPMAP_LINEAR;
+			default: ASSERT(false, "Unknown InterpolationFilter function"); return 0;
+		}
+	}
 	GLenum convert(WrappingMode p_wrapping_mode)
 	{
 		switch (p_wrapping_mode)
@@ -346,6 +387,11 @@ namespace OpenGL
 			case TextureInternalFormat::DEPTH32F_STENCIL8:  return GL_DEPTH32F_STENCIL8;
 			case TextureInternalFormat::DEPTH24_STENCIL8:   return GL_DEPTH24_STENCIL8;
 			case TextureInternalFormat::STENCIL_INDEX8:     return GL_STENCIL_INDEX8;
+			case TextureInternalFormat::BC1_RGB:            return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			case TextureInternalFormat::BC3_RGBA:           return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			case TextureInternalFormat::BC4_R:              return GL_COMPRESSED_RED_RGTC1;
+			case TextureInternalFormat::BC5_RG:             return GL_COMPRESSED_RG_RGTC2;
+			case TextureInternalFormat::BC7_RGBA:           return GL_COMPRESSED_RGBA_BPTC_UNORM;
 			default: ASSERT(false, "Unknown TextureInternalFormat function"); return 0;
 		}
 	};
@@ -379,18 +425,20 @@ namespace OpenGL
 	Texture::Texture(const glm::uvec2& p_resolution,
 	                 InterpolationFilter p_magnification_function,
 	                 WrappingMode p_wrapping_mode,
-	                 TextureInternalFormat p_internal_format)
+	                 TextureInternalFormat p_internal_format,
+	                 GLsizei p_mip_levels)
 	    : m_handle{0}
 	{
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_handle);
 
-		glTextureParameteri(m_handle, GL_TEXTURE_MIN_FILTER, convert(p_magnification_function));
+		glTextureParameteri(m_handle, GL_TEXTURE_MIN_FILTER, convert_min_filter(p_magnification_function, p_mip_levels > 1));
 		glTextureParameteri(m_handle, GL_TEXTURE_MAG_FILTER, convert(p_magnification_function));
 		glTextureParameteri(m_handle, GL_TEXTURE_WRAP_S, convert(p_wrapping_mode));
 		glTextureParameteri(m_handle, GL_TEXTURE_WRAP_T, convert(p_wrapping_mode));
+		if (p_mip_levels > 1)
+			glTextureParameteri(m_handle, GL_TEXTURE_MAX_LEVEL, p_mip_levels - 1);
 
-		constexpr GLint levels = 1;
-		glTextureStorage2D(m_handle, levels, convert(p_internal_format), p_resolution.x, p_resolution.y);
+		glTextureStorage2D(m_handle, p_mip_levels, convert(p_internal_format), p_resolution.x, p_resolution.y);
 
 		if constexpr (LogGLTypeEvents) LOG("Texture constructed with GLHandle {} at address {}", m_handle, (void*)(this));
 	}
@@ -406,13 +454,14 @@ namespace OpenGL
 	{
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_handle);
 
-		glTextureParameteri(m_handle, GL_TEXTURE_MIN_FILTER, convert(p_magnification_function));
+		glTextureParameteri(m_handle, GL_TEXTURE_MIN_FILTER, convert_min_filter(p_magnification_function, generate_mip_map));
 		glTextureParameteri(m_handle, GL_TEXTURE_MAG_FILTER, convert(p_magnification_function));
 		glTextureParameteri(m_handle, GL_TEXTURE_WRAP_S, convert(p_wrapping_mode));
 		glTextureParameteri(m_handle, GL_TEXTURE_WRAP_T, convert(p_wrapping_mode));
 
 		// For valid format combinations see https://www.khronos.org/opengl/wiki/Image_Format#Required_formats
-		constexpr GLint levels = 1;
+		// Immutable storage must be allocated with every mip level up front for glGenerateTextureMipmap to have somewhere to write.
+		const GLint levels = generate_mip_map ? static_cast<GLint>(std::bit_width(std::max(p_resolution.x, p_resolution.y))) : 1;
 		glTextureStorage2D(m_handle, levels, convert(p_internal_format), p_resolution.x, p_resolution.y);
 
 		constexpr GLint level = 0;
@@ -424,6 +473,19 @@ namespace OpenGL
 
 		if constexpr (LogGLTypeEvents) LOG("Texture constructed with GLHandle {} at address {}", m_handle, (void*)(this));
 	}
+	void Texture::upload_level(GLint p_level, const glm::uvec2& p_resolution, TextureFormat p_format, TextureDataType p_data_type, const void* p_pixel_data)
+	{
+		// Mip levels of 1, 2 or 3 byte texels are rarely 4-byte aligned, unpack them tightly.
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		constexpr glm::ivec2 offset = {0, 0};
+		glTextureSubImage2D(m_handle, p_level, offset.x, offset.y, p_resolution.x, p_resolution.y, convert(p_format), convert(p_data_type), p_pixel_data);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+	void Texture::upload_compressed_level(GLint p_level, const glm::uvec2& p_resolution, TextureInternalFormat p_internal_format, GLsizei p_size, const void* p_block_data)
+	{
+		constexpr glm::ivec2 offset = {0, 0};
+		glCompressedTextureSubImage2D(m_handle, p_level, offset.x, offset.y, p_resolution.x, p_resolution.y, convert(p_internal_format), p_size, p_block_data);
+	}
 	Texture::~Texture()
 	{
 		if (m_handle != 0)
@@ -564,6 +626,9 @@ namespace OpenGL
 		// Default to color-only if nothing is requested
 		if (mask == 0) mask = GL_COLOR_BUFFER_BIT;
 
+		if (auto* stream = State::Get().recording())
+			return stream->blit(m_handle, p_destination_fbo.m_handle, p_src_min, p_src_max, p_dst_min, p_dst_max, mask, convert(p_interpolation_filter));
+
 		glBlitNamedFramebuffer(
 			m_handle,
 			p_destination_fbo.m_handle,
@@ -575,11 +640,19 @@ namespace OpenGL
 	}
 	void FBO::clear() const
 	{
+		// While recording the clears are appended to the stream, set_depth_write is recorded by State.
+		auto* stream = State::Get().recording();
 		if (is_default_framebuffer)
 		{
 			constexpr GLint drawbuffer    = 0;
 			constexpr GLfloat clear_depth = 1.0f; // Clear depth to farthest (1.0)
 			constexpr GLint clear_stencil = 0;    // Clear stencil to 0
+			if (stream)
+			{
+				stream->clear_colour(0, m_clear_colour);
+				stream->clear_depth_stencil(0, clear_depth, clear_stencil);
+				return;
+			}
 			glClearNamedFramebufferfv(0, GL_COLOR, drawbuffer, &m_clear_colour[0]);
 			glClearNamedFramebufferfi(0, GL_DEPTH_STENCIL, drawbuffer, clear_depth, clear_stencil);
 			return;
@@ -587,7 +660,10 @@ namespace OpenGL
 
 		if (m_colour_attachment)
 		{
-			glClearNamedFramebufferfv(m_handle, GL_COLOR, 0, &m_clear_colour[0]);
+			if (stream)
+				stream->clear_colour(m_handle, m_clear_colour);
+			else
+				glClearNamedFramebufferfv(m_handle, GL_COLOR, 0, &m_clear_colour[0]);
 		}
 
 		if (m_depth_stencil_attachment)
@@ -595,7 +671,10 @@ namespace OpenGL
 			constexpr GLfloat depth   = 1.0f; // Farthest depth value, range [0, 1]
 			constexpr GLint stencil   = 0;
 			State::Get().set_depth_write(true); // GL requires depth write to be enabled for clearing the depth buffer. oof
-			glClearNamedFramebufferfi(m_handle, GL_DEPTH_STENCIL, 0, depth, stencil);
+			if (stream)
+				stream->clear_depth_stencil(m_handle, depth, stencil);
+			else
+				glClearNamedFramebufferfi(m_handle, GL_DEPTH_STENCIL, 0, depth, stencil);
 		}
 		else
 		{
@@ -603,15 +682,34 @@ namespace OpenGL
 			{
 				constexpr GLfloat depth   = 1.0f; // Farthest depth value, range [0, 1]
 				State::Get().set_depth_write(true); // GL requires depth write to be enabled for clearing the depth buffer. oof
-				glClearNamedFramebufferfv(m_handle, GL_DEPTH, 0, &depth);
+				if (stream)
+					stream->clear_depth(m_handle, depth);
+				else
+					glClearNamedFramebufferfv(m_handle, GL_DEPTH, 0, &depth);
 			}
 			if (m_stencil_attachment)
 			{
 				constexpr GLint stencil   = 0;
-				glClearNamedFramebufferiv(m_handle, GL_STENCIL, 0, &stencil);
+				if (stream)
+					stream->clear_stencil(m_handle, stencil);
+				else
+					glClearNamedFramebufferiv(m_handle, GL_STENCIL, 0, &stencil);
 			}
 		}
 	}
+	void FBO::clear_depth(const glm::uvec2& p_offset, const glm::uvec2& p_size) const
+	{
+		ASSERT(m_depth_attachment, "clear_depth requires a depth attachment without stencil.");
+		ASSERT(p_offset.x + p_size.x <= m_resolution.x && p_offset.y + p_size.y <= m_resolution.y, "Cleared region outside the FBO.");
+
+		// glClearTexSubImage writes the texture directly, unlike glClearNamedFramebuffer it ignores the depth mask and clears a region without a scissor.
+		constexpr GLint level   = 0;
+		constexpr GLfloat depth = 1.0f; // Farthest depth value, range [0, 1]
+		if (auto* stream = State::Get().recording())
+			return stream->clear_depth_region(m_depth_attachment->m_handle, p_offset, p_size, depth);
+
+		glClearTexSubImage(m_depth_attachment->m_handle, level, p_offset.x, p_offset.y, 0, p_size.x, p_size.y, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &depth);
+	}
 	void FBO::resize(const glm::uvec2& p_resolution)
 	{
 		if (p_resolution == m_resolution)
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "GLState.hpp"
+#include "RingBuffer.hpp"
 
 #include "Utility/Logger.hpp"
 
@@ -38,6 +39,12 @@ namespace OpenGL
 		//@param p_capacity The capacity of the buffer in bytes. If 0, the buffer is created with no storage.
 		Buffer(BufferStorageBitfield p_flags, size_t p_capacity = 0);
 
+		// Construct a buffer holding a copy of p_size bytes from p_data.
+		//@param p_flags The flags to use when creating the buffer.
+		//@param p_data The data to copy into the buffer.
+		//@param p_size The number of bytes to copy, the buffer capacity matches it exactly.
+		Buffer(BufferStorageBitfield p_flags, const void* p_data, size_t p_size);
+
 		// Construct a buffer to match the vector p_data exactly.
 		//@param p_flags The flags to use when creating the buffer.
 		//@param p_data The data to copy into the buffer.
@@ -217,6 +224,7 @@ namespace OpenGL
 	class VAO
 	{
 		friend class DrawCall;
+		friend class RenderQueue;
 
 		GLHandle m_handle;
 		GLsizei m_draw_count; // Number of vertices to draw. If an index buffer is attached, this is the number of indices to draw.
@@ -239,6 +247,8 @@ namespace OpenGL
 		//@param p_vertex_buffer_binding_point The vertex buffer binding point of the VAO to bind the buffer to.
 		//@param p_stride The stride in bytes between consecutive vertices in the buffer.
 		void attach_buffer(Buffer& p_vertex_buffer, GLintptr p_vertex_buffer_offset, GLuint p_vertex_buffer_binding_point, GLsizei p_stride, GLsizei p_vertex_count);
+		// Bind the vertices written to p_range of a RingBuffer this frame. The range changes every frame so attach the next frame's before drawing again.
+		void attach_buffer(const RingBuffer::Range& p_range, GLuint p_vertex_buffer_binding_point, GLsizei p_stride, GLsizei p_vertex_count);
 		// Binds p_element_buffer to the VAO. Does not modify the global GL state.
 		//@param p_element_buffer The element buffer object (EBO) to attach to the VAO for reading index data of the attached vertex_buffer.
 		//@param p_element_count The number of indices in p_element_buffer. Used by VAO to determine the number of vertices to draw.
@@ -254,6 +264,7 @@ namespace OpenGL
 	class Texture
 	{
 		friend class DrawCall;
+		friend class RenderQueue;
 		friend class FBO;
 
 		GLHandle m_handle;
@@ -264,10 +275,12 @@ namespace OpenGL
 		//@param p_magnification_function The function to use when magnifying the texture.
 		//@param p_wrapping_mode The wrapping mode to use for the texture.
 		//@param p_internal_format Specifies the sized internal format to be used to store texture image data.
+		//@param p_mip_levels The number of mip levels to allocate storage for. Levels are filled using upload_level.
 		Texture(const glm::uvec2& p_resolution,
 	                 InterpolationFilter p_magnification_function,
 	                 WrappingMode p_wrapping_mode,
-	                 TextureInternalFormat p_internal_format);
+	                 TextureInternalFormat p_internal_format,
+	                 GLsizei p_mip_levels = 1);
 
 		// Create a texture object with the specified resolution. p_pixel_data is copied to the texture.
 		//@param p_resolution The resolution of the texture.
@@ -296,6 +309,21 @@ namespace OpenGL
 		Texture& operator=(Texture&& p_other);
 
 		GLHandle handle() const { return m_handle; }
+
+		// Copy p_pixel_data into mip p_level of the texture. Used to upload mip chains generated on the CPU.
+		//@param p_level The mip level to write. Must be less than the p_mip_levels the texture was constructed with.
+		//@param p_resolution The resolution of p_level.
+		//@param p_format Specifies the format of p_pixel_data.
+		//@param p_data_type Specifies the data type of p_pixel_data.
+		//@param p_pixel_data Tightly packed pixel data (no row alignment padding).
+		void upload_level(GLint p_level, const glm::uvec2& p_resolution, TextureFormat p_format, TextureDataType p_data_type, const void* p_pixel_data);
+		// Copy block compressed p_block_data into mip p_level of the texture. The texture must have been constructed with the same compressed p_internal_format.
+		//@param p_level The mip level to write.
+		//@param p_resolution The resolution of p_level in pixels (not blocks).
+		//@param p_internal_format The compressed format of p_block_data.
+		//@param p_size Size of p_block_data in bytes.
+		//@param p_block_data The compressed blocks of p_level.
+		void upload_compressed_level(GLint p_level, const glm::uvec2& p_resolution, TextureInternalFormat p_internal_format, GLsizei p_size, const void* p_block_data);
 	};
 
 
@@ -357,6 +385,9 @@ namespace OpenGL
 		{ blit_to_fbo(p_destination_fbo, {0, 0}, m_resolution, {0, 0}, p_destination_fbo.m_resolution, p_colour, p_depth, p_stencil, p_interpolation_filter); }
 
 		void clear() const;
+		// Clear the p_size region of the depth attachment starting at p_offset, leaving the rest of the depth untouched.
+		// Requires a depth attachment without stencil.
+		void clear_depth(const glm::uvec2& p_offset, const glm::uvec2& p_size) const;
 		void resize(const glm::uvec2& p_resolution);
 		void set_clear_colour(const glm::vec4& p_clear_colour) { m_clear_colour = p_clear_colour; }
 		bool is_complete() const;
@@ -0,0 +1,55 @@
+#include "UniformID.hpp"
+
+#include "Utility/Logger.hpp"
+
+#include <deque>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+namespace OpenGL
+{
+	namespace
+	{
+		struct IdentifierHash
+		{
+			using is_transparent = void; // Allows finding std::string keys by std::string_view without constructing a string.
+			size_t operator()(std::string_view p_identifier) const { return std::hash<std::string_view>{}(p_identifier); }
+		};
+		struct Registry
+		{
+			std::deque<std::string> identifiers; // Indexed by UniformID, a deque so the references handed out by identifier() stay valid.
+			std::unordered_map<std::string, uint32_t, IdentifierHash, std::equal_to<>> indices;
+		};
+		Registry& registry()
+		{
+			static Registry registry;
+			return registry;
+		}
+	} // namespace
+
+	UniformID::UniformID(std::string_view p_identifier)
+		: m_index{0}
+	{
+		auto& [identifiers, indices] = registry();
+		if (auto it = indices.find(p_identifier); it != indices.end())
+		{
+			m_index = it->second;
+			return;
+		}
+
+		ASSERT_THROW(identifiers.size() < std::numeric_limits<uint32_t>::max(), "[OPENGL][UNIFORM] Too many identifiers interned {}", identifiers.size());
+		m_index = static_cast<uint32_t>(identifiers.size());
+		identifiers.emplace_back(p_identifier);
+		indices.emplace(identifiers.back(), m_index);
+	}
+
+	const std::string& UniformID::identifier() const
+	{
+		return registry().identifiers[m_index];
+	}
+	size_t UniformID::count()
+	{
+		return registry().identifiers.size();
+	}
+} // namespace OpenGL
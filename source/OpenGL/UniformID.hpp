@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace OpenGL
+{
+	// Dense index of a GLSL identifier (loose uniform, sampler or interface block name) shared by every shader.
+	// The identifier is interned the first time it's seen, every UniformID constructed from the same identifier after has the same index.
+	// Shaders resolve an ID to its location once and keep it in a table indexed by the ID, so setting state on a draw is an indexed load.
+	// Constructing an ID costs a hash lookup, draws submitted often should construct theirs once and keep them, see UniformIDs.hpp.
+	class UniformID
+	{
+		uint32_t m_index;
+
+	public:
+		// An ID naming no identifier, only valid to assign over.
+		constexpr UniformID() noexcept : m_index{std::numeric_limits<uint32_t>::max()} {}
+		explicit UniformID(std::string_view p_identifier);
+
+		uint32_t index() const { return m_index; }
+		const std::string& identifier() const;
+		bool operator==(const UniformID& p_other) const = default;
+
+		// Number of identifiers interned so far, one past the largest index.
+		static size_t count();
+	};
+} // namespace OpenGL
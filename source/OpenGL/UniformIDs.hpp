@@ -0,0 +1,69 @@
+#pragma once
+
+#include "UniformID.hpp"
+
+// The identifiers the renderers set on their draws, interned once at startup so a draw never hashes a string.
+// Names match the GLSL identifiers they refer to.
+namespace OpenGL::Uniform
+{
+	// Shared by the mesh shaders.
+	inline const UniformID model{"model"};
+	inline const UniformID dequantise{"dequantise"};
+	inline const UniformID instance_offset{"instance_offset"};
+	inline const UniformID colour{"colour"};
+	inline const UniformID uColour{"uColour"};
+	inline const UniformID shininess{"shininess"};
+	inline const UniformID diffuse{"diffuse"};
+	inline const UniformID specular{"specular"};
+	inline const UniformID scale{"scale"};
+	inline const UniformID ViewProperties{"ViewProperties"};
+	inline const UniformID InstancesBuffer{"InstancesBuffer"};
+
+	// Lighting.
+	inline const UniformID DirectionalLightsBuffer{"DirectionalLightsBuffer"};
+	inline const UniformID PointLightsBuffer{"PointLightsBuffer"};
+	inline const UniformID SpotLightsBuffer{"SpotLightsBuffer"};
+	inline const UniformID LightClustersBuffer{"LightClustersBuffer"};
+	inline const UniformID LightIndicesBuffer{"LightIndicesBuffer"};
+
+	// Shadows.
+	inline const UniformID light_space_mat{"light_space_mat"};
+	inline const UniformID PCF_bias{"PCF_bias"};
+	inline const UniformID ShadowCascadesBuffer{"ShadowCascadesBuffer"};
+	inline const UniformID shadow_map{"shadow_map"};
+
+	// Terrain.
+	inline const UniformID min_height{"min_height"};
+	inline const UniformID max_height{"max_height"};
+	inline const UniformID debug_normals{"debug_normals"};
+	inline const UniformID grass{"grass"};
+	inline const UniformID rock{"rock"};
+	inline const UniformID snow{"snow"};
+
+	// Post processing.
+	inline const UniformID screen_texture{"screen_texture"};
+	inline const UniformID invertColours{"invertColours"};
+	inline const UniformID grayScale{"grayScale"};
+	inline const UniformID sharpen{"sharpen"};
+	inline const UniformID blur{"blur"};
+	inline const UniformID edgeDetection{"edgeDetection"};
+	inline const UniformID offset{"offset"};
+
+	// Selection outline.
+	inline const UniformID mask{"mask"};
+	inline const UniformID mask_depth{"mask_depth"};
+	inline const UniformID scene_depth{"scene_depth"};
+	inline const UniformID texel_size{"texel_size"};
+	inline const UniformID radius{"radius"};
+
+	// Particles.
+	inline const UniformID ParticlesBuffer{"ParticlesBuffer"};
+	inline const UniformID u_acceleration{"u_acceleration"};
+	inline const UniformID start_colour{"start_colour"};
+	inline const UniformID end_colour{"end_colour"};
+	inline const UniformID start_diffuse{"start_diffuse"};
+	inline const UniformID end_diffuse{"end_diffuse"};
+	inline const UniformID size{"size"};
+	inline const UniformID start_size{"start_size"};
+	inline const UniformID end_size{"end_size"};
+} // namespace OpenGL::Uniform
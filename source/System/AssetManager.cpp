@@ -1,5 +1,6 @@
 #include "AssetManager.hpp"
 
+#include "Data/ThumbnailCache.hpp"
 #include "Geometry/Geometry.hpp"
 
 #include "Utility/MeshBuilder.hpp"
@@ -21,37 +22,49 @@ namespace System
 			{
 				auto mb = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles, true>{};
 				mb.add_cone(glm::vec3(0.f, -1.f, 0.f), glm::vec3(0.f, 1.f, 0.f), 1.f, 16);
-				return mb.get_mesh();
+				return mb.get_indexed_mesh();
 			}
 			case ShapeType::Cuboid:
 			{
 				auto mb = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles, true>{};
 				mb.add_cuboid(Geometry::Cuboid(glm::vec3(0.f)));
-				return mb.get_mesh();
+				return mb.get_indexed_mesh();
 			}
 			case ShapeType::Cylinder:
 			{
 				auto mb = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles, true>{};
 				mb.add_cylinder(glm::vec3(0.f, -1.f, 0.f), glm::vec3(0.f, 1.f, 0.f), 1.f, 16);
-				return mb.get_mesh();
+				return mb.get_indexed_mesh();
 			}
 			case ShapeType::Sphere:
 			{
 				auto mb = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles, true>{};
 				mb.add_icosphere(glm::vec3(0.f, 0.f, 0.f), 1.f, 4);
-				return mb.get_mesh();
+				return mb.get_indexed_mesh();
 			}
 			case ShapeType::Quad:
 			{
 				auto mb = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles, true>{};
 				mb.add_quad(glm::vec3(-1.f, 0.f, -1.f), glm::vec3(1.f, 0.f, -1.f), glm::vec3(-1.f, 0.f, 1.f), glm::vec3(1.f, 0.f, 1.f));
-				return mb.get_mesh();
+				return mb.get_indexed_mesh();
 			}
 			default:
 				throw std::runtime_error("Invalid shape type");
 		}
 	}
 
+	static OpenGL::Texture make_thumbnail_texture(const Data::Thumbnail& p_thumbnail)
+	{
+		return OpenGL::Texture{glm::uvec2(p_thumbnail.width, p_thumbnail.height),
+		                       OpenGL::InterpolationFilter::Linear,
+		                       OpenGL::WrappingMode::ClampToEdge,
+		                       OpenGL::TextureInternalFormat::RGBA8,
+		                       OpenGL::TextureFormat::RGBA,
+		                       OpenGL::TextureDataType::UNSIGNED_BYTE,
+		                       false,
+		                       p_thumbnail.pixels.data()};
+	}
+
 	AssetManager::AssetManager()
 		: m_texture_manager{}
 		, m_mesh_manager{}
@@ -64,11 +77,14 @@ namespace System
 		, m_sphere{m_mesh_manager.insert(make_mesh(ShapeType::Sphere))}
 		, m_quad{m_mesh_manager.insert(make_mesh(ShapeType::Quad))}
 	{
+		// Browsing only needs a preview of each texture, these are read from the thumbnail cache and only rebuilt for new or modified files.
+		Data::ThumbnailCache thumbnail_cache{Config::Cache_Directory / "thumbnails.bin"};
+
 		Utility::File::foreach_file(Config::Texture_Directory, [&](auto& entry)
 		{
 			if (entry.is_regular_file())
 			{
-				m_available_textures.emplace_back(AvailableTexture{entry.path().stem().string(), entry.path(), Data::Texture(entry.path())});
+				m_available_textures.emplace_back(AvailableTexture{entry.path().stem().string(), entry.path(), make_thumbnail_texture(thumbnail_cache.get(entry.path()))});
 			}
 		});
 		Utility::File::foreach_file(Config::Texture_PBR_Directory, [&](auto& entry)
@@ -83,7 +99,7 @@ namespace System
 				else if (std::filesystem::exists(entry.path() / "color.png"))  colour_path = entry.path() / "color.png";
 
 				if (colour_path)
-					m_available_PBR_textures.emplace_back(AvailableTexture{entry.path().stem().string(), entry.path(), Data::Texture(*colour_path)});
+					m_available_PBR_textures.emplace_back(AvailableTexture{entry.path().stem().string(), *colour_path, make_thumbnail_texture(thumbnail_cache.get(*colour_path))});
 			}
 		});
 
@@ -92,6 +108,8 @@ namespace System
 			if (entry.is_regular_file() && entry.path().has_extension() && entry.path().extension() == ".obj")
 				m_available_models.push_back(entry.path());
 		});
+
+		thumbnail_cache.save();
 	}
 
 	MeshRef AssetManager::insert(Data::Mesh&& p_mesh_data)
@@ -99,16 +117,24 @@ namespace System
 		return m_mesh_manager.insert(std::move(p_mesh_data));
 	}
 
-	TextureRef AssetManager::get_texture(const std::filesystem::path& p_file_path)
+	MeshRef AssetManager::get_mesh(const std::filesystem::path& p_file_path)
 	{
-		return m_texture_manager.get_or_create([&p_file_path](const Data::Texture& p_texture)
+		return m_mesh_manager.get_or_create([&p_file_path](const Data::Mesh& p_mesh)
 		{
-			return p_texture.filepath() == p_file_path;
+			return p_mesh.filepath == p_file_path;
 		}, p_file_path);
 	}
-	TextureRef AssetManager::get_texture(const std::string_view p_file_name)
+
+	TextureRef AssetManager::get_texture(const std::filesystem::path& p_file_path, Data::TextureUsage p_usage)
+	{
+		return m_texture_manager.get_or_create([&p_file_path, p_usage](const Data::Texture& p_texture)
+		{
+			return p_texture.filepath() == p_file_path && p_texture.usage() == p_usage;
+		}, p_file_path, p_usage);
+	}
+	TextureRef AssetManager::get_texture(const std::string_view p_file_name, Data::TextureUsage p_usage)
 	{
-		return get_texture(Config::Texture_Directory / p_file_name);
+		return get_texture(Config::Texture_Directory / p_file_name, p_usage);
 	}
 
 	void AssetManager::draw_UI(bool* p_open)
@@ -140,7 +166,7 @@ namespace System
 					if (i >= m_available_textures.size())
 						break;
 
-					ImTextureID texture_id = (void*)(intptr_t)m_available_textures[i].thumbnail.m_GL_texture.handle();
+					ImTextureID texture_id = (void*)(intptr_t)m_available_textures[i].thumbnail.handle();
 					if (ImGui::ImageButton(m_available_textures[i].path.filename().stem().string().c_str(),
 										texture_id, button_size))
 					{
@@ -169,8 +195,8 @@ namespace System
 					if (i >= m_available_PBR_textures.size())
 						break;
 
-					ImTextureID texture_id = (void*)(intptr_t)m_available_PBR_textures[i].thumbnail.m_GL_texture.handle();
-					if (ImGui::ImageButton(m_available_PBR_textures[i].path.filename().stem().string().c_str(), texture_id, button_size))
+					ImTextureID texture_id = (void*)(intptr_t)m_available_PBR_textures[i].thumbnail.handle();
+					if (ImGui::ImageButton(m_available_PBR_textures[i].name.c_str(), texture_id, button_size))
 					{
 						LOG("Selected PBR texture: {}", m_available_PBR_textures[i].path.string());
 					}
@@ -180,10 +206,22 @@ namespace System
 				ImGui::EndGroup();
 			}
 		}
+		ImGui::SetNextItemOpen(true, ImGuiCond_Once);
+		if (ImGui::CollapsingHeader("Models"))
+		{
+			for (const auto& model_path : m_available_models)
+			{
+				if (ImGui::Selectable(model_path.stem().string().c_str()))
+				{
+					auto mesh = get_mesh(model_path);
+					LOG("Imported model: {} ({} vertices)", model_path.string(), mesh->get_VAO().draw_count());
+				}
+			}
+		}
 		ImGui::End();
 	}
 
-	bool AssetManager::draw_texture_selector(const char* p_label, TextureRef& p_current_texture, bool p_show_none, bool p_show_PBR)
+	bool AssetManager::draw_texture_selector(const char* p_label, TextureRef& p_current_texture, Data::TextureUsage p_usage, bool p_show_none, bool p_show_PBR)
 	{
 		auto current_tex_name = p_current_texture ? p_current_texture->name() : "None";
 		bool changed          = false;
@@ -192,10 +230,10 @@ namespace System
 		{
 			for (size_t i = 0; i < m_available_textures.size(); ++i)
 			{
-				bool is_selected = p_current_texture ? m_available_textures[i].thumbnail.filepath() == p_current_texture->filepath() : false;
+				bool is_selected = p_current_texture ? m_available_textures[i].path == p_current_texture->filepath() : false;
 				if (ImGui::Selectable(m_available_textures[i].name.c_str(), is_selected))
 				{
-					p_current_texture = get_texture(m_available_textures[i].path);
+					p_current_texture = get_texture(m_available_textures[i].path, p_usage);
 					changed           = true;
 				}
 
@@ -207,10 +245,10 @@ namespace System
 			{
 				for (size_t i = 0; i < m_available_PBR_textures.size(); ++i)
 				{
-					bool is_selected = p_current_texture ? m_available_PBR_textures[i].thumbnail.filepath() == p_current_texture->filepath() : false;
+					bool is_selected = p_current_texture ? m_available_PBR_textures[i].path == p_current_texture->filepath() : false;
 					if (ImGui::Selectable(m_available_PBR_textures[i].name.c_str(), is_selected))
 					{
-						p_current_texture = get_texture(m_available_PBR_textures[i].path);
+						p_current_texture = get_texture(m_available_PBR_textures[i].path, p_usage);
 						changed           = true;
 					}
 
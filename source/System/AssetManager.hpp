@@ -2,6 +2,7 @@
 
 #include "Component/Texture.hpp"
 #include "Component/Mesh.hpp"
+#include "OpenGL/Types.hpp"
 #include "Utility/ResourceManager.hpp"
 
 #include <filesystem>
@@ -9,11 +10,12 @@
 
 namespace System
 {
+	// A texture file available on disk. Only a small preview is uploaded, the full texture is loaded on first use via get_texture.
 	struct AvailableTexture
 	{
 		std::string name;
 		std::filesystem::path path;
-		Data::Texture thumbnail;
+		OpenGL::Texture thumbnail;
 	};
 
 	class AssetManager
@@ -32,24 +34,31 @@ namespace System
 		//@param p_mesh_data The mesh data to insert by move.
 		//@returns A reference to the inserted mesh.
 		[[nodiscard]] MeshRef insert(Data::Mesh&& p_mesh_data);
+		// Get a mesh by model file path. The model is imported on first use, from the processed model cache if it is up to date.
+		//@param p_file_path The path to the model file to load.
+		//@returns A reference to the mesh.
+		[[nodiscard]] MeshRef get_mesh(const std::filesystem::path& p_file_path);
 
-		// Get a texture by file path. The texture is loaded if it has not been loaded before.
+		// Get a texture by file path. The texture is loaded if it has not been loaded for p_usage before.
 		// @param p_file_path The path to the file to load.
+		// @param p_usage What the texels represent in the slot the texture is used in, decides its compression and mip filtering.
 		// @returns A reference to the texture.
-		[[nodiscard]] TextureRef get_texture(const std::filesystem::path& p_file_path);
-		// Get a texture by file name. The texture is loaded if it has not been loaded before.
+		[[nodiscard]] TextureRef get_texture(const std::filesystem::path& p_file_path, Data::TextureUsage p_usage = Data::TextureUsage::Colour);
+		// Get a texture by file name. The texture is loaded if it has not been loaded for p_usage before.
 		// @param p_file_name The name of the file to load.
+		// @param p_usage What the texels represent in the slot the texture is used in, decides its compression and mip filtering.
 		// @returns A reference to the texture.
-		[[nodiscard]] TextureRef get_texture(const std::string_view p_file_name);
-		[[nodiscard]] TextureRef get_texture(const char* p_file_name) { return get_texture(std::string_view(p_file_name)); }
+		[[nodiscard]] TextureRef get_texture(const std::string_view p_file_name, Data::TextureUsage p_usage = Data::TextureUsage::Colour);
+		[[nodiscard]] TextureRef get_texture(const char* p_file_name, Data::TextureUsage p_usage = Data::TextureUsage::Colour) { return get_texture(std::string_view(p_file_name), p_usage); }
 
 		void draw_UI(bool* p_open = nullptr);
 		//@param p_label The label to display for the selector.
 		//@param p_current_texture The current texture to display and select.
+		//@param p_usage The usage of the slot p_current_texture is in, selected textures are loaded for it.
 		//@param p_show_none If true, show "None" as an option.
 		//@param p_show_PBR If true, show PBR textures.
 		//@returns True if the texture was changed.
-		bool draw_texture_selector(const char* p_label, TextureRef& p_current_texture, bool p_show_none = true, bool p_show_PBR = true);
+		bool draw_texture_selector(const char* p_label, TextureRef& p_current_texture, Data::TextureUsage p_usage = Data::TextureUsage::Colour, bool p_show_none = true, bool p_show_PBR = true);
 
 		MeshRef m_cone;
 		MeshRef m_cube;
@@ -54,19 +54,54 @@ namespace System
 	{
 		PERF(SceneUpdate);
 
-		{// Compute rendered bounds from Mesh+Transform entities (excludes physics-only colliders like infinite planes).
-			bool has_bounds = false;
-			m_entities.foreach([&](const Component::Mesh& mesh, const Component::Transform& transform)
+		{// Keep the tree of Mesh+Transform entities up to date (excludes physics-only colliders like infinite planes).
+			m_update_count++;
+			m_entities.foreach([&](ECS::Entity& p_entity, const Component::Mesh& mesh, const Component::Transform& transform)
 			{
-				auto world_AABB = Geometry::AABB::transform(mesh.m_mesh->AABB, transform.m_position, glm::mat4_cast(transform.m_orientation), transform.m_scale);
-				if (!has_bounds)
+				auto [it, inserted] = m_tree_entries.try_emplace(p_entity.ID);
+				TreeEntry& entry    = it->second;
+				entry.last_update   = m_update_count;
+				if (!inserted && entry.transform == transform && entry.mesh_AABB == mesh.m_mesh->AABB)
+					return; // Unchanged, skip transforming the AABB.
+
+				m_revision++;
+				entry.transform = transform;
+				entry.mesh_AABB = mesh.m_mesh->AABB;
+				const auto world_AABB = Geometry::AABB::transform(mesh.m_mesh->AABB, transform.m_position, glm::mat4_cast(transform.m_orientation), transform.m_scale);
+				if (inserted)
 				{
-					m_rendered_bounds = world_AABB;
-					has_bounds        = true;
+					entry.proxy      = m_entity_tree.insert(world_AABB, p_entity.ID);
+					entry.AABB_index = m_entity_AABBs.count;
+					m_entity_AABBs.push_back(world_AABB);
+					m_entity_AABB_owners.push_back(p_entity);
 				}
 				else
-					m_rendered_bounds.unite(world_AABB);
+				{
+					m_entity_tree.move(entry.proxy, world_AABB);
+					m_entity_AABBs.set(entry.AABB_index, world_AABB);
+				}
+			});
+			std::erase_if(m_tree_entries, [&](const auto& p_entry)
+			{
+				if (p_entry.second.last_update == m_update_count)
+					return false;
+
+				// The entity was deleted or lost its Mesh or Transform.
+				m_revision++;
+				m_entity_tree.remove(p_entry.second.proxy);
+				// The last AABB moves into the gap, point its entry at the new index.
+				const size_t index = p_entry.second.AABB_index;
+				m_entity_AABBs.erase(index);
+				m_entity_AABB_owners[index] = m_entity_AABB_owners.back();
+				m_entity_AABB_owners.pop_back();
+				if (index < m_entity_AABB_owners.size())
+					m_tree_entries.at(m_entity_AABB_owners[index].ID).AABB_index = index;
+				return true;
 			});
+
+			// The fat AABBs of the proxies overestimate the bounds by up to the margin of the tree.
+			if (!m_entity_tree.empty())
+				m_rendered_bounds = m_entity_tree.bounds();
 		}
 
 		{// Update the view information
@@ -88,6 +123,36 @@ namespace System
 		}
 	}
 
+	std::optional<ECS::Entity> Scene::cast_ray(const Geometry::Ray& p_ray) const
+	{
+		const auto hit = m_entity_tree.cast_ray(p_ray, [&](EntityID p_entity_ID, float p_closest) -> std::optional<float>
+		{
+			const auto entity = ECS::Entity(p_entity_ID);
+			if (!m_entities.has_components<Component::Mesh, Component::Transform>(entity))
+				return std::nullopt; // Removed since the last update.
+
+			// The distance along a ray is unchanged by an affine transform, so hits in the object space of each mesh compare directly.
+			const glm::mat4 world_to_object = glm::inverse(m_entities.get_component<Component::Transform>(entity).get_model());
+			const auto object_ray = Geometry::Ray(glm::vec3(world_to_object * glm::vec4(p_ray.m_start, 1.f)), glm::vec3(world_to_object * glm::vec4(p_ray.m_direction, 0.f)));
+			return m_entities.get_component<Component::Mesh>(entity).m_mesh->cast_ray(object_ray, p_closest);
+		});
+
+		return hit ? std::optional<ECS::Entity>(ECS::Entity(hit->user_data)) : std::nullopt;
+	}
+
+	size_t Scene::cull(const Geometry::Frustrum& p_frustrum, std::vector<ECS::Entity>& p_visible) const
+	{
+		PERF(SceneCull);
+
+		m_visible_indices.resize(m_entity_AABBs.count);
+		const size_t visible_count = Geometry::Batch::intersecting(p_frustrum, m_entity_AABBs, m_visible_indices.data());
+		p_visible.reserve(p_visible.size() + visible_count);
+		for (size_t i = 0; i < visible_count; i++)
+			p_visible.push_back(m_entity_AABB_owners[m_visible_indices[i]]);
+
+		return m_entity_AABBs.count - visible_count;
+	}
+
 	void Scene::serialise(std::ostream& p_out, uint16_t p_version, const Scene& p_Scene)
 	{
 		ECS::Storage::serialise(p_out, p_version, p_Scene.m_entities);
@@ -142,7 +207,7 @@ namespace System
 		{ // Textured cube
 			Component::Texture texture;
 			texture.m_diffuse  = m_asset_manager.get_texture(Config::Texture_Directory / "metalContainerDiffuse.png");
-			texture.m_specular = m_asset_manager.get_texture(Config::Texture_Directory / "metalContainerSpecular.png");
+			texture.m_specular = m_asset_manager.get_texture(Config::Texture_Directory / "metalContainerSpecular.png", Data::TextureUsage::Data);
 
 			auto pos = glm::vec3(running_x, start_y, -mesh_width);
 			p_scene.m_entities.add_entity(
@@ -225,7 +290,7 @@ namespace System
 			{
 				Component::Texture texture;
 				texture.m_diffuse = m_asset_manager.get_texture(containerDiffuse);
-				texture.m_specular = m_asset_manager.get_texture(containerSpecular);
+				texture.m_specular = m_asset_manager.get_texture(containerSpecular, Data::TextureUsage::Data);
 
 				p_scene.m_entities.add_entity(
 					Component::Label("Cube " + std::to_string((i / 2) + 1)),
@@ -273,7 +338,7 @@ namespace System
 	{
 		auto mb = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles, true>{};
 		mb.add_icosphere(glm::vec3(0.f), 1.f, 1);
-		auto icosphere_mesh = mb.get_mesh();
+		auto icosphere_mesh = mb.get_indexed_mesh();
 		auto icosphere_meshref = m_asset_manager.insert(std::move(icosphere_mesh));
 
 		p_scene.m_entities.add_entity(
@@ -313,7 +378,7 @@ namespace System
 			Component::Mesh mesh = Component::Mesh(m_asset_manager.m_sphere);
 			Component::Texture texture;
 			texture.m_diffuse = m_asset_manager.get_texture(containerDiffuse);
-			texture.m_specular = m_asset_manager.get_texture(containerSpecular);
+			texture.m_specular = m_asset_manager.get_texture(containerSpecular, Data::TextureUsage::Data);
 
 			Component::Collider collider = Component::Collider(Geometry::Sphere{transform.m_position, 0.5f});
 			p_scene.m_entities.add_entity(mesh, transform, collider, name);
@@ -2,10 +2,16 @@
 
 #include "ECS/Storage.hpp"
 #include "Geometry/AABB.hpp"
+#include "Geometry/BatchIntersect.hpp"
+#include "Geometry/DynamicTree.hpp"
+#include "Geometry/Ray.hpp"
+#include "Component/Transform.hpp"
 #include "Component/ViewInformation.hpp"
 
 #include <memory>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace System
 {
@@ -17,13 +23,43 @@ namespace System
 		ECS::Storage m_entities;
 		Geometry::AABB m_rendered_bounds; // The bounding box of Mesh+Transform entities in the scene. Used by rendering (shadow maps, camera refit). This is NOT the physics world bounds — use IPhysicsSystem::get_bounding_box() for that.
 		Component::ViewInformation m_view_information; // Rendering depends on the ViewInformation of the active camera.
+		// World-space AABBs of the Mesh+Transform entities for spatial queries (culling, selection, picking). The user data of each proxy is the EntityID.
+		// update only moves the proxies of entities whose Transform or mesh changed since the last update.
+		Geometry::DynamicTree m_entity_tree;
+		// Exact world-space AABBs of the same entities laid out for the SIMD kernels, m_entity_AABBs[i] bounds m_entity_AABB_owners[i].
+		Geometry::Batch::AABBs m_entity_AABBs;
+		std::vector<ECS::Entity> m_entity_AABB_owners;
 
 		// When the state of the scene changes update the m_rendered_bounds and m_view_information.
 		// Should be called when the scene is first created, when entities are added/removed/changed, when the aspect ratio changes or when the editor changes the scene.
 		void update(float aspect_ratio, std::optional<Component::ViewInformation> view_info_override = std::nullopt);
+		// The closest Mesh+Transform entity whose triangles p_ray hits, as of the last update.
+		std::optional<ECS::Entity> cast_ray(const Geometry::Ray& p_ray) const;
+		// Append the Mesh+Transform entities whose world AABB is inside or intersecting p_frustrum to p_visible, as of the last update.
+		// Not safe to call from multiple threads at once, the visible indices are gathered in a scratch buffer owned by the scene.
+		//@return The number of entities culled.
+		size_t cull(const Geometry::Frustrum& p_frustrum, std::vector<ECS::Entity>& p_visible) const;
+
+		// Incremented by update whenever a Mesh+Transform entity is added, moved or removed. Lets rendering reuse work while the scene is unchanged.
+		size_t revision() const { return m_revision; }
 
 		static void serialise(std::ostream& p_out, uint16_t p_version, const Scene& p_Scene);
 		static Scene deserialise(std::istream& p_in, uint16_t p_version);
+
+	private:
+		// The state of an entity when its proxy in m_entity_tree was last updated.
+		struct TreeEntry
+		{
+			uint32_t proxy;
+			size_t AABB_index; // Index into m_entity_AABBs.
+			Component::Transform transform;
+			Geometry::AABB mesh_AABB; // Object space.
+			size_t last_update;       // The m_update_count the entity was last seen by update, used to remove deleted entities.
+		};
+		std::unordered_map<EntityID, TreeEntry> m_tree_entries;
+		size_t m_update_count = 0;
+		size_t m_revision     = 0;
+		mutable std::vector<uint32_t> m_visible_indices; // Scratch for cull, reused across the frame and shadow cascade culls.
 	};
 
 	class SceneSystem
@@ -6,6 +6,7 @@
 #include "Test/Tests/ResourceManagerTester.hpp"
 #include "Test/Tests/GraphicsTester.hpp"
 #include "Test/Tests/QuadTreeTester.hpp"
+#include "Test/Tests/RendererTester.hpp"
 
 #include <cstring>
 #include "Utility/Stopwatch.hpp"
@@ -44,6 +45,8 @@ int main(int argc, char* argv[])
 	test_managers.emplace_back(std::make_unique<Test::QuadTreeTester>());
 	if (!skip_graphics_test)
 		test_managers.emplace_back(std::make_unique<Test::GraphicsTester>());
+	// Replaces the GL functions of the graphics tests with the null backend, runs last.
+	test_managers.emplace_back(std::make_unique<Test::RendererTester>());
 
 	size_t unit_test_overall_pass_count    = 0;
 	size_t unit_test_overall_fail_count    = 0;
@@ -77,5 +80,14 @@ int main(int argc, char* argv[])
 	if (unit_test_overall_fail_count > 0)
 		printf("***************** FAILED TESTS *****************\n%s", unit_tests_failed_messages.c_str());
 
+	if (should_run_perf_tests)
+	{
+		for (auto& tester : test_managers)
+		{
+			printf("\n***************** STARTING %s PERFORMANCE TESTS *****************\n", tester->m_name.c_str());
+			tester->run_performance_tests();
+		}
+	}
+
 	return unit_test_overall_fail_count;
 }
\ No newline at end of file
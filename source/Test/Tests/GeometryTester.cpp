@@ -1,10 +1,15 @@
 #include "GeometryTester.hpp"
 
 #include "Geometry/AABB.hpp"
+#include "Geometry/BatchIntersect.hpp"
+#include "Geometry/BVH.hpp"
+#include "Geometry/ConvexHull.hpp"
 #include "Geometry/Cone.hpp"
 #include "Geometry/Cylinder.hpp"
+#include "Geometry/DynamicTree.hpp"
 #include "Geometry/Sphere.hpp"
 #include "Geometry/Frustrum.hpp"
+#include "Geometry/GJK.hpp"
 #include "Geometry/Intersect.hpp"
 #include "Geometry/Line.hpp"
 #include "Geometry/LineSegment.hpp"
@@ -12,19 +17,67 @@
 #include "Geometry/Triangle.hpp"
 #include "Geometry/QuadKey.hpp"
 
+#include "Utility/Stopwatch.hpp"
 #include "Utility/Utility.hpp"
 
 #include "glm/glm.hpp"
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <vector>
 
 DISABLE_WARNING_PUSH
 DISABLE_WARNING_HIDES_PREVIOUS_DECLERATION // Required to allow shadowing for the SCOPE_SECTION macro
 
 namespace Test
 {
+	// p_count points spread evenly over the unit sphere along a Fibonacci spiral.
+	static std::vector<glm::vec3> sphere_points(size_t p_count)
+	{
+		const float golden_angle = glm::pi<float>() * (3.f - std::sqrt(5.f));
+		std::vector<glm::vec3> points;
+		points.reserve(p_count);
+		for (size_t i = 0; i < p_count; i++)
+		{
+			const float y      = 1.f - 2.f * (static_cast<float>(i) + 0.5f) / static_cast<float>(p_count);
+			const float radius = std::sqrt(1.f - y * y);
+			const float angle  = golden_angle * static_cast<float>(i);
+			points.push_back(glm::vec3(std::cos(angle) * radius, y, std::sin(angle) * radius));
+		}
+		return points;
+	}
+	// p_count AABBs of varying size scattered around the origin, all within 12 units of it.
+	static std::vector<Geometry::AABB> scattered_AABBs(size_t p_count)
+	{
+		std::vector<Geometry::AABB> AABBs;
+		AABBs.reserve(p_count);
+		for (size_t i = 0; i < p_count; i++)
+		{
+			const float t           = static_cast<float>(i);
+			const glm::vec3 center    = glm::vec3(std::sin(t * 1.7f), std::cos(t * 2.3f), std::sin(t * 0.9f)) * 5.f;
+			const glm::vec3 half_size = glm::vec3(0.5f + static_cast<float>(i % 3) * 0.5f, 0.5f + static_cast<float>(i % 2), 1.f);
+			AABBs.push_back(Geometry::AABB(center - half_size, center + half_size));
+		}
+		return AABBs;
+	}
+	// p_count triangles of varying size and orientation scattered around the origin, all within 12 units of it.
+	static std::vector<Geometry::Triangle> scattered_triangles(size_t p_count)
+	{
+		std::vector<Geometry::Triangle> triangles;
+		triangles.reserve(p_count);
+		for (size_t i = 0; i < p_count; i++)
+		{
+			const float t          = static_cast<float>(i);
+			const glm::vec3 center = glm::vec3(std::sin(t * 1.3f), std::cos(t * 0.7f), std::sin(t * 2.9f)) * 5.f;
+			triangles.push_back(Geometry::Triangle(center + glm::vec3(std::sin(t), 2.f, 0.f), center + glm::vec3(-2.f, std::cos(t), 1.f), center + glm::vec3(1.f, -1.f, std::sin(t * 3.f) * 2.f)));
+		}
+		return triangles;
+	}
+
 	void GeometryTester::run_unit_tests()
 	{
 		run_AABB_tests();
@@ -33,9 +86,318 @@ namespace Test
 		run_sphere_tests();
 		run_point_tests();
 		run_quad_key_tests();
+		run_convex_hull_tests();
+		run_GJK_tests();
+		run_batch_intersect_tests();
+		run_BVH_tests();
+		run_dynamic_tree_tests();
 	}
 	void GeometryTester::run_performance_tests()
 	{
+		// Rays cast from outside a field of primitives, one at a time through the scalar tests and a register at a time through the batch kernels.
+		{
+			constexpr size_t primitive_count = 100000;
+			const auto rays = sphere_points(100);
+
+			const auto AABBs = scattered_AABBs(primitive_count);
+			Geometry::Batch::AABBs AABB_batch;
+			for (const auto& AABB : AABBs)
+				AABB_batch.push_back(AABB);
+
+			size_t scalar_hits = 0;
+			Utility::Stopwatch scalar_AABB_stopwatch;
+			for (const auto& direction : rays)
+			{
+				const auto ray = Geometry::Ray(direction * -20.f, direction);
+				for (const auto& AABB : AABBs)
+					scalar_hits += Geometry::get_intersection(AABB, ray).has_value();
+			}
+			const float scalar_AABB_ms = scalar_AABB_stopwatch.duration_since_start<float, std::milli>().count();
+
+			size_t batch_hits = 0;
+			std::vector<float> distances(primitive_count);
+			Utility::Stopwatch batch_AABB_stopwatch;
+			for (const auto& direction : rays)
+			{
+				Geometry::Batch::intersect(Geometry::Ray(direction * -20.f, direction), AABB_batch, distances.data());
+				batch_hits += std::count_if(distances.begin(), distances.end(), [](float p_distance) { return p_distance != Geometry::Batch::Miss; });
+			}
+			const float batch_AABB_ms = batch_AABB_stopwatch.duration_since_start<float, std::milli>().count();
+
+			printf("Ray v AABB      %zu rays x %zu AABBs     | scalar %8.3fms | batch %8.3fms | %.1fx | hits %zu / %zu\n",
+				rays.size(), primitive_count, scalar_AABB_ms, batch_AABB_ms, scalar_AABB_ms / batch_AABB_ms, batch_hits, scalar_hits);
+
+			const auto triangles = scattered_triangles(primitive_count);
+			Geometry::Batch::Triangles triangle_batch;
+			for (const auto& triangle : triangles)
+				triangle_batch.push_back(triangle);
+
+			scalar_hits = 0;
+			Utility::Stopwatch scalar_triangle_stopwatch;
+			for (const auto& direction : rays)
+			{
+				const auto line = Geometry::Line(direction * -20.f, direction * 20.f);
+				for (const auto& triangle : triangles)
+					scalar_hits += Geometry::get_intersection(line, triangle).has_value();
+			}
+			const float scalar_triangle_ms = scalar_triangle_stopwatch.duration_since_start<float, std::milli>().count();
+
+			batch_hits = 0;
+			Utility::Stopwatch batch_triangle_stopwatch;
+			for (const auto& direction : rays)
+			{
+				Geometry::Batch::intersect(Geometry::Ray(direction * -20.f, direction), triangle_batch, distances.data());
+				batch_hits += std::count_if(distances.begin(), distances.end(), [](float p_distance) { return p_distance != Geometry::Batch::Miss; });
+			}
+			const float batch_triangle_ms = batch_triangle_stopwatch.duration_since_start<float, std::milli>().count();
+
+			printf("Ray v Triangle  %zu rays x %zu triangles | scalar %8.3fms | batch %8.3fms | %.1fx | hits %zu / %zu\n",
+				rays.size(), primitive_count, scalar_triangle_ms, batch_triangle_ms, scalar_triangle_ms / batch_triangle_ms, batch_hits, scalar_hits);
+		}
+		// Closest hit ray casts against a field of AABBs, testing every AABB with the batch kernel or traversing a BVH.
+		{
+			const auto rays = sphere_points(10000);
+			for (const size_t primitive_count : {1000, 10000, 100000})
+			{
+				const auto AABBs = scattered_AABBs(primitive_count);
+				Geometry::Batch::AABBs AABB_batch;
+				for (const auto& AABB : AABBs)
+					AABB_batch.push_back(AABB);
+
+				Utility::Stopwatch build_stopwatch;
+				const auto BVH = Geometry::BVH(AABBs);
+				const float build_ms = build_stopwatch.duration_since_start<float, std::milli>().count();
+
+				float batch_total = 0.f; // Accumulated so the casts can't be optimised away.
+				Utility::Stopwatch batch_stopwatch;
+				for (const auto& direction : rays)
+				{
+					if (auto hit = Geometry::Batch::closest_hit(Geometry::Ray(direction * -20.f, direction), AABB_batch))
+						batch_total += hit->distance;
+				}
+				const float batch_ms = batch_stopwatch.duration_since_start<float, std::milli>().count();
+
+				float BVH_total = 0.f;
+				Utility::Stopwatch BVH_stopwatch;
+				for (const auto& direction : rays)
+				{
+					const auto ray = Geometry::Ray(direction * -20.f, direction);
+					if (auto hit = BVH.cast_ray(ray, [&](uint32_t p_index, float) -> std::optional<float>
+						{
+							float distance = 0.f;
+							return Geometry::get_intersection(AABBs[p_index], ray, &distance) ? std::optional<float>(std::max(distance, 0.f)) : std::nullopt;
+						}))
+						BVH_total += hit->distance;
+				}
+				const float BVH_ms = BVH_stopwatch.duration_since_start<float, std::milli>().count();
+
+				printf("BVH %6zu AABBs x %zu rays | build %8.3fms | batch brute force %9.3fms | BVH %8.3fms | %.1fx | total distance %.1f / %.1f\n",
+					primitive_count, rays.size(), build_ms, batch_ms, BVH_ms, batch_ms / BVH_ms, BVH_total, batch_total);
+			}
+		}
+		// A field of AABBs where a tenth move each frame, kept up to date by moving proxies in a DynamicTree or rebuilding a BVH, then frustum culled.
+		{
+			constexpr size_t primitive_count = 10000;
+			constexpr int frame_count        = 100;
+			auto AABBs = scattered_AABBs(primitive_count);
+			const auto frustrum = Geometry::Frustrum(glm::perspective(glm::radians(30.f), 1.f, 0.1f, 30.f) * glm::lookAt(glm::vec3(6.f, 0.f, 15.f), glm::vec3(6.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f)));
+			const auto frame_offset = [](int p_frame, size_t p_index)
+			{
+				const float t = static_cast<float>(p_frame) * 0.05f + static_cast<float>(p_index);
+				return glm::vec3(std::sin(t), std::cos(t * 1.3f), std::sin(t * 0.7f)) * 0.02f;
+			};
+
+			auto tree = Geometry::DynamicTree();
+			std::vector<uint32_t> proxies;
+			for (size_t i = 0; i < AABBs.size(); i++)
+				proxies.push_back(tree.insert(AABBs[i], i));
+
+			size_t tree_visible = 0;
+			size_t reinserted   = 0;
+			float tree_update_ms = 0.f;
+			float tree_query_ms  = 0.f;
+			auto tree_AABBs = AABBs;
+			for (int frame = 0; frame < frame_count; frame++)
+			{
+				Utility::Stopwatch update_stopwatch;
+				for (size_t i = frame % 10; i < tree_AABBs.size(); i += 10)
+				{
+					const glm::vec3 offset = frame_offset(frame, i);
+					tree_AABBs[i] = Geometry::AABB(tree_AABBs[i].m_min + offset, tree_AABBs[i].m_max + offset);
+					reinserted   += tree.move(proxies[i], tree_AABBs[i]);
+				}
+				tree_update_ms += update_stopwatch.duration_since_start<float, std::milli>().count();
+
+				Utility::Stopwatch query_stopwatch;
+				tree.query(frustrum, [&](size_t p_index) { tree_visible += Geometry::intersecting(frustrum, tree_AABBs[p_index]); });
+				tree_query_ms += query_stopwatch.duration_since_start<float, std::milli>().count();
+			}
+
+			size_t BVH_visible         = 0;
+			size_t brute_force_visible = 0;
+			float BVH_update_ms  = 0.f;
+			float BVH_query_ms   = 0.f;
+			float brute_force_ms = 0.f;
+			auto BVH_AABBs = AABBs;
+			for (int frame = 0; frame < frame_count; frame++)
+			{
+				Utility::Stopwatch update_stopwatch;
+				for (size_t i = frame % 10; i < BVH_AABBs.size(); i += 10)
+				{
+					const glm::vec3 offset = frame_offset(frame, i);
+					BVH_AABBs[i] = Geometry::AABB(BVH_AABBs[i].m_min + offset, BVH_AABBs[i].m_max + offset);
+				}
+				const auto BVH = Geometry::BVH(BVH_AABBs);
+				BVH_update_ms += update_stopwatch.duration_since_start<float, std::milli>().count();
+
+				Utility::Stopwatch query_stopwatch;
+				BVH.query(frustrum, [&](uint32_t p_index) { BVH_visible += Geometry::intersecting(frustrum, BVH_AABBs[p_index]); });
+				BVH_query_ms += query_stopwatch.duration_since_start<float, std::milli>().count();
+
+				Utility::Stopwatch brute_force_stopwatch;
+				for (const auto& AABB : BVH_AABBs)
+					brute_force_visible += Geometry::intersecting(frustrum, AABB);
+				brute_force_ms += brute_force_stopwatch.duration_since_start<float, std::milli>().count();
+			}
+
+			printf("Dynamic tree %zu AABBs x %d frames | update: BVH rebuild %8.3fms, tree move %7.3fms (%zu reinserted) %.1fx | frustum: brute force %8.3fms, BVH %7.3fms, tree %7.3fms | visible %zu / %zu / %zu\n",
+				primitive_count, frame_count, BVH_update_ms, tree_update_ms, reinserted, BVH_update_ms / tree_update_ms, brute_force_ms, BVH_query_ms, tree_query_ms, tree_visible, BVH_visible, brute_force_visible);
+		}
+		// Frustum culling a field of AABBs, one at a time through the scalar test and a register at a time through the batch kernel.
+		{
+			constexpr size_t primitive_count = 100000;
+			const auto AABBs = scattered_AABBs(primitive_count);
+			Geometry::Batch::AABBs AABB_batch;
+			for (const auto& AABB : AABBs)
+				AABB_batch.push_back(AABB);
+
+			std::vector<Geometry::Frustrum> frustrums;
+			for (const auto& direction : sphere_points(100))
+				frustrums.push_back(Geometry::Frustrum(glm::perspective(glm::radians(20.f), 1.5f, 0.1f, 30.f) * glm::lookAt(direction * 12.f, glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f))));
+
+			size_t scalar_visible = 0;
+			Utility::Stopwatch scalar_stopwatch;
+			for (const auto& frustrum : frustrums)
+				for (const auto& AABB : AABBs)
+					scalar_visible += Geometry::intersecting(frustrum, AABB);
+			const float scalar_ms = scalar_stopwatch.duration_since_start<float, std::milli>().count();
+
+			size_t batch_visible = 0;
+			std::vector<uint32_t> indices(primitive_count);
+			Utility::Stopwatch batch_stopwatch;
+			for (const auto& frustrum : frustrums)
+				batch_visible += Geometry::Batch::intersecting(frustrum, AABB_batch, indices.data());
+			const float batch_ms = batch_stopwatch.duration_since_start<float, std::milli>().count();
+
+			printf("Frustum v AABB  %zu frustums x %zu AABBs | scalar %8.3fms | batch %8.3fms | %.1fx | visible %zu / %zu\n",
+				frustrums.size(), primitive_count, scalar_ms, batch_ms, scalar_ms / batch_ms, batch_visible, scalar_visible);
+		}
+		// GJK between two spinning spheres moving in and out of contact.
+		// Brute force rotates the direction into object space and tests every vertex (the support function before hill climbing),
+		// hill climbing walks the hull from the support vertices of the previous frame.
+		{
+			constexpr int frame_count = 10000;
+			const auto frame_transform = [](int p_frame, float p_offset)
+			{
+				const float time  = static_cast<float>(p_frame) * 0.01f;
+				const auto orient = glm::angleAxis(time * (1.f + p_offset), glm::normalize(glm::vec3(1.f, 2.f + p_offset, 3.f)));
+				const auto model  = glm::translate(glm::identity<glm::mat4>(), glm::vec3(std::sin(time) * 3.f * p_offset, 0.f, 0.f)) * glm::mat4_cast(orient);
+				return std::make_pair(model, orient);
+			};
+
+			for (const size_t vertex_count : {32, 256, 2048, 16384})
+			{
+				const auto hull = Geometry::ConvexHull(sphere_points(vertex_count));
+
+				const auto brute_force_support = [&hull](const glm::vec3& p_direction, const glm::mat4& p_transform_1, const glm::quat& p_orientation_1, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2)
+				{
+					const auto support_1 = GJK::support_point(glm::conjugate(p_orientation_1) * p_direction, hull.m_vertices);
+					const auto support_2 = GJK::support_point(-(glm::conjugate(p_orientation_2) * p_direction), hull.m_vertices);
+					return glm::vec3(p_transform_1 * glm::vec4(support_1, 1.f) - p_transform_2 * glm::vec4(support_2, 1.f));
+				};
+				const auto brute_force_intersecting = [&brute_force_support](const glm::mat4& p_transform_1, const glm::quat& p_orientation_1, const glm::mat4& p_transform_2, const glm::quat& p_orientation_2)
+				{
+					glm::vec3 direction  = glm::vec3(1.f, 0.f, 0.f);
+					GJK::Simplex simplex = {brute_force_support(direction, p_transform_1, p_orientation_1, p_transform_2, p_orientation_2)};
+					direction            = -simplex[0];
+					while (true)
+					{
+						const auto support = brute_force_support(direction, p_transform_1, p_orientation_1, p_transform_2, p_orientation_2);
+						if (glm::dot(support, direction) <= 0.f)
+							return false;
+
+						simplex.push_front(support);
+						if (GJK::do_simplex(simplex, direction))
+							return true;
+					}
+				};
+
+				int brute_force_hits = 0;
+				Utility::Stopwatch brute_force_stopwatch;
+				for (int frame = 0; frame < frame_count; frame++)
+				{
+					const auto [transform_1, orientation_1] = frame_transform(frame, 0.f);
+					const auto [transform_2, orientation_2] = frame_transform(frame, 1.f);
+					brute_force_hits += brute_force_intersecting(transform_1, orientation_1, transform_2, orientation_2);
+				}
+				const float brute_force_ms = brute_force_stopwatch.duration_since_start<float, std::milli>().count();
+
+				int hill_climbing_hits = 0;
+				GJK::SupportCache cache;
+				Utility::Stopwatch hill_climbing_stopwatch;
+				for (int frame = 0; frame < frame_count; frame++)
+				{
+					const auto [transform_1, orientation_1] = frame_transform(frame, 0.f);
+					const auto [transform_2, orientation_2] = frame_transform(frame, 1.f);
+					hill_climbing_hits += GJK::intersecting(hull, transform_1, orientation_1, hull, transform_2, orientation_2, glm::vec3(1.f, 0.f, 0.f), &cache);
+				}
+				const float hill_climbing_ms = hill_climbing_stopwatch.duration_since_start<float, std::milli>().count();
+
+				printf("GJK %5zu vertex hulls x %d frames | brute force %8.3fms | hill climbing %8.3fms | %.1fx | intersections %d / %d\n",
+					vertex_count, frame_count, brute_force_ms, hill_climbing_ms, brute_force_ms / hill_climbing_ms, hill_climbing_hits, brute_force_hits);
+			}
+		}
+		// EPA between overlapping spheres at a spread of offsets and orientations.
+		{
+			constexpr int collision_count = 10000;
+			for (const size_t vertex_count : {32, 256, 2048})
+			{
+				const auto hull = Geometry::ConvexHull(sphere_points(vertex_count));
+
+				struct Collision
+				{
+					glm::mat4 transform_1;
+					glm::quat orientation_1;
+					glm::mat4 transform_2;
+					glm::quat orientation_2;
+					GJK::Simplex simplex;
+				};
+				std::vector<Collision> collisions;
+				for (int i = 0; collisions.size() < collision_count; i++)
+				{
+					const float t = static_cast<float>(i);
+					Collision collision;
+					collision.orientation_1 = glm::angleAxis(t * 0.37f, glm::normalize(glm::vec3(1.f, std::sin(t), 2.f)));
+					collision.orientation_2 = glm::angleAxis(t * 0.71f, glm::normalize(glm::vec3(std::cos(t), 1.f, 0.5f)));
+					collision.transform_1   = glm::mat4_cast(collision.orientation_1);
+					collision.transform_2   = glm::translate(glm::identity<glm::mat4>(), glm::vec3(std::sin(t * 1.3f), std::cos(t * 0.7f), std::sin(t * 0.3f)) * 1.2f) * glm::mat4_cast(collision.orientation_2);
+
+					if (GJK::intersecting(hull, collision.transform_1, collision.orientation_1, hull, collision.transform_2, collision.orientation_2, glm::vec3(1.f, 0.f, 0.f), nullptr, &collision.simplex)
+					    && collision.simplex.size == 4)
+						collisions.push_back(collision);
+				}
+
+				float total_depth = 0.f; // Accumulated so the calls can't be optimised away.
+				Utility::Stopwatch stopwatch;
+				for (const auto& collision : collisions)
+					total_depth += GJK::EPA(collision.simplex, hull, collision.transform_1, collision.orientation_1, hull, collision.transform_2, collision.orientation_2).penetration_depth;
+				const float EPA_ms = stopwatch.duration_since_start<float, std::milli>().count();
+
+				printf("EPA %5zu vertex hulls x %d collisions | %8.3fms | %.3fus per call | mean depth %.3f\n",
+					vertex_count, collision_count, EPA_ms, EPA_ms * 1000.f / collision_count, total_depth / collision_count);
+			}
+		}
+
 		//constexpr size_t triangle_count = 1000000 * 2;
 		//std::vector<float> random_triangle_points = Utility::get_random_numbers(std::numeric_limits<float>::min(), std::numeric_limits<float>::max(), triangle_count * 3 * 3);
 		//std::vector<Geometry::Triangle> triangles;
@@ -296,6 +658,18 @@ namespace Test
 				CHECK_EQUAL(frustrum.m_far.m_normal,    glm::vec3(0.f, 0.f, -1.f), "Far");
 			}
 		}
+		{SCOPE_SECTION("Frustrum v AABB");
+			// Camera at the origin looking down -Z with a 90 degree FOV, the frustrum is 10 units wide either side at Z -10.
+			const auto frustrum = Geometry::Frustrum(glm::perspective(glm::radians(90.f), 1.f, 1.f, 100.f));
+
+			CHECK_TRUE(Geometry::intersecting(frustrum, Geometry::AABB(glm::vec3(-1.f, -1.f, -11.f), glm::vec3(1.f, 1.f, -9.f))), "Inside");
+			CHECK_TRUE(Geometry::intersecting(frustrum, Geometry::AABB(glm::vec3(-12.f, -1.f, -11.f), glm::vec3(-8.f, 1.f, -9.f))), "Straddling the left plane");
+			CHECK_TRUE(Geometry::intersecting(frustrum, Geometry::AABB(glm::vec3(-1.f, -1.f, -101.f), glm::vec3(1.f, 1.f, -99.f))), "Straddling the far plane");
+			CHECK_TRUE(!Geometry::intersecting(frustrum, Geometry::AABB(glm::vec3(-1.f, -1.f, 5.f), glm::vec3(1.f, 1.f, 7.f))), "Behind the camera");
+			CHECK_TRUE(!Geometry::intersecting(frustrum, Geometry::AABB(glm::vec3(-0.1f, -0.1f, -0.5f), glm::vec3(0.1f, 0.1f, -0.2f))), "Before the near plane");
+			CHECK_TRUE(!Geometry::intersecting(frustrum, Geometry::AABB(glm::vec3(-1.f, -1.f, -200.f), glm::vec3(1.f, 1.f, -190.f))), "Beyond the far plane");
+			CHECK_TRUE(!Geometry::intersecting(frustrum, Geometry::AABB(glm::vec3(50.f, -1.f, -11.f), glm::vec3(52.f, 1.f, -9.f))), "Right of the right plane");
+		}
 	}
 
 	void GeometryTester::run_sphere_tests()
@@ -931,5 +1305,504 @@ namespace Test
 			}
 		}
 	}
+	void GeometryTester::run_convex_hull_tests()
+	{SCOPE_SECTION("Convex hull");
+		{SCOPE_SECTION("Cube");
+			// Corners of a cube with points inside, on the faces and duplicated which should all be dropped.
+			std::vector<glm::vec3> points;
+			for (int i = 0; i < 8; i++)
+				points.push_back(glm::vec3(i & 1 ? 1.f : -1.f, i & 2 ? 1.f : -1.f, i & 4 ? 1.f : -1.f));
+			points.insert(points.end(), {glm::vec3(0.f), glm::vec3(0.5f, 0.5f, 1.f), glm::vec3(0.f, 0.f, -1.f), glm::vec3(1.f, 0.f, 0.f), glm::vec3(1.f)});
+
+			const auto hull = Geometry::ConvexHull(points);
+			CHECK_EQUAL(hull.m_vertices.size(), 8, "Vertex count");
+			CHECK_EQUAL(hull.m_faces.size(), 12, "Face count");
+			CHECK_EQUAL(hull.m_adjacency.size(), 36, "Each edge links both its vertices"); // 18 edges with the square faces split into triangles.
+
+			bool all_points_inside = true;
+			bool neighbours_linked = true;
+			for (uint32_t face_index = 0; face_index < hull.m_faces.size(); face_index++)
+			{
+				const auto& face = hull.m_faces[face_index];
+				for (const auto& point : points)
+					all_points_inside &= glm::dot(face.normal, point) - face.offset <= 1e-5f;
+
+				for (int i = 0; i < 3; i++)
+				{// The neighbour across each edge shares it in the opposite direction and points back across it.
+					const auto& neighbour = hull.m_faces[face.neighbours[i]];
+					bool linked = false;
+					for (int j = 0; j < 3; j++)
+						linked |= neighbour.neighbours[j] == face_index && neighbour.vertices[j] == face.vertices[(i + 1) % 3] && neighbour.vertices[(j + 1) % 3] == face.vertices[i];
+					neighbours_linked &= linked;
+				}
+			}
+			CHECK_TRUE(all_points_inside, "Every point is behind every face");
+			CHECK_TRUE(neighbours_linked, "Face neighbours");
+
+			bool adjacency_symmetric = true;
+			for (uint32_t vertex = 0; vertex < hull.m_vertices.size(); vertex++)
+			{
+				for (const auto neighbour : hull.neighbours(vertex))
+				{
+					const auto back = hull.neighbours(neighbour);
+					adjacency_symmetric &= std::find(back.begin(), back.end(), vertex) != back.end();
+				}
+			}
+			CHECK_TRUE(adjacency_symmetric, "Vertex adjacency");
+		}
+		{SCOPE_SECTION("Flat");
+			const auto square = Geometry::ConvexHull(std::vector<glm::vec3>{glm::vec3(0.f), glm::vec3(1.f, 0.f, 0.f), glm::vec3(1.f, 1.f, 0.f), glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.5f, 0.5f, 0.f), glm::vec3(0.5f, 0.f, 0.f)});
+			CHECK_TRUE(square.is_flat(), "Coplanar points are flat");
+			CHECK_EQUAL(square.m_vertices.size(), 4, "Coplanar outline vertex count");
+			CHECK_EQUAL(square.neighbours(0).size(), 2, "Outline vertices link to the vertices either side");
+
+			const auto line = Geometry::ConvexHull(std::vector<glm::vec3>{glm::vec3(0.f), glm::vec3(2.f), glm::vec3(1.f), glm::vec3(0.5f)});
+			CHECK_EQUAL(line.m_vertices.size(), 2, "Collinear points keep the end points");
+			CHECK_EQUAL(line.neighbours(0).size(), 1, "Line end points link to each other");
+
+			const auto point = Geometry::ConvexHull(std::vector<glm::vec3>{glm::vec3(1.f, 2.f, 3.f), glm::vec3(1.f, 2.f, 3.f)});
+			CHECK_EQUAL(point.m_vertices.size(), 1, "Duplicate points");
+			CHECK_TRUE(Geometry::ConvexHull(std::vector<glm::vec3>{}).empty(), "No points");
+		}
+	}
+	void GeometryTester::run_GJK_tests()
+	{SCOPE_SECTION("GJK");
+		const auto hull = Geometry::ConvexHull(sphere_points(500));
+
+		{SCOPE_SECTION("Hill climbing support");
+			// Climbing from the last support vertex must reach a vertex as far along the direction as the furthest of all of them.
+			bool matches_brute_force = true;
+			uint32_t last_support    = 0;
+			for (const auto& direction : sphere_points(200))
+			{
+				last_support = hull.support_vertex(direction, last_support);
+				matches_brute_force &= glm::dot(direction, hull.m_vertices[last_support]) == glm::dot(direction, GJK::support_point(direction, hull.m_vertices));
+			}
+			CHECK_TRUE(matches_brute_force, "Support vertex matches brute force");
+		}
+		{SCOPE_SECTION("Intersecting");
+			const auto orientation = glm::angleAxis(glm::radians(45.f), glm::vec3(0.f, 1.f, 0.f));
+			const auto model_at    = [&orientation](const glm::vec3& p_position) { return glm::translate(glm::identity<glm::mat4>(), p_position) * glm::mat4_cast(orientation); };
+
+			GJK::SupportCache cache;
+			CHECK_TRUE(GJK::intersecting(hull, model_at(glm::vec3(0.f)), orientation, hull, model_at(glm::vec3(1.5f, 0.f, 0.f)), orientation, glm::vec3(1.f, 0.f, 0.f), &cache), "Overlapping spheres");
+			CHECK_TRUE(!GJK::intersecting(hull, model_at(glm::vec3(0.f)), orientation, hull, model_at(glm::vec3(2.5f, 0.f, 0.f)), orientation, glm::vec3(1.f, 0.f, 0.f), &cache), "Separated spheres");
+			CHECK_TRUE(GJK::intersecting(hull, model_at(glm::vec3(0.f)), orientation, hull, model_at(glm::vec3(0.f, 1.9f, 0.f)), orientation, glm::vec3(1.f, 0.f, 0.f), &cache), "Overlapping spheres reusing the cache");
+			CHECK_TRUE(!GJK::intersecting(Geometry::ConvexHull(), model_at(glm::vec3(0.f)), orientation, hull, model_at(glm::vec3(0.f)), orientation, glm::vec3(1.f, 0.f, 0.f)), "Empty hull never intersects");
+		}
+		{SCOPE_SECTION("EPA");
+			// Cubes overlapping by 0.5 along X, offset slightly on the other axes so no faces of their Minkowski difference pass through the origin.
+			std::vector<glm::vec3> corners;
+			for (int i = 0; i < 8; i++)
+				corners.push_back(glm::vec3(i & 1 ? 1.f : -1.f, i & 2 ? 1.f : -1.f, i & 4 ? 1.f : -1.f));
+			const auto cube        = Geometry::ConvexHull(corners);
+			const auto orientation = glm::identity<glm::quat>();
+			const auto transform_2 = glm::translate(glm::identity<glm::mat4>(), glm::vec3(1.5f, 0.2f, 0.1f));
+
+			GJK::SupportCache cache;
+			GJK::Simplex simplex;
+			CHECK_TRUE(GJK::intersecting(cube, glm::identity<glm::mat4>(), orientation, cube, transform_2, orientation, glm::vec3(1.f, 0.f, 0.f), &cache, &simplex), "Overlapping cubes");
+
+			const auto collision = GJK::EPA(simplex, cube, glm::identity<glm::mat4>(), orientation, cube, transform_2, orientation, &cache);
+			CHECK_EQUAL_FLOAT(collision.penetration_depth, 0.5f, "Penetration depth", 0.01f);
+			CHECK_EQUAL_FLOAT(collision.normal.x, 1.f, "Collision normal", 0.001f);
+		}
+	}
+	void GeometryTester::run_BVH_tests()
+	{SCOPE_SECTION("BVH");
+		auto AABBs = scattered_AABBs(300);
+		auto BVH   = Geometry::BVH(AABBs);
+
+		// Checks the tree is well formed and every query agrees with testing every AABB.
+		const auto validate = [&]()
+		{
+			std::vector<int> leaf_counts(AABBs.size(), 0);
+			int bad_nodes = 0;
+			for (const auto& node : BVH.m_nodes)
+			{
+				const auto contains = [&node](const glm::vec3& p_min, const glm::vec3& p_max) { return glm::all(glm::lessThanEqual(node.min, p_min)) && glm::all(glm::greaterThanEqual(node.max, p_max)); };
+				if (node.is_leaf())
+				{
+					for (uint32_t i = node.first; i < node.first + node.count; i++)
+					{
+						leaf_counts[BVH.m_primitives[i]]++;
+						bad_nodes += !contains(AABBs[BVH.m_primitives[i]].m_min, AABBs[BVH.m_primitives[i]].m_max);
+					}
+				}
+				else
+					bad_nodes += !contains(BVH.m_nodes[node.first].min, BVH.m_nodes[node.first].max) || !contains(BVH.m_nodes[node.first + 1].min, BVH.m_nodes[node.first + 1].max);
+			}
+			CHECK_EQUAL(bad_nodes, 0, "Nodes bound their children");
+			CHECK_TRUE(std::all_of(leaf_counts.begin(), leaf_counts.end(), [](int p_count) { return p_count == 1; }), "Every primitive in one leaf");
+
+			int mismatches = 0;
+			const auto directions = sphere_points(64);
+			for (const auto& direction : directions)
+			{
+				const auto ray = Geometry::Ray(direction * -20.f + glm::vec3(0.1f, 0.2f, 0.3f), direction);
+				float closest  = Geometry::Batch::Miss;
+				for (const auto& AABB : AABBs)
+				{
+					float distance = 0.f;
+					if (Geometry::get_intersection(AABB, ray, &distance) && distance >= 0.f)
+						closest = std::min(closest, distance);
+				}
+				const auto hit = BVH.cast_ray(ray, [&](uint32_t p_index, float) -> std::optional<float>
+				{
+					float distance = 0.f;
+					return Geometry::get_intersection(AABBs[p_index], ray, &distance) && distance >= 0.f ? std::optional<float>(distance) : std::nullopt;
+				});
+				mismatches += hit.has_value() != (closest != Geometry::Batch::Miss) || (hit && hit->distance != closest);
+
+				const auto query_box = Geometry::AABB(direction * 6.f - glm::vec3(2.f), direction * 6.f + glm::vec3(2.f));
+				std::vector<uint32_t> overlapping;
+				BVH.query(query_box, [&](uint32_t p_index) { if (Geometry::intersecting(AABBs[p_index], query_box)) overlapping.push_back(p_index); });
+				size_t expected_overlapping = 0;
+				for (const auto& AABB : AABBs)
+					expected_overlapping += Geometry::intersecting(AABB, query_box);
+				mismatches += overlapping.size() != expected_overlapping;
+
+				const glm::vec3 point     = direction * 8.f;
+				const auto distance_to    = [&](uint32_t p_index) { const glm::vec3 outside = glm::max(glm::max(AABBs[p_index].m_min - point, point - AABBs[p_index].m_max), glm::vec3(0.f)); return glm::dot(outside, outside); };
+				float expected_nearest    = std::numeric_limits<float>::max();
+				for (uint32_t i = 0; i < AABBs.size(); i++)
+					expected_nearest = std::min(expected_nearest, distance_to(i));
+				const auto nearest = BVH.nearest(point, distance_to);
+				mismatches += !nearest || nearest->distance != std::sqrt(expected_nearest);
+
+				const auto frustrum = Geometry::Frustrum(glm::perspective(glm::radians(60.f), 1.f, 0.1f, 30.f) * glm::lookAt(direction * 15.f, glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f) + direction * 0.01f));
+				size_t visible = 0;
+				BVH.query(frustrum, [&](uint32_t p_index) { visible += Geometry::intersecting(frustrum, AABBs[p_index]); });
+				size_t expected_visible = 0;
+				for (const auto& AABB : AABBs)
+					expected_visible += Geometry::intersecting(frustrum, AABB);
+				mismatches += visible != expected_visible;
+			}
+			CHECK_EQUAL(mismatches, 0, "Queries match brute force");
+		};
+
+		{SCOPE_SECTION("Build");
+			CHECK_TRUE(!BVH.empty(), "Not empty");
+			CHECK_TRUE(std::all_of(BVH.m_nodes.begin(), BVH.m_nodes.end(), [](const Geometry::BVH::Node& p_node) { return p_node.count <= 4; }), "Leaves within the max leaf size");
+			validate();
+		}
+		{SCOPE_SECTION("Refit");
+			for (size_t i = 0; i < AABBs.size(); i++)
+			{
+				const glm::vec3 offset = glm::vec3(std::sin(static_cast<float>(i)), 0.5f, std::cos(static_cast<float>(i) * 0.3f)) * 3.f;
+				AABBs[i] = Geometry::AABB(AABBs[i].m_min + offset, AABBs[i].m_max + offset);
+			}
+			BVH.refit(AABBs);
+			validate();
+		}
+		{SCOPE_SECTION("Empty");
+			const auto empty_BVH = Geometry::BVH(std::vector<Geometry::AABB>{});
+			CHECK_TRUE(empty_BVH.empty(), "Empty");
+			CHECK_TRUE(!empty_BVH.cast_ray(Geometry::Ray(glm::vec3(0.f), glm::vec3(1.f, 0.f, 0.f)), [](uint32_t, float) { return std::optional<float>(0.f); }), "No ray hits");
+		}
+	}
+	void GeometryTester::run_dynamic_tree_tests()
+	{SCOPE_SECTION("Dynamic tree");
+		auto AABBs = scattered_AABBs(300);
+		auto tree  = Geometry::DynamicTree(0.1f);
+		std::vector<uint32_t> proxies(AABBs.size(), Geometry::DynamicTree::Null); // Proxy of each AABB in the tree.
+		for (size_t i = 0; i < AABBs.size(); i++)
+			proxies[i] = tree.insert(AABBs[i], i);
+
+		// Checks the tree is well formed and every query agrees with testing every AABB in the tree.
+		const auto validate = [&]()
+		{
+			std::vector<int> leaf_counts(AABBs.size(), 0);
+			int bad_nodes = 0;
+			if (!tree.empty())
+			{
+				bad_nodes += tree.m_nodes[tree.m_root].parent != Geometry::DynamicTree::Null;
+				std::vector<uint32_t> stack = {tree.m_root};
+				while (!stack.empty())
+				{
+					const auto& node = tree.m_nodes[stack.back()];
+					const uint32_t index = stack.back();
+					stack.pop_back();
+					const auto contains = [&node](const glm::vec3& p_min, const glm::vec3& p_max) { return glm::all(glm::lessThanEqual(node.min, p_min)) && glm::all(glm::greaterThanEqual(node.max, p_max)); };
+					if (node.is_leaf())
+					{
+						leaf_counts[node.user_data]++;
+						bad_nodes += node.height != 0 || !contains(AABBs[node.user_data].m_min, AABBs[node.user_data].m_max) || proxies[node.user_data] != index;
+					}
+					else
+					{
+						const auto& child_1 = tree.m_nodes[node.child_1];
+						const auto& child_2 = tree.m_nodes[node.child_2];
+						bad_nodes += !contains(child_1.min, child_1.max) || !contains(child_2.min, child_2.max)
+						          || child_1.parent != index || child_2.parent != index || node.height != 1 + std::max(child_1.height, child_2.height);
+						stack.push_back(node.child_1);
+						stack.push_back(node.child_2);
+					}
+				}
+			}
+			CHECK_EQUAL(bad_nodes, 0, "Nodes bound their children");
+			size_t live_count = 0;
+			int misplaced     = 0;
+			for (size_t i = 0; i < AABBs.size(); i++)
+			{
+				const bool live = proxies[i] != Geometry::DynamicTree::Null;
+				live_count += live;
+				misplaced  += leaf_counts[i] != (live ? 1 : 0);
+			}
+			CHECK_EQUAL(misplaced, 0, "Every proxy in one leaf");
+			CHECK_EQUAL(tree.size(), live_count, "Size");
+
+			int mismatches = 0;
+			const auto directions = sphere_points(64);
+			for (const auto& direction : directions)
+			{
+				const auto ray = Geometry::Ray(direction * -20.f + glm::vec3(0.1f, 0.2f, 0.3f), direction);
+				float closest  = Geometry::Batch::Miss;
+				for (size_t i = 0; i < AABBs.size(); i++)
+				{
+					float distance = 0.f;
+					if (proxies[i] != Geometry::DynamicTree::Null && Geometry::get_intersection(AABBs[i], ray, &distance) && distance >= 0.f)
+						closest = std::min(closest, distance);
+				}
+				const auto hit = tree.cast_ray(ray, [&](size_t p_index, float) -> std::optional<float>
+				{
+					float distance = 0.f;
+					return Geometry::get_intersection(AABBs[p_index], ray, &distance) && distance >= 0.f ? std::optional<float>(distance) : std::nullopt;
+				});
+				mismatches += hit.has_value() != (closest != Geometry::Batch::Miss) || (hit && hit->distance != closest);
+
+				// Each query is filtered by the exact test as the tree only knows the fat AABBs.
+				const auto query_box = Geometry::AABB(direction * 6.f - glm::vec3(2.f), direction * 6.f + glm::vec3(2.f));
+				const auto sphere    = Geometry::Sphere(direction * 6.f, 3.f);
+				const auto frustrum  = Geometry::Frustrum(glm::perspective(glm::radians(60.f), 1.f, 0.1f, 30.f) * glm::lookAt(direction * 15.f, glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f) + direction * 0.01f));
+				const auto in_sphere = [&](size_t p_index)
+				{
+					const glm::vec3 outside = glm::max(glm::max(AABBs[p_index].m_min - sphere.m_center, sphere.m_center - AABBs[p_index].m_max), glm::vec3(0.f));
+					return glm::dot(outside, outside) <= sphere.m_radius * sphere.m_radius;
+				};
+				size_t overlapping = 0;
+				size_t near_sphere = 0;
+				size_t visible     = 0;
+				tree.query(query_box, [&](size_t p_index) { overlapping += Geometry::intersecting(AABBs[p_index], query_box); });
+				tree.query(sphere, [&](size_t p_index) { near_sphere += in_sphere(p_index); });
+				tree.query(frustrum, [&](size_t p_index) { visible += Geometry::intersecting(frustrum, AABBs[p_index]); });
+				size_t expected_overlapping = 0;
+				size_t expected_near_sphere = 0;
+				size_t expected_visible     = 0;
+				for (size_t i = 0; i < AABBs.size(); i++)
+				{
+					if (proxies[i] == Geometry::DynamicTree::Null)
+						continue;
+					expected_overlapping += Geometry::intersecting(AABBs[i], query_box);
+					expected_near_sphere += in_sphere(i);
+					expected_visible     += Geometry::intersecting(frustrum, AABBs[i]);
+				}
+				mismatches += overlapping != expected_overlapping || near_sphere != expected_near_sphere || visible != expected_visible;
+			}
+			CHECK_EQUAL(mismatches, 0, "Queries match brute force");
+		};
+
+		{SCOPE_SECTION("Insert");
+			CHECK_EQUAL(tree.size(), AABBs.size(), "Size");
+			validate();
+		}
+		{SCOPE_SECTION("Move");
+			// Moves within the margin keep the proxy where it is.
+			const auto nudged = Geometry::AABB(AABBs[0].m_min + glm::vec3(0.05f), AABBs[0].m_max + glm::vec3(0.05f));
+			CHECK_TRUE(!tree.move(proxies[0], nudged), "Small move keeps the leaf");
+			AABBs[0] = nudged;
+
+			int reinserted = 0;
+			for (size_t i = 0; i < AABBs.size(); i++)
+			{
+				const glm::vec3 offset = glm::vec3(std::sin(static_cast<float>(i)), 0.5f, std::cos(static_cast<float>(i) * 0.3f)) * 3.f;
+				AABBs[i]    = Geometry::AABB(AABBs[i].m_min + offset, AABBs[i].m_max + offset);
+				reinserted += tree.move(proxies[i], AABBs[i]);
+			}
+			CHECK_EQUAL(reinserted, static_cast<int>(AABBs.size()), "Large moves reinsert");
+			validate();
+		}
+		{SCOPE_SECTION("Shrink");
+			// A fat AABB far bigger than its object is replaced.
+			const auto shrunk = Geometry::AABB(AABBs[1].get_center() - glm::vec3(0.01f), AABBs[1].get_center() + glm::vec3(0.01f));
+			CHECK_TRUE(tree.move(proxies[1], shrunk), "Shrunk object reinserted");
+			AABBs[1] = shrunk;
+			validate();
+		}
+		{SCOPE_SECTION("Remove");
+			for (size_t i = 0; i < AABBs.size(); i += 2)
+			{
+				tree.remove(proxies[i]);
+				proxies[i] = Geometry::DynamicTree::Null;
+			}
+			validate();
+
+			// Freed nodes are reused.
+			const size_t node_count = tree.m_nodes.size();
+			for (size_t i = 0; i < AABBs.size(); i += 2)
+				proxies[i] = tree.insert(AABBs[i], i);
+			CHECK_EQUAL(tree.m_nodes.size(), node_count, "Nodes reused");
+			validate();
+		}
+		{SCOPE_SECTION("Balance");
+			// Inserting in sorted order builds a list without rotations.
+			auto line_tree = Geometry::DynamicTree();
+			for (int i = 0; i < 1024; i++)
+				line_tree.insert(Geometry::AABB(glm::vec3(static_cast<float>(i), 0.f, 0.f), glm::vec3(static_cast<float>(i) + 1.f, 1.f, 1.f)), i);
+			CHECK_TRUE(line_tree.height() <= 20, "Height near log2(n)");
+		}
+		{SCOPE_SECTION("Empty");
+			tree.clear();
+			CHECK_TRUE(tree.empty(), "Empty");
+			CHECK_TRUE(!tree.cast_ray(Geometry::Ray(glm::vec3(0.f), glm::vec3(1.f, 0.f, 0.f)), [](size_t, float) { return std::optional<float>(0.f); }), "No ray hits");
+		}
+	}
+	void GeometryTester::run_batch_intersect_tests()
+	{SCOPE_SECTION("Batch intersect");
+		// Odd counts so the last register of every batch is part padding.
+		const auto AABBs     = scattered_AABBs(37);
+		const auto triangles = scattered_triangles(41);
+		// Rays start outside all the primitives so the scalar tests, which treat the ray as a line, agree with the batch for hits ahead of the start.
+		const auto directions = sphere_points(64);
+
+		Geometry::Batch::AABBs AABB_batch;
+		for (const auto& AABB : AABBs)
+			AABB_batch.push_back(AABB);
+		Geometry::Batch::Triangles triangle_batch;
+		for (const auto& triangle : triangles)
+			triangle_batch.push_back(triangle);
+
+		{SCOPE_SECTION("Ray v AABBs");
+			int mismatches = 0;
+			int hits       = 0;
+			std::vector<float> distances(AABBs.size());
+			for (const auto& direction : directions)
+			{
+				const auto ray = Geometry::Ray(direction * -20.f + glm::vec3(0.1f, 0.2f, 0.3f), direction);
+				Geometry::Batch::intersect(ray, AABB_batch, distances.data());
+
+				float closest = Geometry::Batch::Miss;
+				for (size_t i = 0; i < AABBs.size(); i++)
+				{
+					float scalar_distance = 0.f;
+					const bool scalar_hit = Geometry::get_intersection(AABBs[i], ray, &scalar_distance).has_value() && scalar_distance >= 0.f;
+					const bool batch_hit  = distances[i] != Geometry::Batch::Miss;
+					if (scalar_hit != batch_hit || (batch_hit && std::abs(distances[i] - scalar_distance) > 0.0001f))
+						mismatches++;
+					hits += batch_hit;
+					closest = std::min(closest, distances[i]);
+				}
+
+				const auto closest_hit = Geometry::Batch::closest_hit(ray, AABB_batch);
+				if (closest_hit.has_value() != (closest != Geometry::Batch::Miss) || (closest_hit && closest_hit->distance != closest))
+					mismatches++;
+			}
+			CHECK_TRUE(hits > 0, "Rays hit some AABBs");
+			CHECK_EQUAL(mismatches, 0, "Batch matches scalar");
+
+			Geometry::Batch::intersect(Geometry::Ray(AABBs[3].get_center(), glm::vec3(0.f, 0.f, 1.f)), AABB_batch, distances.data());
+			CHECK_EQUAL(distances[3], 0.f, "Ray starting inside");
+			Geometry::Batch::intersect(Geometry::Ray(AABBs[3].get_center() - glm::vec3(20.f, 0.f, 0.f), glm::vec3(1.f, 0.f, 0.f)), AABB_batch, distances.data(), 1.f);
+			CHECK_EQUAL(distances[3], Geometry::Batch::Miss, "Hit beyond max distance");
+		}
+		{SCOPE_SECTION("Ray v Triangles");
+			int mismatches = 0;
+			int hits       = 0;
+			std::vector<float> distances(triangles.size());
+			for (const auto& direction : directions)
+			{
+				const auto ray = Geometry::Ray(direction * -20.f + glm::vec3(0.1f, 0.2f, 0.3f), direction);
+				Geometry::Batch::intersect(ray, triangle_batch, distances.data());
+
+				for (size_t i = 0; i < triangles.size(); i++)
+				{
+					const auto scalar_hit = Geometry::get_intersection(Geometry::Line(ray.m_start, ray.m_start + ray.m_direction), triangles[i]);
+					const bool batch_hit  = distances[i] != Geometry::Batch::Miss;
+					if (batch_hit != (scalar_hit && glm::dot(*scalar_hit - ray.m_start, ray.m_direction) >= 0.f)
+					    || (batch_hit && glm::distance(ray.m_start + ray.m_direction * distances[i], *scalar_hit) > 0.001f))
+						mismatches++;
+					hits += batch_hit;
+				}
+			}
+			CHECK_TRUE(hits > 0, "Rays hit some triangles");
+			CHECK_EQUAL(mismatches, 0, "Batch matches scalar");
+		}
+		{SCOPE_SECTION("Ray packet");
+			int mismatches = 0;
+			Geometry::Batch::RayPacket packet;
+			for (size_t i = 0; i < 5; i++)
+				packet.push_back(Geometry::Ray(directions[i * 7] * -20.f, directions[i * 7]));
+
+			std::vector<float> single_distances(std::max(AABBs.size(), triangles.size()));
+			float packet_distances[Geometry::Batch::RayPacket::Size];
+			for (size_t i = 0; i < AABBs.size(); i++)
+			{
+				Geometry::Batch::intersect(packet, AABBs[i], packet_distances);
+				for (size_t ray = 0; ray < packet.count; ray++)
+				{
+					Geometry::Batch::intersect(Geometry::Ray(directions[ray * 7] * -20.f, directions[ray * 7]), AABB_batch, single_distances.data());
+					mismatches += packet_distances[ray] != single_distances[i];
+				}
+			}
+			for (size_t i = 0; i < triangles.size(); i++)
+			{
+				Geometry::Batch::intersect(packet, triangles[i], packet_distances);
+				for (size_t ray = 0; ray < packet.count; ray++)
+				{
+					Geometry::Batch::intersect(Geometry::Ray(directions[ray * 7] * -20.f, directions[ray * 7]), triangle_batch, single_distances.data());
+					mismatches += packet_distances[ray] != single_distances[i];
+				}
+			}
+			CHECK_EQUAL(mismatches, 0, "Packet matches single rays");
+		}
+		{SCOPE_SECTION("Frustrum v AABBs");
+			// Perspective views from around the field looking at different parts of it, and an orthographic view like a directional light.
+			std::vector<Geometry::Frustrum> frustrums;
+			for (size_t i = 0; i < 8; i++)
+			{
+				const glm::vec3 eye = directions[i * 8] * 12.f;
+				frustrums.push_back(Geometry::Frustrum(glm::perspective(glm::radians(40.f), 1.5f, 0.5f, 20.f) * glm::lookAt(eye, directions[i * 8 + 1] * 3.f, glm::vec3(0.f, 1.f, 0.f))));
+			}
+			frustrums.push_back(Geometry::Frustrum(glm::ortho(-4.f, 4.f, -3.f, 3.f, 1.f, 20.f) * glm::lookAt(glm::vec3(2.f, 10.f, 1.f), glm::vec3(0.f), glm::vec3(0.f, 0.f, 1.f))));
+
+			const auto matches_scalar = [&](const Geometry::Batch::AABBs& p_batch, const std::vector<Geometry::AABB>& p_AABBs, size_t& p_visible)
+			{
+				std::vector<uint32_t> indices(p_AABBs.size());
+				for (const auto& frustrum : frustrums)
+				{
+					const size_t visible_count = Geometry::Batch::intersecting(frustrum, p_batch, indices.data());
+					std::vector<uint32_t> expected;
+					for (uint32_t i = 0; i < p_AABBs.size(); i++)
+						if (Geometry::intersecting(frustrum, p_AABBs[i]))
+							expected.push_back(i);
+
+					if (!std::equal(indices.begin(), indices.begin() + visible_count, expected.begin(), expected.end()))
+						return false;
+					p_visible += visible_count;
+				}
+				return true;
+			};
+
+			size_t visible = 0;
+			CHECK_TRUE(matches_scalar(AABB_batch, AABBs, visible), "Batch matches scalar");
+			CHECK_TRUE(visible > 0 && visible < AABBs.size() * frustrums.size(), "Some AABBs culled");
+
+			// Erase moves the last AABB into the gap, mirror that on the scalar side.
+			auto erased_batch = AABB_batch;
+			auto erased_AABBs = AABBs;
+			for (const size_t index : {size_t(5), size_t(0), size_t(20), erased_AABBs.size() - 4})
+			{
+				erased_batch.erase(index);
+				erased_AABBs[index] = erased_AABBs.back();
+				erased_AABBs.pop_back();
+			}
+			CHECK_EQUAL(erased_batch.count, erased_AABBs.size(), "Erase count");
+			visible = 0;
+			CHECK_TRUE(matches_scalar(erased_batch, erased_AABBs, visible), "Batch matches scalar after erase");
+
+			std::vector<uint32_t> indices(AABBs.size());
+			CHECK_EQUAL(Geometry::Batch::intersecting(frustrums.front(), Geometry::Batch::AABBs(), indices.data()), size_t(0), "Empty batch");
+		}
+	}
 } // namespace Test
 DISABLE_WARNING_POP
\ No newline at end of file
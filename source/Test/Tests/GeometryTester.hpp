@@ -20,5 +20,10 @@ namespace Test
 		void run_sphere_tests();
 		void run_point_tests();
 		void run_quad_key_tests();
+		void run_convex_hull_tests();
+		void run_GJK_tests();
+		void run_batch_intersect_tests();
+		void run_BVH_tests();
+		void run_dynamic_tree_tests();
 	};
 } // namespace Test
\ No newline at end of file
@@ -2,13 +2,39 @@
 
 #include "OpenGL/Types.hpp"
 #include "OpenGL/Shader.hpp"
+#include "OpenGL/CommandStream.hpp"
 #include "OpenGL/GLState.hpp"
 #include "OpenGL/DrawCall.hpp"
+#include "OpenGL/InstanceBatcher.hpp"
+#include "OpenGL/LightClusters.hpp"
+#include "OpenGL/RenderQueue.hpp"
+#include "OpenGL/RingBuffer.hpp"
+#include "OpenGL/ShadowMapper.hpp"
+#include "OpenGL/UniformID.hpp"
+
+#include "Component/ViewInformation.hpp"
+#include "Data/Quantise.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "Utility/MeshBuilder.hpp"
+#include "Utility/MeshOptimiser.hpp"
+#include "Utility/MeshSimplifier.hpp"
+#include "Utility/RadixSort.hpp"
+#include "Utility/Stopwatch.hpp"
 
 #include "Platform/Core.hpp"
 #include "Platform/Input.hpp"
 #include "Platform/Window.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
 namespace Test
 {
 	void GraphicsTester::run_unit_tests()
@@ -187,10 +213,626 @@ namespace Test
 			}
 		}
 
+		{SCOPE_SECTION("MeshBuilder")
+			{SCOPE_SECTION("Weld vertices")
+				auto mb = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles>{};
+				mb.add_cuboid(Geometry::Cuboid(glm::vec3(0.f)));
+				const auto flat_mesh    = mb.get_mesh();
+				const auto indexed_mesh = mb.get_indexed_mesh();
+
+				CHECK_TRUE(indexed_mesh.get_VAO().is_indexed(), "Indexed mesh uses an index buffer");
+				CHECK_EQUAL(indexed_mesh.get_VAO().draw_count(), flat_mesh.get_VAO().draw_count(), "Indexed mesh draws the same number of vertices");
+				CHECK_TRUE(flat_mesh.triangle_BVH.empty() && indexed_mesh.triangles.empty(), "No ray cast BVH without build_collision_shape");
+
+				auto flat_vertices = std::vector<Data::PositionVertex>{};
+				for (const auto& corner : {glm::vec3(0.f), glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f), glm::vec3(-0.f, 1.f, 0.f)})
+					flat_vertices.push_back(Data::PositionVertex{corner});
+
+				const auto [unique_vertices, indices] = Utility::weld_vertices(flat_vertices);
+				CHECK_EQUAL(unique_vertices.size(), 3, "Duplicate vertices welded (-0 equals +0)");
+				CHECK_EQUAL(indices.size(), flat_vertices.size(), "One index per input vertex");
+
+				bool indices_match = true;
+				for (size_t i = 0; i < indices.size(); i++)
+					indices_match &= unique_vertices[indices[i]].position == flat_vertices[i].position;
+				CHECK_TRUE(indices_match, "Indices reference the original vertices");
+			}
+			{SCOPE_SECTION("Descriptor")
+				auto mb = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles, true>{};
+				mb.add_cylinder(glm::vec3(1.f, -1.f, 2.f), glm::vec3(1.f, 3.f, 2.f), 0.5f, 16);
+				auto [vertices, indices] = mb.get_indexed_data(false);
+
+				Geometry::AABB bounds{vertices.front().position, vertices.front().position};
+				for (const auto& vertex : vertices)
+					bounds.unite(vertex.position);
+
+				const auto descriptor = mb.get_descriptor();
+				CHECK_TRUE(descriptor.AABB.m_min == bounds.m_min && descriptor.AABB.m_max == bounds.m_max, "Bounds tracked while building");
+				CHECK_TRUE(!descriptor.has_alpha, "Opaque");
+				// The end caps centres and the UV seam duplicates are inside or repeated, only the 2 rings of 16 remain.
+				CHECK_EQUAL(descriptor.collision_hull.m_vertices.size(), 32, "Collision hull vertices");
+				CHECK_TRUE(descriptor.ray_cast, "Collision meshes are ray cast");
+
+				mb.set_colour(glm::vec4(1.f, 1.f, 1.f, 0.5f));
+				mb.add_cuboid(Geometry::Cuboid(glm::vec3(10.f)));
+				CHECK_TRUE(mb.get_descriptor().has_alpha, "Transparent colour tracked");
+				CHECK_EQUAL(mb.get_descriptor().AABB.m_max, glm::vec3(11.f), "Bounds grow with new shapes");
+			}
+			{SCOPE_SECTION("Optimise")
+				auto mb = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles>{};
+				mb.add_icosphere(glm::vec3(0.f), 1.f, 3);
+				const auto [welded_vertices, welded_indices]       = mb.get_indexed_data(false);
+				const auto [optimised_vertices, optimised_indices] = mb.get_indexed_data(true);
+
+				CHECK_EQUAL(optimised_indices.size(), welded_indices.size(), "Triangle count unchanged");
+				CHECK_EQUAL(optimised_vertices.size(), welded_vertices.size(), "Vertex count unchanged");
+				CHECK_TRUE(Utility::MeshOptimiser::ACMR(optimised_indices, optimised_vertices.size()) < Utility::MeshOptimiser::ACMR(welded_indices, welded_vertices.size()), "ACMR reduced");
+
+				// Vertex fetch order puts every vertex in first use order.
+				unsigned int next_new_vertex = 0;
+				bool first_use_order         = true;
+				for (const auto index : optimised_indices)
+				{
+					if (index == next_new_vertex)
+						next_new_vertex++;
+					else
+						first_use_order &= index < next_new_vertex;
+				}
+				CHECK_TRUE(first_use_order, "Vertices in first use order");
+			}
+			{SCOPE_SECTION("Simplify")
+				// Without normals the icosphere welds into a closed smooth mesh every vertex of which can collapse.
+				auto mb = Utility::MeshBuilder<Data::PositionVertex, OpenGL::PrimitiveMode::Triangles>{};
+				mb.add_icosphere(glm::vec3(0.f), 1.f, 4);
+				auto [vertices, indices] = mb.get_indexed_data();
+				const auto full_index_count = indices.size();
+				const auto LODs = Utility::MeshSimplifier::build_LODs(vertices, indices);
+
+				CHECK_TRUE(LODs.size() > 1 && LODs.size() <= Utility::MeshSimplifier::Max_LOD_Count, "LODs generated");
+				CHECK_EQUAL(LODs.front().index_count, full_index_count, "LOD 0 is the full mesh");
+				CHECK_EQUAL(LODs.back().first_index + LODs.back().index_count, indices.size(), "LODs appended to the indices");
+
+				bool shrinking = true, error_increasing = true, on_sphere = true, closed = true;
+				for (size_t i = 1; i < LODs.size(); i++)
+				{
+					shrinking        &= LODs[i].index_count < LODs[i - 1].index_count && LODs[i].index_count % 3 == 0;
+					error_increasing &= LODs[i].error >= LODs[i - 1].error && LODs[i].error <= Utility::MeshSimplifier::Default_Max_Error;
+
+					// Vertices never move, and a closed mesh stays closed. Every directed edge has its opposite.
+					std::set<std::pair<unsigned int, unsigned int>> edges;
+					for (auto index = LODs[i].first_index; index < LODs[i].first_index + LODs[i].index_count; index++)
+					{
+						on_sphere &= std::abs(glm::length(vertices[indices[index]].position) - 1.f) < 0.0001f;
+						edges.emplace(indices[index], indices[index - index % 3 + (index + 1) % 3]);
+					}
+					for (const auto& [from, to] : edges)
+						closed &= edges.contains({to, from});
+				}
+				CHECK_TRUE(shrinking, "Each LOD has fewer triangles");
+				CHECK_TRUE(error_increasing, "Each LOD has a larger error within the limit");
+				CHECK_TRUE(on_sphere, "LOD vertices are original vertices");
+				CHECK_TRUE(closed, "LODs have no holes");
+
+				// Flat shaded, every vertex is on a normal seam of 5+ wedges so nothing can collapse without smearing normals.
+				auto flat_mb = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles>{};
+				flat_mb.add_icosphere(glm::vec3(0.f), 1.f, 4);
+				auto [flat_vertices, flat_indices] = flat_mb.get_indexed_data();
+				CHECK_EQUAL(Utility::MeshSimplifier::build_LODs(flat_vertices, flat_indices).size(), 1, "Normal seams are preserved");
+			}
+		}
+		{SCOPE_SECTION("Quantise")
+			{SCOPE_SECTION("Half float")
+				// Every finite half converts to a float exactly and back to the same bits.
+				bool round_trip = true;
+				for (uint32_t half = 0; half < 0x10000; half++)
+				{
+					if (((half >> 10) & 0x1F) != 0x1F)
+						round_trip &= Data::Quantise::to_half(Data::Quantise::from_half(static_cast<uint16_t>(half))) == half;
+				}
+				CHECK_TRUE(round_trip, "Round trip");
+				CHECK_EQUAL(Data::Quantise::from_half(Data::Quantise::to_half(256.f)), 256.f, "Integer UVs are exact");
+				CHECK_EQUAL(Data::Quantise::from_half(Data::Quantise::to_half(1.f + 1.f / 2048.f)), 1.f, "Ties round to even");
+				CHECK_TRUE(std::isinf(Data::Quantise::from_half(Data::Quantise::to_half(70000.f))), "Overflow to infinity");
+			}
+			{SCOPE_SECTION("Unorm")
+				CHECK_EQUAL(Data::Quantise::to_unorm16(0.f), 0, "Unorm16 min");
+				CHECK_EQUAL(Data::Quantise::to_unorm16(1.f), 65535, "Unorm16 max");
+				CHECK_EQUAL(Data::Quantise::to_unorm16(2.f), 65535, "Unorm16 clamped");
+				CHECK_EQUAL(Data::Quantise::to_unorm8(0.5f), 128, "Unorm8 rounds to nearest");
+			}
+			{SCOPE_SECTION("Octahedral normals")
+				bool axes_exact = true;
+				for (const auto& axis : {glm::vec3(1.f, 0.f, 0.f), glm::vec3(-1.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, -1.f, 0.f), glm::vec3(0.f, 0.f, 1.f), glm::vec3(0.f, 0.f, -1.f)})
+					axes_exact &= Data::Quantise::from_octahedral(Data::Quantise::to_octahedral(axis)) == axis;
+				CHECK_TRUE(axes_exact, "Axes are exact");
+
+				// Measure the angle with atan2 of the cross and dot product, acos loses all precision at these tiny angles.
+				float max_error_degrees = 0.f;
+				auto mb = Utility::MeshBuilder<Data::PositionVertex, OpenGL::PrimitiveMode::Triangles>{};
+				mb.add_icosphere(glm::vec3(0.f), 1.f, 5);
+				const auto [sphere_vertices, sphere_indices] = mb.get_indexed_data(false);
+				for (const auto& vertex : sphere_vertices)
+				{
+					const auto normal  = glm::normalize(vertex.position);
+					const auto decoded = Data::Quantise::from_octahedral(Data::Quantise::to_octahedral(normal));
+					max_error_degrees  = std::max(max_error_degrees, glm::degrees(std::atan2(glm::length(glm::cross(normal, decoded)), glm::dot(normal, decoded))));
+				}
+				CHECK_TRUE(max_error_degrees < 0.01f, "Angular error below 0.01 degrees");
+			}
+			{SCOPE_SECTION("Vertex")
+				const glm::vec3 min = glm::vec3(-2.f, 5.f, 0.f);
+				const glm::vec3 max = glm::vec3(6.f, 5.f, 1.f); // Flat in y.
+				Data::Vertex vertex;
+				vertex.position = glm::vec3(1.234f, 5.f, 0.999f);
+				vertex.normal   = glm::vec3(0.f, 1.f, 0.f);
+				vertex.uv       = glm::vec2(3.5f, -1.f);
+				vertex.colour   = glm::vec4(1.f, 0.f, 0.5f, 1.f);
+				const auto quantised = Data::Quantise::quantise(vertex, min, max);
+
+				// Mirrors the GL vertex fetch of the normalised position followed by Data::Mesh::dequantise_matrix.
+				const auto scale    = Data::Quantise::position_scale(min, max);
+				const auto position = min + glm::vec3(quantised.position[0], quantised.position[1], quantised.position[2]) / 65535.f * scale;
+				const auto max_step = (max - min) / 65535.f;
+				CHECK_TRUE(std::abs(position.x - vertex.position.x) <= max_step.x
+					&& std::abs(position.y - vertex.position.y) <= 0.0001f
+					&& std::abs(position.z - vertex.position.z) <= max_step.z, "Position within one step");
+				CHECK_TRUE(Data::Quantise::from_octahedral({quantised.normal[0], quantised.normal[1]}) == vertex.normal, "Normal");
+				CHECK_TRUE(Data::Quantise::from_half(quantised.uv[0]) == 3.5f && Data::Quantise::from_half(quantised.uv[1]) == -1.f, "UV");
+				CHECK_TRUE(quantised.colour[0] == 255 && quantised.colour[1] == 0 && quantised.colour[2] == 128 && quantised.colour[3] == 255, "Colour");
+			}
+		}
+		{SCOPE_SECTION("State changes")
+			OpenGL::State::Get().set_polygon_mode(OpenGL::PolygonMode::Fill);
+			OpenGL::State::Get().reset_state_changes();
+			OpenGL::State::Get().set_polygon_mode(OpenGL::PolygonMode::Line);
+			OpenGL::State::Get().set_polygon_mode(OpenGL::PolygonMode::Line);
+			OpenGL::State::Get().set_polygon_mode(OpenGL::PolygonMode::Fill);
+			CHECK_EQUAL(OpenGL::State::Get().get_state_changes().fixed_function, 2, "Redundant changes are skipped");
+			CHECK_EQUAL(OpenGL::State::Get().get_state_changes().total(), 2, "Total");
+			OpenGL::State::Get().reset_state_changes();
+			CHECK_EQUAL(OpenGL::State::Get().get_state_changes().total(), 0, "Reset");
+		}
+		{SCOPE_SECTION("Radix sort")
+			// Keys spread over every byte with many duplicates, paired with their original index to check the sort is stable.
+			std::vector<std::pair<uint64_t, size_t>> items;
+			uint64_t state = 0x9E3779B97F4A7C15ull;
+			for (size_t i = 0; i < 5000; i++)
+			{
+				state ^= state << 13; state ^= state >> 7; state ^= state << 17; // xorshift64
+				items.push_back({state & 0xFF000000FFFF00FFull, i});
+			}
+			auto expected = items;
+			std::stable_sort(expected.begin(), expected.end(), [](const auto& p_a, const auto& p_b) { return p_a.first < p_b.first; });
+
+			std::vector<std::pair<uint64_t, size_t>> scratch;
+			Utility::radix_sort(items, scratch, [](const auto& p_item) { return p_item.first; });
+			CHECK_TRUE(items == expected, "Matches std::stable_sort");
+
+			// Keys sharing every byte skip all the passes.
+			std::vector<uint32_t> equal_keys(100, 7u);
+			std::vector<uint32_t> equal_scratch;
+			Utility::radix_sort(equal_keys, equal_scratch, [](uint32_t p_key) { return p_key; });
+			CHECK_TRUE(std::all_of(equal_keys.begin(), equal_keys.end(), [](uint32_t p_key) { return p_key == 7u; }), "Equal keys");
+
+			std::vector<uint16_t> small_keys = {3, 1, 2};
+			std::vector<uint16_t> small_scratch;
+			Utility::radix_sort(small_keys, small_scratch, [](uint16_t p_key) { return p_key; });
+			CHECK_TRUE(small_keys == std::vector<uint16_t>({1, 2, 3}), "16-bit keys");
+
+			std::vector<float> floats = {3.5f, -0.f, -1e30f, 0.f, 2.f, -2.5f, 1e-30f, -1e-30f, std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()};
+			auto sorted_floats = floats;
+			std::stable_sort(sorted_floats.begin(), sorted_floats.end());
+			std::vector<float> float_scratch;
+			Utility::radix_sort(floats, float_scratch, [](float p_value) { return Utility::sortable_key(p_value); });
+			CHECK_TRUE(floats == sorted_floats, "Float keys");
+		}
+		{SCOPE_SECTION("UniformID")
+			const OpenGL::UniformID model{"model"};
+			const size_t count = OpenGL::UniformID::count();
+			CHECK_TRUE(OpenGL::UniformID{"model"} == model, "Same identifier same ID");
+			CHECK_EQUAL(OpenGL::UniformID::count(), count, "Interned once");
+			CHECK_TRUE(OpenGL::UniformID{"view"} != model, "Different identifier different ID");
+			CHECK_TRUE(model.identifier() == "model", "Identifier");
+			CHECK_TRUE(model.index() < OpenGL::UniformID::count(), "Dense index");
+		}
+		{SCOPE_SECTION("Instance batcher")
+			// Instances are told apart by the x translation of their model matrix.
+			auto instance = [](float p_index)
+			{
+				auto model  = glm::mat4(1.f);
+				model[3][0] = p_index;
+				return OpenGL::InstanceData{model, glm::vec4(1.f), 32.f};
+			};
+			const OpenGL::InstanceBatcher::Key LOD_1 = {nullptr, 1, nullptr, nullptr, nullptr};
+			const OpenGL::InstanceBatcher::Key LOD_0 = {nullptr, 0, nullptr, nullptr, nullptr};
+
+			OpenGL::InstanceBatcher batcher;
+			batcher.push(LOD_1, instance(0.f));
+			batcher.push(LOD_0, instance(1.f));
+			batcher.push(LOD_1, instance(2.f));
+			batcher.push(LOD_1, instance(3.f));
+			batcher.push(LOD_0, instance(4.f));
+			batcher.build();
+
+			const auto& groups    = batcher.groups();
+			const auto& instances = batcher.instances();
+			CHECK_EQUAL(groups.size(), 2, "Group count");
+			CHECK_TRUE(groups[0].key == LOD_0 && groups[0].first_instance == 0 && groups[0].instance_count == 2, "First group");
+			CHECK_TRUE(groups[1].key == LOD_1 && groups[1].first_instance == 2 && groups[1].instance_count == 3, "Second group");
+
+			std::vector<float> order;
+			for (const auto& data : instances)
+				order.push_back(data.model[3][0]);
+			CHECK_TRUE(order == std::vector<float>({1.f, 4.f, 0.f, 2.f, 3.f}), "Instances keep their push order within a group");
+
+			OpenGL::RingBuffer ring{1024};
+			const auto range = batcher.upload(ring);
+			std::vector<OpenGL::InstanceData> uploaded(instances.size());
+			OpenGL::get_named_buffer_sub_data(range.handle, range.offset, range.size, uploaded.data());
+			CHECK_EQUAL(static_cast<size_t>(range.size), instances.size() * sizeof(OpenGL::InstanceData), "Upload size");
+			CHECK_TRUE(std::equal(uploaded.begin(), uploaded.end(), instances.begin(), [](const auto& p_a, const auto& p_b) { return p_a.model == p_b.model; }), "Upload");
+
+			batcher.build();
+			CHECK_TRUE(batcher.groups().empty() && batcher.instances().empty(), "Build consumes the pushed instances");
+
+			{SCOPE_SECTION("Back to front")
+				// Depths interleave the two LODs so only neighbours in depth order share a group.
+				batcher.push(LOD_0, instance(0.f), 5.f);
+				batcher.push(LOD_1, instance(1.f), 20.f);
+				batcher.push(LOD_0, instance(2.f), 30.f);
+				batcher.push(LOD_0, instance(3.f), 25.f);
+				batcher.push(LOD_1, instance(4.f), 10.f);
+				batcher.push(LOD_1, instance(5.f), 10.f);
+				batcher.build_back_to_front();
+
+				std::vector<float> back_to_front;
+				for (const auto& data : batcher.instances())
+					back_to_front.push_back(data.model[3][0]);
+				CHECK_TRUE(back_to_front == std::vector<float>({2.f, 3.f, 1.f, 4.f, 5.f, 0.f}), "Instances ordered farthest first, equal depths in push order");
+
+				const auto& sorted_groups = batcher.groups();
+				CHECK_EQUAL(sorted_groups.size(), 3, "Group count");
+				CHECK_TRUE(sorted_groups[0].key == LOD_0 && sorted_groups[0].instance_count == 2 && sorted_groups[0].depth == 30.f, "Farthest group");
+				CHECK_TRUE(sorted_groups[1].key == LOD_1 && sorted_groups[1].instance_count == 3 && sorted_groups[1].depth == 20.f, "Middle group");
+				CHECK_TRUE(sorted_groups[2].key == LOD_0 && sorted_groups[2].instance_count == 1 && sorted_groups[2].depth == 5.f, "Nearest group");
+			}
+		}
+		{SCOPE_SECTION("Ring buffer")
+			const auto alignment = static_cast<GLintptr>(std::max(OpenGL::get_uniform_buffer_offset_alignment(), OpenGL::get_shader_storage_buffer_offset_alignment()));
+
+			OpenGL::RingBuffer ring{1024};
+			const auto first  = ring.push(glm::vec4(1.f));
+			const auto second = ring.push(glm::vec4(2.f));
+			CHECK_EQUAL(first.offset, 0, "First allocation at the start of the first region");
+			CHECK_TRUE(second.offset > first.offset && second.offset % alignment == 0, "Allocations aligned for binding");
+			CHECK_EQUAL(static_cast<size_t>(second.size), sizeof(glm::vec4), "Allocation size unpadded");
+
+			glm::vec4 read_back;
+			OpenGL::get_named_buffer_sub_data(second.handle, second.offset, second.size, &read_back);
+			CHECK_TRUE(read_back == glm::vec4(2.f), "Writes visible to GL without a flush");
+
+			ring.end_frame();
+			const auto next_frame = ring.push(glm::vec4(3.f));
+			CHECK_EQUAL(static_cast<size_t>(next_frame.offset), ring.region_size(), "Next frame writes the next region");
+
+			ring.end_frame();
+			ring.push(glm::vec4(4.f));
+			ring.end_frame();
+			const auto wrapped = ring.push(glm::vec4(5.f));
+			CHECK_EQUAL(wrapped.offset, 0, "Wraps back to the first region after Region_Count frames");
+
+			const auto grown = ring.allocate(ring.region_size() + 1);
+			CHECK_TRUE(grown.handle != wrapped.handle && ring.region_size() >= static_cast<size_t>(grown.size), "Full region grows the ring");
+			ring.end_frame();
+		}
+		{SCOPE_SECTION("Light clusters")
+			const glm::uvec2 resolution = {1600, 900};
+			// The cluster phong.frag reads for a view space position, through the same projection and pixel mapping as the GPU.
+			auto cluster_of = [&resolution](const OpenGL::LightClusters& p_clusters, const glm::mat4& p_projection, const glm::vec3& p_position)
+			{
+				const glm::vec4 clip  = p_projection * glm::vec4(p_position, 1.f);
+				const glm::vec2 pixel = ((glm::vec2(clip.x, clip.y) / clip.w) * 0.5f + glm::vec2(0.5f)) * glm::vec2(resolution);
+				return p_clusters.cluster_index(p_clusters.cluster_at(pixel, -p_position.z));
+			};
+			auto on_screen = [](const glm::mat4& p_projection, const glm::vec3& p_position)
+			{
+				const glm::vec4 clip = p_projection * glm::vec4(p_position, 1.f);
+				return clip.w > 0.f && std::abs(clip.x) <= clip.w && std::abs(clip.y) <= clip.w && std::abs(clip.z) <= clip.w;
+			};
+			auto lists = [](const OpenGL::LightClusters& p_clusters, size_t p_cluster, uint32_t p_light, bool p_spot)
+			{
+				const auto& cluster = p_clusters.clusters()[p_cluster];
+				const auto begin    = p_clusters.light_indices().begin() + cluster.offset + (p_spot ? cluster.point_count : 0);
+				const auto end      = begin + (p_spot ? cluster.spot_count : cluster.point_count);
+				return std::find(begin, end, p_light) != end;
+			};
+
+			{SCOPE_SECTION("Attenuation radius")
+				const float radius = OpenGL::LightClusters::attenuation_radius(1.f, 0.09f, 0.032f, 1.f);
+				CHECK_EQUAL_FLOAT(1.f / (1.f + (0.09f * radius) + (0.032f * radius * radius)), 1.f / 256.f, "Quadratic", 0.00001f);
+				CHECK_EQUAL(OpenGL::LightClusters::attenuation_radius(1.f, 0.5f, 0.f, 1.f), 510.f, "Linear");
+				CHECK_TRUE(std::isinf(OpenGL::LightClusters::attenuation_radius(1.f, 0.f, 0.f, 1.f)), "No falloff");
+			}
+
+			const std::array<std::pair<const char*, glm::mat4>, 2> projections = {{
+				{"Perspective",  glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.04f, 10000000.f)},
+				{"Orthographic", glm::ortho(-16.f, 16.f, -9.f, 9.f, 0.04f, 1000.f)}
+			}};
+			for (const auto& [name, projection] : projections)
+			{SCOPE_SECTION(name)
+				OpenGL::LightClusters clusters;
+				clusters.build_grid(projection, resolution);
+
+				// Enough lights for the assignment to run on several threads, those off screen have no cluster at their position to check.
+				std::vector<OpenGL::LightClusters::PointLight> point_lights;
+				std::vector<OpenGL::LightClusters::SpotLight> spot_lights;
+				for (int i = 0; i < 400; i++)
+				{
+					const float depth = 0.5f + static_cast<float>(i % 40) * 2.f;
+					const float x     = (static_cast<float>(i % 7) - 3.f) / 3.f;
+					const float y     = (static_cast<float>(i % 5) - 2.f) / 2.f;
+					point_lights.push_back({glm::vec3(x * 8.f, y * 4.f, -depth), 0.25f + static_cast<float>(i % 3)});
+					spot_lights.push_back({glm::vec3(y * 8.f, x * 4.f, -depth), 4.f, glm::normalize(glm::vec3(x, y, -1.f)), 0.4f});
+				}
+				clusters.assign(point_lights, spot_lights);
+
+				bool points_listed = true;
+				for (uint32_t i = 0; i < point_lights.size(); i++)
+					if (on_screen(projection, point_lights[i].position))
+						points_listed &= lists(clusters, cluster_of(clusters, projection, point_lights[i].position), i, false);
+				CHECK_TRUE(points_listed, "Point lights listed in the cluster at their centre");
+
+				bool spots_listed = true;
+				for (uint32_t i = 0; i < spot_lights.size(); i++)
+					if (on_screen(projection, spot_lights[i].position + spot_lights[i].direction))
+						spots_listed &= lists(clusters, cluster_of(clusters, projection, spot_lights[i].position + spot_lights[i].direction), i, true);
+				CHECK_TRUE(spots_listed, "Spot lights listed in the cluster along their axis");
+
+				size_t listed = 0;
+				for (const auto& cluster : clusters.clusters())
+					listed += cluster.point_count + cluster.spot_count;
+				CHECK_EQUAL(listed, clusters.light_indices().size(), "Cluster lists cover the light indices");
+				CHECK_TRUE(clusters.light_indices().size() < clusters.clusters().size() * (point_lights.size() + spot_lights.size()), "Lights culled from clusters");
+
+				const OpenGL::LightClusters::PointLight behind = {glm::vec3(0.f, 0.f, 5.f), 1.f};
+				clusters.assign(std::span(&behind, 1), {});
+				CHECK_TRUE(clusters.light_indices().empty(), "Light behind the view in no cluster");
+			}
+		}
+		{SCOPE_SECTION("Shadow cascades")
+			using ShadowMapper = OpenGL::ShadowMapper;
+
+			{SCOPE_SECTION("Split depths")
+				const auto logarithmic = ShadowMapper::split_depths(1.f, 1000.f, 3, 1.f);
+				CHECK_EQUAL_FLOAT(logarithmic[0], 10.f, "Logarithmic first split", 0.001f);
+				CHECK_EQUAL_FLOAT(logarithmic[1], 100.f, "Logarithmic second split", 0.01f);
+				CHECK_EQUAL(logarithmic[2], 1000.f, "Last split at far depth");
+				const auto uniform = ShadowMapper::split_depths(1.f, 1000.f, 3, 0.f);
+				CHECK_EQUAL_FLOAT(uniform[0], 334.f, "Uniform first split", 0.001f);
+				CHECK_EQUAL_FLOAT(uniform[1], 667.f, "Uniform second split", 0.001f);
+			}
+
+			const float resolution         = 2048.f;
+			const glm::vec3 light_direction = glm::normalize(glm::vec3(0.3f, -0.4f, -1.f));
+			const Geometry::AABB scene_bounds(glm::vec3(-100.f, -100.f, -5.f), glm::vec3(100.f, 100.f, 20.f));
+			auto camera_at = [](const glm::vec3& p_position, const glm::vec3& p_forward)
+			{
+				Component::ViewInformation view_info;
+				view_info.m_view       = glm::lookAt(p_position, p_position + p_forward, glm::vec3(0.f, 0.f, 1.f));
+				view_info.m_projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 500.f);
+				return view_info;
+			};
+			// Whether the world space p_position is inside the light volume of p_fit.
+			auto inside = [](const ShadowMapper::Fit& p_fit, const glm::vec3& p_position)
+			{
+				const glm::vec4 clip = p_fit.light_proj_view * glm::vec4(p_position, 1.f);
+				return std::abs(clip.x) <= clip.w && std::abs(clip.y) <= clip.w && std::abs(clip.z) <= clip.w;
+			};
+
+			const auto view_info = camera_at(glm::vec3(0.f, 0.f, 2.f), glm::vec3(1.f, 0.f, 0.f));
+			const auto fit       = ShadowMapper::fit_cascade(view_info, 10.f, 40.f, light_direction, scene_bounds, resolution, 0.1f);
+			{SCOPE_SECTION("Fit")
+				bool covered = true;
+				const glm::mat4 inverse_view_proj = glm::inverse(view_info.m_projection * view_info.m_view);
+				for (float depth : {10.f, 40.f})
+				{
+					for (const glm::vec2 NDC : {glm::vec2(-1.f, -1.f), glm::vec2(1.f, -1.f), glm::vec2(-1.f, 1.f), glm::vec2(1.f, 1.f)})
+					{
+						// Walk the corner line of the view volume to the view depth of the cascade boundary.
+						const glm::vec4 near_point = inverse_view_proj * glm::vec4(NDC, -1.f, 1.f);
+						const glm::vec3 near_world = glm::vec3(near_point) / near_point.w;
+						const glm::vec3 direction  = glm::normalize(near_world - glm::vec3(0.f, 0.f, 2.f));
+						covered &= inside(fit, glm::vec3(0.f, 0.f, 2.f) + direction * (depth / direction.x));
+					}
+				}
+				CHECK_TRUE(covered, "Corners of the depth range inside the light volume");
+				CHECK_TRUE(inside(fit, glm::vec3(20.f, 0.f, 2.f) - light_direction * 15.f), "Caster between the light and the depth range inside the light volume");
+
+				const float texel_size = 2.f * fit.half_extent / resolution;
+				const glm::vec2 texels = fit.center / texel_size;
+				CHECK_EQUAL_FLOAT(texels.x, std::round(texels.x), "Centre snapped to a texel on x", 0.01f);
+				CHECK_EQUAL_FLOAT(texels.y, std::round(texels.y), "Centre snapped to a texel on y", 0.01f);
+
+				const auto turned = ShadowMapper::fit_cascade(camera_at(glm::vec3(0.f, 0.f, 2.f), glm::vec3(0.f, 1.f, 0.f)), 10.f, 40.f, light_direction, scene_bounds, resolution, 0.1f);
+				CHECK_EQUAL_FLOAT(turned.half_extent, fit.half_extent, "Volume size unchanged by turning the camera", 0.0001f);
+			}
+			{SCOPE_SECTION("Covers")
+				CHECK_TRUE(fit.covers(fit), "Covers itself");
+				const auto nudged = ShadowMapper::fit_cascade(camera_at(glm::vec3(0.5f, 0.f, 2.f), glm::vec3(1.f, 0.f, 0.f)), 10.f, 40.f, light_direction, scene_bounds, resolution, 0.1f);
+				CHECK_TRUE(fit.covers(nudged), "Covers a camera moved within the padding");
+				const auto moved = ShadowMapper::fit_cascade(camera_at(glm::vec3(30.f, 0.f, 2.f), glm::vec3(1.f, 0.f, 0.f)), 10.f, 40.f, light_direction, scene_bounds, resolution, 0.1f);
+				CHECK_TRUE(!fit.covers(moved), "Camera moved past the padding not covered");
+			}
+		}
+		{SCOPE_SECTION("Command stream")
+			using Command = OpenGL::CommandStream::Command;
+			auto& state   = OpenGL::State::Get();
+
+			std::array<unsigned int, 8> data = {1, 2, 3, 4, 5, 6, 7, 8};
+			OpenGL::Buffer in_buffer  = OpenGL::Buffer({OpenGL::BufferStorageFlag::DynamicStorageBit}, std::array<unsigned int, 8>{});
+			OpenGL::Buffer out_buffer = OpenGL::Buffer({OpenGL::BufferStorageFlag::DynamicStorageBit}, std::array<unsigned int, 8>{});
+			OpenGL::Shader shader     = OpenGL::Shader("increment.comp");
+
+			OpenGL::CommandStream stream;
+			state.set_polygon_mode(OpenGL::PolygonMode::Fill);
+			state.reset_state_changes();
+			state.begin_recording(stream);
+			state.set_polygon_mode(OpenGL::PolygonMode::Line);
+			state.set_polygon_mode(OpenGL::PolygonMode::Line);
+			in_buffer.set_data(data, 0);
+			OpenGL::DrawCall compute_call;
+			compute_call.set_SSBO("DataIn", in_buffer);
+			compute_call.set_SSBO("DataOut", out_buffer);
+			compute_call.submit_compute(shader, 8, 1, 1);
+			state.end_recording();
+
+			CHECK_EQUAL(stream.count(Command::PolygonMode), 2, "Starting state and the change recorded, the redundant change skipped");
+			CHECK_EQUAL(stream.count(Command::BufferSubData), 1, "Upload recorded");
+			CHECK_EQUAL(stream.count(Command::BindShaderStorageBuffer), 2, "Bindings recorded");
+			CHECK_EQUAL(stream.draw_count(), 1, "Draw count");
+			CHECK_EQUAL(state.get_state_changes().fixed_function, 1, "State changes counted while recording");
+
+			const auto not_issued = out_buffer.download_data<unsigned int>(data.size());
+			CHECK_TRUE(std::all_of(not_issued.begin(), not_issued.end(), [](unsigned int p_value) { return p_value == 0; }), "Nothing issued while recording");
+
+			state.set_polygon_mode(OpenGL::PolygonMode::Fill);
+			stream.replay();
+			const auto replayed = out_buffer.download_data<unsigned int>(data.size());
+			CHECK_TRUE(replayed == std::vector<unsigned int>({2, 3, 4, 5, 6, 7, 8, 9}), "Replay");
+
+			state.reset_state_changes();
+			state.set_polygon_mode(OpenGL::PolygonMode::Line);
+			CHECK_EQUAL(state.get_state_changes().total(), 0, "State follows the replayed changes");
+			state.set_polygon_mode(OpenGL::PolygonMode::Fill);
+
+			stream.clear();
+			CHECK_TRUE(stream.empty() && stream.size_bytes() == 0, "Clear");
+
+			// Growing a buffer copies the recorded upload into a new buffer and deletes the old one, both must replay after the upload.
+			state.begin_recording(stream);
+			in_buffer.set_data(data, 0);
+			in_buffer.reserve(in_buffer.capacity() * 2);
+			out_buffer.clear();
+			state.end_recording();
+			CHECK_EQUAL(stream.count(Command::CopyBufferSubData), 1, "Copy recorded");
+			CHECK_EQUAL(stream.count(Command::ClearBufferSubData), 1, "Clear recorded");
+			CHECK_EQUAL(stream.count(Command::DeleteBuffer), 1, "Delete recorded");
+
+			stream.replay();
+			const auto copied = in_buffer.download_data<unsigned int>(data.size());
+			CHECK_TRUE(copied == std::vector<unsigned int>(data.begin(), data.end()), "Copy replayed after the upload");
+			const auto cleared = out_buffer.download_data<unsigned int>(data.size());
+			CHECK_TRUE(std::all_of(cleared.begin(), cleared.end(), [](unsigned int p_value) { return p_value == 0; }), "Clear replayed");
+			stream.clear();
+		}
+		{SCOPE_SECTION("Render queue")
+			using Pass = OpenGL::RenderQueue::Pass;
+
+			std::array<glm::vec3, 3> triangle = {glm::vec3(0.f), glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f)};
+			OpenGL::Buffer vertex_buffer = OpenGL::Buffer({OpenGL::BufferStorageFlag::DynamicStorageBit}, triangle);
+			OpenGL::VAO VAO;
+			VAO.set_vertex_attrib_pointers(OpenGL::PrimitiveMode::Triangles, {{0, 3, OpenGL::BufferDataType::Float, 0, 0, false}});
+			VAO.attach_buffer(vertex_buffer, 0, 0, sizeof(glm::vec3), static_cast<GLsizei>(triangle.size()));
+			OpenGL::FBO FBO{glm::uvec2(4, 4)};
+			OpenGL::Shader shader = OpenGL::Shader("uniformColour");
+
+			// The renderer draws the terrain between the passes, the transparent draws must stay queued until it's drawn.
+			OpenGL::RenderQueue queue;
+			OpenGL::DrawCall draw_call;
+			queue.push(OpenGL::RenderQueue::make_key(Pass::Transparent, shader, nullptr, VAO, 1.f), draw_call, shader, VAO, FBO);
+			queue.push(OpenGL::RenderQueue::make_key(Pass::Opaque, shader, nullptr, VAO, 1.f), draw_call, shader, VAO, FBO);
+			queue.push(OpenGL::RenderQueue::make_key(Pass::Opaque, shader, nullptr, VAO, 2.f), draw_call, shader, VAO, FBO);
+
+			OpenGL::CommandStream stream;
+			auto& state = OpenGL::State::Get();
+			state.begin_recording(stream);
+			queue.submit(Pass::Opaque);
+			const size_t opaque_draws = stream.draw_count();
+			const size_t queued       = queue.size();
+			queue.submit(Pass::Transparent);
+			state.end_recording();
+
+			CHECK_EQUAL(opaque_draws, 2, "Opaque pass submits only the opaque draws");
+			CHECK_EQUAL(queued, 1, "Transparent draws stay queued after the opaque pass");
+			CHECK_EQUAL(queue.submitted_count(), 1, "Transparent pass submits the rest");
+			CHECK_EQUAL(stream.draw_count(), 3, "Draw count");
+			CHECK_TRUE(queue.empty(), "Queue empty once every pass is submitted");
+		}
+
 		Platform::Core::deinitialise_GLFW();
 	}
 
 	void GraphicsTester::run_performance_tests()
 	{
+		// Vertex cache efficiency of the built-in primitives before and after MeshOptimiser. Lower is better for both metrics.
+		auto report = [](const char* p_name, const auto& p_mesh_builder)
+		{
+			const auto [welded_vertices, welded_indices]       = p_mesh_builder.get_indexed_data(false);
+			const auto [optimised_vertices, optimised_indices] = p_mesh_builder.get_indexed_data(true);
+			printf("%-22s %7zu tris | ACMR %.3f -> %.3f | ATVR %.3f -> %.3f\n", p_name, welded_indices.size() / 3,
+				Utility::MeshOptimiser::ACMR(welded_indices, welded_vertices.size()), Utility::MeshOptimiser::ACMR(optimised_indices, optimised_vertices.size()),
+				Utility::MeshOptimiser::ATVR(welded_indices, welded_vertices.size()), Utility::MeshOptimiser::ATVR(optimised_indices, optimised_vertices.size()));
+		};
+
+		using MeshBuilder = Utility::MeshBuilder<Data::Vertex, OpenGL::PrimitiveMode::Triangles>;
+		{
+			auto mb = MeshBuilder{};
+			mb.add_quad(glm::vec3(-1.f, 0.f, -1.f), glm::vec3(1.f, 0.f, -1.f), glm::vec3(-1.f, 0.f, 1.f), glm::vec3(1.f, 0.f, 1.f));
+			report("Quad", mb);
+		}
+		{
+			auto mb = MeshBuilder{};
+			mb.add_cuboid(Geometry::Cuboid(glm::vec3(0.f)));
+			report("Cuboid", mb);
+		}
+		{
+			auto mb = MeshBuilder{};
+			mb.add_cone(glm::vec3(0.f, -1.f, 0.f), glm::vec3(0.f, 1.f, 0.f), 1.f, 64);
+			report("Cone (64 segments)", mb);
+		}
+		{
+			auto mb = MeshBuilder{};
+			mb.add_cylinder(glm::vec3(0.f, -1.f, 0.f), glm::vec3(0.f, 1.f, 0.f), 1.f, 64);
+			report("Cylinder (64 segments)", mb);
+		}
+		{
+			auto mb = MeshBuilder{};
+			mb.add_arrow(glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f), 64);
+			report("Arrow (64 segments)", mb);
+		}
+		for (size_t subdivisions = 1; subdivisions <= 6; subdivisions++)
+		{
+			auto mb = MeshBuilder{};
+			mb.add_icosphere(glm::vec3(0.f), 1.f, subdivisions);
+			report(std::format("Icosphere ({})", subdivisions).c_str(), mb);
+		}
+
+		// Sorting a frame of render queue keys: few distinct shaders, textures and VAOs in the high bits, distinct depths in the low bits.
+		{
+			constexpr size_t draw_count = 100000;
+			std::vector<std::pair<uint64_t, uint32_t>> keys;
+			for (uint32_t i = 0; i < draw_count; i++)
+			{
+				const uint64_t shader  = i % 7;
+				const uint64_t texture = (i * 2654435761u) % 40;
+				const uint64_t VAO     = (i * 40503u) % 300;
+				const uint64_t depth   = (i * 2246822519u) & 0xFFFF;
+				keys.push_back({shader << 48 | texture << 32 | VAO << 16 | depth, i});
+			}
+
+			auto std_sorted = keys;
+			Utility::Stopwatch std_stopwatch;
+			std::stable_sort(std_sorted.begin(), std_sorted.end(), [](const auto& p_a, const auto& p_b) { return p_a.first < p_b.first; });
+			const float std_ms = std_stopwatch.duration_since_start<float, std::milli>().count();
+
+			auto radix_sorted = keys;
+			std::vector<std::pair<uint64_t, uint32_t>> scratch;
+			Utility::Stopwatch radix_stopwatch;
+			Utility::radix_sort(radix_sorted, scratch, [](const auto& p_key) { return p_key.first; });
+			const float radix_ms = radix_stopwatch.duration_since_start<float, std::milli>().count();
+
+			printf("Render queue sort %zu keys | std::stable_sort %7.3fms | radix sort %7.3fms | %.1fx | %s\n",
+				draw_count, std_ms, radix_ms, std_ms / radix_ms, radix_sorted == std_sorted ? "match" : "MISMATCH");
+		}
 	}
 } // namespace Test
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "RendererTester.hpp"
+
+#include "OpenGL/CommandStream.hpp"
+#include "OpenGL/DebugRenderer.hpp"
+#include "OpenGL/GLState.hpp"
+#include "OpenGL/NullGL.hpp"
+#include "OpenGL/OpenGLRenderer.hpp"
+#include "OpenGL/Types.hpp"
+
+#include "System/AssetManager.hpp"
+#include "System/SceneSystem.hpp"
+
+#include "Component/Collider.hpp"
+#include "Component/FirstPersonCamera.hpp"
+#include "Component/Input.hpp"
+#include "Component/Label.hpp"
+#include "Component/Lights.hpp"
+#include "Component/Mesh.hpp"
+#include "Component/ParticleEmitter.hpp"
+#include "Component/Terrain.hpp"
+#include "Component/Texture.hpp"
+#include "Component/Transform.hpp"
+
+#include "ECS/Component.hpp"
+#include "Platform/Core.hpp"
+#include "Utility/Config.hpp"
+
+namespace Test
+{
+	void RendererTester::run_unit_tests()
+	{
+		ECS::Component::set_info<Component::Collider>();
+		ECS::Component::set_info<Component::FirstPersonCamera>();
+		ECS::Component::set_info<Component::Input>();
+		ECS::Component::set_info<Component::Label>();
+		ECS::Component::set_info<Component::PointLight>();
+		ECS::Component::set_info<Component::DirectionalLight>();
+		ECS::Component::set_info<Component::SpotLight>();
+		ECS::Component::set_info<Component::Mesh>();
+		ECS::Component::set_info<Component::ParticleEmitter>();
+		ECS::Component::set_info<Component::Terrain>();
+		ECS::Component::set_info<Component::Texture>();
+		ECS::Component::set_info<Component::Transform>();
+
+		Platform::Core::initialise_directories();
+		OpenGL::NullGL::initialise();
+		OpenGL::DebugRenderer::init();
+
+		{SCOPE_SECTION("Draw scene")
+			System::AssetManager asset_manager;
+			System::SceneSystem scene_system(asset_manager);
+			OpenGL::OpenGLRenderer renderer(asset_manager, scene_system);
+			OpenGL::FBO target_FBO{glm::uvec2(1920, 1080)};
+			scene_system.get_current_scene().update(16.f / 9.f);
+
+			auto& state = OpenGL::State::Get();
+			// Record one frame of the scene, the draws and state changes it made.
+			auto record_frame = [&](OpenGL::CommandStream& p_stream)
+			{
+				state.begin_recording(p_stream);
+				renderer.draw(DeltaTime(1.f / 60.f), target_FBO);
+				state.end_recording();
+				return std::make_pair(p_stream.draw_count(), state.get_state_changes());
+			};
+
+			OpenGL::CommandStream first_frame;
+			const auto [first_draws, first_changes] = record_frame(first_frame);
+			CHECK_TRUE(first_draws > 0, "Draws recorded");
+			CHECK_TRUE(first_changes.programs > 0 && first_changes.programs <= first_draws, "Program changes at most one per draw");
+			CHECK_TRUE(first_changes.VAOs > 0 && first_changes.VAOs <= first_draws, "VAO changes at most one per draw");
+			CHECK_TRUE(first_changes.buffers > 0, "Buffers bound");
+			CHECK_TRUE(first_changes.textures > 0, "Textures bound");
+
+			const size_t issued_draws = OpenGL::NullGL::draw_count();
+			first_frame.replay();
+			CHECK_EQUAL(OpenGL::NullGL::draw_count() - issued_draws, first_draws, "Replay issues every recorded draw");
+
+			// The camera and lights haven't moved, the depth maps of the shadow cascades are reused.
+			OpenGL::CommandStream second_frame;
+			const auto [second_draws, second_changes] = record_frame(second_frame);
+			CHECK_TRUE(second_draws < first_draws, "Unchanged frame reuses the shadow cascades");
+			CHECK_TRUE(second_changes.programs <= second_draws && second_changes.VAOs <= second_draws, "State changes at most one per draw");
+
+			renderer.m_draw_grid = false;
+			OpenGL::CommandStream no_grid_frame;
+			const size_t no_grid_draws = record_frame(no_grid_frame).first;
+			const size_t grid_draws    = OpenGL::DebugRenderer::m_debug_options.m_show_origin_arrows ? 2 : 1;
+			CHECK_EQUAL(second_draws - no_grid_draws, grid_draws, "Grid draws skipped");
+		}
+
+		OpenGL::DebugRenderer::deinit();
+		OpenGL::NullGL::deinitialise();
+	}
+} // namespace Test
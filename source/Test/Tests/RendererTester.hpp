@@ -0,0 +1,16 @@
+#pragma once
+
+#include "TestManager.hpp"
+
+namespace Test
+{
+	// Draws scenes through OpenGLRenderer on the null GL backend, runs without a window or GPU.
+	class RendererTester : public TestManager
+	{
+	public:
+		RendererTester() : TestManager(std::string("RENDERER")) {}
+
+		void run_unit_tests()        override;
+		void run_performance_tests() override {};
+	};
+} // namespace Test
@@ -123,7 +123,11 @@ namespace UI
 						m_debug_selection_ray     = cursor_ray;
 
 						const bool ctrl_held = m_input.is_modifier_down(Platform::Modifier::Control);
-						if (auto ent = m_physics_system.cast_ray(cursor_ray))
+						// Pick against the triangles of rendered meshes first, colliders without a mesh are only reachable through physics.
+						auto ent = m_scene_system.get_current_scene().cast_ray(cursor_ray);
+						if (!ent)
+							ent = m_physics_system.cast_ray(cursor_ray);
+						if (ent)
 						{
 							if (ctrl_held)
 							{
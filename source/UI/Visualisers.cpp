@@ -263,17 +263,18 @@ namespace UI
 			auto entity_1_mesh      = &p_scene.m_entities.get_component<Component::Mesh>(p_entity_1);
 			auto entity_2_mesh      = &p_scene.m_entities.get_component<Component::Mesh>(p_entity_2);
 
-			if (entity_1_transform && entity_2_transform && entity_1_mesh && entity_2_mesh && entity_1_mesh->m_mesh && entity_2_mesh->m_mesh)
+			if (entity_1_transform && entity_2_transform && entity_1_mesh && entity_2_mesh && entity_1_mesh->m_mesh && entity_2_mesh->m_mesh
+			    && !entity_1_mesh->m_mesh->collision_hull.empty() && !entity_2_mesh->m_mesh->collision_hull.empty())
 			{
 				{ // Render a debug point cloud of the Minkowski difference.
 					ImGui::Separator();
-					ImGui::Text("Mesh 1 vertex count", entity_1_mesh->m_mesh->vertex_positions.size());
-					ImGui::Text("Mesh 2 vertex count", entity_2_mesh->m_mesh->vertex_positions.size());
+					ImGui::Text("Mesh 1 vertex count", entity_1_mesh->m_mesh->collision_hull.m_vertices.size());
+					ImGui::Text("Mesh 2 vertex count", entity_2_mesh->m_mesh->collision_hull.m_vertices.size());
 					ImGui::Text("Current step", p_debug_step + 1);
 
 					// The GJK algorithm avoids ever doing this by transforming the support point directions into the local space of the objects and transforming the result.
-					for (auto& vertex_1 : entity_1_mesh->m_mesh->vertex_positions)
-						for (auto& vertex_2 : entity_2_mesh->m_mesh->vertex_positions)
+					for (auto& vertex_1 : entity_1_mesh->m_mesh->collision_hull.m_vertices)
+						for (auto& vertex_2 : entity_2_mesh->m_mesh->collision_hull.m_vertices)
 						{
 							auto vertex_1_world_space = glm::vec3(entity_1_transform->get_model() * glm::vec4(vertex_1, 1.f));
 							auto vertex_2_world_space = glm::vec3(entity_2_transform->get_model() * glm::vec4(vertex_2, 1.f));
@@ -283,9 +284,11 @@ namespace UI
 
 				// Start direction is the vector between the two entities. Improvement would be to use the previous GJK result as the starting direction.
 				glm::vec3 direction = glm::normalize(entity_2_transform->m_position - entity_1_transform->m_position);
+				GJK::SupportCache support_cache;
 				GJK::Simplex simplex = {GJK::support_point(direction,
-				                                           entity_1_mesh->m_mesh->vertex_positions, entity_1_transform->get_model(), entity_1_transform->m_orientation,
-				                                           entity_2_mesh->m_mesh->vertex_positions, entity_2_transform->get_model(), entity_2_transform->m_orientation)};
+				                                           entity_1_mesh->m_mesh->collision_hull, entity_1_transform->get_model(), entity_1_transform->m_orientation,
+				                                           entity_2_mesh->m_mesh->collision_hull, entity_2_transform->get_model(), entity_2_transform->m_orientation,
+				                                           support_cache)};
 				direction = -simplex[0]; // AO, search in the direction of the origin. Reversed direction to point towards the origin.
 
 				std::optional<bool> intersecting;
@@ -297,8 +300,9 @@ namespace UI
 					while (true) // Main GJK loop. Converge on a simplex that encloses the origin.
 					{
 						auto new_support_point = GJK::support_point(direction,
-						                                            entity_1_mesh->m_mesh->vertex_positions, entity_1_transform->get_model(), entity_1_transform->m_orientation,
-						                                            entity_2_mesh->m_mesh->vertex_positions, entity_2_transform->get_model(), entity_2_transform->m_orientation);
+						                                            entity_1_mesh->m_mesh->collision_hull, entity_1_transform->get_model(), entity_1_transform->m_orientation,
+						                                            entity_2_mesh->m_mesh->collision_hull, entity_2_transform->get_model(), entity_2_transform->m_orientation,
+						                                            support_cache);
 
 						if (glm::dot(new_support_point, direction) <= 0.f)
 						{// If the new support point is not past the origin then its impossible to enclose the origin.
@@ -337,8 +341,9 @@ namespace UI
 						if (*intersecting)
 						{
 							auto cp = GJK::EPA(simplex,
-											entity_1_mesh->m_mesh->vertex_positions, entity_1_transform->get_model(), entity_1_transform->m_orientation,
-											entity_2_mesh->m_mesh->vertex_positions, entity_2_transform->get_model(), entity_2_transform->m_orientation);
+											entity_1_mesh->m_mesh->collision_hull, entity_1_transform->get_model(), entity_1_transform->m_orientation,
+											entity_2_mesh->m_mesh->collision_hull, entity_2_transform->get_model(), entity_2_transform->m_orientation,
+											&support_cache);
 
 							cp.A = glm::vec3(entity_1_transform->get_model() * glm::vec4(cp.A, 1.f));
 							cp.B = glm::vec3(entity_2_transform->get_model() * glm::vec4(cp.B, 1.f));
@@ -3,6 +3,23 @@
 
 #include <fstream>
 #include <sstream>
+#include <utility>
+
+#ifdef _WIN32
+	// Keep Windows.h from defining min/max macros that break std::min/std::max and from pulling in rarely used APIs.
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 namespace Utility
 {
@@ -47,4 +64,94 @@ namespace Utility
 		for (const auto& entry : std::filesystem::recursive_directory_iterator(p_directory))
 			p_function(entry);
 	}
+
+#ifdef _WIN32
+	namespace
+	{
+		// Closes the handle it owns on destruction, so the failure paths of the MappedFile constructor don't leak it.
+		class ScopedHandle
+		{
+			HANDLE m_handle;
+
+		public:
+			explicit ScopedHandle(HANDLE p_handle) : m_handle{p_handle} {}
+			~ScopedHandle()
+			{
+				if (valid())
+					CloseHandle(m_handle);
+			}
+			ScopedHandle(const ScopedHandle& p_other)            = delete;
+			ScopedHandle& operator=(const ScopedHandle& p_other) = delete;
+
+			bool valid() const  { return m_handle != nullptr && m_handle != INVALID_HANDLE_VALUE; }
+			HANDLE get() const  { return m_handle; }
+			// Give up ownership of the handle, the caller becomes responsible for closing it.
+			HANDLE release()    { return std::exchange(m_handle, nullptr); }
+		};
+	} // namespace
+
+	MappedFile::MappedFile(const std::filesystem::path& p_path)
+		: m_data{nullptr}
+		, m_size{0}
+		, m_file_handle{INVALID_HANDLE_VALUE}
+		, m_mapping_handle{nullptr}
+	{
+		ScopedHandle file{CreateFileW(p_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr)};
+		ASSERT_THROW(file.valid(), "Failed to open file '{}' for mapping.", p_path.string());
+
+		LARGE_INTEGER file_size;
+		ASSERT_THROW(GetFileSizeEx(file.get(), &file_size), "Failed to read the size of file '{}'.", p_path.string());
+		m_size = static_cast<size_t>(file_size.QuadPart);
+		if (m_size > 0) // Empty files cannot be mapped.
+		{
+			ScopedHandle mapping{CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr)};
+			ASSERT_THROW(mapping.valid(), "Failed to create file mapping for '{}'.", p_path.string());
+			m_data = static_cast<const char*>(MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0));
+			ASSERT_THROW(m_data != nullptr, "Failed to map view of file '{}'.", p_path.string());
+			m_mapping_handle = mapping.release();
+		}
+		m_file_handle = file.release();
+	}
+	MappedFile::~MappedFile()
+	{
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping_handle)
+			CloseHandle(m_mapping_handle);
+		if (m_file_handle != INVALID_HANDLE_VALUE)
+			CloseHandle(m_file_handle);
+	}
+#else
+	MappedFile::MappedFile(const std::filesystem::path& p_path)
+		: m_data{nullptr}
+		, m_size{0}
+	{
+		const int file_descriptor = open(p_path.c_str(), O_RDONLY);
+		ASSERT_THROW(file_descriptor != -1, "Failed to open file '{}' for mapping.", p_path.string());
+
+		struct stat file_status;
+		if (fstat(file_descriptor, &file_status) != 0)
+		{
+			close(file_descriptor);
+			ASSERT_THROW(false, "Failed to read the size of file '{}'.", p_path.string());
+		}
+		m_size = static_cast<size_t>(file_status.st_size);
+		if (m_size > 0) // Empty files cannot be mapped.
+		{
+			void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+			if (mapping != MAP_FAILED)
+			{
+				madvise(mapping, m_size, MADV_SEQUENTIAL);
+				m_data = static_cast<const char*>(mapping);
+			}
+		}
+		close(file_descriptor); // The mapping keeps its own reference to the file.
+		ASSERT_THROW(m_size == 0 || m_data != nullptr, "Failed to map file '{}'.", p_path.string());
+	}
+	MappedFile::~MappedFile()
+	{
+		if (m_data)
+			munmap(const_cast<char*>(m_data), m_size);
+	}
+#endif
 } // namespace Utility
\ No newline at end of file
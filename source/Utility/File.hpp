@@ -5,6 +5,7 @@
 #include <filesystem>
 #include <functional>
 #include <string>
+#include <string_view>
 
 namespace Utility
 {
@@ -17,4 +18,27 @@ namespace Utility
 		static void foreach_file_recursive(const std::filesystem::path& p_directory, const std::function<void(const std::filesystem::directory_entry& p_entry)>& p_function);
 		static std::string read_from_file(const std::filesystem::path& p_path);
 	};
+
+	// Read-only memory mapping of a whole file.
+	// The file contents are paged in by the OS as they are accessed instead of being copied into a buffer up front.
+	class MappedFile
+	{
+		const char* m_data;
+		size_t m_size;
+#ifdef _WIN32
+		void* m_file_handle;
+		void* m_mapping_handle;
+#endif
+
+	public:
+		// Map the file at p_path into memory. Throws if the file cannot be opened or mapped.
+		MappedFile(const std::filesystem::path& p_path);
+		~MappedFile();
+		MappedFile(const MappedFile& p_other)            = delete;
+		MappedFile& operator=(const MappedFile& p_other) = delete;
+
+		const char* data() const { return m_data; }
+		size_t size()      const { return m_size; }
+		std::string_view view() const { return {m_data, m_size}; }
+	};
 } // namespace Utility
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "MeshOptimiser.hpp"
+#include "MeshSimplifier.hpp"
 #include "Utility.hpp"
 
 #include "Component/Mesh.hpp"
@@ -11,6 +13,7 @@
 #include "Geometry/Sphere.hpp"
 #include "Geometry/Triangle.hpp"
 #include "Geometry/AABB.hpp"
+#include "Geometry/ConvexHull.hpp"
 
 #include "OpenGL/GLState.hpp"
 
@@ -20,24 +23,101 @@
 #include "glm/gtc/quaternion.hpp"
 
 #include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <vector>
 #include <numbers>
 #include <utility>
+#include <unordered_set>
 #include <type_traits>
 
 namespace Utility
 {
+	// Merge identical vertices in p_vertices and generate an index buffer referencing the unique vertices.
+	// Vertices are compared member-wise, only exact duplicates are welded so hard edges and UV seams are preserved.
+	//@param p_vertices Flat (non-indexed) list of vertices.
+	//@returns The unique vertices in order of first use and one index into them per vertex of p_vertices.
+	template <typename VertexType>
+	requires Data::is_valid_mesh_vert<VertexType>
+	[[nodiscard]] std::pair<std::vector<VertexType>, std::vector<unsigned int>> weld_vertices(const std::vector<VertexType>& p_vertices)
+	{
+		static_assert(std::is_trivially_copyable_v<VertexType> && sizeof(VertexType) % sizeof(float) == 0, "VertexType must be made up of floats.");
+		constexpr size_t float_count = sizeof(VertexType) / sizeof(float);
+		constexpr auto empty_slot    = std::numeric_limits<unsigned int>::max();
+
+		const auto to_floats = [](const VertexType& p_vertex)
+		{
+			std::array<float, float_count> floats;
+			std::memcpy(floats.data(), &p_vertex, sizeof(VertexType));
+			return floats;
+		};
+		const auto hash = [](const std::array<float, float_count>& p_floats)
+		{
+			uint64_t result = 0xcbf29ce484222325ull; // FNV-1a over the float bits, -0 and +0 hash the same as they compare equal.
+			for (const float value : p_floats)
+				result = (result ^ (value == 0.f ? 0u : std::bit_cast<uint32_t>(value))) * 0x100000001b3ull;
+			return result;
+		};
+
+		std::vector<VertexType> unique_vertices;
+		std::vector<unsigned int> indices;
+		unique_vertices.reserve(p_vertices.size() / 2);
+		indices.reserve(p_vertices.size());
+
+		// Open addressing table of indices into unique_vertices, kept at most half full.
+		const size_t table_size = std::bit_ceil(std::max<size_t>(p_vertices.size() * 2, 16));
+		std::vector<unsigned int> table(table_size, empty_slot);
+
+		for (const auto& vertex : p_vertices)
+		{
+			const auto floats = to_floats(vertex);
+			size_t slot = hash(floats) & (table_size - 1);
+			while (table[slot] != empty_slot && to_floats(unique_vertices[table[slot]]) != floats)
+				slot = (slot + 1) & (table_size - 1);
+
+			if (table[slot] == empty_slot)
+			{
+				table[slot] = static_cast<unsigned int>(unique_vertices.size());
+				unique_vertices.push_back(vertex);
+			}
+			indices.push_back(table[slot]);
+		}
+
+		return {std::move(unique_vertices), std::move(indices)};
+	}
+
+	struct PositionHash
+	{
+		size_t operator()(const glm::vec3& p_position) const
+		{// -0 and +0 compare equal so must hash the same.
+			return (std::bit_cast<uint32_t>(p_position.x == 0.f ? 0.f : p_position.x) * 73856093u)
+			     ^ (std::bit_cast<uint32_t>(p_position.y == 0.f ? 0.f : p_position.y) * 19349663u)
+			     ^ (std::bit_cast<uint32_t>(p_position.z == 0.f ? 0.f : p_position.z) * 83492791u);
+		}
+	};
+
+	//@param build_collision_shape Gather the unique vertex positions as primitives are added, the mesh then gets their convex hull for collision detection.
+	// Meshes built for collision are scene meshes, they also get the triangle BVH of Data::Mesh::cast_ray.
 	template <typename VertexType = Data::Vertex, OpenGL::PrimitiveMode primitive_mode = OpenGL::PrimitiveMode::Triangles, bool build_collision_shape = false>
 	requires Data::is_valid_mesh_vert<VertexType>
 	class MeshBuilder
 	{
 		std::vector<VertexType> data;
 		glm::vec4 current_colour;
+		// Properties of data tracked as vertices are added so they never need another pass over it.
+		Geometry::AABB bounds;
+		bool has_alpha;
+		std::unordered_set<glm::vec3, PositionHash> unique_positions; // Only filled if build_collision_shape.
 
 	public:
 		MeshBuilder() noexcept
 			: data{}
 			, current_colour{glm::vec4{1.f}}
+			, bounds{}
+			, has_alpha{false}
+			, unique_positions{}
 		{}
 		void reserve(size_t size)
 		{
@@ -46,6 +126,9 @@ namespace Utility
 		void clear()
 		{
 			data.clear();
+			bounds    = Geometry::AABB{};
+			has_alpha = false;
+			unique_positions.clear();
 		}
 		bool empty() const
 		{
@@ -53,14 +136,27 @@ namespace Utility
 		}
 		Geometry::AABB get_bounds() const
 		{
-			Geometry::AABB bounds;
-			if (!data.empty())
+			return bounds;
+		}
+		// The vertices added so far, for streaming them to the GPU without constructing a Data::Mesh.
+		const std::vector<VertexType>& get_data() const
+		{
+			return data;
+		}
+		// Properties of the mesh built so far for constructing a Data::Mesh. With build_collision_shape, this builds the convex hull of the positions
+		// and requests the triangle BVH for ray casts.
+		[[nodiscard]] Data::MeshDescriptor get_descriptor() const
+		{
+			Data::MeshDescriptor descriptor;
+			descriptor.AABB      = bounds;
+			descriptor.has_alpha = has_alpha;
+			if constexpr (build_collision_shape)
 			{
-				bounds = Geometry::AABB(data[0].position, data[0].position);
-				for (size_t i = 1; i < data.size(); ++i)
-					bounds.unite(data[i].position);
+				descriptor.collision_hull = Geometry::ConvexHull(std::vector<glm::vec3>(unique_positions.begin(), unique_positions.end()));
+				descriptor.ray_cast       = true;
 			}
-			return bounds;
+
+			return descriptor;
 		}
 		void set_colour(const glm::vec4& colour)
 		{
@@ -74,12 +170,53 @@ namespace Utility
 		}
 		[[nodiscard]] Data::Mesh get_mesh()
 		{
-			return Data::Mesh{data, primitive_mode};
+			return Data::Mesh{data, primitive_mode, get_descriptor()};
+		}
+		// Get the vertex data with identical vertices welded together and an index buffer referencing them.
+		//@param p_optimise Reorder triangles and vertices for the vertex cache, overdraw and vertex fetch. Only applies to Triangles.
+		[[nodiscard]] std::pair<std::vector<VertexType>, std::vector<unsigned int>> get_indexed_data(bool p_optimise = true) const
+		{
+			auto indexed_data = weld_vertices(data);
+			if constexpr (primitive_mode == OpenGL::PrimitiveMode::Triangles)
+			{
+				if (p_optimise)
+					MeshOptimiser::optimise(indexed_data.first, indexed_data.second);
+			}
+			return indexed_data;
+		}
+		// Get the mesh with identical vertices welded together and drawn via an index buffer.
+		// Neighbouring triangles of the add_ shapes share vertices, so this shrinks vertex memory and lets the GPU reuse transformed vertices.
+		// Triangle meshes dense enough to simplify also get a chain of LODs appended to their indices.
+		[[nodiscard]] Data::Mesh get_indexed_mesh()
+		{
+			auto [vertices, indices] = get_indexed_data();
+			auto descriptor          = get_descriptor();
+			if constexpr (primitive_mode == OpenGL::PrimitiveMode::Triangles)
+				descriptor.LODs = MeshSimplifier::build_LODs(vertices, indices);
+
+			return Data::Mesh{std::move(vertices), std::move(indices), primitive_mode, std::move(descriptor)};
 		}
 
 	private:
 		// Helpers for MeshBuilder::add_ functions. These perform the actual adding of vertices to the data vector.
 
+		// Append a finished vertex to data, updating the tracked properties of the mesh.
+		template <typename Vertex>
+		void push_vertex(Vertex&& v)
+		{
+			if (data.empty())
+				bounds = Geometry::AABB(v.position, v.position);
+			else
+				bounds.unite(v.position);
+
+			if constexpr (Data::has_colour_member<VertexType>)
+				has_alpha = has_alpha || v.colour.a < 1.f;
+			if constexpr (build_collision_shape)
+				unique_positions.insert(v.position);
+
+			data.emplace_back(std::forward<Vertex>(v));
+		}
+
 		// Add a vertex to the mesh.
 		template <typename Vertex>
 		void add_vertex_impl(Vertex&& v)
@@ -92,7 +229,7 @@ namespace Utility
 			if constexpr (Data::has_colour_member<VertexType>)
 				v.colour = current_colour;
 
-			data.emplace_back(std::forward<Vertex>(v));
+			push_vertex(std::forward<Vertex>(v));
 		}
 		// Add a line to the mesh.
 		template <typename Vertex, typename Vertex2>
@@ -117,8 +254,8 @@ namespace Utility
 					v1.colour = current_colour;
 					v2.colour = current_colour;
 				}
-				data.emplace_back(std::forward<Vertex>(v1));
-				data.emplace_back(std::forward<Vertex2>(v2));
+				push_vertex(std::forward<Vertex>(v1));
+				push_vertex(std::forward<Vertex2>(v2));
 			}
 			else
 				[]<bool flag=false>(){ static_assert(flag, "Not implemented add_line for this combo of VertexType params."); }(); // #CPP23 P2593R0 swap for static_assert(false)
@@ -157,9 +294,9 @@ namespace Utility
 						v3.colour = current_colour;
 					}
 
-					data.emplace_back(std::forward<Vertex>(v1));
-					data.emplace_back(std::forward<Vertex2>(v2));
-					data.emplace_back(std::forward<Vertex3>(v3));
+					push_vertex(std::forward<Vertex>(v1));
+					push_vertex(std::forward<Vertex2>(v2));
+					push_vertex(std::forward<Vertex3>(v3));
 				}
 			}
 			else
@@ -185,9 +322,9 @@ namespace Utility
 				v2.normal = normal;
 				v3.normal = normal;
 
-				data.emplace_back(std::forward<Vertex>(v1));
-				data.emplace_back(std::forward<Vertex2>(v2));
-				data.emplace_back(std::forward<Vertex3>(v3));
+				push_vertex(std::forward<Vertex>(v1));
+				push_vertex(std::forward<Vertex2>(v2));
+				push_vertex(std::forward<Vertex3>(v3));
 			}
 			else
 				[]<bool flag=false>(){ static_assert(flag, "Not implemented add_triangle for this combo of VertexType params."); }(); // #CPP23 P2593R0 swap for static_assert(false)
@@ -0,0 +1,289 @@
+#include "MeshOptimiser.hpp"
+
+#include "Logger.hpp"
+
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Utility::MeshOptimiser
+{
+	// Simulates a FIFO post-transform cache. A vertex is in the cache if fewer than cache_size misses happened since it was last missed.
+	class FIFOCache
+	{
+		std::vector<size_t> m_time_stamps; // Per vertex, miss_count at the time the vertex was last added.
+		size_t m_cache_size;
+		size_t m_miss_count;
+
+	public:
+		FIFOCache(size_t p_vertex_count, size_t p_cache_size)
+			: m_time_stamps(p_vertex_count, 0)
+			, m_cache_size{p_cache_size}
+			, m_miss_count{p_cache_size + 1} // Start past cache_size so no vertex begins in the cache.
+		{}
+		// Returns true if p_vertex missed the cache, adding it to the cache.
+		bool access(unsigned int p_vertex)
+		{
+			if (m_miss_count - m_time_stamps[p_vertex] > m_cache_size)
+			{
+				m_time_stamps[p_vertex] = m_miss_count++;
+				return true;
+			}
+			return false;
+		}
+		size_t age(unsigned int p_vertex)    const { return m_miss_count - m_time_stamps[p_vertex]; }
+		void flush()                               { m_miss_count += m_cache_size + 1; }
+	};
+
+	std::vector<unsigned int> optimise_vertex_cache(const std::vector<unsigned int>& p_indices, size_t p_vertex_count, size_t p_cache_size, std::vector<size_t>* p_clusters)
+	{
+		ASSERT(p_indices.size() % 3 == 0, "[MESH OPTIMISER] Index count {} is not a multiple of 3.", p_indices.size());
+		const size_t triangle_count = p_indices.size() / 3;
+
+		// Vertex-triangle adjacency in CSR form. live_triangles counts how many unemitted triangles use each vertex.
+		std::vector<unsigned int> live_triangles(p_vertex_count, 0);
+		for (const auto index : p_indices)
+			live_triangles[index]++;
+
+		std::vector<size_t> adjacency_offsets(p_vertex_count + 1, 0);
+		for (size_t vertex = 0; vertex < p_vertex_count; vertex++)
+			adjacency_offsets[vertex + 1] = adjacency_offsets[vertex] + live_triangles[vertex];
+
+		std::vector<unsigned int> adjacency(p_indices.size());
+		{
+			std::vector<size_t> fill = adjacency_offsets;
+			for (size_t i = 0; i < p_indices.size(); i++)
+				adjacency[fill[p_indices[i]]++] = static_cast<unsigned int>(i / 3);
+		}
+
+		std::vector<bool> emitted(triangle_count, false);
+		std::vector<unsigned int> dead_end_stack;
+		std::vector<unsigned int> candidates;
+		std::vector<unsigned int> output;
+		output.reserve(p_indices.size());
+		FIFOCache cache{p_vertex_count, p_cache_size};
+		size_t cursor = 0; // Next vertex to try once the dead-end stack is exhausted, scanned in input order.
+
+		// When no candidate neighbours remain, resume from the most recently used vertex with triangles left, otherwise the next in input order.
+		auto skip_dead_end = [&]() -> long long
+		{
+			while (!dead_end_stack.empty())
+			{
+				const auto vertex = dead_end_stack.back();
+				dead_end_stack.pop_back();
+				if (live_triangles[vertex] > 0)
+					return vertex;
+			}
+			while (cursor < p_vertex_count)
+			{
+				if (live_triangles[cursor] > 0)
+					return static_cast<long long>(cursor);
+				cursor++;
+			}
+			return -1;
+		};
+
+		long long fanning_vertex = skip_dead_end();
+		if (p_clusters)
+			p_clusters->assign(1, 0);
+
+		while (fanning_vertex >= 0)
+		{
+			// Emit every remaining triangle around the fanning vertex.
+			candidates.clear();
+			for (size_t i = adjacency_offsets[fanning_vertex]; i < adjacency_offsets[fanning_vertex + 1]; i++)
+			{
+				const auto triangle = adjacency[i];
+				if (emitted[triangle])
+					continue;
+
+				for (size_t corner = 0; corner < 3; corner++)
+				{
+					const auto vertex = p_indices[triangle * 3 + corner];
+					output.push_back(vertex);
+					dead_end_stack.push_back(vertex);
+					candidates.push_back(vertex);
+					live_triangles[vertex]--;
+					cache.access(vertex);
+				}
+				emitted[triangle] = true;
+			}
+
+			// Pick the next fanning vertex among the candidates, preferring the oldest one that will still be in the cache once its remaining triangles are emitted.
+			long long best_vertex = -1;
+			long long best_priority = -1;
+			for (const auto vertex : candidates)
+			{
+				if (live_triangles[vertex] == 0)
+					continue;
+
+				long long priority = 0;
+				if (cache.age(vertex) + 2 * live_triangles[vertex] <= p_cache_size)
+					priority = static_cast<long long>(cache.age(vertex));
+				if (priority > best_priority)
+				{
+					best_priority = priority;
+					best_vertex   = vertex;
+				}
+			}
+
+			if (best_vertex == -1)
+			{
+				best_vertex = skip_dead_end();
+				if (p_clusters && best_vertex >= 0)
+					p_clusters->push_back(output.size() / 3);
+			}
+			fanning_vertex = best_vertex;
+		}
+
+		ASSERT(output.size() == p_indices.size(), "[MESH OPTIMISER] Tipsify emitted {} indices, expected {}.", output.size(), p_indices.size());
+		return output;
+	}
+
+	void optimise_overdraw(std::vector<unsigned int>& p_indices, const std::vector<glm::vec3>& p_positions, const std::vector<size_t>& p_clusters, size_t p_cache_size, float p_threshold)
+	{
+		const size_t triangle_count = p_indices.size() / 3;
+		if (triangle_count == 0)
+			return;
+
+		// Split the hard clusters from Tipsify further into soft clusters. A cluster can end once the ACMR of the triangles since the
+		// last split (measured with a cold cache) has fallen within p_threshold of the ACMR of the whole hard cluster.
+		std::vector<size_t> soft_clusters;
+		{
+			FIFOCache cache{p_positions.size(), p_cache_size};
+			auto triangle_misses = [&](size_t p_triangle)
+			{
+				size_t misses = 0;
+				for (size_t corner = 0; corner < 3; corner++)
+					misses += cache.access(p_indices[p_triangle * 3 + corner]);
+				return misses;
+			};
+
+			for (size_t cluster = 0; cluster < p_clusters.size(); cluster++)
+			{
+				const size_t begin = p_clusters[cluster];
+				const size_t end   = cluster + 1 < p_clusters.size() ? p_clusters[cluster + 1] : triangle_count;
+
+				cache.flush();
+				size_t cluster_misses = 0;
+				for (size_t triangle = begin; triangle < end; triangle++)
+					cluster_misses += triangle_misses(triangle);
+				const float cluster_ACMR = static_cast<float>(cluster_misses) / static_cast<float>(end - begin);
+
+				cache.flush();
+				soft_clusters.push_back(begin);
+				size_t misses = 0;
+				for (size_t triangle = begin; triangle < end; triangle++)
+				{
+					misses += triangle_misses(triangle);
+					const size_t triangles_in_cluster = triangle - soft_clusters.back() + 1;
+					if (triangle + 1 < end && static_cast<float>(misses) <= static_cast<float>(triangles_in_cluster) * cluster_ACMR * p_threshold)
+					{
+						soft_clusters.push_back(triangle + 1);
+						cache.flush();
+						misses = 0;
+					}
+				}
+			}
+		}
+
+		// Sort clusters by how much they face away from the mesh centre. Outward facing clusters on the outside are likely to occlude the rest.
+		glm::vec3 mesh_centroid = glm::vec3{0.f};
+		float mesh_area         = 0.f;
+		std::vector<float> cluster_sort_keys(soft_clusters.size());
+		std::vector<glm::vec3> cluster_centroids(soft_clusters.size());
+		std::vector<glm::vec3> cluster_normals(soft_clusters.size());
+
+		for (size_t cluster = 0; cluster < soft_clusters.size(); cluster++)
+		{
+			const size_t begin = soft_clusters[cluster];
+			const size_t end   = cluster + 1 < soft_clusters.size() ? soft_clusters[cluster + 1] : triangle_count;
+
+			glm::vec3 centroid = glm::vec3{0.f};
+			glm::vec3 normal   = glm::vec3{0.f};
+			float area         = 0.f;
+			for (size_t triangle = begin; triangle < end; triangle++)
+			{
+				const auto& a = p_positions[p_indices[triangle * 3 + 0]];
+				const auto& b = p_positions[p_indices[triangle * 3 + 1]];
+				const auto& c = p_positions[p_indices[triangle * 3 + 2]];
+				const auto triangle_normal = glm::cross(b - a, c - a); // Length is twice the triangle area.
+				const float triangle_area  = glm::length(triangle_normal);
+
+				centroid += (a + b + c) * (triangle_area / 3.f);
+				normal   += triangle_normal;
+				area     += triangle_area;
+			}
+
+			mesh_centroid += centroid;
+			mesh_area     += area;
+			cluster_centroids[cluster] = area > 0.f ? centroid / area : p_positions[p_indices[begin * 3]];
+			cluster_normals[cluster]   = glm::length(normal) > 0.f ? glm::normalize(normal) : glm::vec3{0.f};
+		}
+		if (mesh_area > 0.f)
+			mesh_centroid /= mesh_area;
+
+		for (size_t cluster = 0; cluster < soft_clusters.size(); cluster++)
+			cluster_sort_keys[cluster] = glm::dot(cluster_centroids[cluster] - mesh_centroid, cluster_normals[cluster]);
+
+		std::vector<size_t> cluster_order(soft_clusters.size());
+		std::iota(cluster_order.begin(), cluster_order.end(), size_t(0));
+		std::stable_sort(cluster_order.begin(), cluster_order.end(), [&cluster_sort_keys](size_t p_a, size_t p_b) { return cluster_sort_keys[p_a] > cluster_sort_keys[p_b]; });
+
+		std::vector<unsigned int> sorted_indices;
+		sorted_indices.reserve(p_indices.size());
+		for (const auto cluster : cluster_order)
+		{
+			const size_t begin = soft_clusters[cluster];
+			const size_t end   = cluster + 1 < soft_clusters.size() ? soft_clusters[cluster + 1] : triangle_count;
+			sorted_indices.insert(sorted_indices.end(), p_indices.begin() + begin * 3, p_indices.begin() + end * 3);
+		}
+		p_indices = std::move(sorted_indices);
+	}
+
+	std::vector<unsigned int> optimise_vertex_fetch_remap(std::vector<unsigned int>& p_indices, size_t p_vertex_count)
+	{
+		std::vector<unsigned int> remap(p_vertex_count, Unused_Vertex);
+		unsigned int next_vertex = 0;
+		for (auto& index : p_indices)
+		{
+			if (remap[index] == Unused_Vertex)
+				remap[index] = next_vertex++;
+
+			index = remap[index];
+		}
+		return remap;
+	}
+
+	float ACMR(const std::vector<unsigned int>& p_indices, size_t p_vertex_count, size_t p_cache_size)
+	{
+		if (p_indices.empty())
+			return 0.f;
+
+		FIFOCache cache{p_vertex_count, p_cache_size};
+		size_t misses = 0;
+		for (const auto index : p_indices)
+			misses += cache.access(index);
+
+		return static_cast<float>(misses) / static_cast<float>(p_indices.size() / 3);
+	}
+	float ATVR(const std::vector<unsigned int>& p_indices, size_t p_vertex_count, size_t p_cache_size)
+	{
+		if (p_indices.empty())
+			return 0.f;
+
+		std::vector<bool> referenced(p_vertex_count, false);
+		size_t referenced_count = 0;
+		for (const auto index : p_indices)
+		{
+			if (!referenced[index])
+			{
+				referenced[index] = true;
+				referenced_count++;
+			}
+		}
+
+		return ACMR(p_indices, p_vertex_count, p_cache_size) * static_cast<float>(p_indices.size() / 3) / static_cast<float>(referenced_count);
+	}
+} // namespace Utility::MeshOptimiser
\ No newline at end of file
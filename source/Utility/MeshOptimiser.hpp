@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Data/Vertex.hpp"
+
+#include "glm/vec3.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Reordering passes for indexed triangle lists, run on index data before it is uploaded.
+// The passes only change the order triangles are drawn in and the order vertices are stored in, never the resulting image (bar overdraw).
+namespace Utility::MeshOptimiser
+{
+	// Approximate size of the post-transform vertex cache modelled by the passes and metrics.
+	constexpr size_t Default_Cache_Size = 16;
+	// How much the ACMR of a cluster may grow when it's split for overdraw sorting. 1.05 allows 5% more vertex shader invocations.
+	constexpr float Default_Overdraw_Threshold = 1.05f;
+
+	// Reorder the triangles of p_indices to maximise post-transform vertex cache hits using Tipsify (Sander et al. 2007).
+	//@param p_indices Triangle list, 3 indices per triangle.
+	//@param p_vertex_count Number of vertices p_indices references.
+	//@param p_cache_size Size of the FIFO cache to optimise for.
+	//@param p_clusters If not null, receives the first triangle of each run Tipsify had to restart from a dead-end.
+	//@returns The reordered triangle list.
+	[[nodiscard]] std::vector<unsigned int> optimise_vertex_cache(const std::vector<unsigned int>& p_indices, size_t p_vertex_count, size_t p_cache_size = Default_Cache_Size, std::vector<size_t>* p_clusters = nullptr);
+
+	// Split p_indices into clusters and sort them front to back from the outside in so that occluding geometry is drawn first.
+	// Clusters start at the p_clusters triangles and are split further where the vertex cache cost of doing so is within p_threshold.
+	//@param p_indices Triangle list previously ordered by optimise_vertex_cache, reordered in place.
+	//@param p_positions Vertex positions indexed by p_indices.
+	//@param p_clusters The clusters output by optimise_vertex_cache.
+	void optimise_overdraw(std::vector<unsigned int>& p_indices, const std::vector<glm::vec3>& p_positions, const std::vector<size_t>& p_clusters,
+	                       size_t p_cache_size = Default_Cache_Size, float p_threshold = Default_Overdraw_Threshold);
+
+	// Build a remap table that puts vertices in the order p_indices first uses them, so vertex fetches read memory linearly.
+	// Vertices that are never referenced are mapped to Unused_Vertex.
+	//@returns One entry per vertex with its new position, p_indices are updated in place.
+	constexpr unsigned int Unused_Vertex = ~0u;
+	[[nodiscard]] std::vector<unsigned int> optimise_vertex_fetch_remap(std::vector<unsigned int>& p_indices, size_t p_vertex_count);
+
+	// Average cache miss ratio. Vertex shader invocations per triangle for a FIFO cache of p_cache_size. 0.5 is the best case for large regular meshes and 3 the worst.
+	[[nodiscard]] float ACMR(const std::vector<unsigned int>& p_indices, size_t p_vertex_count, size_t p_cache_size = Default_Cache_Size);
+	// Average transformed vertex ratio. Vertex shader invocations per referenced vertex. 1 is the best case.
+	[[nodiscard]] float ATVR(const std::vector<unsigned int>& p_indices, size_t p_vertex_count, size_t p_cache_size = Default_Cache_Size);
+
+	// Run the vertex cache, overdraw and vertex fetch passes over an indexed triangle mesh.
+	template <typename VertexType>
+	requires Data::has_position_member<VertexType>
+	void optimise(std::vector<VertexType>& p_vertices, std::vector<unsigned int>& p_indices)
+	{
+		if (p_indices.size() < 3)
+			return;
+
+		std::vector<size_t> clusters;
+		p_indices = optimise_vertex_cache(p_indices, p_vertices.size(), Default_Cache_Size, &clusters);
+
+		std::vector<glm::vec3> positions;
+		positions.reserve(p_vertices.size());
+		for (const auto& vertex : p_vertices)
+			positions.push_back(vertex.position);
+		optimise_overdraw(p_indices, positions, clusters);
+
+		const auto remap = optimise_vertex_fetch_remap(p_indices, p_vertices.size());
+		std::vector<VertexType> remapped_vertices;
+		remapped_vertices.resize(p_vertices.size() - std::count(remap.begin(), remap.end(), Unused_Vertex));
+		for (size_t i = 0; i < p_vertices.size(); i++)
+			if (remap[i] != Unused_Vertex)
+				remapped_vertices[remap[i]] = p_vertices[i];
+
+		p_vertices = std::move(remapped_vertices);
+	}
+} // namespace Utility::MeshOptimiser
\ No newline at end of file
@@ -0,0 +1,457 @@
+#include "MeshSimplifier.hpp"
+#include "MeshOptimiser.hpp"
+
+#include "Logger.hpp"
+
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Utility::MeshSimplifier
+{
+	// How a vertex may be collapsed, decided from the open edges around it and the other vertices at its position (its wedges).
+	enum class VertexKind : uint8_t
+	{
+		Manifold, // Single wedge with no open edges. Can collapse onto any neighbour.
+		Border,   // Single wedge on one open edge loop of the mesh. Can only collapse along the border.
+		Seam,     // Two wedges whose open edges close each other at the position level. Both wedges collapse together along the seam.
+		Locked    // Corners, seam junctions and anything non-manifold. Never collapsed.
+	};
+
+	constexpr unsigned int No_Edge       = ~0u;  // openinc/openout value for a vertex with no open edge.
+	constexpr double Border_Edge_Weight  = 10.0; // Weight of the plane perpendicular to border and seam edges, keeps the silhouette of open edges in place.
+	constexpr float Pass_Error_Bound     = 1.5f; // A pass collapses edges up to this factor of the cost of the edge that would meet the pass goal.
+	constexpr float Min_LOD_Reduction    = 0.8f; // A LOD with more than this fraction of the indices of the previous one is not worth its memory.
+	constexpr size_t Min_LOD_Triangles   = 16;   // Don't generate LODs below this triangle count.
+
+	// Symmetric 4x4 matrix accumulating the squared distance to a set of weighted planes. Error(v) = v'Av + 2b'v + c.
+	struct Quadric
+	{
+		double a00 = 0.0, a11 = 0.0, a22 = 0.0, a10 = 0.0, a20 = 0.0, a21 = 0.0;
+		double b0  = 0.0, b1  = 0.0, b2  = 0.0;
+		double c   = 0.0;
+		double weight = 0.0;
+
+		// Quadric of the plane with unit p_normal passing through p_point.
+		static Quadric from_plane(const glm::vec3& p_normal, const glm::vec3& p_point, double p_weight)
+		{
+			const double a = p_normal.x, b = p_normal.y, c = p_normal.z;
+			const double d = -glm::dot(p_normal, p_point);
+
+			Quadric q;
+			q.a00 = a * a * p_weight; q.a11 = b * b * p_weight; q.a22 = c * c * p_weight;
+			q.a10 = a * b * p_weight; q.a20 = a * c * p_weight; q.a21 = b * c * p_weight;
+			q.b0  = a * d * p_weight; q.b1  = b * d * p_weight; q.b2  = c * d * p_weight;
+			q.c   = d * d * p_weight;
+			q.weight = p_weight;
+			return q;
+		}
+		Quadric& operator+=(const Quadric& p_other)
+		{
+			a00 += p_other.a00; a11 += p_other.a11; a22 += p_other.a22;
+			a10 += p_other.a10; a20 += p_other.a20; a21 += p_other.a21;
+			b0  += p_other.b0;  b1  += p_other.b1;  b2  += p_other.b2;
+			c   += p_other.c;
+			weight += p_other.weight;
+			return *this;
+		}
+		// Weighted mean squared distance of p_point to the planes.
+		float error(const glm::vec3& p_point) const
+		{
+			const double x = p_point.x, y = p_point.y, z = p_point.z;
+			const double r = a00 * x * x + a11 * y * y + a22 * z * z
+			               + 2.0 * (a10 * x * y + a20 * x * z + a21 * y * z)
+			               + 2.0 * (b0 * x + b1 * y + b2 * z)
+			               + c;
+			return weight > 0.0 ? static_cast<float>(std::abs(r) / weight) : 0.f;
+		}
+	};
+
+	struct Collapse
+	{
+		unsigned int from;
+		unsigned int to;
+		float cost; // Squared error of moving from onto to.
+	};
+
+	// Key of a position for welding, -0 is folded onto 0 so both weld together.
+	struct PositionKey
+	{
+		uint32_t x, y, z;
+		bool operator==(const PositionKey& p_other) const = default;
+
+		explicit PositionKey(const glm::vec3& p_position)
+			: x{std::bit_cast<uint32_t>(p_position.x == 0.f ? 0.f : p_position.x)}
+			, y{std::bit_cast<uint32_t>(p_position.y == 0.f ? 0.f : p_position.y)}
+			, z{std::bit_cast<uint32_t>(p_position.z == 0.f ? 0.f : p_position.z)}
+		{}
+	};
+	struct PositionKeyHash
+	{
+		size_t operator()(const PositionKey& p_key) const
+		{
+			return (p_key.x * 73856093u) ^ (p_key.y * 19349663u) ^ (p_key.z * 83492791u);
+		}
+	};
+
+	// Vertex-triangle adjacency in CSR form for the current triangle list.
+	struct Adjacency
+	{
+		std::vector<unsigned int> offsets;   // Per vertex, first entry in triangles. Vertex count + 1 entries.
+		std::vector<unsigned int> triangles; // Triangles using each vertex.
+
+		void build(const std::vector<unsigned int>& p_indices, size_t p_vertex_count)
+		{
+			offsets.assign(p_vertex_count + 1, 0);
+			for (const auto index : p_indices)
+				offsets[index + 1]++;
+			for (size_t vertex = 0; vertex < p_vertex_count; vertex++)
+				offsets[vertex + 1] += offsets[vertex];
+
+			triangles.resize(p_indices.size());
+			std::vector<unsigned int> fill{offsets.begin(), offsets.end() - 1};
+			for (size_t i = 0; i < p_indices.size(); i++)
+				triangles[fill[p_indices[i]]++] = static_cast<unsigned int>(i / 3);
+		}
+		// Whether a triangle of p_indices has the directed edge p_from -> p_to.
+		bool has_edge(const std::vector<unsigned int>& p_indices, unsigned int p_from, unsigned int p_to) const
+		{
+			for (auto i = offsets[p_from]; i < offsets[p_from + 1]; i++)
+			{
+				const auto* triangle = &p_indices[triangles[i] * 3];
+				for (int corner = 0; corner < 3; corner++)
+					if (triangle[corner] == p_from && triangle[(corner + 1) % 3] == p_to)
+						return true;
+			}
+			return false;
+		}
+	};
+
+	std::vector<unsigned int> simplify(const std::vector<unsigned int>& p_indices, const std::vector<glm::vec3>& p_positions, size_t p_target_index_count, float p_max_error, float* p_result_error)
+	{
+		ASSERT(p_indices.size() % 3 == 0, "[MESH SIMPLIFIER] Index count {} is not a multiple of 3.", p_indices.size());
+		const size_t vertex_count = p_positions.size();
+
+		// Normalise positions into the unit cube so errors are relative to the mesh size.
+		std::vector<glm::vec3> positions(vertex_count);
+		{
+			glm::vec3 min{std::numeric_limits<float>::max()};
+			glm::vec3 max{std::numeric_limits<float>::lowest()};
+			for (const auto index : p_indices)
+			{
+				min = glm::min(min, p_positions[index]);
+				max = glm::max(max, p_positions[index]);
+			}
+			const float extent = std::max({max.x - min.x, max.y - min.y, max.z - min.z});
+			const float scale  = extent > 0.f ? 1.f / extent : 0.f;
+			for (size_t i = 0; i < vertex_count; i++)
+				positions[i] = (p_positions[i] - min) * scale;
+		}
+
+		// remap is the first vertex at each position, wedge links the vertices at the same position in a circular list.
+		// Only referenced vertices take part so unused duplicates don't turn seams into junctions.
+		std::vector<unsigned int> remap(vertex_count, No_Edge);
+		std::vector<unsigned int> wedge(vertex_count);
+		{
+			std::unordered_map<PositionKey, unsigned int, PositionKeyHash> first_at_position;
+			first_at_position.reserve(vertex_count);
+			for (const auto index : p_indices)
+			{
+				if (remap[index] != No_Edge)
+					continue;
+
+				const auto [it, inserted] = first_at_position.try_emplace(PositionKey{p_positions[index]}, index);
+				remap[index] = it->second;
+				if (inserted)
+					wedge[index] = index;
+				else
+				{
+					wedge[index]      = wedge[it->second];
+					wedge[it->second] = index;
+				}
+			}
+		}
+
+		// Drop triangles that are degenerate at the position level, they have no area to preserve.
+		std::vector<unsigned int> indices;
+		indices.reserve(p_indices.size());
+		for (size_t i = 0; i < p_indices.size(); i += 3)
+		{
+			const auto a = p_indices[i], b = p_indices[i + 1], c = p_indices[i + 2];
+			if (remap[a] != remap[b] && remap[a] != remap[c] && remap[b] != remap[c])
+				indices.insert(indices.end(), {a, b, c});
+		}
+
+		Adjacency adjacency;
+		adjacency.build(indices, vertex_count);
+
+		// Per vertex, the vertex at the other end of its open outgoing/incoming edge. No_Edge if there is none, the vertex itself if there are several.
+		std::vector<unsigned int> openout(vertex_count);
+		std::vector<unsigned int> openinc(vertex_count);
+		std::vector<VertexKind> kinds(vertex_count);
+		std::vector<Quadric> quadrics(vertex_count); // Indexed by the remap vertex of each position.
+
+		auto classify = [&]()
+		{
+			std::fill(openout.begin(), openout.end(), No_Edge);
+			std::fill(openinc.begin(), openinc.end(), No_Edge);
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				const auto from = indices[i];
+				const auto to   = indices[i - i % 3 + (i + 1) % 3];
+				if (!adjacency.has_edge(indices, to, from))
+				{
+					openout[from] = openout[from] == No_Edge ? to : from;
+					openinc[to]   = openinc[to]   == No_Edge ? from : to;
+				}
+			}
+
+			auto single_open_edges = [&](unsigned int p_vertex)
+			{
+				return openinc[p_vertex] != No_Edge && openout[p_vertex] != No_Edge && openinc[p_vertex] != p_vertex && openout[p_vertex] != p_vertex;
+			};
+
+			for (unsigned int vertex = 0; vertex < vertex_count; vertex++)
+			{
+				if (remap[vertex] != vertex)
+					continue; // Classified with the first vertex at its position.
+
+				VertexKind kind = VertexKind::Locked;
+				if (wedge[vertex] == vertex)
+				{
+					if (openinc[vertex] == No_Edge && openout[vertex] == No_Edge)
+						kind = VertexKind::Manifold;
+					else if (single_open_edges(vertex))
+						kind = VertexKind::Border;
+				}
+				else if (wedge[wedge[vertex]] == vertex)
+				{
+					// Two wedges form a seam if each wedge's open edges are the other wedge's open edges reversed.
+					const auto other = wedge[vertex];
+					if (single_open_edges(vertex) && single_open_edges(other)
+					    && remap[openinc[vertex]] == remap[openout[other]] && remap[openout[vertex]] == remap[openinc[other]])
+						kind = VertexKind::Seam;
+				}
+
+				auto w = vertex;
+				do
+				{
+					kinds[w] = kind;
+					w        = wedge[w];
+				} while (w != vertex);
+			}
+		};
+
+		{ // Accumulate the planes of the triangles around each position, and the planes perpendicular to the open edges.
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				const glm::vec3& p0 = positions[indices[i]];
+				const glm::vec3& p1 = positions[indices[i + 1]];
+				const glm::vec3& p2 = positions[indices[i + 2]];
+
+				const auto normal = glm::cross(p1 - p0, p2 - p0);
+				const auto length = glm::length(normal);
+				if (length == 0.f)
+					continue;
+
+				const auto triangle = Quadric::from_plane(normal / length, p0, length * 0.5);
+				for (int corner = 0; corner < 3; corner++)
+					quadrics[remap[indices[i + corner]]] += triangle;
+			}
+
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				const auto from = indices[i];
+				const auto to   = indices[i - i % 3 + (i + 1) % 3];
+				if (adjacency.has_edge(indices, to, from))
+					continue;
+
+				const auto opposite = indices[i - i % 3 + (i + 2) % 3];
+				const auto edge     = positions[to] - positions[from];
+				const auto length   = glm::length(edge);
+				const auto edge_dir = length > 0.f ? edge / length : edge;
+				auto perpendicular  = positions[opposite] - positions[from];
+				perpendicular      -= edge_dir * glm::dot(perpendicular, edge_dir);
+				const auto perpendicular_length = glm::length(perpendicular);
+				if (length == 0.f || perpendicular_length == 0.f)
+					continue;
+
+				const auto edge_quadric = Quadric::from_plane(perpendicular / perpendicular_length, positions[from], length * length * Border_Edge_Weight);
+				quadrics[remap[from]] += edge_quadric;
+				quadrics[remap[to]]   += edge_quadric;
+			}
+		}
+
+		classify();
+
+		auto can_collapse = [&](unsigned int p_from, unsigned int p_to)
+		{
+			switch (kinds[p_from])
+			{
+				case VertexKind::Manifold: return true;
+				case VertexKind::Border:   return (kinds[p_to] == VertexKind::Border || kinds[p_to] == VertexKind::Locked) && (openout[p_from] == p_to || openinc[p_from] == p_to);
+				case VertexKind::Seam:     return (kinds[p_to] == VertexKind::Seam   || kinds[p_to] == VertexKind::Locked) && (openout[p_from] == p_to || openinc[p_from] == p_to);
+				case VertexKind::Locked:   return false;
+				default: throw std::runtime_error("Unknown VertexKind");
+			}
+		};
+
+		// Whether moving every wedge of p_from onto the position of p_to would flip a triangle that survives the collapse.
+		auto flips_triangle = [&](unsigned int p_from, unsigned int p_to)
+		{
+			const auto& target = positions[p_to];
+			auto w = p_from;
+			do
+			{
+				for (auto t = adjacency.offsets[w]; t < adjacency.offsets[w + 1]; t++)
+				{
+					const auto* triangle = &indices[adjacency.triangles[t] * 3];
+					const int corner     = triangle[0] == w ? 0 : triangle[1] == w ? 1 : 2;
+					const auto b         = triangle[(corner + 1) % 3];
+					const auto c         = triangle[(corner + 2) % 3];
+					if (remap[b] == remap[p_to] || remap[c] == remap[p_to])
+						continue; // Collapsed away.
+
+					const auto before = glm::cross(positions[b] - positions[w], positions[c] - positions[w]);
+					const auto after  = glm::cross(positions[b] - target, positions[c] - target);
+					if (glm::dot(before, after) <= 0.f)
+						return true;
+				}
+				w = wedge[w];
+			} while (w != p_from);
+			return false;
+		};
+
+		const auto target_index_count = std::min(p_target_index_count, indices.size());
+		const float max_cost          = p_max_error * p_max_error;
+		float result_cost             = 0.f;
+		std::vector<Collapse> collapses;
+		std::vector<unsigned int> collapse_remap(vertex_count);
+		std::vector<bool> touched(vertex_count);
+
+		while (indices.size() > target_index_count)
+		{
+			// Gather the cheapest valid direction of every edge.
+			collapses.clear();
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				const auto a = indices[i];
+				const auto b = indices[i - i % 3 + (i + 1) % 3];
+				if (a > b && adjacency.has_edge(indices, b, a))
+					continue; // Interior edge, considered from the other side.
+
+				const bool a_to_b = can_collapse(a, b);
+				const bool b_to_a = can_collapse(b, a);
+				if (!a_to_b && !b_to_a)
+					continue;
+
+				const float cost_a_to_b = a_to_b ? quadrics[remap[a]].error(positions[b]) : std::numeric_limits<float>::max();
+				const float cost_b_to_a = b_to_a ? quadrics[remap[b]].error(positions[a]) : std::numeric_limits<float>::max();
+				if (cost_a_to_b <= cost_b_to_a)
+					collapses.push_back({a, b, cost_a_to_b});
+				else
+					collapses.push_back({b, a, cost_b_to_a});
+			}
+			if (collapses.empty())
+				break;
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& p_a, const Collapse& p_b) { return p_a.cost < p_b.cost; });
+
+			// Each collapse removes about two triangles. Stop the pass at the goal, or once edges get much costlier than the goal edge
+			// as those collapses are better re-evaluated after the cheap ones changed the mesh.
+			const size_t triangles_to_remove = (indices.size() - target_index_count) / 3;
+			const size_t collapse_goal       = std::max<size_t>(1, triangles_to_remove / 2);
+			const float pass_cost_limit      = std::min(max_cost, collapses[std::min(collapse_goal, collapses.size()) - 1].cost * Pass_Error_Bound);
+
+			for (size_t i = 0; i < vertex_count; i++)
+				collapse_remap[i] = static_cast<unsigned int>(i);
+			std::fill(touched.begin(), touched.end(), false);
+
+			size_t triangles_removed = 0;
+			for (const auto& collapse : collapses)
+			{
+				if (collapse.cost > pass_cost_limit || triangles_removed >= triangles_to_remove)
+					break;
+
+				const auto from_position = remap[collapse.from];
+				const auto to_position   = remap[collapse.to];
+				if (touched[from_position] || touched[to_position])
+					continue; // A neighbouring collapse changed this edge, it's re-evaluated next pass.
+				if (flips_triangle(collapse.from, collapse.to))
+					continue;
+
+				if (kinds[collapse.from] == VertexKind::Seam)
+				{
+					// The other wedge collapses along its side of the seam, which runs in the opposite direction.
+					const auto other_from = wedge[collapse.from];
+					const auto other_to   = openout[collapse.from] == collapse.to ? openinc[other_from] : openout[other_from];
+					if (remap[other_to] != to_position)
+						continue;
+
+					collapse_remap[other_from] = other_to;
+				}
+				collapse_remap[collapse.from] = collapse.to;
+
+				quadrics[to_position] += quadrics[from_position];
+				touched[from_position] = true;
+				touched[to_position]   = true;
+				triangles_removed     += kinds[collapse.from] == VertexKind::Border ? 1 : 2;
+				result_cost            = std::max(result_cost, collapse.cost);
+			}
+			if (triangles_removed == 0)
+				break;
+
+			size_t write = 0;
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				const auto a = collapse_remap[indices[i]], b = collapse_remap[indices[i + 1]], c = collapse_remap[indices[i + 2]];
+				if (remap[a] == remap[b] || remap[a] == remap[c] || remap[b] == remap[c])
+					continue;
+
+				indices[write++] = a;
+				indices[write++] = b;
+				indices[write++] = c;
+			}
+			indices.resize(write);
+
+			adjacency.build(indices, vertex_count);
+			classify();
+		}
+
+		if (p_result_error)
+			*p_result_error = std::sqrt(result_cost);
+
+		return indices;
+	}
+
+	std::vector<Data::MeshLOD> build_LODs(std::vector<unsigned int>& p_indices, const std::vector<glm::vec3>& p_positions, float p_ratio, float p_max_error)
+	{
+		std::vector<Data::MeshLOD> LODs{{0, static_cast<uint32_t>(p_indices.size()), 0.f}};
+		// Every level is simplified from LOD 0 so its error is measured against the full detail mesh rather than accumulating across levels.
+		const std::vector<unsigned int> full_detail = p_indices;
+		size_t target_index_count = full_detail.size();
+		while (LODs.size() < Max_LOD_Count)
+		{
+			target_index_count = static_cast<size_t>(static_cast<float>(target_index_count) * p_ratio) / 3 * 3;
+			if (target_index_count < Min_LOD_Triangles * 3)
+				break;
+
+			float error = 0.f;
+			auto LOD    = simplify(full_detail, p_positions, target_index_count, p_max_error, &error);
+			if (LOD.empty() || static_cast<float>(LOD.size()) > static_cast<float>(LODs.back().index_count) * Min_LOD_Reduction)
+				break;
+
+			LOD = MeshOptimiser::optimise_vertex_cache(LOD, p_positions.size());
+			LODs.push_back({static_cast<uint32_t>(p_indices.size()), static_cast<uint32_t>(LOD.size()), std::max(error, LODs.back().error)});
+			p_indices.insert(p_indices.end(), LOD.begin(), LOD.end());
+		}
+
+		return LODs;
+	}
+} // namespace Utility::MeshSimplifier
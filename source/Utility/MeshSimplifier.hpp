@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Data/MeshFile.hpp"
+#include "Data/Vertex.hpp"
+
+#include "glm/vec3.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// Quadric error metric edge collapse simplification (Garland and Heckbert 1997) for indexed triangle lists.
+// Vertices are only ever collapsed onto a neighbouring vertex, so a simplified mesh is a new index list into the original vertex buffer.
+// Vertices that share a position but not their other attributes (UV and normal seams) are collapsed together along the seam,
+// so seams don't tear open and attributes are never smeared across them. Mesh borders are only collapsed along themselves.
+namespace Utility::MeshSimplifier
+{
+	// Maximum number of levels build_LODs produces, including the full detail LOD 0.
+	constexpr size_t Max_LOD_Count = 5;
+	// Fraction of the triangles of LOD 0 each successive LOD keeps relative to the previous one.
+	constexpr float Default_LOD_Ratio = 0.5f;
+	// Largest error a LOD may have relative to the longest side of the mesh AABB. Past this the simplified mesh looks nothing like the original.
+	constexpr float Default_Max_Error = 0.05f;
+
+	// Simplify the triangle list p_indices towards p_target_index_count indices.
+	//@param p_indices Triangle list, 3 indices per triangle.
+	//@param p_positions Vertex positions indexed by p_indices. Vertices with identical positions are treated as one vertex split by a seam.
+	//@param p_target_index_count Simplification stops once the index count is at or below this.
+	//@param p_max_error Collapses that would move the surface further than this are not performed. Relative to the longest side of the mesh AABB.
+	//@param p_result_error If not null, receives the error of the simplified mesh relative to the longest side of the mesh AABB.
+	//@returns The simplified triangle list, referencing a subset of the vertices p_indices references.
+	[[nodiscard]] std::vector<unsigned int> simplify(const std::vector<unsigned int>& p_indices, const std::vector<glm::vec3>& p_positions, size_t p_target_index_count,
+	                                                 float p_max_error = Default_Max_Error, float* p_result_error = nullptr);
+
+	// Generate a chain of simplified versions of the triangle list p_indices, each with around p_ratio of the triangles of the previous level.
+	// The chain ends after Max_LOD_Count levels, when p_max_error is reached or when a level no longer shrinks meaningfully.
+	// The triangles of each new level are reordered for the post-transform vertex cache.
+	//@param p_indices Triangle list of the full detail mesh. The triangle lists of the new levels are appended to it.
+	//@returns The index range of every level in p_indices, LOD 0 being the original triangle list.
+	[[nodiscard]] std::vector<Data::MeshLOD> build_LODs(std::vector<unsigned int>& p_indices, const std::vector<glm::vec3>& p_positions,
+	                                                    float p_ratio = Default_LOD_Ratio, float p_max_error = Default_Max_Error);
+
+	template <typename VertexType>
+	requires Data::has_position_member<VertexType>
+	[[nodiscard]] std::vector<Data::MeshLOD> build_LODs(const std::vector<VertexType>& p_vertices, std::vector<unsigned int>& p_indices,
+	                                                    float p_ratio = Default_LOD_Ratio, float p_max_error = Default_Max_Error)
+	{
+		std::vector<glm::vec3> positions;
+		positions.reserve(p_vertices.size());
+		for (const auto& vertex : p_vertices)
+			positions.push_back(vertex.position);
+
+		return build_LODs(p_indices, positions, p_ratio, p_max_error);
+	}
+} // namespace Utility::MeshSimplifier
@@ -0,0 +1,107 @@
+#include "Parallel.hpp"
+
+namespace Utility
+{
+	ThreadPool::Batch::Batch(size_t p_chunk_count, std::function<void(size_t p_chunk)> p_run_chunk)
+		: m_chunk_count{p_chunk_count}
+		, m_run_chunk{std::move(p_run_chunk)}
+		, m_next_chunk{0}
+		, m_chunks_done{0}
+		, m_failed{false}
+		, m_exception{}
+		, m_mutex{}
+		, m_done{}
+	{}
+
+	void ThreadPool::Batch::work()
+	{
+		for (size_t chunk = m_next_chunk.fetch_add(1); chunk < m_chunk_count; chunk = m_next_chunk.fetch_add(1))
+		{
+			if (!m_failed.load(std::memory_order_relaxed))
+			{
+				try
+				{
+					m_run_chunk(chunk);
+				}
+				catch (...)
+				{
+					std::scoped_lock lock(m_mutex);
+					if (!m_exception)
+						m_exception = std::current_exception();
+					m_failed.store(true, std::memory_order_relaxed);
+				}
+			}
+
+			if (m_chunks_done.fetch_add(1) + 1 == m_chunk_count)
+			{
+				std::scoped_lock lock(m_mutex);
+				m_done.notify_all();
+			}
+		}
+	}
+
+	void ThreadPool::Batch::wait()
+	{
+		std::unique_lock lock(m_mutex);
+		m_done.wait(lock, [this] { return m_chunks_done.load() == m_chunk_count; });
+
+		if (m_exception)
+			std::rethrow_exception(m_exception);
+	}
+
+	ThreadPool& ThreadPool::get()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	ThreadPool::ThreadPool()
+		: m_queue{}
+		, m_mutex{}
+		, m_work_available{}
+		, m_workers{}
+	{
+		// The threads submitting work process chunks too, so one fewer worker than hardware threads keeps every core busy.
+		const size_t worker_count = std::max(2u, std::thread::hardware_concurrency()) - 1;
+		m_workers.reserve(worker_count);
+		for (size_t i = 0; i < worker_count; i++)
+			m_workers.emplace_back([this](std::stop_token p_stop_token) { worker_loop(p_stop_token); });
+	}
+	ThreadPool::~ThreadPool()
+	{
+		for (auto& worker : m_workers)
+			worker.request_stop();
+		m_work_available.notify_all();
+		m_workers.clear(); // jthreads join on destruction.
+	}
+
+	void ThreadPool::submit(const std::shared_ptr<Batch>& p_batch, size_t p_helpers)
+	{
+		p_helpers = std::min(p_helpers, m_workers.size());
+		{
+			std::scoped_lock lock(m_mutex);
+			for (size_t i = 0; i < p_helpers; i++)
+				m_queue.push_back(p_batch);
+		}
+		for (size_t i = 0; i < p_helpers; i++)
+			m_work_available.notify_one();
+	}
+
+	void ThreadPool::worker_loop(std::stop_token p_stop_token)
+	{
+		while (true)
+		{
+			std::shared_ptr<Batch> batch;
+			{
+				std::unique_lock lock(m_mutex);
+				if (!m_work_available.wait(lock, p_stop_token, [this] { return !m_queue.empty(); }))
+					return; // Stop requested.
+
+				batch = std::move(m_queue.front());
+				m_queue.pop_front();
+			}
+			// The batch may already be fully claimed by the submitting thread, work returns immediately in that case.
+			batch->work();
+		}
+	}
+} // namespace Utility
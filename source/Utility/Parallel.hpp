@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Utility
+{
+	// Persistent worker threads shared by every parallel_for call, started on first use and joined at exit.
+	class ThreadPool
+	{
+	public:
+		// The chunks of one parallel_for call. Chunks are claimed by the pool workers and the submitting thread until none remain.
+		struct Batch
+		{
+			Batch(size_t p_chunk_count, std::function<void(size_t p_chunk)> p_run_chunk);
+
+			// Claim and run chunks until every chunk has been claimed. Exceptions thrown by a chunk are stored and the remaining chunks skipped.
+			void work();
+			// Block until every claimed chunk is complete then rethrow the first exception a chunk threw.
+			void wait();
+
+		private:
+			const size_t m_chunk_count;
+			const std::function<void(size_t p_chunk)> m_run_chunk;
+			std::atomic<size_t> m_next_chunk;
+			std::atomic<size_t> m_chunks_done;
+			std::atomic<bool> m_failed;
+			std::exception_ptr m_exception; // Guarded by m_mutex.
+			std::mutex m_mutex;
+			std::condition_variable m_done;
+		};
+
+		static ThreadPool& get();
+
+		// Number of worker threads, excluding the threads that submit work.
+		size_t worker_count() const { return m_workers.size(); }
+		// Wake up to p_helpers workers to help p_batch. The submitting thread must call Batch::work then Batch::wait.
+		void submit(const std::shared_ptr<Batch>& p_batch, size_t p_helpers);
+
+		ThreadPool(const ThreadPool& p_other)            = delete;
+		ThreadPool& operator=(const ThreadPool& p_other) = delete;
+
+	private:
+		ThreadPool();
+		~ThreadPool();
+		void worker_loop(std::stop_token p_stop_token);
+
+		std::deque<std::shared_ptr<Batch>> m_queue; // A batch is queued once per helper it asked for. Guarded by m_mutex.
+		std::mutex m_mutex;
+		std::condition_variable_any m_work_available;
+		std::vector<std::jthread> m_workers;
+	};
+
+	// Split the range [0, p_count) into contiguous chunks and call p_function(begin, end) for each chunk on the ThreadPool workers.
+	// The calling thread processes chunks itself and returns once every chunk is complete, so parallel_for can be nested.
+	// If a chunk throws, the remaining unclaimed chunks are skipped and the first exception is rethrown on the calling thread.
+	// Chunks must not write to shared state without synchronisation.
+	//@param p_count Number of items to process.
+	//@param p_min_chunk_size Smallest number of items worth giving a thread. Small ranges run on the calling thread only.
+	//@param p_function Callable with signature void(size_t begin, size_t end).
+	template <typename Func>
+	void parallel_for(size_t p_count, size_t p_min_chunk_size, const Func& p_function)
+	{
+		if (p_count == 0)
+			return;
+
+		auto& pool                = ThreadPool::get();
+		const size_t thread_count = std::clamp(p_count / std::max<size_t>(p_min_chunk_size, 1), size_t(1), pool.worker_count() + 1);
+		if (thread_count == 1)
+		{
+			p_function(size_t(0), p_count);
+			return;
+		}
+
+		const size_t chunk_size  = (p_count + thread_count - 1) / thread_count;
+		const size_t chunk_count = (p_count + chunk_size - 1) / chunk_size;
+
+		// p_function is only called for claimed chunks, all of which complete before wait returns, so the batch can reference it.
+		auto batch = std::make_shared<ThreadPool::Batch>(chunk_count, [&p_function, chunk_size, p_count](size_t p_chunk)
+		{
+			p_function(p_chunk * chunk_size, std::min((p_chunk + 1) * chunk_size, p_count));
+		});
+		pool.submit(batch, chunk_count - 1);
+		batch->work();
+		batch->wait();
+	}
+} // namespace Utility
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Utility
+{
+	// Map p_value to an unsigned key ordering the same as the floats, negatives included, so radix_sort can sort by a float.
+	// Positive floats already order as their bit patterns once the sign bit is set, negative floats order in reverse so all their bits are flipped.
+	inline uint32_t sortable_key(float p_value)
+	{
+		const uint32_t bits = std::bit_cast<uint32_t>(p_value);
+		return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+	}
+
+	// Stable least significant digit radix sort of p_items by an unsigned integer key, one byte of the key per pass.
+	// All the byte histograms are built in a single read over the items and passes where every key shares the same byte are skipped,
+	// so keys that only use their low bits (or only differ in a few bytes) cost fewer passes.
+	//@param p_scratch Storage for the passes to ping-pong between, reused between calls to avoid allocating.
+	//@param p_key Callable returning the key of an item, called once per item per pass.
+	template <typename T, typename KeyFunc>
+	requires std::unsigned_integral<std::invoke_result_t<KeyFunc, const T&>>
+	void radix_sort(std::vector<T>& p_items, std::vector<T>& p_scratch, const KeyFunc& p_key)
+	{
+		using Key = std::invoke_result_t<KeyFunc, const T&>;
+		constexpr size_t Pass_Count = sizeof(Key);
+
+		const size_t count = p_items.size();
+		if (count < 2)
+			return;
+
+		std::array<std::array<size_t, 256>, Pass_Count> histograms = {};
+		for (const auto& item : p_items)
+		{
+			const Key key = p_key(item);
+			for (size_t pass = 0; pass < Pass_Count; pass++)
+				histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+		}
+
+		p_scratch.resize(count);
+		std::vector<T>* source      = &p_items;
+		std::vector<T>* destination = &p_scratch;
+		for (size_t pass = 0; pass < Pass_Count; pass++)
+		{
+			auto& histogram = histograms[pass];
+			if (histogram[(p_key(p_items.front()) >> (pass * 8)) & 0xFF] == count)
+				continue; // Every key has the same byte here, the order is unchanged.
+
+			// Turn the counts into the first output position of each byte value.
+			size_t offset = 0;
+			for (auto& bucket : histogram)
+				offset += std::exchange(bucket, offset);
+
+			for (const auto& item : *source)
+				(*destination)[histogram[(p_key(item) >> (pass * 8)) & 0xFF]++] = item;
+			std::swap(source, destination);
+		}
+
+		if (source != &p_items)
+			p_items.swap(p_scratch);
+	}
+} // namespace Utility
@@ -0,0 +1,159 @@
+#pragma once
+
+// Minimal wrapper over 4-wide float SIMD registers used by the CPU-side kernels (image filtering, culling, intersection batches).
+// The instruction set is selected at compile time: SSE on x86-64, NEON on ARM, with a scalar fallback for everything else.
+// When the compiler targets AVX2 (-mavx2 or /arch:AVX2) an 8-wide Float8 is also available and becomes FloatWide, the widest register kernels should use.
+#if defined(__AVX2__)
+	#define SPIRIT_SIMD_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define SPIRIT_SIMD_SSE
+	#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#define SPIRIT_SIMD_NEON
+	#include <arm_neon.h>
+#endif
+
+namespace Utility::SIMD
+{
+#if defined(SPIRIT_SIMD_SSE)
+	using Float4 = __m128;
+
+	inline Float4 load(const float* p_source)                  { return _mm_loadu_ps(p_source); }
+	inline void store(float* p_destination, Float4 p_value)    { _mm_storeu_ps(p_destination, p_value); }
+	inline Float4 set(float p_value)                           { return _mm_set1_ps(p_value); }
+	inline Float4 set(float p_x, float p_y, float p_z, float p_w) { return _mm_setr_ps(p_x, p_y, p_z, p_w); }
+	inline Float4 add(Float4 p_a, Float4 p_b)                  { return _mm_add_ps(p_a, p_b); }
+	inline Float4 sub(Float4 p_a, Float4 p_b)                  { return _mm_sub_ps(p_a, p_b); }
+	inline Float4 mul(Float4 p_a, Float4 p_b)                  { return _mm_mul_ps(p_a, p_b); }
+	inline Float4 min(Float4 p_a, Float4 p_b)                  { return _mm_min_ps(p_a, p_b); }
+	inline Float4 max(Float4 p_a, Float4 p_b)                  { return _mm_max_ps(p_a, p_b); }
+	// Returns p_a * p_b + p_c.
+	inline Float4 mul_add(Float4 p_a, Float4 p_b, Float4 p_c)  { return _mm_add_ps(_mm_mul_ps(p_a, p_b), p_c); }
+	inline Float4 div(Float4 p_a, Float4 p_b)                  { return _mm_div_ps(p_a, p_b); }
+	inline Float4 abs(Float4 p_value)                          { return _mm_andnot_ps(_mm_set1_ps(-0.f), p_value); }
+
+	// Per-lane comparison result, all bits set in lanes where the comparison holds. Comparisons involving NaN are false.
+	using Mask4 = __m128;
+
+	inline Mask4 less(Float4 p_a, Float4 p_b)                  { return _mm_cmplt_ps(p_a, p_b); }
+	inline Mask4 less_equal(Float4 p_a, Float4 p_b)            { return _mm_cmple_ps(p_a, p_b); }
+	inline Mask4 greater(Float4 p_a, Float4 p_b)               { return _mm_cmpgt_ps(p_a, p_b); }
+	inline Mask4 greater_equal(Float4 p_a, Float4 p_b)         { return _mm_cmpge_ps(p_a, p_b); }
+	inline Mask4 mask_and(Mask4 p_a, Mask4 p_b)                { return _mm_and_ps(p_a, p_b); }
+	inline Mask4 mask_or(Mask4 p_a, Mask4 p_b)                 { return _mm_or_ps(p_a, p_b); }
+	// Returns p_a in lanes where p_mask is set, p_b elsewhere.
+	inline Float4 select(Mask4 p_mask, Float4 p_a, Float4 p_b) { return _mm_or_ps(_mm_and_ps(p_mask, p_a), _mm_andnot_ps(p_mask, p_b)); }
+	// Bit i of the result is set if lane i of p_mask is set.
+	inline int mask_bits(Mask4 p_mask)                         { return _mm_movemask_ps(p_mask); }
+#elif defined(SPIRIT_SIMD_NEON)
+	using Float4 = float32x4_t;
+
+	inline Float4 load(const float* p_source)                  { return vld1q_f32(p_source); }
+	inline void store(float* p_destination, Float4 p_value)    { vst1q_f32(p_destination, p_value); }
+	inline Float4 set(float p_value)                           { return vdupq_n_f32(p_value); }
+	inline Float4 set(float p_x, float p_y, float p_z, float p_w) { const float values[4] = {p_x, p_y, p_z, p_w}; return vld1q_f32(values); }
+	inline Float4 add(Float4 p_a, Float4 p_b)                  { return vaddq_f32(p_a, p_b); }
+	inline Float4 sub(Float4 p_a, Float4 p_b)                  { return vsubq_f32(p_a, p_b); }
+	inline Float4 mul(Float4 p_a, Float4 p_b)                  { return vmulq_f32(p_a, p_b); }
+	inline Float4 min(Float4 p_a, Float4 p_b)                  { return vminq_f32(p_a, p_b); }
+	inline Float4 max(Float4 p_a, Float4 p_b)                  { return vmaxq_f32(p_a, p_b); }
+	// Returns p_a * p_b + p_c.
+	inline Float4 mul_add(Float4 p_a, Float4 p_b, Float4 p_c)  { return vmlaq_f32(p_c, p_a, p_b); }
+	inline Float4 div(Float4 p_a, Float4 p_b) // vdivq_f32 is AArch64 only, refine the reciprocal estimate with two Newton-Raphson steps instead.
+	{
+		float32x4_t reciprocal = vrecpeq_f32(p_b);
+		reciprocal = vmulq_f32(vrecpsq_f32(p_b, reciprocal), reciprocal);
+		reciprocal = vmulq_f32(vrecpsq_f32(p_b, reciprocal), reciprocal);
+		return vmulq_f32(p_a, reciprocal);
+	}
+	inline Float4 abs(Float4 p_value)                          { return vabsq_f32(p_value); }
+
+	// Per-lane comparison result, all bits set in lanes where the comparison holds. Comparisons involving NaN are false.
+	using Mask4 = uint32x4_t;
+
+	inline Mask4 less(Float4 p_a, Float4 p_b)                  { return vcltq_f32(p_a, p_b); }
+	inline Mask4 less_equal(Float4 p_a, Float4 p_b)            { return vcleq_f32(p_a, p_b); }
+	inline Mask4 greater(Float4 p_a, Float4 p_b)               { return vcgtq_f32(p_a, p_b); }
+	inline Mask4 greater_equal(Float4 p_a, Float4 p_b)         { return vcgeq_f32(p_a, p_b); }
+	inline Mask4 mask_and(Mask4 p_a, Mask4 p_b)                { return vandq_u32(p_a, p_b); }
+	inline Mask4 mask_or(Mask4 p_a, Mask4 p_b)                 { return vorrq_u32(p_a, p_b); }
+	// Returns p_a in lanes where p_mask is set, p_b elsewhere.
+	inline Float4 select(Mask4 p_mask, Float4 p_a, Float4 p_b) { return vbslq_f32(p_mask, p_a, p_b); }
+	// Bit i of the result is set if lane i of p_mask is set.
+	inline int mask_bits(Mask4 p_mask)
+	{
+		return static_cast<int>((vgetq_lane_u32(p_mask, 0) & 1u) | (vgetq_lane_u32(p_mask, 1) & 2u) | (vgetq_lane_u32(p_mask, 2) & 4u) | (vgetq_lane_u32(p_mask, 3) & 8u));
+	}
+#else
+	struct Float4 { float v[4]; };
+
+	inline Float4 load(const float* p_source)                  { return {p_source[0], p_source[1], p_source[2], p_source[3]}; }
+	inline void store(float* p_destination, Float4 p_value)    { for (int i = 0; i < 4; i++) p_destination[i] = p_value.v[i]; }
+	inline Float4 set(float p_value)                           { return {p_value, p_value, p_value, p_value}; }
+	inline Float4 set(float p_x, float p_y, float p_z, float p_w) { return {p_x, p_y, p_z, p_w}; }
+	inline Float4 add(Float4 p_a, Float4 p_b)                  { return {p_a.v[0] + p_b.v[0], p_a.v[1] + p_b.v[1], p_a.v[2] + p_b.v[2], p_a.v[3] + p_b.v[3]}; }
+	inline Float4 sub(Float4 p_a, Float4 p_b)                  { return {p_a.v[0] - p_b.v[0], p_a.v[1] - p_b.v[1], p_a.v[2] - p_b.v[2], p_a.v[3] - p_b.v[3]}; }
+	inline Float4 mul(Float4 p_a, Float4 p_b)                  { return {p_a.v[0] * p_b.v[0], p_a.v[1] * p_b.v[1], p_a.v[2] * p_b.v[2], p_a.v[3] * p_b.v[3]}; }
+	inline Float4 min(Float4 p_a, Float4 p_b)                  { return {p_a.v[0] < p_b.v[0] ? p_a.v[0] : p_b.v[0], p_a.v[1] < p_b.v[1] ? p_a.v[1] : p_b.v[1], p_a.v[2] < p_b.v[2] ? p_a.v[2] : p_b.v[2], p_a.v[3] < p_b.v[3] ? p_a.v[3] : p_b.v[3]}; }
+	inline Float4 max(Float4 p_a, Float4 p_b)                  { return {p_a.v[0] > p_b.v[0] ? p_a.v[0] : p_b.v[0], p_a.v[1] > p_b.v[1] ? p_a.v[1] : p_b.v[1], p_a.v[2] > p_b.v[2] ? p_a.v[2] : p_b.v[2], p_a.v[3] > p_b.v[3] ? p_a.v[3] : p_b.v[3]}; }
+	// Returns p_a * p_b + p_c.
+	inline Float4 mul_add(Float4 p_a, Float4 p_b, Float4 p_c)  { return add(mul(p_a, p_b), p_c); }
+	inline Float4 div(Float4 p_a, Float4 p_b)                  { return {p_a.v[0] / p_b.v[0], p_a.v[1] / p_b.v[1], p_a.v[2] / p_b.v[2], p_a.v[3] / p_b.v[3]}; }
+	inline Float4 abs(Float4 p_value)                          { return {p_value.v[0] < 0.f ? -p_value.v[0] : p_value.v[0], p_value.v[1] < 0.f ? -p_value.v[1] : p_value.v[1], p_value.v[2] < 0.f ? -p_value.v[2] : p_value.v[2], p_value.v[3] < 0.f ? -p_value.v[3] : p_value.v[3]}; }
+
+	// Per-lane comparison result. Comparisons involving NaN are false.
+	struct Mask4 { bool v[4]; };
+
+	inline Mask4 less(Float4 p_a, Float4 p_b)                  { return {p_a.v[0] < p_b.v[0], p_a.v[1] < p_b.v[1], p_a.v[2] < p_b.v[2], p_a.v[3] < p_b.v[3]}; }
+	inline Mask4 less_equal(Float4 p_a, Float4 p_b)            { return {p_a.v[0] <= p_b.v[0], p_a.v[1] <= p_b.v[1], p_a.v[2] <= p_b.v[2], p_a.v[3] <= p_b.v[3]}; }
+	inline Mask4 greater(Float4 p_a, Float4 p_b)               { return {p_a.v[0] > p_b.v[0], p_a.v[1] > p_b.v[1], p_a.v[2] > p_b.v[2], p_a.v[3] > p_b.v[3]}; }
+	inline Mask4 greater_equal(Float4 p_a, Float4 p_b)         { return {p_a.v[0] >= p_b.v[0], p_a.v[1] >= p_b.v[1], p_a.v[2] >= p_b.v[2], p_a.v[3] >= p_b.v[3]}; }
+	inline Mask4 mask_and(Mask4 p_a, Mask4 p_b)                { return {p_a.v[0] && p_b.v[0], p_a.v[1] && p_b.v[1], p_a.v[2] && p_b.v[2], p_a.v[3] && p_b.v[3]}; }
+	inline Mask4 mask_or(Mask4 p_a, Mask4 p_b)                 { return {p_a.v[0] || p_b.v[0], p_a.v[1] || p_b.v[1], p_a.v[2] || p_b.v[2], p_a.v[3] || p_b.v[3]}; }
+	// Returns p_a in lanes where p_mask is set, p_b elsewhere.
+	inline Float4 select(Mask4 p_mask, Float4 p_a, Float4 p_b) { return {p_mask.v[0] ? p_a.v[0] : p_b.v[0], p_mask.v[1] ? p_a.v[1] : p_b.v[1], p_mask.v[2] ? p_a.v[2] : p_b.v[2], p_mask.v[3] ? p_a.v[3] : p_b.v[3]}; }
+	// Bit i of the result is set if lane i of p_mask is set.
+	inline int mask_bits(Mask4 p_mask)                         { return (p_mask.v[0] ? 1 : 0) | (p_mask.v[1] ? 2 : 0) | (p_mask.v[2] ? 4 : 0) | (p_mask.v[3] ? 8 : 0); }
+#endif
+
+	inline Float4 clamp(Float4 p_value, Float4 p_min, Float4 p_max) { return min(max(p_value, p_min), p_max); }
+
+#if defined(SPIRIT_SIMD_AVX2)
+	using Float8 = __m256;
+	using Mask8  = __m256;
+
+	inline Float8 load8(const float* p_source)                 { return _mm256_loadu_ps(p_source); }
+	inline void store(float* p_destination, Float8 p_value)    { _mm256_storeu_ps(p_destination, p_value); }
+	inline Float8 set8(float p_value)                          { return _mm256_set1_ps(p_value); }
+	inline Float8 add(Float8 p_a, Float8 p_b)                  { return _mm256_add_ps(p_a, p_b); }
+	inline Float8 sub(Float8 p_a, Float8 p_b)                  { return _mm256_sub_ps(p_a, p_b); }
+	inline Float8 mul(Float8 p_a, Float8 p_b)                  { return _mm256_mul_ps(p_a, p_b); }
+	inline Float8 div(Float8 p_a, Float8 p_b)                  { return _mm256_div_ps(p_a, p_b); }
+	inline Float8 min(Float8 p_a, Float8 p_b)                  { return _mm256_min_ps(p_a, p_b); }
+	inline Float8 max(Float8 p_a, Float8 p_b)                  { return _mm256_max_ps(p_a, p_b); }
+	inline Float8 mul_add(Float8 p_a, Float8 p_b, Float8 p_c)  { return _mm256_add_ps(_mm256_mul_ps(p_a, p_b), p_c); }
+	inline Float8 abs(Float8 p_value)                          { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), p_value); }
+	inline Mask8 less(Float8 p_a, Float8 p_b)                  { return _mm256_cmp_ps(p_a, p_b, _CMP_LT_OQ); }
+	inline Mask8 less_equal(Float8 p_a, Float8 p_b)            { return _mm256_cmp_ps(p_a, p_b, _CMP_LE_OQ); }
+	inline Mask8 greater(Float8 p_a, Float8 p_b)               { return _mm256_cmp_ps(p_a, p_b, _CMP_GT_OQ); }
+	inline Mask8 greater_equal(Float8 p_a, Float8 p_b)         { return _mm256_cmp_ps(p_a, p_b, _CMP_GE_OQ); }
+	inline Mask8 mask_and(Mask8 p_a, Mask8 p_b)                { return _mm256_and_ps(p_a, p_b); }
+	inline Mask8 mask_or(Mask8 p_a, Mask8 p_b)                 { return _mm256_or_ps(p_a, p_b); }
+	inline Float8 select(Mask8 p_mask, Float8 p_a, Float8 p_b) { return _mm256_blendv_ps(p_b, p_a, p_mask); }
+	inline int mask_bits(Mask8 p_mask)                         { return _mm256_movemask_ps(p_mask); }
+
+	using FloatWide = Float8;
+	using MaskWide  = Mask8;
+	constexpr int Wide_Lanes = 8;
+	inline FloatWide load_wide(const float* p_source)          { return load8(p_source); }
+	inline FloatWide set_wide(float p_value)                   { return set8(p_value); }
+#else
+	using FloatWide = Float4;
+	using MaskWide  = Mask4;
+	constexpr int Wide_Lanes = 4;
+	inline FloatWide load_wide(const float* p_source)          { return load(p_source); }
+	inline FloatWide set_wide(float p_value)                   { return set(p_value); }
+#endif
+} // namespace Utility::SIMD
\ No newline at end of file